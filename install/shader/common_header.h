@@ -271,6 +271,16 @@ namespace engine
     #define EMeshType_StaticMesh            0
     #define EMeshType_ReflectionCaptureMesh 1
 
+    // Static mesh vertex format, compact format decode when fetch.
+    #define EVertexFormat                   int
+    #define EVertexFormat_Float             0
+    #define EVertexFormat_Compact           1
+
+    // Static mesh submesh index format.
+    #define EIndexFormat                    int
+    #define EIndexFormat_Uint32             0
+    #define EIndexFormat_Uint16             1
+
     #define ERendererType                   int
     #define ERendererType_Viewport          0
     #define ERendererType_ReflectionCapture 1        
@@ -311,6 +321,18 @@ namespace engine
     constexpr uint kUv0Strip      = 2U;
     constexpr uint kTangentStrip  = 4U;
 
+    // Compact vertex format strip in float, see VertexPositionCompact in asset_common.h.
+    constexpr uint kPositionCompactStrip = 2U;
+    constexpr uint kNormalCompactStrip   = 1U;
+    constexpr uint kUv0CompactStrip      = 1U;
+    constexpr uint kTangentCompactStrip  = 1U;
+
+    // Static mesh max LOD count include LOD0, same as kStaticMeshMaxLodCount in asset_common.h.
+    constexpr uint kMaxStaticMeshLodCount = 4U;
+
+    // Texture streaming feedback store sampled lod plus this offset, so finer lod than resident first mip keep positive.
+    constexpr uint kTextureStreamingFeedbackLodOffset = 16U;
+
     // Max cascade count is 8.
     constexpr uint kMaxCascadeNum = 8U;
 
@@ -532,6 +554,29 @@ namespace engine
         vec3 extents; 
         // Index of submeshes in the mesh.
         uint submeshIndex;         
+
+        // Meshlets buffer in bindless buffer id, only valid when meshletCount > 0.
+        uint meshletsArrayId;
+        // Meshlet range of this submesh.
+        uint meshletStart;
+        uint meshletCount;
+        // Vertex streams format, compact position is relative to submesh bounds.
+        EVertexFormat vertexFormat;
+
+        // Submesh indices relative to base vertex.
+        uint vertexStart;
+        // Submesh indices start word in indices buffer, indexStartPosition is logical position used for draw.
+        uint indexWordStart;
+        // 16 bit indices pack two in one word.
+        EIndexFormat indexFormat;
+        // LOD count include LOD0, LODs share vertices and index format with LOD0.
+        uint lodCount;
+
+        // LOD logical index range, .x is LOD0 same as indexStartPosition and indicesCount.
+        uvec4 lodIndexStart;
+        uvec4 lodIndicesCount;
+        // LOD simplify error in mesh local unit, .x is zero.
+        vec4 lodError;
     };
     CHECK_SIZE_GPU_SAFE(MeshInfo)
 
@@ -559,6 +604,41 @@ namespace engine
         uint objectId;
     };
 
+    // Meshlet C++ define in asset_common.h, layout must keep same.
+#ifndef __cplusplus
+    struct StaticMeshMeshlet
+    {
+        // .xyz is center local position, .w is radius.
+        vec4 sphereBounds;
+        // .xyz is normal cone axis, .w is cone cutoff.
+        vec4 coneAxisCutoff;
+        // Normal cone apex local position.
+        vec3 coneApex;
+        // Index start offset position in mesh indices.
+        uint indicesStart;
+
+        uint triangleCount;
+        uint vertexCount;
+        uint pad0;
+        uint pad1;
+    };
+#endif
+
+    // Static mesh meshlet culling counters of one view, read back for stat.
+    struct StaticMeshMeshletCullStat
+    {
+        uint meshletTotal;
+        uint meshletVisible;
+        uint triangleTotal;
+        uint triangleVisible;
+
+        uint triangleFrustumCulled;
+        uint triangleConeCulled;
+        uint triangleOcclusionCulled;
+        uint pad0;
+    };
+    CHECK_SIZE_GPU_SAFE(StaticMeshMeshletCullStat)
+
     struct CascadeInfo
     {
         mat4 viewProj;
@@ -20,6 +20,7 @@ layout (set = 0, binding = 4) buffer  SSBOPerObject    { PerObjectInfo objectDat
 
 layout(set = 3, binding = 0) buffer BindlessSSBOVertices{ float data[]; } verticesArray[];
 layout(set = 4, binding = 0) buffer BindlessSSBOIndices{ uint data[]; } indicesArray[];
+#include "static_mesh_vertex.glsl"
 layout(set = 5, binding = 0) uniform sampler bindlessSampler[];
 layout(set = 6, binding = 0) uniform  texture2D texture2DBindlessArray[];
 
@@ -43,25 +44,16 @@ bool hitTest(in rayQueryEXT rayQuery)
     const BSDFMaterialInfo material = objectData.materialInfoData;
 
     // 
-    int primitiveID = int(meshInfo.indexStartPosition) + rayQueryGetIntersectionPrimitiveIndexEXT(rayQuery, false) * 3;
-
-    const uint indicesId  = meshInfo.indicesArrayId;
-    const uint uv0Id      = meshInfo.uv0sArrayId;
+    const uint primitiveID = meshInfo.indexStartPosition + uint(rayQueryGetIntersectionPrimitiveIndexEXT(rayQuery, false)) * 3;
 
     // Hit triangle id.
-    const uint vertexId_0 = indicesArray[nonuniformEXT(indicesId)].data[primitiveID + 0];
-    const uint vertexId_1 = indicesArray[nonuniformEXT(indicesId)].data[primitiveID + 1];
-    const uint vertexId_2 = indicesArray[nonuniformEXT(indicesId)].data[primitiveID + 2];
-
-    vec2 v0, v1, v2;
-    v0.x = verticesArray[nonuniformEXT(uv0Id)].data[vertexId_0 * kUv0Strip + 0];
-    v0.y = verticesArray[nonuniformEXT(uv0Id)].data[vertexId_0 * kUv0Strip + 1];
-
-    v1.x = verticesArray[nonuniformEXT(uv0Id)].data[vertexId_1 * kUv0Strip + 0];
-    v1.y = verticesArray[nonuniformEXT(uv0Id)].data[vertexId_1 * kUv0Strip + 1];
+    const uint vertexId_0 = loadStaticMeshIndex(meshInfo, primitiveID + 0);
+    const uint vertexId_1 = loadStaticMeshIndex(meshInfo, primitiveID + 1);
+    const uint vertexId_2 = loadStaticMeshIndex(meshInfo, primitiveID + 2);
 
-    v2.x = verticesArray[nonuniformEXT(uv0Id)].data[vertexId_2 * kUv0Strip + 0];
-    v2.y = verticesArray[nonuniformEXT(uv0Id)].data[vertexId_2 * kUv0Strip + 1];
+    const vec2 v0 = loadStaticMeshUv0(meshInfo, vertexId_0);
+    const vec2 v1 = loadStaticMeshUv0(meshInfo, vertexId_1);
+    const vec2 v2 = loadStaticMeshUv0(meshInfo, vertexId_2);
 
     vec2  bary = rayQueryGetIntersectionBarycentricsEXT(rayQuery, false);
     const vec3 barycentrics = vec3(1.0 - bary.x - bary.y, bary.x, bary.y);
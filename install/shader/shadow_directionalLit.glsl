@@ -37,6 +37,8 @@ layout(set = 0, binding =10) buffer SSBODrawCount     { uint drawCount;
 // Bindless texture array.
 layout(set = 3, binding = 0) buffer BindlessSSBOVertices{ float data[]; } verticesArray[];
 layout(set = 4, binding = 0) buffer BindlessSSBOIndices{ uint data[]; } indicesArray[];
+#include "static_mesh_vertex.glsl"
+#include "static_mesh_lod.glsl"
 layout(set = 5, binding = 0) uniform sampler bindlessSampler[];
 layout(set = 6, binding = 0) uniform  texture2D texture2DBindlessArray[];
 
@@ -62,6 +64,12 @@ layout (push_constant) uniform PushConsts
     uint contactShadowSampleNum;
     uint bContactShadow;
     uint bCloudShadow;
+
+    // Static mesh LOD select by main view, cascade bias make far cascade coarser.
+    float lodErrorPixels;
+    int lodBias;
+    uint pad0;
+    uint pad1;
 };
 
 const int kShadowFilterSampleCount = 8;
@@ -392,13 +400,15 @@ void main()
         }
     }
     
+    const uint lod = selectStaticMeshLod(meshInfo, objectData.modelMatrix, lodErrorPixels, lodBias);
+
     // Build draw command if visible.
     uint drawId = atomicAdd(drawCount, 1);
     indirectCommands[drawId].objectId = idx;
 
     // We fetech vertex by index, so vertex count is index count.
-    indirectCommands[drawId].vertexCount = meshInfo.indicesCount;
-    indirectCommands[drawId].firstVertex = meshInfo.indexStartPosition;
+    indirectCommands[drawId].vertexCount = meshInfo.lodIndicesCount[lod];
+    indirectCommands[drawId].firstVertex = meshInfo.lodIndexStart[lod];
 
     // We fetch vertex in vertex shader, so instancing is unused when rendering.
     indirectCommands[drawId].instanceCount = 1;
@@ -438,25 +448,14 @@ void main()
     outObjectId = indirectCommands[gl_DrawID].objectId;
     const PerObjectInfo objectData = objectDatas[outObjectId];
 
-    // We get bindless array id first.
-    const uint indicesId  = objectData.meshInfoData.indicesArrayId;
-    const uint positionId = objectData.meshInfoData.positionsArrayId;
-    const uint uv0Id = objectData.meshInfoData.uv0sArrayId;
-
     // Vertex count same with index count, so vertex index same with index index.
     const uint indexId = gl_VertexIndex;
 
     // Then fetech vertex index from indices array.
-    const uint vertexId = indicesArray[nonuniformEXT(indicesId)].data[indexId];
-
-    vec3 position;
-    vec2 uv0;
+    const uint vertexId = loadStaticMeshIndex(objectData.meshInfoData, indexId);
 
-    position.x = verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionStrip + 0];
-    position.y = verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionStrip + 1];
-    position.z = verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionStrip + 2];
-    uv0.x = verticesArray[nonuniformEXT(uv0Id)].data[vertexId * kUv0Strip + 0];
-    uv0.y = verticesArray[nonuniformEXT(uv0Id)].data[vertexId * kUv0Strip + 1];
+    const vec3 position = loadStaticMeshPosition(objectData.meshInfoData, vertexId);
+    const vec2 uv0 = loadStaticMeshUv0(objectData.meshInfoData, vertexId);
 
     // Uv0 ready.
     vsOut.uv0 = uv0;
@@ -23,6 +23,7 @@ layout (set = 0, binding = 6) uniform texture2D inGbufferB;
 
 layout(set = 3, binding = 0) buffer BindlessSSBOVertices{ float data[]; } verticesArray[];
 layout(set = 4, binding = 0) buffer BindlessSSBOIndices{ uint data[]; } indicesArray[];
+#include "static_mesh_vertex.glsl"
 layout(set = 5, binding = 0) uniform sampler bindlessSampler[];
 layout(set = 6, binding = 0) uniform  texture2D texture2DBindlessArray[];
 
@@ -50,32 +51,21 @@ HitPayload hitTest(in rayQueryEXT rayQuery)
     const BSDFMaterialInfo material = objectData.materialInfoData;
 
     // 
-    int primitiveID = int(meshInfo.indexStartPosition) + rayQueryGetIntersectionPrimitiveIndexEXT(rayQuery, false) * 3;
-
-    const uint indicesId  = meshInfo.indicesArrayId;
-    const uint uv0Id      = meshInfo.uv0sArrayId;
-    const uint normalId   = meshInfo.normalsArrayId;
-    const uint positionId = meshInfo.positionsArrayId;
+    const uint primitiveID = meshInfo.indexStartPosition + uint(rayQueryGetIntersectionPrimitiveIndexEXT(rayQuery, false)) * 3;
 
     // Hit triangle id.
-    const uint vertexId_0 = indicesArray[nonuniformEXT(indicesId)].data[primitiveID + 0];
-    const uint vertexId_1 = indicesArray[nonuniformEXT(indicesId)].data[primitiveID + 1];
-    const uint vertexId_2 = indicesArray[nonuniformEXT(indicesId)].data[primitiveID + 2];
+    const uint vertexId_0 = loadStaticMeshIndex(meshInfo, primitiveID + 0);
+    const uint vertexId_1 = loadStaticMeshIndex(meshInfo, primitiveID + 1);
+    const uint vertexId_2 = loadStaticMeshIndex(meshInfo, primitiveID + 2);
 
     vec2  bary = rayQueryGetIntersectionBarycentricsEXT(rayQuery, false);
     const vec3 barycentrics = vec3(1.0 - bary.x - bary.y, bary.x, bary.y);
 
     vec2 uv;
     {
-        vec2 v0, v1, v2;
-        v0.x = verticesArray[nonuniformEXT(uv0Id)].data[vertexId_0 * kUv0Strip + 0];
-        v0.y = verticesArray[nonuniformEXT(uv0Id)].data[vertexId_0 * kUv0Strip + 1];
-
-        v1.x = verticesArray[nonuniformEXT(uv0Id)].data[vertexId_1 * kUv0Strip + 0];
-        v1.y = verticesArray[nonuniformEXT(uv0Id)].data[vertexId_1 * kUv0Strip + 1];
-
-        v2.x = verticesArray[nonuniformEXT(uv0Id)].data[vertexId_2 * kUv0Strip + 0];
-        v2.y = verticesArray[nonuniformEXT(uv0Id)].data[vertexId_2 * kUv0Strip + 1];
+        const vec2 v0 = loadStaticMeshUv0(meshInfo, vertexId_0);
+        const vec2 v1 = loadStaticMeshUv0(meshInfo, vertexId_1);
+        const vec2 v2 = loadStaticMeshUv0(meshInfo, vertexId_2);
 
         uv =  v0 * barycentrics.x + v1 * barycentrics.y + v2 * barycentrics.z;
     }
@@ -84,37 +74,18 @@ HitPayload hitTest(in rayQueryEXT rayQuery)
 
     vec3 normal;
     {
-        vec3 n0, n1, n2;
-        n0.x = verticesArray[nonuniformEXT(normalId)].data[vertexId_0 * kNormalStrip + 0];
-        n0.y = verticesArray[nonuniformEXT(normalId)].data[vertexId_0 * kNormalStrip + 1];
-        n0.z = verticesArray[nonuniformEXT(normalId)].data[vertexId_0 * kNormalStrip + 2];
-
-        n1.x = verticesArray[nonuniformEXT(normalId)].data[vertexId_1 * kNormalStrip + 0];
-        n1.y = verticesArray[nonuniformEXT(normalId)].data[vertexId_1 * kNormalStrip + 1];
-        n1.z = verticesArray[nonuniformEXT(normalId)].data[vertexId_1 * kNormalStrip + 2];
-
-        n2.x = verticesArray[nonuniformEXT(normalId)].data[vertexId_2 * kNormalStrip + 0];
-        n2.y = verticesArray[nonuniformEXT(normalId)].data[vertexId_2 * kNormalStrip + 1];
-        n2.z = verticesArray[nonuniformEXT(normalId)].data[vertexId_2 * kNormalStrip + 2];
+        const vec3 n0 = loadStaticMeshNormal(meshInfo, vertexId_0);
+        const vec3 n1 = loadStaticMeshNormal(meshInfo, vertexId_1);
+        const vec3 n2 = loadStaticMeshNormal(meshInfo, vertexId_2);
 
         normal = n0 * barycentrics.x + n1 * barycentrics.y + n2 * barycentrics.z;
     }
 
     vec3 position;
     {
-        vec3 p0, p1, p2;
-
-        p0.x = verticesArray[nonuniformEXT(positionId)].data[vertexId_0 * kPositionStrip + 0];
-        p0.y = verticesArray[nonuniformEXT(positionId)].data[vertexId_0 * kPositionStrip + 1];
-        p0.z = verticesArray[nonuniformEXT(positionId)].data[vertexId_0 * kPositionStrip + 2];
-
-        p1.x = verticesArray[nonuniformEXT(positionId)].data[vertexId_1 * kPositionStrip + 0];
-        p1.y = verticesArray[nonuniformEXT(positionId)].data[vertexId_1 * kPositionStrip + 1];
-        p1.z = verticesArray[nonuniformEXT(positionId)].data[vertexId_1 * kPositionStrip + 2];
-
-        p2.x = verticesArray[nonuniformEXT(positionId)].data[vertexId_2 * kPositionStrip + 0];
-        p2.y = verticesArray[nonuniformEXT(positionId)].data[vertexId_2 * kPositionStrip + 1];
-        p2.z = verticesArray[nonuniformEXT(positionId)].data[vertexId_2 * kPositionStrip + 2];
+        const vec3 p0 = loadStaticMeshPosition(meshInfo, vertexId_0);
+        const vec3 p1 = loadStaticMeshPosition(meshInfo, vertexId_1);
+        const vec3 p2 = loadStaticMeshPosition(meshInfo, vertexId_2);
 
         position = p0 * barycentrics.x + p1 * barycentrics.y + p2 * barycentrics.z;
     }
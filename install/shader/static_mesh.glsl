@@ -17,11 +17,22 @@ layout (set = 0, binding = 0) uniform UniformFrameData{ PerFrameData frameData;
 layout (set = 0, binding = 1) readonly buffer SSBOPerObject { PerObjectInfo objectDatas[]; };
 layout (set = 0, binding = 2) buffer SSBOIndirectDraws { StaticMeshDrawCommand drawCommands[]; };
 layout (set = 0, binding = 3) buffer SSBODrawCount{ uint drawCount; };
+layout (set = 0, binding = 4) buffer SSBOMeshletCullObjects { uint meshletCullObjects[]; };
+layout (set = 0, binding = 5) buffer SSBOMeshletCullDispatch { uint meshletCullGroupCountX; uint meshletCullGroupCountY; uint meshletCullGroupCountZ; };
+
+#include "static_mesh_lod.glsl"
 
 layout (push_constant) uniform PushConsts 
 {
     // Total static mesh count need to cull.  
     uint cullCount; 
+
+    // Object with meshlets push to meshlet culling when enable.
+    uint bMeshletCull;
+
+    // LOD select by projected error, see static_mesh_lod.glsl.
+    float lodErrorPixels;
+    int lodBias;
 };
 
 layout(local_size_x = 64) in;
@@ -34,6 +45,13 @@ void main()
         return;
     }
 
+    // Meshlet culling one group per object, group count x accumulate when object visible.
+    if(idx == 0)
+    {
+        meshletCullGroupCountY = 1;
+        meshletCullGroupCountZ = 1;
+    }
+
     const PerObjectInfo objectData = objectDatas[idx];
     const MeshInfo meshInfo = objectData.meshInfoData;
 
@@ -69,14 +87,25 @@ void main()
 		}
 	}
 
+    // Prepass and gbuffer select LOD by same rule, so depth keep equal.
+    const uint lod = selectStaticMeshLod(meshInfo, objectData.modelMatrix, lodErrorPixels, lodBias);
+
+    // Object with meshlets draw by meshlet culling result, meshlets only build for LOD0.
+    if(bMeshletCull != 0 && meshInfo.meshletCount > 0 && lod == 0)
+    {
+        uint cullId = atomicAdd(meshletCullGroupCountX, 1);
+        meshletCullObjects[cullId] = idx;
+        return;
+    }
+
     // Build draw command if visible.
     {
         uint drawId = atomicAdd(drawCount, 1);
         drawCommands[drawId].objectId = idx;
 
         // We fetech vertex by index, so vertex count is index count.
-        drawCommands[drawId].vertexCount = meshInfo.indicesCount;
-        drawCommands[drawId].firstVertex = meshInfo.indexStartPosition;
+        drawCommands[drawId].vertexCount = meshInfo.lodIndicesCount[lod];
+        drawCommands[drawId].firstVertex = meshInfo.lodIndexStart[lod];
 
         // We fetch vertex in vertex shader, so instancing is unused when rendering.
         drawCommands[drawId].instanceCount = 1;
@@ -99,6 +128,7 @@ layout (set = 0, binding = 2) readonly buffer SSBOIndirectDraws { StaticMeshDraw
 
 layout (set = 1, binding = 0) readonly buffer BindlessSSBOVertices { float data[]; } verticesArray[];
 layout (set = 2, binding = 0) readonly buffer BindlessSSBOIndices { uint data[]; } indicesArray[];
+#include "static_mesh_vertex.glsl"
 layout (set = 3, binding = 0) uniform  texture2D texture2DBindlessArray[];
 layout (set = 4, binding = 0) uniform  sampler samplerArray[];
 
@@ -113,25 +143,14 @@ void main()
     outObjectId = drawCommands[gl_DrawID].objectId;
     const PerObjectInfo objectData = objectDatas[outObjectId];
 
-    // We get bindless array id first.
-    const uint indicesId  = objectData.meshInfoData.indicesArrayId;
-    const uint positionId = objectData.meshInfoData.positionsArrayId;
-    const uint uv0Id = objectData.meshInfoData.uv0sArrayId;
-
     // Vertex count same with index count, so vertex index same with index index.
     const uint indexId = gl_VertexIndex;
 
     // Then fetech vertex index from indices array.
-    const uint vertexId = indicesArray[nonuniformEXT(indicesId)].data[indexId];
+    const uint vertexId = loadStaticMeshIndex(objectData.meshInfoData, indexId);
 
-    vec3 position;
-    vec2 uv0;
-
-    position.x = verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionStrip + 0];
-    position.y = verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionStrip + 1];
-    position.z = verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionStrip + 2];
-    uv0.x = verticesArray[nonuniformEXT(uv0Id)].data[vertexId * kUv0Strip + 0];
-    uv0.y = verticesArray[nonuniformEXT(uv0Id)].data[vertexId * kUv0Strip + 1];
+    const vec3 position = loadStaticMeshPosition(objectData.meshInfoData, vertexId);
+    const vec2 uv0 = loadStaticMeshUv0(objectData.meshInfoData, vertexId);
 
     // Uv0 ready.
     vsOut.uv0 = uv0;
@@ -187,6 +206,10 @@ layout (set = 0, binding = 3) buffer SSBODrawCount{ uint drawCount; };
 layout (set = 0, binding = 4) uniform texture2D inHzbFurthest;
 layout (set = 0, binding = 5) buffer  SSBOLineVertexBuffers  { LineDrawVertex lineVertices[]; };
 layout (set = 0, binding = 6) buffer  SSBODrawCmdCountBuffer  { uint lineCount; };
+layout (set = 0, binding = 7) buffer SSBOMeshletCullObjects { uint meshletCullObjects[]; };
+layout (set = 0, binding = 8) buffer SSBOMeshletCullDispatch { uint meshletCullGroupCountX; uint meshletCullGroupCountY; uint meshletCullGroupCountZ; };
+
+#include "static_mesh_lod.glsl"
 
 layout (push_constant) uniform PushConsts 
 {
@@ -194,6 +217,13 @@ layout (push_constant) uniform PushConsts
     uint cullCount; 
     uint hzbMipCount;
     vec2 hzbSrcSize;
+
+    // Object with meshlets push to meshlet culling when enable.
+    uint bMeshletCull;
+
+    // LOD select by projected error, see static_mesh_lod.glsl.
+    float lodErrorPixels;
+    int lodBias;
 };
 
 layout(local_size_x = 64) in;
@@ -206,6 +236,13 @@ void main()
         return;
     }
 
+    // Meshlet culling one group per object, group count x accumulate when object visible.
+    if(idx == 0)
+    {
+        meshletCullGroupCountY = 1;
+        meshletCullGroupCountZ = 1;
+    }
+
     const PerObjectInfo objectData = objectDatas[idx];
     const MeshInfo meshInfo = objectData.meshInfoData;
 
@@ -338,14 +375,25 @@ void main()
     }
 #endif
 
+    // Prepass and gbuffer select LOD by same rule, so depth keep equal.
+    const uint lod = selectStaticMeshLod(meshInfo, objectData.modelMatrix, lodErrorPixels, lodBias);
+
+    // Object with meshlets draw by meshlet culling result, meshlets only build for LOD0.
+    if(bMeshletCull != 0 && meshInfo.meshletCount > 0 && lod == 0)
+    {
+        uint cullId = atomicAdd(meshletCullGroupCountX, 1);
+        meshletCullObjects[cullId] = idx;
+        return;
+    }
+
     // Build draw command if visible.
     {
         uint drawId = atomicAdd(drawCount, 1);
         drawCommands[drawId].objectId = idx;
 
         // We fetech vertex by index, so vertex count is index count.
-        drawCommands[drawId].vertexCount = meshInfo.indicesCount;
-        drawCommands[drawId].firstVertex = meshInfo.indexStartPosition;
+        drawCommands[drawId].vertexCount = meshInfo.lodIndicesCount[lod];
+        drawCommands[drawId].firstVertex = meshInfo.lodIndexStart[lod];
 
         // We fetch vertex in vertex shader, so instancing is unused when rendering.
         drawCommands[drawId].instanceCount = 1;
@@ -354,6 +402,193 @@ void main()
 
 #endif // STATIC_MESH_GBUFFER_CULL_PASS
 
+#if defined(STATIC_MESH_PREPASS_MESHLET_CULL_PASS) || defined(STATIC_MESH_GBUFFER_MESHLET_CULL_PASS)
+
+layout (set = 0, binding = 0) uniform UniformFrameData{ PerFrameData frameData; };
+layout (set = 0, binding = 1) readonly buffer SSBOPerObject { PerObjectInfo objectDatas[]; };
+layout (set = 0, binding = 2) buffer SSBOIndirectDraws { StaticMeshDrawCommand drawCommands[]; };
+layout (set = 0, binding = 3) buffer SSBODrawCount{ uint drawCount; };
+layout (set = 0, binding = 4) readonly buffer SSBOMeshletCullObjects { uint meshletCullObjects[]; };
+
+#ifdef STATIC_MESH_GBUFFER_MESHLET_CULL_PASS
+layout (set = 0, binding = 5) uniform texture2D inHzbFurthest;
+layout (set = 0, binding = 6) buffer SSBOMeshletCullStat { StaticMeshMeshletCullStat meshletCullStat; };
+#endif
+
+layout (set = 1, binding = 0) readonly buffer BindlessSSBOMeshlets { StaticMeshMeshlet data[]; } meshletsArray[];
+
+layout (push_constant) uniform PushConsts 
+{
+    // Backface cull by meshlet normal cone, static mesh pipelines are two side so it can be disabled.
+    uint bConeCull;
+    uint hzbMipCount;
+    vec2 hzbSrcSize;
+};
+
+#ifdef STATIC_MESH_GBUFFER_MESHLET_CULL_PASS
+
+// Stat of whole group, flush to global counter once.
+shared uint sharedMeshletVisible;
+shared uint sharedTriangleVisible;
+shared uint sharedTriangleFrustumCulled;
+shared uint sharedTriangleConeCulled;
+shared uint sharedTriangleOcclusionCulled;
+
+// Same as object hzb culling, test local aabb.
+bool isOccludedByHzb(vec3 localPos, vec3 extent, in const mat4 mvp)
+{
+    const vec3 uvZ0 = projectPos(localPos + extent * vec3( 1.0,  1.0,  1.0), mvp);
+    const vec3 uvZ1 = projectPos(localPos + extent * vec3(-1.0,  1.0,  1.0), mvp);
+    const vec3 uvZ2 = projectPos(localPos + extent * vec3( 1.0, -1.0,  1.0), mvp);
+    const vec3 uvZ3 = projectPos(localPos + extent * vec3( 1.0,  1.0, -1.0), mvp);
+    const vec3 uvZ4 = projectPos(localPos + extent * vec3(-1.0, -1.0,  1.0), mvp);
+    const vec3 uvZ5 = projectPos(localPos + extent * vec3( 1.0, -1.0, -1.0), mvp);
+    const vec3 uvZ6 = projectPos(localPos + extent * vec3(-1.0,  1.0, -1.0), mvp);
+    const vec3 uvZ7 = projectPos(localPos + extent * vec3(-1.0, -1.0, -1.0), mvp);
+
+    vec3 maxUvz = max(max(max(max(max(max(max(uvZ0, uvZ1), uvZ2), uvZ3), uvZ4), uvZ5), uvZ6), uvZ7);
+    vec3 minUvz = min(min(min(min(min(min(min(uvZ0, uvZ1), uvZ2), uvZ3), uvZ4), uvZ5), uvZ6), uvZ7);
+
+    if(maxUvz.z < 1.0f && minUvz.z > 0.0f)
+    {
+        const vec2 bounds = maxUvz.xy - minUvz.xy;
+
+        const float edge = max(1.0, max(bounds.x, bounds.y) * max(hzbSrcSize.x, hzbSrcSize.y));
+        int mipLevel = int(min(ceil(log2(edge)), hzbMipCount - 1));
+
+        const vec2 mipSize = vec2(textureSize(inHzbFurthest, mipLevel));
+        const ivec2 samplePosMax = ivec2(saturate(maxUvz.xy) * mipSize);
+        const ivec2 samplePosMin = ivec2(saturate(minUvz.xy) * mipSize);
+
+        vec4 occ = vec4(
+            texelFetch(inHzbFurthest, samplePosMax.xy, mipLevel).x, 
+            texelFetch(inHzbFurthest, samplePosMin.xy, mipLevel).x, 
+            texelFetch(inHzbFurthest, ivec2(samplePosMax.x, samplePosMin.y), mipLevel).x, 
+            texelFetch(inHzbFurthest, ivec2(samplePosMin.x, samplePosMax.y), mipLevel).x);
+
+        float occDepth = min(occ.w, min(occ.z, min(occ.x, occ.y)));
+        return occDepth > maxUvz.z;
+    }
+
+    return false;
+}
+
+#endif // STATIC_MESH_GBUFFER_MESHLET_CULL_PASS
+
+// One group per visible object, loop all meshlets of object.
+layout(local_size_x = 64) in;
+void main()
+{
+    const uint objectId = meshletCullObjects[gl_WorkGroupID.x];
+    const PerObjectInfo objectData = objectDatas[objectId];
+    const MeshInfo meshInfo = objectData.meshInfoData;
+    const mat4 modelMatrix = objectData.modelMatrix;
+
+#ifdef STATIC_MESH_GBUFFER_MESHLET_CULL_PASS
+    if(gl_LocalInvocationIndex == 0)
+    {
+        sharedMeshletVisible = 0;
+        sharedTriangleVisible = 0;
+        sharedTriangleFrustumCulled = 0;
+        sharedTriangleConeCulled = 0;
+        sharedTriangleOcclusionCulled = 0;
+    }
+    barrier();
+
+    const mat4 mvp = frameData.camViewProj * modelMatrix;
+#endif
+
+    // Sphere radius scale by max axis scale.
+    const vec3 axisScale = vec3(length(modelMatrix[0].xyz), length(modelMatrix[1].xyz), length(modelMatrix[2].xyz));
+    const float maxScale = max(axisScale.x, max(axisScale.y, axisScale.z));
+    const float minScale = min(axisScale.x, min(axisScale.y, axisScale.z));
+
+    // Normal cone angle only keep when uniform scale.
+    const bool bConeCullValid = (bConeCull != 0) && (maxScale - minScale <= maxScale * 1e-3f);
+
+    for(uint i = gl_LocalInvocationIndex; i < meshInfo.meshletCount; i += gl_WorkGroupSize.x)
+    {
+        const StaticMeshMeshlet meshlet = meshletsArray[nonuniformEXT(meshInfo.meshletsArrayId)].data[meshInfo.meshletStart + i];
+
+        // Frustum culling test.
+        const vec3 worldCenter = (modelMatrix * vec4(meshlet.sphereBounds.xyz, 1.0)).xyz;
+        const float worldRadius = meshlet.sphereBounds.w * maxScale;
+
+        bool bVisible = true;
+        for(int p = 0; p < 6; p++)
+        {
+            if(dot(worldCenter, frameData.frustumPlanes[p].xyz) + frameData.frustumPlanes[p].w < -worldRadius)
+            {
+                bVisible = false;
+                break;
+            }
+        }
+
+#ifdef STATIC_MESH_GBUFFER_MESHLET_CULL_PASS
+        if(!bVisible)
+        {
+            atomicAdd(sharedTriangleFrustumCulled, meshlet.triangleCount);
+        }
+#endif
+
+        // Backface cone culling test, cutoff 1.0 is degenerate cone.
+        if(bVisible && bConeCullValid && meshlet.coneAxisCutoff.w < 1.0)
+        {
+            const vec3 worldApex = (modelMatrix * vec4(meshlet.coneApex, 1.0)).xyz;
+            const vec3 worldAxis = normalize(mat3(modelMatrix) * meshlet.coneAxisCutoff.xyz);
+
+            if(dot(normalize(worldApex - frameData.camWorldPos.xyz), worldAxis) >= meshlet.coneAxisCutoff.w)
+            {
+                bVisible = false;
+            #ifdef STATIC_MESH_GBUFFER_MESHLET_CULL_PASS
+                atomicAdd(sharedTriangleConeCulled, meshlet.triangleCount);
+            #endif
+            }
+        }
+
+#ifdef STATIC_MESH_GBUFFER_MESHLET_CULL_PASS
+        // Hzb culling test.
+        if(bVisible && isOccludedByHzb(meshlet.sphereBounds.xyz, vec3(meshlet.sphereBounds.w), mvp))
+        {
+            bVisible = false;
+            atomicAdd(sharedTriangleOcclusionCulled, meshlet.triangleCount);
+        }
+#endif
+
+        // Build draw command of meshlet index range if visible.
+        if(bVisible)
+        {
+            uint drawId = atomicAdd(drawCount, 1);
+            drawCommands[drawId].objectId = objectId;
+
+            drawCommands[drawId].vertexCount = meshlet.triangleCount * 3;
+            drawCommands[drawId].firstVertex = meshlet.indicesStart;
+            drawCommands[drawId].instanceCount = 1;
+
+        #ifdef STATIC_MESH_GBUFFER_MESHLET_CULL_PASS
+            atomicAdd(sharedMeshletVisible, 1);
+            atomicAdd(sharedTriangleVisible, meshlet.triangleCount);
+        #endif
+        }
+    }
+
+#ifdef STATIC_MESH_GBUFFER_MESHLET_CULL_PASS
+    barrier();
+    if(gl_LocalInvocationIndex == 0)
+    {
+        atomicAdd(meshletCullStat.meshletTotal, meshInfo.meshletCount);
+        atomicAdd(meshletCullStat.meshletVisible, sharedMeshletVisible);
+        atomicAdd(meshletCullStat.triangleTotal, meshInfo.indicesCount / 3);
+        atomicAdd(meshletCullStat.triangleVisible, sharedTriangleVisible);
+        atomicAdd(meshletCullStat.triangleFrustumCulled, sharedTriangleFrustumCulled);
+        atomicAdd(meshletCullStat.triangleConeCulled, sharedTriangleConeCulled);
+        atomicAdd(meshletCullStat.triangleOcclusionCulled, sharedTriangleOcclusionCulled);
+    }
+#endif
+}
+
+#endif // STATIC_MESH_PREPASS_MESHLET_CULL_PASS || STATIC_MESH_GBUFFER_MESHLET_CULL_PASS
+
 #ifdef STATIC_MESH_GBUFFER_PASS
 
 // Attributes need lerp.
@@ -371,9 +606,11 @@ struct VS2PS
 layout (set = 0, binding = 0) uniform UniformFrameData { PerFrameData frameData; };
 layout (set = 0, binding = 1) readonly buffer SSBOPerObject { PerObjectInfo objectDatas[]; };
 layout (set = 0, binding = 2) readonly buffer SSBOIndirectDraws { StaticMeshDrawCommand drawCommands[]; };
+layout (set = 0, binding = 3) buffer SSBOTextureStreamingFeedback { uint textureStreamingFeedback[]; };
 
 layout (set = 1, binding = 0) readonly buffer BindlessSSBOVertices { float data[]; } verticesArray[];
 layout (set = 2, binding = 0) readonly buffer BindlessSSBOIndices { uint data[]; } indicesArray[];
+#include "static_mesh_vertex.glsl"
 layout (set = 3, binding = 0) uniform  texture2D texture2DBindlessArray[];
 layout (set = 4, binding = 0) uniform  sampler samplerArray[];
 
@@ -388,43 +625,20 @@ void main()
     outObjectId = drawCommands[gl_DrawID].objectId;
     const PerObjectInfo objectData = objectDatas[outObjectId];
 
-    // We get bindless array id first.
-    const uint indicesId  = objectData.meshInfoData.indicesArrayId;
-    const uint positionId = objectData.meshInfoData.positionsArrayId;
-    const uint tangentId = objectData.meshInfoData.tangentsArrayId;
-    const uint normalId = objectData.meshInfoData.normalsArrayId;
-    const uint uv0Id = objectData.meshInfoData.uv0sArrayId;
-
     // Vertex count same with index count, so vertex index same with index index.
     const uint indexId = gl_VertexIndex;
 
     // Then fetech vertex index from indices array.
-    const uint vertexId = indicesArray[nonuniformEXT(indicesId)].data[indexId];
+    const uint vertexId = loadStaticMeshIndex(objectData.meshInfoData, indexId);
 
     // Now we can get triangle id easily.
     const uint triangleId = vertexId / 3;
 
-    // Finally we get vertex info.
-    vec3 position;
-    vec4 tangent;
-    vec2 uv0;
-    vec3 normal;
-
-    position.x = verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionStrip + 0];
-    position.y = verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionStrip + 1];
-    position.z = verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionStrip + 2];
-
-    tangent.x = verticesArray[nonuniformEXT(tangentId)].data[vertexId * kTangentStrip + 0];
-    tangent.y = verticesArray[nonuniformEXT(tangentId)].data[vertexId * kTangentStrip + 1];
-    tangent.z = verticesArray[nonuniformEXT(tangentId)].data[vertexId * kTangentStrip + 2];
-    tangent.w = verticesArray[nonuniformEXT(tangentId)].data[vertexId * kTangentStrip + 3];
-
-    normal.x = verticesArray[nonuniformEXT(normalId)].data[vertexId * kNormalStrip + 0];
-    normal.y = verticesArray[nonuniformEXT(normalId)].data[vertexId * kNormalStrip + 1];
-    normal.z = verticesArray[nonuniformEXT(normalId)].data[vertexId * kNormalStrip + 2];
-
-    uv0.x = verticesArray[nonuniformEXT(uv0Id)].data[vertexId * kUv0Strip + 0];
-    uv0.y = verticesArray[nonuniformEXT(uv0Id)].data[vertexId * kUv0Strip + 1];
+    // Finally we get vertex info, compact vertex format decode here.
+    const vec3 position = loadStaticMeshPosition(objectData.meshInfoData, vertexId);
+    const vec4 tangent  = loadStaticMeshTangent(objectData.meshInfoData, vertexId);
+    const vec2 uv0      = loadStaticMeshUv0(objectData.meshInfoData, vertexId);
+    const vec3 normal   = loadStaticMeshNormal(objectData.meshInfoData, vertexId);
 
     // Uv0 ready.
     vsOut.uv0 = uv0;
@@ -468,8 +682,20 @@ void main()
 
 #ifdef PIXEL_SHADER ////////////// pixel shader start 
 
+// Only one pixel of 8x8 tile write texture streaming feedback each frame, rotate by frame index.
+bool bWriteStreamingFeedback = false;
+
 vec4 tex(uint texId,uint samplerId,vec2 uv)
 {
+    // Lod relative to sampled image mip 0, resident first mip add on CPU.
+    // Query in uniform control flow, implicit derivatives undefined inside per pixel branch.
+    const float lod = textureQueryLod(sampler2D(texture2DBindlessArray[nonuniformEXT(texId)], samplerArray[nonuniformEXT(samplerId)]), uv).y;
+    if (bWriteStreamingFeedback)
+    {
+        const float feedbackLod = clamp(floor(lod + frameData.basicTextureLODBias) + float(kTextureStreamingFeedbackLodOffset), 0.0, 255.0);
+        atomicMin(textureStreamingFeedback[texId], uint(feedbackLod));
+    }
+
     return texture(sampler2D(texture2DBindlessArray[nonuniformEXT(texId)], samplerArray[nonuniformEXT(samplerId)]), uv, frameData.basicTextureLODBias);
 }
 
@@ -511,6 +737,14 @@ void main()
     const PerObjectInfo objectData = objectDatas[inObjectId];
     const BSDFMaterialInfo material = objectData.materialInfoData;
 
+    // Reflection capture view no need texture detail.
+    {
+        const uvec2 tilePos = uvec2(gl_FragCoord.xy) % 8;
+        bWriteStreamingFeedback = 
+            (frameData.renderType == ERendererType_Viewport) && 
+            (tilePos.x + tilePos.y * 8 == frameData.frameIndex.x % 64);
+    }
+
     // Load base color and cut off alpha.
     vec4 baseColor = tex(material.baseColorId, material.baseColorSampler, vsIn.uv0);
     baseColor = baseColor * material.baseColorMul + material.baseColorAdd;
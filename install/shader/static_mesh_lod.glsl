@@ -0,0 +1,39 @@
+#ifndef STATIC_MESH_LOD_GLSL
+#define STATIC_MESH_LOD_GLSL
+
+// Static mesh LOD selection of culling passes, include after frameData declared.
+// LOD error is simplify error in mesh local unit, see StaticMeshLod in asset_common.h.
+
+// Select coarsest LOD whose projected error no bigger than lodErrorPixels, then offset by lodBias.
+// Selection only depend on main camera, so all passes which share same bias pick same LOD.
+uint selectStaticMeshLod(in const MeshInfo meshInfo, in const mat4 modelMatrix, float lodErrorPixels, int lodBias)
+{
+    if (meshInfo.lodCount <= 1)
+    {
+        return 0;
+    }
+
+    const float scale = max(length(modelMatrix[0].xyz), max(length(modelMatrix[1].xyz), length(modelMatrix[2].xyz)));
+    const vec3 worldCenter = (modelMatrix * vec4(meshInfo.sphereBounds.xyz, 1.0)).xyz;
+
+    // Nearest distance to bounds sphere, clamp to near plane when camera inside.
+    const float distance = max(length(frameData.camWorldPos.xyz - worldCenter) - meshInfo.sphereBounds.w * scale, frameData.camInfo.z);
+
+    // Error of one world unit at distance one in pixels.
+    const float pixelScale = frameData.renderHeight * 0.5 / tan(frameData.camInfo.x * 0.5);
+    const float errorScale = scale * pixelScale / distance;
+
+    uint lod = 0;
+    for (uint i = 1; i < meshInfo.lodCount; i++)
+    {
+        if (meshInfo.lodError[i] * errorScale > lodErrorPixels)
+        {
+            break;
+        }
+        lod = i;
+    }
+
+    return uint(clamp(int(lod) + lodBias, 0, int(meshInfo.lodCount) - 1));
+}
+
+#endif // STATIC_MESH_LOD_GLSL
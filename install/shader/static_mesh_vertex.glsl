@@ -0,0 +1,107 @@
+#ifndef STATIC_MESH_VERTEX_GLSL
+#define STATIC_MESH_VERTEX_GLSL
+
+// Static mesh vertex fetch from bindless vertices and indices array, handle float and compact vertex format,
+// 16 bit and 32 bit submesh indices. Include after bindless verticesArray and indicesArray declared.
+// Compact vertex layout see VertexPositionCompact in asset_common.h.
+
+// Index id is logical index position, same as draw vertex index, return absolute vertex id.
+uint loadStaticMeshIndex(in const MeshInfo meshInfo, uint indexId)
+{
+    const uint indicesId = meshInfo.indicesArrayId;
+    const uint localId = indexId - meshInfo.indexStartPosition;
+
+    uint index;
+    if (meshInfo.indexFormat == EIndexFormat_Uint16)
+    {
+        const uint word = indicesArray[nonuniformEXT(indicesId)].data[meshInfo.indexWordStart + localId / 2];
+        index = (word >> ((localId & 1u) * 16u)) & 0xFFFFu;
+    }
+    else
+    {
+        index = indicesArray[nonuniformEXT(indicesId)].data[meshInfo.indexWordStart + localId];
+    }
+
+    return meshInfo.vertexStart + index;
+}
+
+vec3 decodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+    const float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+vec3 loadStaticMeshPosition(in const MeshInfo meshInfo, uint vertexId)
+{
+    const uint positionId = meshInfo.positionsArrayId;
+    if (meshInfo.vertexFormat == EVertexFormat_Compact)
+    {
+        const uint xy = floatBitsToUint(verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionCompactStrip + 0]);
+        const uint zw = floatBitsToUint(verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionCompactStrip + 1]);
+
+        // Snorm relative to submesh bounds.
+        const vec3 snorm = vec3(unpackSnorm2x16(xy), unpackSnorm2x16(zw).x);
+        return meshInfo.sphereBounds.xyz + meshInfo.extents * snorm;
+    }
+
+    vec3 position;
+    position.x = verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionStrip + 0];
+    position.y = verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionStrip + 1];
+    position.z = verticesArray[nonuniformEXT(positionId)].data[vertexId * kPositionStrip + 2];
+    return position;
+}
+
+vec3 loadStaticMeshNormal(in const MeshInfo meshInfo, uint vertexId)
+{
+    const uint normalId = meshInfo.normalsArrayId;
+    if (meshInfo.vertexFormat == EVertexFormat_Compact)
+    {
+        const uint n = floatBitsToUint(verticesArray[nonuniformEXT(normalId)].data[vertexId * kNormalCompactStrip]);
+        return decodeOctahedral(unpackSnorm2x16(n));
+    }
+
+    vec3 normal;
+    normal.x = verticesArray[nonuniformEXT(normalId)].data[vertexId * kNormalStrip + 0];
+    normal.y = verticesArray[nonuniformEXT(normalId)].data[vertexId * kNormalStrip + 1];
+    normal.z = verticesArray[nonuniformEXT(normalId)].data[vertexId * kNormalStrip + 2];
+    return normal;
+}
+
+vec4 loadStaticMeshTangent(in const MeshInfo meshInfo, uint vertexId)
+{
+    const uint tangentId = meshInfo.tangentsArrayId;
+    if (meshInfo.vertexFormat == EVertexFormat_Compact)
+    {
+        const uint t = floatBitsToUint(verticesArray[nonuniformEXT(tangentId)].data[vertexId * kTangentCompactStrip]);
+
+        // Octahedral unorm15x2, bit 31 is bitangent sign.
+        const vec2 e = vec2(t & 0x7FFFu, (t >> 15) & 0x7FFFu) / 32767.0 * 2.0 - 1.0;
+        return vec4(decodeOctahedral(e), (t & 0x80000000u) != 0 ? -1.0 : 1.0);
+    }
+
+    vec4 tangent;
+    tangent.x = verticesArray[nonuniformEXT(tangentId)].data[vertexId * kTangentStrip + 0];
+    tangent.y = verticesArray[nonuniformEXT(tangentId)].data[vertexId * kTangentStrip + 1];
+    tangent.z = verticesArray[nonuniformEXT(tangentId)].data[vertexId * kTangentStrip + 2];
+    tangent.w = verticesArray[nonuniformEXT(tangentId)].data[vertexId * kTangentStrip + 3];
+    return tangent;
+}
+
+vec2 loadStaticMeshUv0(in const MeshInfo meshInfo, uint vertexId)
+{
+    const uint uv0Id = meshInfo.uv0sArrayId;
+    if (meshInfo.vertexFormat == EVertexFormat_Compact)
+    {
+        return unpackHalf2x16(floatBitsToUint(verticesArray[nonuniformEXT(uv0Id)].data[vertexId * kUv0CompactStrip]));
+    }
+
+    vec2 uv0;
+    uv0.x = verticesArray[nonuniformEXT(uv0Id)].data[vertexId * kUv0Strip + 0];
+    uv0.y = verticesArray[nonuniformEXT(uv0Id)].data[vertexId * kUv0Strip + 1];
+    return uv0;
+}
+
+#endif
@@ -14,6 +14,8 @@
 #include "builtin_resources.h"
 #include "widgets/viewport.h"
 #include <asset/asset_manager.h>
+#include <asset/asset_cook.h>
+#include <asset/asset_pack.h>
 #include <ui/imgui/imgui_impl_vulkan.h>
 #include <profile/profile.h>
 
@@ -85,6 +87,18 @@ int Editor::run(int argc, char** argv)
     // Init cvar configs.
     initBasicCVarConfigs();
 
+    // Headless asset cook, no window and editor init.
+    if (isAssetCookCommandLine(argc, argv))
+    {
+        return runAssetCookCommandLine(argc, argv);
+    }
+
+    // Headless project pack.
+    if (isAssetPackCommandLine(argc, argv))
+    {
+        return runAssetPackCommandLine(argc, argv);
+    }
+
     // Install engine hook.
     Engine::get()->initGLFWWindowsHook(m_windows);
 
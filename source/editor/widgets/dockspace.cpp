@@ -400,7 +400,7 @@ void ContentAssetImportWidget::onDrawState()
                 });
             }
 
-            CHECK(m_executeFutures.futures.empty());
+            CHECK(m_importGraph == nullptr);
             {
                 auto type = rttr::type::get_by_name(typeName);
 
@@ -408,16 +408,12 @@ void ContentAssetImportWidget::onDrawState()
                 rttr::variant returnValue = method.invoke({});
                 const auto& meta = returnValue.get_value<AssetReflectionInfo>();
 
-                CHECK(meta.importConfig.importAssetFromConfigThreadSafe);
-
-                const auto loop = [this, meta](const size_t loopStart, const size_t loopEnd)
+                m_importGraph = std::make_unique<ImportJobGraph>();
+                for (auto& ptr : importConfigs)
                 {
-                    for (size_t i = loopStart; i < loopEnd; ++i)
-                    {
-                        meta.importConfig.importAssetFromConfigThreadSafe(importConfigs[i]);
-                    }
-                };
-                m_executeFutures = Engine::get()->getThreadPool()->parallelizeLoop(0, importConfigs.size(), loop);
+                    buildAssetImportJobs(meta, ptr, *m_importGraph);
+                }
+                m_importGraph->execute();
             }
         }
     }
@@ -442,16 +438,43 @@ void ContentAssetImportWidget::onDrawState()
 
 void ContentAssetImportWidget::onDrawImporting()
 {
-    CHECK(!m_executeFutures.futures.empty());
+    CHECK(m_importGraph != nullptr);
     CHECK(m_bImporting);
 
     ImGui::Indent();
-    ImGui::Text("Asset  Importing ...    ");
+    ImGui::Text(m_importGraph->isCancelled() ? "Asset  Cancelling ...  " : "Asset  Importing ...    ");
     ImGui::SameLine();
 
-    float progress = m_executeFutures.getProgress();
+    float progress = m_importGraph->getProgress();
     ImGui::ProgressBar(progress, ImVec2(0.0f, 0.0f));
 
+    // Per stage job count, stage without job hide.
+    for (size_t i = 0; i < size_t(EImportJobStage::Max); i++)
+    {
+        const auto stage = EImportJobStage(i);
+        const auto stageProgress = m_importGraph->getStageProgress(stage);
+        if (stageProgress.total == 0)
+        {
+            continue;
+        }
+
+        ImGui::TextDisabled("%-10s %u / %u finished, %u running.", 
+            ImportJobGraph::getStageName(stage), stageProgress.finished, stageProgress.total, stageProgress.running);
+    }
+
+    if (const uint32_t failedCount = m_importGraph->getFailedCount(); failedCount > 0)
+    {
+        ImGui::TextColored(ImVec4(1.0f, 0.08f, 0.08f, 1.0f), "%u jobs fail.", failedCount);
+    }
+
+    ImGui::BeginDisabled(m_importGraph->isCancelled());
+    if (ImGui::Button("Cancel", ImVec2(120, 0)))
+    {
+        // Running jobs keep going, wait them finish.
+        m_importGraph->cancel();
+    }
+    ImGui::EndDisabled();
+
     ImGui::Unindent();
     ImGui::Separator();
 
@@ -481,13 +504,13 @@ void ContentAssetImportWidget::onDrawImporting()
     ImGui::EndDisabled();
 
     bool bAccept = false;
-    if (progress > 0.99f)
+    if (m_importGraph->isFinished())
     {
-        m_executeFutures.wait();
+        m_importGraph->wait();
 
         // Clean state.
         m_bImporting = false;
-        m_executeFutures = {};
+        m_importGraph = nullptr;
         if (m_importProgress.logHandle.isValid())
         {
             LoggerSystem::get()->popCallback(m_importProgress.logHandle);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../editor.h"
+#include <asset/import_job_graph.h>
 
 struct WidgetInView
 {
@@ -60,8 +61,8 @@ protected:
 		std::deque<std::pair<engine::ELogType,std::string>> logItems{ };
 	} m_importProgress{ };
 
-	// Import execut futures.
-	engine::FutureCollection<void> m_executeFutures = {};
+	// Import jobs of all configs, shared worker pool and progress.
+	std::unique_ptr<engine::ImportJobGraph> m_importGraph = nullptr;
 
 	// The assets is importing?
 	bool m_bImporting = false;
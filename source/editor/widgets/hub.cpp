@@ -26,6 +26,18 @@ void HubWidget::onTick(const engine::RuntimeModuleTickData& tickData, engine::Vu
 {
 	ZoneScoped;
 
+	// Project setup in flight, only draw progress until finish.
+	if (m_setupProjectFuture.valid())
+	{
+		drawSetupProgress();
+		if (m_setupProjectFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+		{
+			m_setupProjectFuture.get();
+			onSetupEditorProjectFinish();
+		}
+		return;
+	}
+
 	bool bProjectSelectReady = false;
 	std::u16string projectPath;
 
@@ -205,7 +217,52 @@ bool HubWidget::createOrOpenProject(const std::filesystem::path& projectPath)
 void HubWidget::setupEditorProject(const std::filesystem::path& path)
 {
     ZoneScoped;
-	getAssetManager()->setupProject(path.u16string());
+
+	m_setupFinishedCount = 0;
+	m_setupTotalCount = 0;
+	m_setupProgressHandle = getAssetManager()->onProjectSetupProgress.addLambda([this](size_t finished, size_t total)
+	{
+		m_setupFinishedCount = finished;
+		m_setupTotalCount = total;
+	});
+
+	// Setup on a standalone thread, it will dispatch work to engine thread pool and wait.
+	m_setupProjectFuture = std::async(std::launch::async, [path]()
+	{
+		getAssetManager()->setupProject(path.u16string());
+	});
+}
+
+void HubWidget::drawSetupProgress()
+{
+	ImGui::DockSpaceOverViewport();
+
+	const ImGuiViewport* viewport = ImGui::GetMainViewport();
+	ImGui::SetNextWindowPos(viewport->WorkPos);
+	ImGui::SetNextWindowSize(viewport->WorkSize);
+
+	ImGui::Begin("ProjectSetupWindow", nullptr, 
+		ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoSavedSettings);
+	{
+		const size_t finished = m_setupFinishedCount;
+		const size_t total = m_setupTotalCount;
+
+		ImGui::Indent();
+		ImGui::Spacing();
+		ImGui::TextDisabled("Loading project assets ...");
+		ImGui::Spacing();
+
+		const float progress = total > 0 ? float(finished) / float(total) : 0.0f;
+		ImGui::ProgressBar(progress, ImVec2(-ImGui::GetFontSize(), 0.0f), std::format("{0} / {1}", finished, total).c_str());
+		ImGui::Unindent();
+	}
+	ImGui::End();
+}
+
+void HubWidget::onSetupEditorProjectFinish()
+{
+	getAssetManager()->onProjectSetupProgress.remove(m_setupProgressHandle);
+
 	const auto& projectConfig = getAssetManager()->getProjectConfig();
 
 	LOG_TRACE("Start editor with project {}.", utf8::utf16to8(projectConfig.projectName));
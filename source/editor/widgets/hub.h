@@ -4,6 +4,7 @@
 #include <graphics/graphics.h>
 
 #include <filesystem>
+#include <future>
 
 class Editor;
 
@@ -34,8 +35,8 @@ protected:
 	bool newProject();
 	bool createOrOpenProject(const std::filesystem::path& path);
 	void setupEditorProject(const std::filesystem::path& path);
-
-
+	void onSetupEditorProjectFinish();
+	void drawSetupProgress();
 
 protected:
 	// Is project path ready.
@@ -47,4 +48,10 @@ protected:
 
 	// Recent project lists.
 	RecentOpenProjects m_recentProjectList;
+
+	// Project setup run async, hub draw progress when setup.
+	std::future<void> m_setupProjectFuture;
+	engine::DelegateHandle m_setupProgressHandle;
+	std::atomic<size_t> m_setupFinishedCount = 0;
+	std::atomic<size_t> m_setupTotalCount = 0;
 };
\ No newline at end of file
@@ -12,6 +12,9 @@ const static std::string kIconViewport = ICON_FA_EARTH_ASIA;
 
 static AutoCVarInt32 cVarEnableStatUnit("stat.unit", "Enable stat unit frame.", "stat", 1, CVarFlags::ReadAndWrite);
 static AutoCVarInt32 cVarEnableStatFrameGraph("stat.frameGraph", "Enable stat frame graph.", "stat", 1, CVarFlags::ReadAndWrite);
+static AutoCVarInt32 cVarEnableStatTextureStreaming("stat.textureStreaming", "Enable stat texture streaming.", "stat", 0, CVarFlags::ReadAndWrite);
+static AutoCVarInt32 cVarEnableStatAssetCache("stat.assetCache", "Enable stat gpu asset lru cache.", "stat", 0, CVarFlags::ReadAndWrite);
+static AutoCVarInt32 cVarEnableStatMemoryBudget("stat.memoryBudget", "Enable stat gpu memory budget.", "stat", 0, CVarFlags::ReadAndWrite);
 
 
 
@@ -169,6 +172,110 @@ void ViewportWidget::drawProfileViewer(uint32_t width, uint32_t height)
 		ImGui::SetCursorPos(srcPos);
 		frameGraphView();
 	}
+
+	if (cVarEnableStatTextureStreaming.get() > 0)
+	{
+		const auto& stats = getContext()->getTextureStreaming().getStats();
+		const auto toMB = [](VkDeviceSize size) { return double(size) / (1024.0 * 1024.0); };
+
+		auto textureStreamingView = [&]()
+		{
+			ui::beginGroupPanel("Texture Streaming");
+			{
+				ImGui::Text("Budget : %.1f MB", toMB(stats.budgetSize));
+				ImGui::Text("Resident : %.1f MB", toMB(stats.residentSize));
+				ImGui::Text("Wanted : %.1f MB", toMB(stats.wantedSize));
+				ImGui::Text("Textures : %u (%u full resident)", stats.textureCount, stats.fullyResidentCount);
+				ImGui::Text("Pending : %u", stats.pendingCount);
+			}
+			ImGui::Spacing();
+			ui::endGroupPanel();
+		};
+
+		const auto srcPos = ImGui::GetCursorPos();
+		ImGui::PushStyleVar(ImGuiStyleVar_Alpha, 0.0f);
+		ImGui::BeginDisabled();
+		textureStreamingView();
+		ImGui::EndDisabled();
+		ImGui::PopStyleVar();
+		ImGui::GetWindowDrawList()->AddRectFilled(ImGui::GetItemRectMin(), ImGui::GetItemRectMax(), IM_COL32(0, 0, 0, 139), 2.0f);
+		ImGui::SetCursorPos(srcPos);
+		textureStreamingView();
+	}
+
+	if (cVarEnableStatAssetCache.get() > 0)
+	{
+		const auto stats = getContext()->getLRU()->getStats();
+		const auto toMB = [](uint64_t size) { return double(size) / (1024.0 * 1024.0); };
+		const uint64_t lookupCount = stats.hitCount + stats.weakHitCount + stats.missCount;
+
+		auto assetCacheView = [&]()
+		{
+			ui::beginGroupPanel("Asset Cache");
+			{
+				ImGui::Text("Used : %.1f / %.1f MB", toMB(stats.usedSize), toMB(getContext()->getLRU()->getCapacity()));
+				ImGui::Text("Assets : %u (%u weak)", stats.ownerCount, stats.weakCount);
+				ImGui::Text("Hits : %llu (%llu weak)", stats.hitCount, stats.weakHitCount);
+				ImGui::Text("Misses : %llu", stats.missCount);
+				ImGui::Text("Hit rate : %.1f %%", lookupCount > 0 ? 100.0 * double(stats.hitCount + stats.weakHitCount) / double(lookupCount) : 0.0);
+				ImGui::Text("Evictions : %llu (%.1f MB)", stats.evictionCount, toMB(stats.evictedSize));
+			}
+			ImGui::Spacing();
+			ui::endGroupPanel();
+		};
+
+		const auto srcPos = ImGui::GetCursorPos();
+		ImGui::PushStyleVar(ImGuiStyleVar_Alpha, 0.0f);
+		ImGui::BeginDisabled();
+		assetCacheView();
+		ImGui::EndDisabled();
+		ImGui::PopStyleVar();
+		ImGui::GetWindowDrawList()->AddRectFilled(ImGui::GetItemRectMin(), ImGui::GetItemRectMax(), IM_COL32(0, 0, 0, 139), 2.0f);
+		ImGui::SetCursorPos(srcPos);
+		assetCacheView();
+	}
+
+	if (cVarEnableStatMemoryBudget.get() > 0)
+	{
+		const auto& memoryBudget = getContext()->getMemoryBudget();
+		const auto& stats = memoryBudget.getStats();
+		const auto toMB = [](VkDeviceSize size) { return double(size) / (1024.0 * 1024.0); };
+
+		auto memoryBudgetView = [&]()
+		{
+			ui::beginGroupPanel("GPU Memory");
+			{
+				ImGui::Text("Device local : %.1f / %.1f MB (target %.1f MB)", toMB(stats.deviceLocalUsage), toMB(stats.deviceLocalBudget), toMB(stats.targetUsage));
+				ImGui::Text("Render targets : %.1f MB", toMB(stats.renderTargetSize));
+				ImGui::Text("Buffer parameters : %.1f MB", toMB(stats.bufferParameterSize));
+				ImGui::Text("FSR2 : %.1f MB", toMB(stats.fsr2Size));
+				ImGui::Text("Asset cache : %.1f MB", toMB(stats.lruCacheSize));
+				ImGui::Text("Evictions : %llu (%.1f MB)", stats.evictionCount, toMB(stats.evictedSize));
+
+				for (uint32_t i = 0; i < stats.heapCount; i++)
+				{
+					const auto& heap = stats.heaps[i];
+					const std::string label = std::format("Heap {}{}", i, heap.bDeviceLocal ? " (device local)" : "");
+					const std::string overlay = std::format("{:.1f} / {:.1f} MB, vma {:.1f} MB", toMB(heap.usage), toMB(heap.budget), toMB(heap.vmaAllocationSize));
+
+					ImGui::PlotLines(label.c_str(), memoryBudget.getUsageHistory(i), GPUMemoryBudget::kHistoryCount, memoryBudget.getHistoryOffset(),
+						overlay.c_str(), 0.0f, float(toMB(heap.budget)), ImVec2(0.0f, 40.0f));
+				}
+			}
+			ImGui::Spacing();
+			ui::endGroupPanel();
+		};
+
+		const auto srcPos = ImGui::GetCursorPos();
+		ImGui::PushStyleVar(ImGuiStyleVar_Alpha, 0.0f);
+		ImGui::BeginDisabled();
+		memoryBudgetView();
+		ImGui::EndDisabled();
+		ImGui::PopStyleVar();
+		ImGui::GetWindowDrawList()->AddRectFilled(ImGui::GetItemRectMin(), ImGui::GetItemRectMax(), IM_COL32(0, 0, 0, 139), 2.0f);
+		ImGui::SetCursorPos(srcPos);
+		memoryBudgetView();
+	}
 	ImGui::Unindent();
 }
 
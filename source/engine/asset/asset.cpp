@@ -88,7 +88,7 @@ namespace engine
 		std::u16string storePath = m_saveInfo.getStorePath();
 		auto result = asset / storePath;
 		auto result2 = asset.append(storePath);
-		return result;
+		return applySaveAside(result);
 	}
 
 	void AssetInterface::discardChanged()
@@ -130,7 +130,7 @@ namespace engine
 		std::u16string p = utf8::utf8to16(getSnapshotUUID());
 		std::filesystem::path cache = getAssetManager()->getProjectConfig().cachePath;
 
-		return cache / p;
+		return applySaveAside(cache / p);
 	}
 
 	UUID AssetInterface::getBinUUID() const
@@ -143,7 +143,138 @@ namespace engine
 		std::u16string p = utf8::utf8to16(getBinUUID());
 		std::filesystem::path cache = getAssetManager()->getProjectConfig().cachePath;
 
-		return cache / p;
+		return applySaveAside(cache / p);
+	}
+
+	std::filesystem::path AssetInterface::applySaveAside(std::filesystem::path path) const
+	{
+		if (m_bSaveAside)
+		{
+			path += kAssetSaveAsideSuffix;
+		}
+		return path;
+	}
+
+	bool AssetInterface::commitSaveAside()
+	{
+		CHECK(m_bSaveAside);
+
+		m_bSaveAside = false;
+		const std::filesystem::path finalPaths[] = { getBinPath(), getSnapshotPath(), getSavePath() };
+		m_bSaveAside = true;
+
+		struct CommitFile
+		{
+			std::filesystem::path finalPath;
+			std::filesystem::path asidePath;
+			std::filesystem::path replacedPath;
+
+			bool bFinalExist = false;
+			bool bReplaced = false;
+			bool bCommitted = false;
+		};
+
+		std::vector<CommitFile> files { };
+		for (const auto& finalPath : finalPaths)
+		{
+			CommitFile file { };
+			file.finalPath = finalPath;
+			file.asidePath = finalPath;
+			file.asidePath += kAssetSaveAsideSuffix;
+			file.replacedPath = finalPath;
+			file.replacedPath += kAssetReplacedSuffix;
+
+			std::error_code ec;
+			if (!std::filesystem::exists(file.asidePath, ec))
+			{
+				continue;
+			}
+
+			file.bFinalExist = std::filesystem::exists(file.finalPath, ec);
+			files.push_back(std::move(file));
+		}
+
+		// Undo all done renames in reverse order, asset file first so it never point to a missing bin.
+		auto rollback = [&]()
+		{
+			for (auto iter = files.rbegin(); iter != files.rend(); ++iter)
+			{
+				std::error_code ec;
+				if (iter->bCommitted)
+				{
+					std::filesystem::rename(iter->finalPath, iter->asidePath, ec);
+					if (ec)
+					{
+						LOG_ERROR("Rollback {} fail: {}.", utf8::utf16to8(iter->finalPath.u16string()), ec.message());
+					}
+				}
+				if (iter->bReplaced)
+				{
+					std::filesystem::rename(iter->replacedPath, iter->finalPath, ec);
+					if (ec)
+					{
+						LOG_ERROR("Rollback {} fail: {}.", utf8::utf16to8(iter->replacedPath.u16string()), ec.message());
+					}
+				}
+			}
+		};
+
+		// Move all old files away first, old file still mapped by loading task fail on windows, retry later.
+		for (auto& file : files)
+		{
+			if (!file.bFinalExist)
+			{
+				continue;
+			}
+
+			std::error_code ec;
+			std::filesystem::remove(file.replacedPath, ec);
+			std::filesystem::rename(file.finalPath, file.replacedPath, ec);
+			if (ec)
+			{
+				LOG_TRACE("Rename {} fail: {}, retry later.", utf8::utf16to8(file.finalPath.u16string()), ec.message());
+				rollback();
+				return false;
+			}
+			file.bReplaced = true;
+		}
+
+		// Asset file rename last, it only point to new bin after bin ready.
+		for (auto& file : files)
+		{
+			std::error_code ec;
+			std::filesystem::rename(file.asidePath, file.finalPath, ec);
+			if (ec)
+			{
+				LOG_TRACE("Rename {} fail: {}, retry later.", utf8::utf16to8(file.asidePath.u16string()), ec.message());
+				rollback();
+				return false;
+			}
+			file.bCommitted = true;
+		}
+
+		for (const auto& file : files)
+		{
+			if (file.bReplaced)
+			{
+				std::error_code ec;
+				std::filesystem::remove(file.replacedPath, ec);
+			}
+		}
+
+		m_bSaveAside = false;
+		return true;
+	}
+
+	void AssetInterface::discardSaveAside()
+	{
+		CHECK(m_bSaveAside);
+
+		for (const auto& asidePath : { getBinPath(), getSnapshotPath(), getSavePath() })
+		{
+			std::error_code ec;
+			std::filesystem::remove(asidePath, ec);
+		}
 	}
 
 	VulkanImage* AssetInterface::getSnapshotImage()
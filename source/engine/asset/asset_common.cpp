@@ -1,13 +1,14 @@
 #include "asset_common.h"
 
 #include <lz4.h>
+#include <lz4hc.h>
 
 #include <rttr/registration>
 #include "asset_manager.h"
 
 namespace engine
 {
-    const uint32_t engine::kAssetVersion = 6;
+    const uint32_t engine::kAssetVersion = 11;
 
     AssetSaveInfo::AssetSaveInfo(const u8str& name, const u8str& storeFolder)
         : m_name(name), m_storeFolder(storeFolder)
@@ -83,7 +84,7 @@ namespace engine
         std::filesystem::path path = getAssetManager()->getProjectConfig().assetPath;
         path /= this->getStorePath();
 
-        return std::filesystem::exists(path);
+        return isAssetFileExist(path);
     }
 
 
@@ -104,35 +105,32 @@ namespace engine
 
 
 
+    static AutoCVarInt32 cVarAssetCompressionHCLevel(
+        "asset.compression.hcLevel",
+        "Binary stream compression level, 0 is fast lz4, 1~12 is lz4hc level for offline cooking.",
+        "Asset",
+        0,
+        CVarFlags::ReadAndWrite);
+
     bool engine::loadAssetBinaryWithDecompression(
         std::vector<uint8_t>& out, 
         const std::filesystem::path& rawSavePath)
     {
         ZoneScoped;
-        if (!std::filesystem::exists(rawSavePath))
+
+        std::vector<char> payload;
+        if (!loadAssetPayload(payload, rawSavePath))
         {
-            LOG_ERROR("Binary data {} miss!", utf8::utf16to8(rawSavePath.u16string()));
             return false;
         }
 
-        std::ifstream is(rawSavePath, std::ios::binary);
-        cereal::BinaryInputArchive archive(is);
-
-        AssetCompressionHelper sizeHelper;
-
-        std::vector<uint8_t> compressionData;
-        archive(sizeHelper, compressionData);
-
-        // Resize to src data.
-        out.resize(sizeHelper.originalSize);
-
-        LZ4_decompress_safe((const char*)compressionData.data(), (char*)out.data(), sizeHelper.compressionSize, sizeHelper.originalSize);
+        out.assign(payload.begin(), payload.end());
         return true;
     }
 
     bool engine::saveAssetBinaryWithCompression(
         const uint8_t* out, 
-        int size, 
+        size_t size, 
         const std::filesystem::path& savePath, 
         const char* suffix)
     {
@@ -140,32 +138,506 @@ namespace engine
         std::filesystem::path rawSavePath = savePath;
         rawSavePath += suffix;
 
-        if (std::filesystem::exists(rawSavePath))
+        return saveAssetBinaryStreams({ { out, size } }, rawSavePath, true);
+    }
+
+    bool engine::decompressMappedAsset(std::vector<char>& out, const AssetFileView& file)
+    {
+        ZoneScoped;
+        if (file.getSize() < kAssetCompressionHeaderSize)
         {
-            LOG_ERROR("Binary data {} already exist, make sure never import save resource at same folder!", utf8::utf16to8(rawSavePath.u16string()));
             return false;
         }
 
-        // Save to disk.
-        std::ofstream os(rawSavePath, std::ios::binary);
-        cereal::BinaryOutputArchive archive(os);
+        const uint8_t* data = file.getData();
+
+        int32_t originalSize;
+        int32_t compressionSize;
+        uint64_t vectorSize;
+        memcpy(&originalSize, data, sizeof(int32_t));
+        memcpy(&compressionSize, data + sizeof(int32_t), sizeof(int32_t));
+        memcpy(&vectorSize, data + sizeof(int32_t) * 2, sizeof(uint64_t));
 
-        // LZ4 compression.
-        std::vector<uint8_t> compressionData;
+        if (originalSize < 0 || compressionSize < 0 || 
+            vectorSize != (uint64_t)compressionSize ||
+            file.getSize() < kAssetCompressionHeaderSize + vectorSize)
+        {
+            return false;
+        }
 
-        // Compress and shrink.
-        auto compressStaging = LZ4_compressBound(size);
-        compressionData.resize(compressStaging);
-        auto compressedSize = LZ4_compress_default((const char*)out, (char*)compressionData.data(), size, compressStaging);
-        compressionData.resize(compressedSize);
+        out.resize(originalSize);
+        const int decompressSize = LZ4_decompress_safe(
+            (const char*)(data + kAssetCompressionHeaderSize), 
+            out.data(), 
+            compressionSize, 
+            originalSize);
 
-        AssetCompressionHelper sizeHelper
+        return decompressSize == originalSize;
+    }
+
+    bool engine::loadAssetPayload(std::vector<char>& out, const std::filesystem::path& savePath)
+    {
+        ZoneScoped;
+
+        // Binary stream container, whole payload store in stream 0.
         {
-            .originalSize = size,
-            .compressionSize = compressedSize,
+            AssetBinaryStreamReader reader { };
+            if (reader.open(savePath))
+            {
+                if (reader.getStreamCount() != 1)
+                {
+                    LOG_ERROR("Asset data {} stream count un-match!", utf8::utf16to8(savePath.u16string()));
+                    return false;
+                }
+
+                out.resize(reader.getStreamSize(0));
+                if (!reader.decompressStream(0, out.data()))
+                {
+                    LOG_ERROR("Asset data {} broken!", utf8::utf16to8(savePath.u16string()));
+                    return false;
+                }
+                return true;
+            }
+        }
+
+        // Legacy single block file, map file so compressed payload decompress from page cache directly.
+        AssetFileView file;
+        if (!file.open(savePath))
+        {
+            LOG_ERROR("Asset data {} miss!", utf8::utf16to8(savePath.u16string()));
+            return false;
+        }
+
+        if (!decompressMappedAsset(out, file))
+        {
+            LOG_ERROR("Asset data {} broken!", utf8::utf16to8(savePath.u16string()));
+            return false;
+        }
+
+        return true;
+    }
+
+    bool engine::saveAssetBinaryStreams(
+        const std::vector<AssetBinaryStreamView>& streams, 
+        const std::filesystem::path& savePath, 
+        bool bRequireNoExist,
+        const AssetBinaryStreamSaveConfig& config)
+    {
+        ZoneScoped;
+        if (bRequireNoExist && std::filesystem::exists(savePath))
+        {
+            LOG_ERROR("Binary data {} already exist, make sure never import save resource at same folder!", 
+                utf8::utf16to8(savePath.u16string()));
+            return false;
+        }
+
+        const uint32_t chunkSize = config.chunkSize;
+        const int32_t hcLevel = config.hcLevel >= 0 ? config.hcLevel : cVarAssetCompressionHCLevel.get();
+        CHECK(chunkSize > 0 && chunkSize <= LZ4_MAX_INPUT_SIZE);
+
+        std::vector<AssetBinaryStreamEntry> streamEntries(streams.size());
+        std::vector<AssetBinaryChunkEntry> chunkEntries { };
+        for (size_t i = 0; i < streams.size(); i++)
+        {
+            streamEntries[i].originalSize = streams[i].size;
+            streamEntries[i].firstChunk = (uint32_t)chunkEntries.size();
+            streamEntries[i].chunkCount = (uint32_t)divideRoundingUp<uint64_t>(streams[i].size, chunkSize);
+
+            chunkEntries.resize(chunkEntries.size() + streamEntries[i].chunkCount);
+        }
+
+        // Compress all chunks.
+        std::vector<std::vector<char>> compressedDatas(chunkEntries.size());
+        std::vector<const char*> chunkDatas(chunkEntries.size());
+        for (size_t i = 0; i < streams.size(); i++)
+        {
+            const auto& stream = streams[i];
+            for (uint32_t j = 0; j < streamEntries[i].chunkCount; j++)
+            {
+                const uint32_t chunkIndex = streamEntries[i].firstChunk + j;
+                const uint64_t rawOffset = (uint64_t)j * chunkSize;
+                const int rawSize = (int)std::min<uint64_t>(chunkSize, stream.size - rawOffset);
+                const char* rawData = (const char*)stream.data + rawOffset;
+
+                auto& compressedData = compressedDatas[chunkIndex];
+                compressedData.resize(LZ4_compressBound(rawSize));
+
+                const int compressedSize = (hcLevel > 0)
+                    ? LZ4_compress_HC(rawData, compressedData.data(), rawSize, (int)compressedData.size(), hcLevel)
+                    : LZ4_compress_default(rawData, compressedData.data(), rawSize, (int)compressedData.size());
+
+                auto& chunk = chunkEntries[chunkIndex];
+                chunk.originalSize = (uint32_t)rawSize;
+                chunk.flags = 0;
+
+                // Store raw when compression no benefit, loader just copy from mapping.
+                if (compressedSize <= 0 || compressedSize >= rawSize)
+                {
+                    compressedData.clear();
+                    chunkDatas[chunkIndex] = rawData;
+                    chunk.compressionSize = (uint32_t)rawSize;
+                    chunk.flags |= EAssetBinaryChunkFlags_Stored;
+                }
+                else
+                {
+                    compressedData.resize(compressedSize);
+                    chunkDatas[chunkIndex] = compressedData.data();
+                    chunk.compressionSize = (uint32_t)compressedSize;
+                }
+
+                chunk.checksum = crc::crc32(chunkDatas[chunkIndex], chunk.compressionSize);
+            }
+        }
+
+        AssetBinaryStreamHeader header
+        {
+            .magic = kAssetBinaryStreamMagic,
+            .version = kAssetBinaryStreamVersion,
+            .streamCount = (uint32_t)streamEntries.size(),
+            .chunkCount = (uint32_t)chunkEntries.size(),
+            .chunkSize = chunkSize,
+            .flags = 0,
         };
 
-        archive(sizeHelper, compressionData);
+        uint64_t offset = 
+            sizeof(AssetBinaryStreamHeader) + 
+            sizeof(AssetBinaryStreamEntry) * streamEntries.size() + 
+            sizeof(AssetBinaryChunkEntry) * chunkEntries.size();
+        for (auto& chunk : chunkEntries)
+        {
+            chunk.offset = offset;
+            offset += chunk.compressionSize;
+        }
+
+        std::ofstream os(savePath, std::ios::binary | std::ios::trunc);
+        if (!os)
+        {
+            LOG_ERROR("Binary data {} open failed!", utf8::utf16to8(savePath.u16string()));
+            return false;
+        }
+
+        os.write((const char*)&header, sizeof(header));
+        os.write((const char*)streamEntries.data(), sizeof(AssetBinaryStreamEntry) * streamEntries.size());
+        os.write((const char*)chunkEntries.data(), sizeof(AssetBinaryChunkEntry) * chunkEntries.size());
+        for (size_t i = 0; i < chunkEntries.size(); i++)
+        {
+            os.write(chunkDatas[i], chunkEntries[i].compressionSize);
+        }
+
+        return os.good();
+    }
+
+    bool AssetBinaryStreamReader::open(const std::filesystem::path& path)
+    {
+        m_streams.clear();
+        m_chunks.clear();
+
+        if (!m_file.open(path))
+        {
+            return false;
+        }
+
+        const uint8_t* data = m_file.getData();
+        const size_t fileSize = m_file.getSize();
+
+        uint32_t magic = 0;
+        uint32_t version = 0;
+        if (fileSize < sizeof(uint32_t) * 2)
+        {
+            return false;
+        }
+        memcpy(&magic, data, sizeof(uint32_t));
+        memcpy(&version, data + sizeof(uint32_t), sizeof(uint32_t));
+
+        if (magic != kAssetBinaryStreamMagic)
+        {
+            return false;
+        }
+
+        if (version == kAssetBinaryStreamVersionSingleBlock)
+        {
+            // Version 1: uint32 magic | uint32 version | uint32 streamCount | uint32 padding,
+            // then per stream uint64 offset | uint64 originalSize | uint64 compressionSize.
+            // Convert each stream as one chunk.
+            constexpr size_t kHeaderSize = sizeof(uint32_t) * 4;
+            constexpr size_t kEntrySize = sizeof(uint64_t) * 3;
+            if (fileSize < kHeaderSize)
+            {
+                return false;
+            }
+
+            uint32_t streamCount;
+            memcpy(&streamCount, data + sizeof(uint32_t) * 2, sizeof(uint32_t));
+            if (fileSize < kHeaderSize + kEntrySize * streamCount)
+            {
+                return false;
+            }
+
+            m_streams.resize(streamCount);
+            m_chunks.resize(streamCount);
+            for (uint32_t i = 0; i < streamCount; i++)
+            {
+                uint64_t entry[3];
+                memcpy(entry, data + kHeaderSize + kEntrySize * i, kEntrySize);
+
+                m_streams[i] = { .originalSize = entry[1], .firstChunk = i, .chunkCount = 1 };
+
+                auto& chunk = m_chunks[i];
+                chunk.streamOffset = 0;
+                chunk.entry.offset = entry[0];
+                chunk.entry.originalSize = (uint32_t)entry[1];
+                chunk.entry.compressionSize = (uint32_t)entry[2];
+                chunk.entry.checksum = 0;
+                chunk.entry.flags = EAssetBinaryChunkFlags_NoChecksum;
+                if (entry[1] == entry[2])
+                {
+                    chunk.entry.flags |= EAssetBinaryChunkFlags_Stored;
+                }
+            }
+        }
+        else if (version == kAssetBinaryStreamVersion)
+        {
+            if (fileSize < sizeof(AssetBinaryStreamHeader))
+            {
+                return false;
+            }
+
+            AssetBinaryStreamHeader header;
+            memcpy(&header, data, sizeof(header));
+
+            const size_t streamTableSize = sizeof(AssetBinaryStreamEntry) * header.streamCount;
+            const size_t chunkTableSize = sizeof(AssetBinaryChunkEntry) * header.chunkCount;
+            if (fileSize < sizeof(AssetBinaryStreamHeader) + streamTableSize + chunkTableSize)
+            {
+                return false;
+            }
+
+            m_streams.resize(header.streamCount);
+            memcpy(m_streams.data(), data + sizeof(AssetBinaryStreamHeader), streamTableSize);
+
+            std::vector<AssetBinaryChunkEntry> chunkEntries(header.chunkCount);
+            memcpy(chunkEntries.data(), data + sizeof(AssetBinaryStreamHeader) + streamTableSize, chunkTableSize);
+
+            m_chunks.resize(header.chunkCount);
+            for (uint32_t i = 0; i < header.chunkCount; i++)
+            {
+                m_chunks[i].entry = chunkEntries[i];
+            }
+
+            for (const auto& stream : m_streams)
+            {
+                if ((uint64_t)stream.firstChunk + stream.chunkCount > header.chunkCount)
+                {
+                    m_streams.clear();
+                    m_chunks.clear();
+                    return false;
+                }
+
+                // Chunk decompress write original size at stream offset, table must stay inside stream.
+                uint64_t streamOffset = 0;
+                for (uint32_t i = 0; i < stream.chunkCount; i++)
+                {
+                    auto& chunk = m_chunks[stream.firstChunk + i];
+                    if (chunk.entry.originalSize > header.chunkSize)
+                    {
+                        LOG_ERROR("Binary data {} chunk {} size {} over chunk size {}!", utf8::utf16to8(path.u16string()), stream.firstChunk + i, chunk.entry.originalSize, header.chunkSize);
+                        m_streams.clear();
+                        m_chunks.clear();
+                        return false;
+                    }
+
+                    chunk.streamOffset = streamOffset;
+                    streamOffset += chunk.entry.originalSize;
+                }
+
+                if (streamOffset != stream.originalSize)
+                {
+                    LOG_ERROR("Binary data {} chunks size {} un-match stream size {}!", utf8::utf16to8(path.u16string()), streamOffset, stream.originalSize);
+                    m_streams.clear();
+                    m_chunks.clear();
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            LOG_ERROR("Binary data {} version {} un-support!", utf8::utf16to8(path.u16string()), version);
+            return false;
+        }
+
+        for (const auto& chunk : m_chunks)
+        {
+            // Stored chunk copy original size from file.
+            const bool bStoredSizeMismatch = (chunk.entry.flags & EAssetBinaryChunkFlags_Stored) && (chunk.entry.originalSize != chunk.entry.compressionSize);
+            if (bStoredSizeMismatch || chunk.entry.offset > fileSize || chunk.entry.compressionSize > fileSize - chunk.entry.offset)
+            {
+                m_streams.clear();
+                m_chunks.clear();
+                return false;
+            }
+        }
+
         return true;
     }
+
+    size_t AssetBinaryStreamReader::getTotalSize() const
+    {
+        size_t size = 0;
+        for (const auto& stream : m_streams)
+        {
+            size += (size_t)stream.originalSize;
+        }
+        return size;
+    }
+
+    bool AssetBinaryStreamReader::decompressChunk(uint32_t chunkIndex, void* dest) const
+    {
+        const auto& entry = m_chunks.at(chunkIndex).entry;
+        const char* src = (const char*)(m_file.getData() + entry.offset);
+
+        if (!(entry.flags & EAssetBinaryChunkFlags_NoChecksum) && 
+            crc::crc32(src, entry.compressionSize) != entry.checksum)
+        {
+            LOG_ERROR("Binary chunk {} checksum un-match!", chunkIndex);
+            return false;
+        }
+
+        if (entry.flags & EAssetBinaryChunkFlags_Stored)
+        {
+            memcpy(dest, src, entry.originalSize);
+            return true;
+        }
+
+        const int decompressSize = LZ4_decompress_safe(
+            src, 
+            (char*)dest, 
+            (int)entry.compressionSize, 
+            (int)entry.originalSize);
+
+        return decompressSize == (int)entry.originalSize;
+    }
+
+    bool AssetBinaryStreamReader::decompressStream(uint32_t index, void* dest, ThreadPool* threadPool) const
+    {
+        ZoneScoped;
+        const auto& stream = m_streams.at(index);
+
+        if (threadPool && stream.chunkCount > 1)
+        {
+            // Chunk decompress cost similar and big, claim one chunk each time.
+            std::atomic<bool> bResult = true;
+            const auto loop = [&](const uint32_t loopStart, const uint32_t loopEnd)
+            {
+                for (uint32_t i = loopStart; i < loopEnd; ++i)
+                {
+                    const auto& chunk = m_chunks[stream.firstChunk + i];
+                    if (!decompressChunk(stream.firstChunk + i, (char*)dest + chunk.streamOffset))
+                    {
+                        bResult = false;
+                    }
+                }
+            };
+
+            threadPool->parallelFor(0u, stream.chunkCount, loop, 1);
+            return bResult;
+        }
+
+        for (uint32_t i = 0; i < stream.chunkCount; i++)
+        {
+            const auto& chunk = m_chunks[stream.firstChunk + i];
+            if (!decompressChunk(stream.firstChunk + i, (char*)dest + chunk.streamOffset))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool AssetBinaryStreamReader::readStreamRange(uint32_t index, size_t offset, size_t size, void* dest) const
+    {
+        ZoneScoped;
+        const auto& stream = m_streams.at(index);
+        if (offset + size > stream.originalSize)
+        {
+            return false;
+        }
+
+        std::vector<char> chunkCache { };
+        for (uint32_t i = 0; i < stream.chunkCount; i++)
+        {
+            const uint32_t chunkIndex = stream.firstChunk + i;
+            const auto& chunk = m_chunks[chunkIndex];
+
+            const size_t chunkStart = (size_t)chunk.streamOffset;
+            const size_t chunkEnd = chunkStart + chunk.entry.originalSize;
+            if (chunkEnd <= offset || chunkStart >= offset + size)
+            {
+                continue;
+            }
+
+            char* destPtr = (char*)dest + (std::max(chunkStart, offset) - offset);
+            if (chunkStart >= offset && chunkEnd <= offset + size)
+            {
+                // Whole chunk inside range, decompress in place.
+                if (!decompressChunk(chunkIndex, destPtr))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                // Range edge, decompress to cache then copy overlap part.
+                chunkCache.resize(chunk.entry.originalSize);
+                if (!decompressChunk(chunkIndex, chunkCache.data()))
+                {
+                    return false;
+                }
+
+                const size_t copyStart = std::max(chunkStart, offset);
+                const size_t copyEnd = std::min(chunkEnd, offset + size);
+                memcpy(destPtr, chunkCache.data() + (copyStart - chunkStart), copyEnd - copyStart);
+            }
+        }
+
+        return true;
+    }
+
+    bool StaticMeshBin::saveBinaryStreams(const std::filesystem::path& savePath) const
+    {
+        // Legacy absolute indices only save when no packed.
+        const auto indicesView = indicesPacked.empty() ? buildBinaryStreamView(indices) : buildBinaryStreamView(indicesPacked);
+
+        std::vector<AssetBinaryStreamView> streams;
+        if (positionsCompact.empty())
+        {
+            streams =
+            {
+                indicesView,
+                buildBinaryStreamView(positions),
+                buildBinaryStreamView(normals),
+                buildBinaryStreamView(uv0s),
+                buildBinaryStreamView(tangents),
+            };
+        }
+        else
+        {
+            // Loader select stripe size by asset vertex format.
+            streams =
+            {
+                indicesView,
+                buildBinaryStreamView(positionsCompact),
+                buildBinaryStreamView(normalsCompact),
+                buildBinaryStreamView(uv0sCompact),
+                buildBinaryStreamView(tangentsCompact),
+            };
+        }
+
+        // Meshlet stream only exist when cook with meshlet, loader check stream count.
+        if (!meshlets.empty())
+        {
+            streams.push_back(buildBinaryStreamView(meshlets));
+        }
+
+        return saveAssetBinaryStreams(streams, savePath, false);
+    }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../utils/utils.h"
+#include "asset_pack.h"
 #include <engine/graphics/resource.h>
 #include <fstream>
 #include <lz4.h>
@@ -100,11 +101,48 @@ namespace engine
 
 namespace engine
 {
+	class ImportJobGraph;
 
 	struct AssetImportConfigInterface
 	{
 		using ImportAssetPath = std::pair<std::filesystem::path, std::filesystem::path>;
 		ImportAssetPath path;
+
+		// Import into exist asset of save path, keep its uuid, see AssetManager::createImportAsset.
+		bool bReimport = false;
+
+		virtual ~AssetImportConfigInterface() = default;
+
+		// Import settings record in asset, so reimport can rebuild same config, path not include.
+		virtual void saveSettings(cereal::BinaryOutputArchive& archive) const { }
+		virtual void loadSettings(cereal::BinaryInputArchive& archive) { }
+	};
+
+	// Raw source which asset import from, used to detect source change and reimport.
+	struct AssetImportSource
+	{
+		// Absolute path of raw source when import.
+		u8str path = {};
+
+		// Raw dependencies relative to source folder, such as obj material file or gltf external buffers.
+		std::vector<u8str> dependencies = {};
+
+		// Latest write time of source and dependencies, fast check before hash.
+		int64_t writeTime = 0;
+
+		// Content hash of source and dependencies.
+		std::string hash = {};
+
+		// Import config settings, see AssetImportConfigInterface::saveSettings.
+		std::vector<uint8_t> settings = {};
+
+		bool empty() const { return path.empty(); }
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			archive(path, dependencies, writeTime, hash, settings);
+		}
 	};
 
 	enum class EAssetType
@@ -132,6 +170,9 @@ namespace engine
 			std::function<ImportConfigPtr()> buildAssetImportConfig = nullptr;
 			std::function<void(ImportConfigPtr)> drawAssetImportConfig = nullptr;
 			std::function<bool(ImportConfigPtr)> importAssetFromConfigThreadSafe = nullptr;
+
+			// Add import jobs into graph, null will add one job call importAssetFromConfigThreadSafe.
+			std::function<void(ImportConfigPtr, ImportJobGraph&)> buildImportJobs = nullptr;
 		} importConfig;
 	};
 
@@ -283,9 +324,16 @@ namespace engine
 		}
 	};
 
+	// Reimport asset files save aside with this suffix, rename to final path when commit.
+	constexpr const char* kAssetSaveAsideSuffix = ".reimport";
+
+	// Old asset files move to this suffix when commit, remove after all new files in place, move back when fail.
+	constexpr const char* kAssetReplacedSuffix = ".replaced";
+
 	class AssetInterface : public std::enable_shared_from_this<AssetInterface>
 	{
 		REGISTER_BODY_DECLARE();
+		friend class AssetManager;
 
 	public:
 		AssetInterface() = default;
@@ -296,6 +344,7 @@ namespace engine
 		virtual EAssetType getType() const  = 0;
 		virtual void onPostAssetConstruct() = 0; // Call back when call AssetManager::createAsset
 		virtual VulkanImage* getSnapshotImage();
+		virtual void collectDependencies(std::vector<UUID>& outDependencies) const { }
 		// ~AssetInterface virtual function.
 
 		// Get suffix of asset.
@@ -344,9 +393,15 @@ namespace engine
 
 		std::filesystem::path getRawAssetPath() const;
 
+		// Empty if asset not import from raw source.
+		const AssetImportSource& getImportSource() const { return m_importSource; }
+
 		UUID getBinUUID() const;
 		std::filesystem::path getBinPath() const;
 
+		// Asset, bin and snapshot path add save aside suffix, live asset of same uuid may still map final files.
+		bool isSaveAside() const { return m_bSaveAside; }
+
 	protected:
 		// ~AssetInterface virtual function.
 		virtual bool saveImpl() = 0;
@@ -354,15 +409,28 @@ namespace engine
 		virtual void unloadImpl() = 0;
 		// ~AssetInterface virtual function.
 
+	private:
+		std::filesystem::path applySaveAside(std::filesystem::path path) const;
+
+		// Rename all save aside files to final path or none of them, return false and keep save aside if any file still in use.
+		bool commitSaveAside();
+
+		// Remove save aside files, when reimport fail.
+		void discardSaveAside();
+
 	private:
 		// Asset is dirty or not.
 		bool m_bDirty = false;
 
+		bool m_bSaveAside = false;
+
 	protected:
 		AssetSaveInfo m_saveInfo = { };
 
 		// Raw asset path relative to asset folder.
 		u8str m_rawAssetPath = {};
+
+		AssetImportSource m_importSource = {};
 	};
 
 	struct AssetCompressionHelper
@@ -377,42 +445,159 @@ namespace engine
 		}
 	};
 
+	// Binary stream container, payload split into streams (e.g. gpu upload payloads in upload order),
+	// each stream split into fixed size chunks, every chunk compressed independently with lz4 or lz4hc.
+	// Streams always start at a new chunk, so one stream can decompress directly into destination memory,
+	// chunks can decompress in parallel and a sub range of stream can read partially.
+	// Magic high bit set so it never collide with legacy file first int (positive original size).
+	constexpr uint32_t kAssetBinaryStreamMagic   = 0xDA4B5354u;
+	constexpr uint32_t kAssetBinaryStreamVersion = 2;
+
+	// Version 1 store one lz4 block per stream, still readable.
+	constexpr uint32_t kAssetBinaryStreamVersionSingleBlock = 1;
+
+	// Default chunk size, small enough to parallel decompress a single texture mip.
+	constexpr uint32_t kAssetBinaryStreamDefaultChunkSize = 256 * 1024;
+
+	struct AssetBinaryStreamHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t streamCount;
+		uint32_t chunkCount;
+		uint32_t chunkSize;
+		uint32_t flags;
+	};
+	static_assert(sizeof(AssetBinaryStreamHeader) == 24);
+
+	struct AssetBinaryStreamEntry
+	{
+		// Size when decompressed.
+		uint64_t originalSize;
+
+		// Chunk range of this stream in chunk table.
+		uint32_t firstChunk;
+		uint32_t chunkCount;
+	};
+	static_assert(sizeof(AssetBinaryStreamEntry) == 16);
+
+	enum EAssetBinaryChunkFlags : uint32_t
+	{
+		// Chunk store without compression, compression no benefit.
+		EAssetBinaryChunkFlags_Stored = 0x1,
+
+		// Chunk no checksum, only version 1 file.
+		EAssetBinaryChunkFlags_NoChecksum = 0x2,
+	};
+
+	struct AssetBinaryChunkEntry
+	{
+		// Offset from file start.
+		uint64_t offset;
+
+		uint32_t compressionSize;
+		uint32_t originalSize;
+
+		// Crc32 of chunk data store in file.
+		uint32_t checksum;
+		uint32_t flags;
+	};
+	static_assert(sizeof(AssetBinaryChunkEntry) == 24);
+
+	struct AssetBinaryStreamView
+	{
+		const void* data = nullptr;
+		size_t size = 0;
+	};
+
+	template<typename T>
+	inline AssetBinaryStreamView buildBinaryStreamView(const std::vector<T>& in)
+	{
+		return { in.data(), in.size() * sizeof(T) };
+	}
+
+	struct AssetBinaryStreamSaveConfig
+	{
+		uint32_t chunkSize = kAssetBinaryStreamDefaultChunkSize;
+
+		// 0 use fast lz4, otherwise lz4hc level, used when offline cooking.
+		// Negative use cvar asset.compression.hcLevel.
+		int32_t hcLevel = -1;
+	};
+
+	extern bool saveAssetBinaryStreams(
+		const std::vector<AssetBinaryStreamView>& streams, 
+		const std::filesystem::path& savePath, 
+		bool bRequireNoExist = true,
+		const AssetBinaryStreamSaveConfig& config = {});
+
+	class AssetBinaryStreamReader : NonCopyable
+	{
+	public:
+		// Return false if file miss or file is not binary stream format, file may inside mounted pack.
+		bool open(const std::filesystem::path& path);
+
+		uint32_t getStreamCount() const { return (uint32_t)m_streams.size(); }
+		size_t getStreamSize(uint32_t index) const { return (size_t)m_streams.at(index).originalSize; }
+		size_t getTotalSize() const;
+
+		// Decompress whole stream into dest, dest must own at least getStreamSize(index) bytes.
+		// When thread pool valid, chunks decompress parallel, caller also decompress chunks while wait.
+		bool decompressStream(uint32_t index, void* dest, ThreadPool* threadPool = nullptr) const;
+
+		// Decompress [offset, offset + size) of stream into dest, only touch chunks overlap the range.
+		bool readStreamRange(uint32_t index, size_t offset, size_t size, void* dest) const;
+
+	private:
+		bool decompressChunk(uint32_t chunkIndex, void* dest) const;
+
+		struct Chunk
+		{
+			AssetBinaryChunkEntry entry;
+
+			// Offset relative to owner stream start when decompressed.
+			uint64_t streamOffset;
+		};
+
+		AssetFileView m_file;
+		std::vector<AssetBinaryStreamEntry> m_streams;
+		std::vector<Chunk> m_chunks;
+	};
+
+	// Legacy compressed file layout: cereal binary of AssetCompressionHelper and std::vector<char>.
+	// int32 originalSize | int32 compressionSize | uint64 vector size | compressed bytes.
+	constexpr size_t kAssetCompressionHeaderSize = sizeof(int32_t) * 2 + sizeof(uint64_t);
+
+	// Decompress a mapped legacy compressed file into out, return false if data broken.
+	extern bool decompressMappedAsset(std::vector<char>& out, const AssetFileView& file);
+
+	// Load whole decompressed payload of asset file, support binary stream container and legacy single block file.
+	extern bool loadAssetPayload(std::vector<char>& out, const std::filesystem::path& savePath);
+
 	extern bool loadAssetBinaryWithDecompression(std::vector<uint8_t>& out, const std::filesystem::path& rawSavePath);
-	extern bool saveAssetBinaryWithCompression(const uint8_t* out, int size, const std::filesystem::path& savePath, const char* suffix);
+	extern bool saveAssetBinaryWithCompression(const uint8_t* out, size_t size, const std::filesystem::path& savePath, const char* suffix);
 
 	inline bool saveAssetBinaryWithCompression(const std::vector<uint8_t>& out, const std::filesystem::path& savePath, const char* suffix)
 	{
-		return saveAssetBinaryWithCompression(out.data(), (int)out.size(), savePath, suffix);
+		return saveAssetBinaryWithCompression(out.data(), out.size(), savePath, suffix);
 	}
 
 	template<typename T>
 	inline bool loadAsset(T& out, const std::filesystem::path& savePath)
 	{
-		if (!std::filesystem::exists(savePath))
+		ZoneScoped;
+
+		std::vector<char> decompressionData;
+		if (!loadAssetPayload(decompressionData, savePath))
 		{
-			LOG_ERROR("Asset data {} miss!", utf8::utf16to8(savePath.u16string()));
 			return false;
 		}
 
-		AssetCompressionHelper sizeHelper;
-		std::vector<char> compressionData;
+		// Cereal parse from decompressed memory view, no string or stringstream copy.
 		{
-			std::ifstream is(savePath, std::ios::binary);
+			MemoryViewStreamBuffer buffer(decompressionData.data(), decompressionData.size());
+			std::istream is(&buffer);
 			cereal::BinaryInputArchive archive(is);
-			archive(sizeHelper, compressionData);
-		}
-
-		std::vector<char> decompressionData(sizeHelper.originalSize);
-		CHECK(sizeHelper.compressionSize == compressionData.size());
-		int decompressSize = LZ4_decompress_safe(compressionData.data(), decompressionData.data(), sizeHelper.compressionSize, sizeHelper.originalSize);
-		CHECK(decompressSize == sizeHelper.originalSize);
-
-		// Exist copsaveAssety-construct.
-		{
-			std::string str(decompressionData.data(), decompressionData.size());
-			std::stringstream ss;
-			ss << std::move(str);
-			cereal::BinaryInputArchive archive(ss);
 			archive(out);
 		}
 
@@ -422,15 +607,13 @@ namespace engine
 	template<typename T>
 	inline bool saveAsset(const T& in, const std::filesystem::path& savePath, bool bRequireNoExist = true)
 	{
-		std::filesystem::path rawSavePath = savePath;
-		if (bRequireNoExist && std::filesystem::exists(rawSavePath))
+		if (bRequireNoExist && std::filesystem::exists(savePath))
 		{
 			LOG_ERROR("Meta data {} already exist, make sure never import save resource at same folder!",
-				utf8::utf16to8(rawSavePath.u16string()));
+				utf8::utf16to8(savePath.u16string()));
 			return false;
 		}
 
-		AssetCompressionHelper sizeHelper;
 		std::string originalData;
 		{
 			std::stringstream ss;
@@ -439,21 +622,7 @@ namespace engine
 			originalData = std::move(ss.str());
 		}
 
-		std::vector<char> compressedData(LZ4_compressBound((int)originalData.size()));
-		sizeHelper.compressionSize = LZ4_compress_default(
-			originalData.c_str(),
-			compressedData.data(),
-			(int)originalData.size(),
-			(int)compressedData.size());
-
-		compressedData.resize(sizeHelper.compressionSize);
-		sizeHelper.originalSize = (int)originalData.size();
-		{
-			std::ofstream os(rawSavePath, std::ios::binary);
-			cereal::BinaryOutputArchive archive(os);
-			archive(sizeHelper, compressedData);
-		}
-		return true;
+		return saveAssetBinaryStreams({ { originalData.data(), originalData.size() } }, savePath, false);
 	}
 
 	struct StaticMeshRenderBounds
@@ -469,6 +638,22 @@ namespace engine
 		float radius;
 	};
 
+	// Max LOD count of static mesh submesh include LOD0, same as kMaxStaticMeshLodCount in common_header.h.
+	static const uint32_t kStaticMeshMaxLodCount = 4;
+
+	// Simplified index range of submesh, share vertices with LOD0.
+	struct StaticMeshLod
+	{
+		ARCHIVE_DECLARE;
+
+		// Logical index range, same as submesh indicesStart.
+		uint32_t indicesStart = 0;
+		uint32_t indicesCount = 0;
+
+		// Max simplify error to LOD0 in mesh local unit.
+		float error = 0.0f;
+	};
+
 	struct StaticMeshSubMesh
 	{
 		ARCHIVE_DECLARE;
@@ -479,8 +664,65 @@ namespace engine
 		// Material of this submesh.
 		UUID material = {};
 		StaticMeshRenderBounds bounds = {};
+
+		// Meshlet range in static mesh meshlets, zero count if mesh cook without meshlet.
+		uint32_t meshletStart = 0;
+		uint32_t meshletCount = 0;
+
+		// Submesh indices store relative to vertexStart, start from indicesWordStart word of index buffer.
+		// indicesStart still is logical index position, used for draw and meshlet.
+		uint32_t vertexStart = 0;
+		uint32_t indicesWordStart = 0;
+
+		// Two 16 bit indices pack in one word when submesh vertex range fit.
+		bool bIndex16 = false;
+
+		// LOD1 and coarser, index ranges follow LOD0 continuously, empty if mesh cook without LOD.
+		std::vector<StaticMeshLod> lods;
+
+		// Index count of LOD0 and all LODs.
+		uint32_t getIndicesCountWithLods() const
+		{
+			uint32_t count = indicesCount;
+			for (const auto& lod : lods)
+			{
+				count += lod.indicesCount;
+			}
+			return count;
+		}
 	};
 
+	// Submesh vertex range max count which can use 16 bit indices.
+	static const uint32_t kIndex16MaxVertices = 65535;
+
+	// Meshlet max vertex and triangle count, keep small so one meshlet fit one cull thread.
+	static const uint32_t kMeshletMaxVertices  = 64;
+	static const uint32_t kMeshletMaxTriangles = 124;
+
+	// Continuous triangles range of submesh indices, used for gpu meshlet culling.
+	// Layout same with StaticMeshMeshlet in common_header.h.
+	struct StaticMeshMeshlet
+	{
+		// .xyz is center local position, .w is radius.
+		math::vec4 sphereBounds;
+
+		// .xyz is normal cone axis, .w is cone cutoff, meshlet is backface when
+		// dot(normalize(coneApex - cameraPos), coneAxis) >= cutoff. Cutoff is 1.0 when cone is degenerate.
+		math::vec4 coneAxisCutoff;
+
+		// Normal cone apex local position.
+		math::vec3 coneApex;
+
+		// Index start offset position in mesh indices.
+		uint32_t indicesStart;
+
+		uint32_t triangleCount;
+		uint32_t vertexCount;
+		uint32_t pad0;
+		uint32_t pad1;
+	};
+	static_assert(sizeof(StaticMeshMeshlet) == sizeof(float) * 16);
+
 	// Standard index type in this engine.
 	using VertexIndexType = uint32_t;
 
@@ -500,6 +742,20 @@ namespace engine
 	using VertexUv0 = math::vec2;
 	static_assert(sizeof(VertexUv0) == sizeof(float) * 2);
 
+	// Compact vertex format, 20 bytes per vertex instead of 48 bytes, decode when shader fetch.
+	// Position is snorm16x4 relative to submesh bounds, position = origin + extents * snorm.xyz.
+	using VertexPositionCompact = math::uvec2;
+	static_assert(sizeof(VertexPositionCompact) == sizeof(float) * 2);
+
+	// Octahedral encode normal, snorm16x2.
+	using VertexNormalCompact = uint32_t;
+
+	// Octahedral encode tangent, unorm15x2 in low 30 bits, bit 31 set when bitangent sign is negative.
+	using VertexTangentCompact = uint32_t;
+
+	// Half float uv.
+	using VertexUv0Compact = uint32_t;
+
 	struct StaticMeshBin
 	{
 		ARCHIVE_DECLARE;
@@ -509,5 +765,22 @@ namespace engine
 		std::vector<VertexTangent> tangents;
 		std::vector<VertexUv0> uv0s;
 		std::vector<VertexIndexType> indices;
+
+		// Optional, empty if mesh cook without meshlet.
+		std::vector<StaticMeshMeshlet> meshlets;
+
+		// Packed submesh local indices, 16 bit indices pack two in one word, see StaticMeshSubMesh.
+		std::vector<uint32_t> indicesPacked;
+
+		// Optional compact vertex streams, float vertex streams clear when compact streams valid.
+		std::vector<VertexPositionCompact> positionsCompact;
+		std::vector<VertexNormalCompact> normalsCompact;
+		std::vector<VertexTangentCompact> tangentsCompact;
+		std::vector<VertexUv0Compact> uv0sCompact;
+
+		// Save as binary stream file, stream order same with gpu upload order:
+		// indices, positions, normals, uv0s, tangents, meshlets.
+		// Compact vertex streams save instead of float vertex streams when exist, same as packed indices.
+		bool saveBinaryStreams(const std::filesystem::path& savePath) const;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,420 @@
+#include "asset_cook.h"
+#include "asset.h"
+#include "asset_manager.h"
+#include "asset_reimport.h"
+#include "import_job_graph.h"
+#include "../engine.h"
+
+#include <nameof/nameof.hpp>
+
+namespace engine
+{
+	static const std::string kCookCommand = "--cook";
+	static const std::string kCookSummaryOption = "--summary";
+	static const std::string kCookForceOption = "--force";
+
+	struct AssetCookType
+	{
+		std::string typeName;
+		AssetReflectionInfo info;
+	};
+
+	struct AssetCookItem
+	{
+		std::filesystem::path srcPath;
+		std::filesystem::path savePath;
+
+		const AssetCookType* type = nullptr;
+
+		// Target already exist in project and its source unchanged, no cook.
+		bool bSkipped = false;
+
+		// Target already exist, cook again as reimport because source changed or force.
+		bool bRecook = false;
+
+		// Import settings of exist target, recook keep them.
+		std::vector<uint8_t> settings;
+
+		// Index of job graph group, -1 if skipped.
+		int32_t group = -1;
+	};
+
+	static std::string toLowerExtension(const std::filesystem::path& path)
+	{
+		std::string extension = utf8::utf16to8(path.extension().u16string());
+		if (extension.starts_with("."))
+		{
+			extension.erase(0, 1);
+		}
+
+		std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+		return extension;
+	}
+
+	// Raw file extension to import type, first group of importRawAssetExtension list all extensions of the type.
+	static std::unordered_map<std::string, AssetCookType> collectCookTypes()
+	{
+		std::unordered_map<std::string, AssetCookType> result { };
+
+		for (auto& assetType : rttr::type::get<AssetInterface>().get_derived_classes())
+		{
+			const auto& method = assetType.get_method("uiGetAssetReflectionInfo");
+			if (!method.is_static() || !method.is_valid())
+			{
+				continue;
+			}
+
+			rttr::variant returnValue = method.invoke({});
+			if (!returnValue.is_valid() || !returnValue.is_type<AssetReflectionInfo>())
+			{
+				continue;
+			}
+
+			const auto& meta = returnValue.get_value<AssetReflectionInfo>();
+			if (!meta.importConfig.bImportable || !meta.importConfig.buildAssetImportConfig)
+			{
+				continue;
+			}
+
+			const std::string& extensions = meta.importConfig.importRawAssetExtension;
+			std::stringstream ss(extensions.substr(0, extensions.find(';')));
+
+			std::string extension;
+			while (std::getline(ss, extension, ','))
+			{
+				result[extension] = { std::string(assetType.get_name()), meta };
+			}
+		}
+
+		return result;
+	}
+
+	// Static mesh save path is a folder, other asset save file beside save path with type suffix.
+	static bool isCookTargetExist(const std::filesystem::path& savePath)
+	{
+		if (std::filesystem::exists(savePath))
+		{
+			return true;
+		}
+
+		for (size_t i = 0; i < size_t(EAssetType::max); i++)
+		{
+			auto assetPath = savePath;
+			assetPath += utf8::utf8to16(std::format(".{}", nameof::nameof_enum(EAssetType(i))));
+
+			if (std::filesystem::exists(assetPath))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Index entry of exist cook target, static mesh asset file is inside save path folder with folder name.
+	static const AssetIndexEntry* findCookTargetIndexEntry(const std::filesystem::path& assetPath, const std::filesystem::path& savePath)
+	{
+		for (size_t i = 0; i < size_t(EAssetType::max); i++)
+		{
+			const auto suffix = utf8::utf8to16(std::format(".{}", nameof::nameof_enum(EAssetType(i))));
+
+			auto assetFilePath = savePath;
+			assetFilePath += suffix;
+			if (const auto* entry = getAssetManager()->getAssetIndexEntry(buildRelativePathUtf8(assetPath, assetFilePath)))
+			{
+				return entry;
+			}
+
+			const auto folderAssetFilePath = savePath / (savePath.filename().u16string() + suffix);
+			if (const auto* entry = getAssetManager()->getAssetIndexEntry(buildRelativePathUtf8(assetPath, folderAssetFilePath)))
+			{
+				return entry;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool engine::isAssetCookCommandLine(int argc, char** argv)
+	{
+		return argc > 1 && kCookCommand == argv[1];
+	}
+
+	int engine::runAssetCookCommandLine(int argc, char** argv)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		const auto cookStartTime = Clock::now();
+
+		CHECK(isAssetCookCommandLine(argc, argv));
+		if (argc < 3)
+		{
+			LOG_ERROR("Usage: dark --cook <project.dark> [sources...] [--summary <path>] [--force].");
+			return 1;
+		}
+
+		const std::filesystem::path projectPath = std::filesystem::absolute(utf8::utf8to16(argv[2]));
+		if (!std::filesystem::is_regular_file(projectPath))
+		{
+			LOG_ERROR("Project file {} not exist, cook fail.", argv[2]);
+			return 1;
+		}
+
+		std::vector<std::filesystem::path> sources { };
+		std::filesystem::path summaryPath = projectPath.parent_path() / "log" / "cook_summary.json";
+		bool bForce = false;
+		for (int i = 3; i < argc; i++)
+		{
+			if (kCookSummaryOption == argv[i] && i + 1 < argc)
+			{
+				summaryPath = utf8::utf8to16(argv[++i]);
+			}
+			else if (kCookForceOption == argv[i])
+			{
+				bForce = true;
+			}
+			else
+			{
+				sources.push_back(std::filesystem::absolute(utf8::utf8to16(argv[i])));
+			}
+		}
+
+		if (sources.empty())
+		{
+			sources.push_back(projectPath.parent_path() / "raw");
+		}
+
+		if (!Engine::get()->initHeadless())
+		{
+			LOG_ERROR("Headless engine init fail, cook fail.");
+			return 1;
+		}
+
+		getAssetManager()->setupProject(projectPath);
+		const std::filesystem::path assetPath = getAssetManager()->getProjectConfig().assetPath;
+
+		// Collect cook items, folder keep relative layout under asset folder.
+		const auto cookTypes = collectCookTypes();
+		std::vector<AssetCookItem> items { };
+		std::unordered_set<std::filesystem::path> savePaths { };
+		auto addItem = [&](const std::filesystem::path& srcPath, const std::filesystem::path& savePath, bool bWarnUnknownType)
+		{
+			const auto typeIter = cookTypes.find(toLowerExtension(srcPath));
+			if (typeIter == cookTypes.end())
+			{
+				if (bWarnUnknownType)
+				{
+					LOG_WARN("Source {} type unknown, skip.", utf8::utf16to8(srcPath.u16string()));
+				}
+				return;
+			}
+
+			if (savePaths.contains(savePath))
+			{
+				LOG_WARN("Source {} cook target conflict with other source, skip.", utf8::utf16to8(srcPath.u16string()));
+				return;
+			}
+			savePaths.insert(savePath);
+
+			AssetCookItem item { };
+			item.srcPath = srcPath;
+			item.savePath = savePath;
+			item.type = &typeIter->second;
+
+			// Exist target recook when force or its import source changed, target without import source only recook by force.
+			if (isCookTargetExist(savePath))
+			{
+				// Target import from other source keep default settings.
+				const auto* entry = findCookTargetIndexEntry(assetPath, savePath);
+				const bool bHasSource = entry && !entry->importSource.empty();
+				const bool bSameSource = bHasSource && std::filesystem::path(utf8::utf8to16(entry->importSource.path)) == srcPath;
+				if (bSameSource)
+				{
+					item.settings = entry->importSource.settings;
+				}
+
+				if (bForce)
+				{
+					item.bRecook = true;
+				}
+				else if (bHasSource)
+				{
+					item.bRecook = !bSameSource || checkAssetImportSource(entry->importSource) == EAssetImportSourceState::Changed;
+				}
+
+				item.bSkipped = !item.bRecook;
+			}
+
+			items.push_back(item);
+		};
+
+		for (const auto& source : sources)
+		{
+			std::error_code ec;
+			if (std::filesystem::is_directory(source, ec))
+			{
+				for (const auto& entry : std::filesystem::recursive_directory_iterator(source, ec))
+				{
+					if (entry.is_regular_file(ec))
+					{
+						const auto relativePath = std::filesystem::relative(entry.path(), source, ec);
+						addItem(entry.path(), assetPath / relativePath.parent_path() / relativePath.stem(), false);
+					}
+				}
+			}
+			else if (std::filesystem::is_regular_file(source, ec))
+			{
+				addItem(source, assetPath / source.stem(), true);
+			}
+			else
+			{
+				LOG_WARN("Source {} not exist, skip.", utf8::utf16to8(source.u16string()));
+			}
+		}
+
+		// All assets cook in one graph so heavy stages balance across whole library.
+		ImportJobGraph graph;
+		uint32_t groupCount = 0;
+		for (auto& item : items)
+		{
+			if (item.bSkipped)
+			{
+				continue;
+			}
+
+			std::error_code ec;
+			std::filesystem::create_directories(item.savePath.parent_path(), ec);
+
+			auto config = item.type->info.importConfig.buildAssetImportConfig();
+			config->path = { item.srcPath, item.savePath };
+			config->bReimport = item.bRecook;
+			if (!item.settings.empty())
+			{
+				MemoryViewStreamBuffer buffer(item.settings.data(), item.settings.size());
+				std::istream is(&buffer);
+				cereal::BinaryInputArchive archive(is);
+				config->loadSettings(archive);
+			}
+
+			item.group = int32_t(groupCount++);
+			graph.beginGroup(utf8::utf16to8(item.srcPath.u16string()));
+			buildAssetImportJobs(item.type->info, config, graph);
+			graph.endGroup();
+		}
+
+		const size_t recookCount = std::count_if(items.begin(), items.end(), [](const AssetCookItem& item) { return item.bRecook; });
+		LOG_INFO("Cook {} assets on {} threads, {} recook exist, {} skipped because exist and source unchanged.",
+			groupCount, Engine::get()->getThreadPool()->getThreadCount(), recookCount, items.size() - groupCount);
+
+		graph.execute();
+		{
+			// Progress log for long cook, build box console has no ui.
+			int32_t prevPercent = -1;
+			while (!graph.isFinished())
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+				const int32_t percent = int32_t(graph.getProgress() * 100.0f);
+				if (percent / 10 != prevPercent / 10)
+				{
+					prevPercent = percent;
+					LOG_INFO("Cook progress {}%.", percent);
+				}
+			}
+			graph.wait();
+		}
+
+		// Recook assets save aside, replace exist files now.
+		getAssetManager()->commitReimportAssets();
+
+		const auto groupStats = graph.getGroupStats();
+		const double cookTime = std::chrono::duration<double, std::milli>(Clock::now() - cookStartTime).count();
+
+		// Per asset timings and json summary.
+		nlohmann::json summary { };
+		nlohmann::json assets = nlohmann::json::array();
+
+		uint32_t succeedCount = 0;
+		uint32_t failedCount = 0;
+		uint32_t skippedCount = 0;
+		for (const auto& item : items)
+		{
+			const std::string srcUtf8 = utf8::utf16to8(item.srcPath.u16string());
+
+			nlohmann::json asset { };
+			asset["source"] = srcUtf8;
+			asset["target"] = buildRelativePathUtf8(assetPath, item.savePath);
+			asset["type"] = item.type->typeName;
+
+			if (item.bSkipped)
+			{
+				skippedCount++;
+				asset["result"] = "skipped";
+			}
+			else
+			{
+				const auto& stat = groupStats[item.group];
+
+				// Cancel or fail job skip its dependents, asset only succeed when all jobs run.
+				const bool bSucceed = (stat.failedCount == 0) && (stat.finishedCount == stat.jobCount);
+				if (bSucceed)
+				{
+					succeedCount++;
+					LOG_INFO("Cook {} succeed, wall {:.2f} ms, job {:.2f} ms, {} jobs.", srcUtf8, stat.wallTime, stat.jobTime, stat.jobCount);
+				}
+				else
+				{
+					failedCount++;
+					LOG_ERROR("Cook {} fail, {} of {} jobs fail.", srcUtf8, stat.failedCount, stat.jobCount);
+				}
+
+				asset["result"] = bSucceed ? "succeeded" : "failed";
+				asset["recook"] = item.bRecook;
+				asset["wallTimeMs"] = stat.wallTime;
+				asset["jobTimeMs"] = stat.jobTime;
+				asset["jobCount"] = stat.jobCount;
+				asset["failedJobCount"] = stat.failedCount;
+			}
+
+			assets.push_back(asset);
+		}
+
+		nlohmann::json stages { };
+		for (size_t i = 0; i < size_t(EImportJobStage::Max); i++)
+		{
+			const auto stage = EImportJobStage(i);
+			stages[ImportJobGraph::getStageName(stage)] = graph.getStageProgress(stage).total;
+		}
+
+		summary["project"] = utf8::utf16to8(projectPath.u16string());
+		summary["threadCount"] = Engine::get()->getThreadPool()->getThreadCount();
+		summary["totalTimeMs"] = cookTime;
+		summary["succeededCount"] = succeedCount;
+		summary["failedCount"] = failedCount;
+		summary["skippedCount"] = skippedCount;
+		summary["stageJobCount"] = stages;
+		summary["assets"] = assets;
+
+		{
+			std::error_code ec;
+			std::filesystem::create_directories(summaryPath.parent_path(), ec);
+
+			std::ofstream os(summaryPath);
+			os << summary.dump(4);
+			if (!os)
+			{
+				LOG_ERROR("Cook summary write to {} fail.", utf8::utf16to8(summaryPath.u16string()));
+			}
+		}
+
+		LOG_INFO("Cook finish in {:.2f} ms, {} succeed, {} fail, {} skipped, summary write to {}.",
+			cookTime, succeedCount, failedCount, skippedCount, utf8::utf16to8(summaryPath.u16string()));
+
+		if (!Engine::get()->releaseHeadless())
+		{
+			LOG_ERROR("Headless engine release fail.");
+			return 1;
+		}
+
+		return failedCount > 0 ? 1 : 0;
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "asset_common.h"
+
+namespace engine
+{
+	// Headless asset cook, import raw sources into project without window, vulkan context and ui.
+	// Usage: dark --cook <project.dark> [sources...] [--summary <path>] [--force]
+	//   sources: raw files or folders, folder cook recursively and keep its layout under project asset folder,
+	//            default is raw folder beside project file.
+	//   summary: json summary of cook result and timings, default is cook_summary.json in project log folder.
+	//   force:   recook all targets which already exist in project.
+	// Exist target recook when its import source changed, skip when unchanged, import type pick by raw file extension.
+	extern bool isAssetCookCommandLine(int argc, char** argv);
+
+	// Return process exit code, zero when all assets cook succeed.
+	extern int runAssetCookCommandLine(int argc, char** argv);
+}
@@ -1,15 +1,202 @@
 #include "asset_manager.h"
+#include "asset_reimport.h"
+#include "derived_data_cache.h"
+#include "import_job_graph.h"
+#include "gltf_import.h"
+#include "texture_bc.h"
 #include "../graphics/context.h"
 #include "../engine.h"
 
 namespace engine
 {
+	static AutoCVarCmd cVarBenchmarkBinLoad("cmd.asset.benchmarkBinLoad", "Benchmark load time and resident memory of legacy and mapped bin load path.");
+	static AutoCVarCmd cVarDerivedDataCacheStat("cmd.asset.ddc.stat", "Log derived data cache hit/miss statistics.");
+	static AutoCVarCmd cVarDerivedDataCacheClear("cmd.asset.ddc.clear", "Remove all derived data cache entries.");
+	static AutoCVarCmd cVarBenchmarkStaticMeshImport("cmd.asset.benchmarkStaticMeshImport", "Benchmark assimp and native gltf static mesh import time.");
+	static AutoCVarCmd cVarBenchmarkBCEncode("cmd.asset.benchmarkBCEncode", "Benchmark speed and quality of stb_dxt and simd block compression encoders.");
+	static AutoCVarCmd cVarReimportChanged("cmd.asset.reimportChanged", "Reimport assets whose raw source changed, and refresh their dependents.");
+
+	static AutoCVarInt32 cVarReimportDetectOnStartup(
+		"asset.reimport.detectOnStartup",
+		"Check raw source of imported assets when project setup, reimport changed ones in background.",
+		"Asset",
+		0,
+		CVarFlags::ReadAndWrite);
+
+	static AutoCVarString cVarBenchmarkStaticMeshImportPath(
+		"asset.benchmark.staticMeshImportPath",
+		"Raw mesh path used by static mesh import benchmark.",
+		"Asset",
+		"",
+		CVarFlags::ReadAndWrite);
+
+	static AutoCVarString cVarBenchmarkBCImageFolder(
+		"asset.benchmark.bcImageFolder",
+		"Image folder used by block compression encode benchmark.",
+		"Asset",
+		"",
+		CVarFlags::ReadAndWrite);
+
+	struct BinLoadBenchmarkResult
+	{
+		double milliseconds = 0.0;
+		size_t residentGrow = 0;
+	};
+
+	static size_t getResidentGrow(const ProcessMemoryStat& before)
+	{
+		const size_t now = getProcessMemoryStat().residentSize;
+		return now > before.residentSize ? now - before.residentSize : 0;
+	}
+
+	// Legacy single lz4 block file, only for benchmark compare.
+	static void saveLegacyBin(const std::vector<uint8_t>& payload, const std::filesystem::path& path)
+	{
+		std::string originalData;
+		{
+			std::stringstream ss;
+			cereal::BinaryOutputArchive archive(ss);
+			archive(payload);
+			originalData = std::move(ss.str());
+		}
+
+		std::vector<char> compressedData(LZ4_compressBound((int)originalData.size()));
+
+		AssetCompressionHelper sizeHelper;
+		sizeHelper.originalSize = (int)originalData.size();
+		sizeHelper.compressionSize = LZ4_compress_default(
+			originalData.c_str(), compressedData.data(), (int)originalData.size(), (int)compressedData.size());
+		compressedData.resize(sizeHelper.compressionSize);
+
+		std::ofstream os(path, std::ios::binary);
+		cereal::BinaryOutputArchive archive(os);
+		archive(sizeHelper, compressedData);
+	}
+
+	// Legacy load path: ifstream + cereal -> vector -> lz4 -> string -> stringstream -> cereal.
+	static BinLoadBenchmarkResult benchmarkLegacyBinLoad(const std::filesystem::path& path, void* dest)
+	{
+		BinLoadBenchmarkResult result{ };
+		const auto memoryBefore = getProcessMemoryStat();
+		const auto timeBefore = std::chrono::high_resolution_clock::now();
+		{
+			AssetCompressionHelper sizeHelper;
+			std::vector<char> compressionData;
+			{
+				std::ifstream is(path, std::ios::binary);
+				cereal::BinaryInputArchive archive(is);
+				archive(sizeHelper, compressionData);
+			}
+
+			std::vector<char> decompressionData(sizeHelper.originalSize);
+			LZ4_decompress_safe(compressionData.data(), decompressionData.data(), sizeHelper.compressionSize, sizeHelper.originalSize);
+
+			std::string str(decompressionData.data(), decompressionData.size());
+			std::stringstream ss;
+			ss << std::move(str);
+			cereal::BinaryInputArchive archive(ss);
+
+			std::vector<uint8_t> payload;
+			archive(payload);
+			memcpy(dest, payload.data(), payload.size());
+
+			// All intermediate copies still alive here.
+			result.residentGrow = getResidentGrow(memoryBefore);
+		}
+		result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - timeBefore).count();
+		return result;
+	}
+
+	// Mapped load path: decompress each stream chunks from file mapping into destination in parallel.
+	static BinLoadBenchmarkResult benchmarkMappedBinLoad(const std::filesystem::path& path, void* dest)
+	{
+		BinLoadBenchmarkResult result{ };
+		const auto memoryBefore = getProcessMemoryStat();
+		const auto timeBefore = std::chrono::high_resolution_clock::now();
+		{
+			AssetBinaryStreamReader reader{};
+			CHECK(reader.open(path));
+
+			size_t offset = 0;
+			for (uint32_t i = 0; i < reader.getStreamCount(); i++)
+			{
+				CHECK(reader.decompressStream(i, (char*)dest + offset, Engine::get()->getThreadPool()));
+				offset += reader.getStreamSize(i);
+			}
+
+			result.residentGrow = getResidentGrow(memoryBefore);
+		}
+		result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - timeBefore).count();
+		return result;
+	}
+
+	static void benchmarkBinLoad(const std::vector<std::filesystem::path>& binPaths, const std::filesystem::path& tempPath)
+	{
+		BinLoadBenchmarkResult legacyTotal{ };
+		BinLoadBenchmarkResult mappedTotal{ };
+		size_t legacyPeak = 0;
+		size_t mappedPeak = 0;
+		size_t totalSize = 0;
+		size_t fileCount = 0;
+
+		for (const auto& binPath : binPaths)
+		{
+			AssetBinaryStreamReader reader{};
+			if (!reader.open(binPath))
+			{
+				continue;
+			}
+
+			// Destination simulate stage buffer, already resident before load.
+			std::vector<uint8_t> dest(reader.getTotalSize(), 0);
+
+			// Rebuild same payload as legacy single block bin file.
+			{
+				size_t offset = 0;
+				for (uint32_t i = 0; i < reader.getStreamCount(); i++)
+				{
+					CHECK(reader.decompressStream(i, dest.data() + offset));
+					offset += reader.getStreamSize(i);
+				}
+				saveLegacyBin(dest, tempPath);
+			}
+
+			const auto mapped = benchmarkMappedBinLoad(binPath, dest.data());
+			const auto legacy = benchmarkLegacyBinLoad(tempPath, dest.data());
+
+			mappedTotal.milliseconds += mapped.milliseconds;
+			legacyTotal.milliseconds += legacy.milliseconds;
+			mappedPeak = std::max(mappedPeak, mapped.residentGrow);
+			legacyPeak = std::max(legacyPeak, legacy.residentGrow);
+
+			totalSize += dest.size();
+			fileCount++;
+		}
+		std::filesystem::remove(tempPath);
+
+		const double kMB = 1024.0 * 1024.0;
+		LOG_INFO("Bin load benchmark: {0} files, {1:.2f} MB payload.", fileCount, totalSize / kMB);
+		LOG_INFO("  Legacy path: {0:.2f} ms, max resident grow {1:.2f} MB.", legacyTotal.milliseconds, legacyPeak / kMB);
+		LOG_INFO("  Mapped path: {0:.2f} ms, max resident grow {1:.2f} MB.", mappedTotal.milliseconds, mappedPeak / kMB);
+		LOG_INFO("  Process peak resident: {0:.2f} MB.", getProcessMemoryStat().peakResidentSize / kMB);
+	}
+
+	const uint32_t AssetIndex::kVersion = 2;
+
 	AssetManager* engine::getAssetManager()
 	{
 		static AssetManager* manager = Engine::get()->getRuntimeModule<AssetManager>();
 		return manager;
 	}
 
+	AssetManager::AssetManager(Engine* engine)
+		: IRuntimeModule(engine)
+	{
+
+	}
+
+	AssetManager::~AssetManager() = default;
+
 	void AssetManager::registerCheck(Engine* engine)
 	{
 	}
@@ -21,16 +208,168 @@ namespace engine
 
 	bool AssetManager::tick(const RuntimeModuleTickData& tickData)
 	{
+		flushAssetIndex();
+		return tickAssets(tickData);
+	}
+
+	void AssetManager::registerTickTasks(FrameTaskGraph& graph)
+	{
+		// Index save only touch disk, overlap with whole frame.
+		graph.addTask({ "AssetManager::flushAssetIndex", { }, { ETickResource::AssetIndex }, false, [this](const RuntimeModuleTickData&)
+		{
+			flushAssetIndex();
+			return true;
+		}});
+
+		graph.addTask({ "AssetManager::tickAssets", { }, { ETickResource::Asset, ETickResource::GPUAsset }, true, [this](const RuntimeModuleTickData& tickData)
+		{
+			return tickAssets(tickData);
+		}});
+	}
+
+	void AssetManager::flushAssetIndex()
+	{
+		// Flush project index once per frame when some asset saved.
+		std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+		if (m_bProjectSetup && m_bAssetIndexDirty)
+		{
+			saveAssetIndex();
+		}
+	}
+
+	bool AssetManager::tickAssets(const RuntimeModuleTickData& tickData)
+	{
+		// Background reimport finish, replace assets on main thread.
+		bool bReimportFinished;
+		{
+			std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+			bReimportFinished = m_reimportGraph ? m_reimportGraph->isFinished() : !m_reimportAssets.empty();
+		}
+
+		if (bReimportFinished)
+		{
+			commitReimportAssets();
+		}
+
+		CVarCmdHandle(cVarReimportChanged, [&]()
+		{
+			reimportChangedAssets();
+		});
+
+		CVarCmdHandle(cVarBenchmarkBinLoad, [&]()
+		{
+			if (!m_bProjectSetup)
+			{
+				LOG_WARN("Project not setup, skip bin load benchmark.");
+				return;
+			}
+
+			std::vector<std::filesystem::path> binPaths{ };
+			{
+				std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+				for (const auto& [uuid, entry] : m_assetIndex.entries)
+				{
+					if (entry.type == EAssetType::darkstaticmesh || entry.type == EAssetType::darktexture)
+					{
+						const auto saveInfo = AssetSaveInfo::buildRelativeProject(std::filesystem::path(m_projectConfig.assetPath) / utf8::utf8to16(uuid));
+						binPaths.push_back(std::filesystem::path(m_projectConfig.cachePath) / utf8::utf8to16(saveInfo.getBinUUID()));
+					}
+				}
+			}
+
+			benchmarkBinLoad(binPaths, std::filesystem::path(m_projectConfig.cachePath) / "benchmark_legacy_bin");
+		});
+
+		CVarCmdHandle(cVarDerivedDataCacheStat, [&]()
+		{
+			if (auto* cache = getDerivedDataCache())
+			{
+				cache->logStat();
+			}
+			else
+			{
+				LOG_INFO("Derived data cache is disable.");
+			}
+		});
+
+		CVarCmdHandle(cVarDerivedDataCacheClear, [&]()
+		{
+			if (auto* cache = getDerivedDataCache())
+			{
+				cache->clear();
+			}
+		});
+
+		CVarCmdHandle(cVarBenchmarkStaticMeshImport, [&]()
+		{
+			const std::filesystem::path rawMeshPath = utf8::utf8to16(cVarBenchmarkStaticMeshImportPath.get());
+			if (!std::filesystem::exists(rawMeshPath))
+			{
+				LOG_WARN("Raw mesh {} not exist, set asset.benchmark.staticMeshImportPath first.", cVarBenchmarkStaticMeshImportPath.get());
+				return;
+			}
+
+			benchmarkStaticMeshImport(rawMeshPath);
+		});
+
+		CVarCmdHandle(cVarBenchmarkBCEncode, [&]()
+		{
+			const std::filesystem::path imageFolder = utf8::utf8to16(cVarBenchmarkBCImageFolder.get());
+			if (!std::filesystem::is_directory(imageFolder))
+			{
+				LOG_WARN("Image folder {} not exist, set asset.benchmark.bcImageFolder first.", cVarBenchmarkBCImageFolder.get());
+				return;
+			}
+
+			benchmarkBCEncode(imageFolder);
+		});
+
 		return true;
 	}
 
 	bool AssetManager::beforeRelease()
 	{
+		// Reimport jobs lock manager, stop them before lock.
+		std::unique_ptr<ImportJobGraph> reimportGraph;
+		{
+			std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+			reimportGraph = std::move(m_reimportGraph);
+		}
+
+		if (reimportGraph)
+		{
+			reimportGraph->cancel();
+			reimportGraph->wait();
+		}
+
+		std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+		for (const auto& [uuid, asset] : m_reimportAssets)
+		{
+			asset->discardSaveAside();
+		}
+		m_reimportAssets.clear();
+
+		if (m_bProjectSetup && m_bAssetIndexDirty)
+		{
+			saveAssetIndex();
+		}
+
+		// Report derived data cache efficiency of this session.
+		if (auto* cache = getDerivedDataCache())
+		{
+			const auto stat = cache->getStat();
+			if (stat.hitCount + stat.missCount > 0)
+			{
+				cache->logStat();
+			}
+		}
+
 		return true;
 	}
 
 	bool AssetManager::release()
 	{
+		unmountAssetPacks();
 		return true;
 	}
 
@@ -38,41 +377,451 @@ namespace engine
 	{
         ZoneScopedN("vAssetManager::setupProject(const std::filesystem::path&)");
 
-		m_bProjectSetup = true;
+		ProjectConfig projectConfig { };
+		projectConfig.rootPath        = inProjectPath.parent_path().u16string();
+		projectConfig.projectFilePath = inProjectPath.u16string();
+		projectConfig.projectName     = inProjectPath.filename().replace_extension().u16string();
+		projectConfig.assetPath       = (inProjectPath.parent_path() / "asset" ).u16string();
+		projectConfig.cachePath       = (inProjectPath.parent_path() / "cache" ).u16string();
+		projectConfig.configPath      = (inProjectPath.parent_path() / "config").u16string();
+		projectConfig.logPath         = (inProjectPath.parent_path() / "log"   ).u16string();
+		projectConfig.packPath        = (inProjectPath.parent_path() / "pack"  ).u16string();
+		{
+			std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+			m_projectConfig = std::move(projectConfig);
+		}
+
+		using Clock = std::chrono::high_resolution_clock;
+		auto getMilliseconds = [](Clock::time_point start)
+		{
+			return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		};
+
+		// Packed project read index, asset files and bins from pack, no per file open.
+		mountAssetPacks(m_projectConfig.packPath, m_projectConfig.rootPath);
+
+		// Previous project index, asset file unchanged since index build register without deserialize.
+		AssetIndex prevIndex { };
+		{
+			ZoneScopedN("AssetManager::setupProject load index");
+			const auto startTime = Clock::now();
+
+			loadAssetIndex(prevIndex);
+
+			LOG_INFO("Project setup load index: {0} entries, {1:.2f} ms.", prevIndex.entries.size(), getMilliseconds(startTime));
+		}
+
+		// Scan whole asset folder to collect asset files.
+		std::vector<std::filesystem::path> assetPaths { };
+		{
+			ZoneScopedN("AssetManager::setupProject scan");
+			const auto startTime = Clock::now();
+
+			scanProjectAssetPaths(m_projectConfig.assetPath, assetPaths);
+
+			// Packed assets which have no loose file.
+			if (isAssetPackMounted())
+			{
+				const std::unordered_set<std::filesystem::path> loosePaths(assetPaths.begin(), assetPaths.end());
+
+				std::vector<std::filesystem::path> packedPaths { };
+				collectAssetPackFiles(m_projectConfig.assetPath, ".dark", packedPaths);
+
+				for (auto& path : packedPaths)
+				{
+					if (!loosePaths.contains(path))
+					{
+						assetPaths.push_back(std::move(path));
+					}
+				}
+			}
+
+			LOG_INFO("Project setup scan: {0} files, {1:.2f} ms.", assetPaths.size(), getMilliseconds(startTime));
+		}
 
-		m_projectConfig.rootPath        = inProjectPath.parent_path().u16string();
-		m_projectConfig.projectFilePath = inProjectPath.u16string();
-		m_projectConfig.projectName     = inProjectPath.filename().replace_extension().u16string();
-		m_projectConfig.assetPath       = (inProjectPath.parent_path() / "asset" ).u16string();
-		m_projectConfig.cachePath       = (inProjectPath.parent_path() / "cache" ).u16string();
-		m_projectConfig.configPath      = (inProjectPath.parent_path() / "config").u16string();
-		m_projectConfig.logPath         = (inProjectPath.parent_path() / "log"   ).u16string();
+		// Stat, read and deserialize on thread pool, no manager lock require here.
+		struct SetupAssetItem
+		{
+			UUID uuid;
+			const AssetIndexEntry* indexEntry = nullptr;
+			std::shared_ptr<AssetInterface> asset = nullptr;
+		};
+		std::vector<SetupAssetItem> items(assetPaths.size());
+		{
+			ZoneScopedN("AssetManager::setupProject load");
+			const auto startTime = Clock::now();
+
+			std::atomic<size_t> finishedCount = 0;
+			const auto loop = [&](const size_t loopStart, const size_t loopEnd)
+			{
+				for (size_t i = loopStart; i < loopEnd; ++i)
+				{
+					const auto& path = assetPaths[i];
+					auto& item = items[i];
+
+					item.uuid = AssetSaveInfo::buildRelativeProject(path).getUUID();
+
+					int64_t fileTime;
+					uint64_t fileSize;
+					getAssetFileStamp(path, fileTime, fileSize);
+
+					auto iter = prevIndex.entries.find(item.uuid);
+					if (iter != prevIndex.entries.end() &&
+						iter->second.fileTime == fileTime &&
+						iter->second.fileSize == fileSize)
+					{
+						item.indexEntry = &iter->second;
+					}
+					else if (!loadAsset(item.asset, path))
+					{
+						// New or modified asset, deserialize to rebuild index entry.
+						LOG_ERROR("Asset {} load failed when setup project.", utf8::utf16to8(path.u16string()));
+						item.asset = nullptr;
+					}
+
+					finishedCount++;
+				}
+			};
+
+			// More blocks than threads, deserialize cost vary a lot between asset types.
+			auto* threadPool = Engine::get()->getThreadPool();
+			auto futures = threadPool->parallelizeLoop(0, items.size(), loop, threadPool->getThreadCount() * 8);
+
+			for (auto& future : futures.futures)
+			{
+				while (future.wait_for(std::chrono::milliseconds(10)) != std::future_status::ready)
+				{
+					onProjectSetupProgress.broadcast(finishedCount.load(), items.size());
+				}
+			}
+			onProjectSetupProgress.broadcast(items.size(), items.size());
 
-		// Scan whole asset folder to setup asset uuid map.
-		setupProjectRecursive(m_projectConfig.assetPath);
+			LOG_INFO("Project setup load: {0} assets, {1:.2f} ms on {2} threads.", 
+				items.size(), getMilliseconds(startTime), threadPool->getThreadCount());
+		}
+
+		// Only map insert serialized.
+		size_t indexedCount = 0;
+		size_t loadedCount = 0;
+		{
+			ZoneScopedN("AssetManager::setupProject register");
+			const auto startTime = Clock::now();
+
+			std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+			m_assetIndex = { };
+			for (size_t i = 0; i < items.size(); i++)
+			{
+				const auto& item = items[i];
+				if (item.indexEntry)
+				{
+					registerIndexedAsset(*item.indexEntry);
+					indexedCount++;
+				}
+				else if (item.asset)
+				{
+					insertAsset(item.uuid, item.asset, false);
+					m_assetIndex.entries[item.uuid] = buildAssetIndexEntry(item.asset, assetPaths[i]);
+					loadedCount++;
+				}
+			}
+
+			// Some entry stale or removed, index need to rewrite.
+			if (loadedCount > 0 || prevIndex.entries.size() != m_assetIndex.entries.size())
+			{
+				saveAssetIndex();
+			}
+
+			// Main thread read index and config once see setup flag.
+			m_bProjectSetup.store(true, std::memory_order_release);
+
+			LOG_INFO("Project setup register: {0:.2f} ms.", getMilliseconds(startTime));
+		}
+
+		LOG_INFO("Project setup with {0} assets, {1} register from index, {2} deserialized.", 
+			assetPaths.size(), indexedCount, loadedCount);
+
+		// Pick up raw source edits since last session, headless cook skip.
+		if (cVarReimportDetectOnStartup.get() != 0 && Engine::get()->isWindowApplication())
+		{
+			reimportChangedAssets();
+		}
 	}
 
-	void AssetManager::setupProjectRecursive(const std::filesystem::path& path)
+	bool AssetManager::reimportChangedAssets()
 	{
-        ZoneScopedN("AssetManager::setupProjectRecursive(const std::filesystem::path&)");
-		const bool bFolder = std::filesystem::is_directory(path);
-		if (bFolder)
+		std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+
+		if (!m_bProjectSetup)
+		{
+			LOG_WARN("Project not setup, skip reimport.");
+			return false;
+		}
+
+		if (m_reimportGraph || !m_reimportAssets.empty())
+		{
+			LOG_WARN("Last reimport still running, skip reimport.");
+			return false;
+		}
+
+		std::vector<AssetIndexEntry> entries { };
+		for (const auto& [uuid, entry] : m_assetIndex.entries)
+		{
+			if (!entry.importSource.empty())
+			{
+				entries.push_back(entry);
+			}
+		}
+
+		m_reimportGraph = std::make_unique<ImportJobGraph>();
+		buildReimportChangedJobs(std::move(entries), *m_reimportGraph);
+		m_reimportGraph->execute();
+
+		return true;
+	}
+
+	void AssetManager::commitReimportAssets()
+	{
+		// Reimport jobs lock manager, wait without lock.
+		std::unique_ptr<ImportJobGraph> reimportGraph;
+		{
+			std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+			reimportGraph = std::move(m_reimportGraph);
+		}
+
+		if (reimportGraph)
 		{
-			for (const auto& entry : std::filesystem::directory_iterator(path))
+			reimportGraph->wait();
+			if (reimportGraph->getFailedCount() > 0)
 			{
-				setupProjectRecursive(entry);
+				LOG_ERROR("Reimport finish with {} jobs fail.", reimportGraph->getFailedCount());
 			}
 		}
-		else
+
+		std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+
+		std::vector<UUID> refreshIds { };
+		for (auto iter = m_reimportAssets.begin(); iter != m_reimportAssets.end();)
+		{
+			const UUID uuid = iter->first;
+			const auto asset = iter->second;
+
+			// Import fail before save, keep exist asset.
+			if (asset->isDirty())
+			{
+				LOG_WARN("Asset {} reimport fail, keep exist asset.", uuid);
+				asset->discardSaveAside();
+				iter = m_reimportAssets.erase(iter);
+				continue;
+			}
+
+			// Old bin still map by loading task, commit next tick.
+			if (!asset->commitSaveAside())
+			{
+				++iter;
+				continue;
+			}
+			iter = m_reimportAssets.erase(iter);
+
+			m_dirtyAssetIds.erase(uuid);
+			insertAsset(uuid, asset, false);
+			updateAssetIndex(asset);
+			refreshIds.push_back(uuid);
+
+			// Cached gpu data load from old bin, evict so next use load new one.
+			if (Engine::get()->isWindowApplication())
+			{
+				getContext()->eraseLRUAsset(asset->getBinUUID());
+				getContext()->eraseLRUAsset(asset->getSnapshotUUID());
+			}
+		}
+
+		if (refreshIds.empty())
+		{
+			return;
+		}
+
+		// Dependents also refresh, such as material of texture and static mesh of material.
+		std::unordered_map<UUID, std::vector<UUID>> dependents { };
+		for (const auto& [uuid, entry] : m_assetIndex.entries)
+		{
+			for (const auto& dependency : entry.dependencies)
+			{
+				dependents[dependency].push_back(uuid);
+			}
+		}
+
+		const size_t reimportCount = refreshIds.size();
+		size_t refreshCount = 0;
+
+		m_refreshVersion++;
+		while (!refreshIds.empty())
+		{
+			const UUID id = refreshIds.back();
+			refreshIds.pop_back();
+
+			auto& version = m_assetRefreshVersions[id];
+			if (version == m_refreshVersion)
+			{
+				continue;
+			}
+
+			version = m_refreshVersion;
+			refreshCount++;
+
+			if (auto iter = dependents.find(id); iter != dependents.end())
+			{
+				refreshIds.insert(refreshIds.end(), iter->second.begin(), iter->second.end());
+			}
+		}
+
+		LOG_INFO("Reimport commit {} assets, {} assets refresh.", reimportCount, refreshCount);
+	}
+
+	void AssetManager::scanProjectAssetPaths(const std::filesystem::path& rootPath, std::vector<std::filesystem::path>& outAssetPaths)
+	{
+		auto* threadPool = Engine::get()->getThreadPool();
+
+		// Breadth first, each level folders list on thread pool, no nested wait inside worker.
+		std::vector<std::filesystem::path> folders = { rootPath };
+		while (!folders.empty())
 		{
-			const auto extension = path.extension().string();
-			if (extension.starts_with(".dark"))
+			struct ScanResult
+			{
+				std::vector<std::filesystem::path> folders;
+				std::vector<std::filesystem::path> files;
+			};
+
+			const auto loop = [&](const size_t loopStart, const size_t loopEnd)
 			{
-				tryLoadAsset(path);
+				ScanResult result { };
+				for (size_t i = loopStart; i < loopEnd; ++i)
+				{
+					std::error_code ec;
+					for (const auto& entry : std::filesystem::directory_iterator(folders[i], ec))
+					{
+						if (entry.is_directory(ec))
+						{
+							result.folders.push_back(entry.path());
+						}
+						else if (entry.path().extension().string().starts_with(".dark"))
+						{
+							result.files.push_back(entry.path());
+						}
+					}
+				}
+				return result;
+			};
+
+			auto results = threadPool->parallelizeLoop(0, folders.size(), loop).get();
+
+			folders.clear();
+			for (auto& result : results)
+			{
+				folders.insert(folders.end(), std::make_move_iterator(result.folders.begin()), std::make_move_iterator(result.folders.end()));
+				outAssetPaths.insert(outAssetPaths.end(), std::make_move_iterator(result.files.begin()), std::make_move_iterator(result.files.end()));
 			}
 		}
 	}
 
+	std::shared_ptr<AssetInterface> AssetManager::getAsset(const UUID& id)
+	{
+		std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+
+		auto iter = m_assets.find(id);
+		if (iter != m_assets.end() && iter->second)
+		{
+			return iter->second;
+		}
+
+		// Asset only registered from project index, deserialize it now.
+		if (m_assetIndex.entries.contains(id))
+		{
+			return tryLoadAsset(std::filesystem::path(m_projectConfig.assetPath) / utf8::utf8to16(id));
+		}
+
+		return m_assets.at(id);
+	}
+
+	std::filesystem::path AssetManager::getAssetIndexPath() const
+	{
+		return std::filesystem::path(m_projectConfig.cachePath) / "AssetIndex.bin";
+	}
+
+	bool AssetManager::loadAssetIndex(AssetIndex& outIndex) const
+	{
+		ZoneScoped;
+
+		const auto path = getAssetIndexPath();
+		if (!isAssetFileExist(path))
+		{
+			return false;
+		}
+
+		AssetIndex index { };
+		if (!loadAsset(index, path))
+		{
+			return false;
+		}
+
+		if (index.version != AssetIndex::kVersion || index.assetVersion != kAssetVersion)
+		{
+			LOG_INFO("Project asset index out of date, rebuild it.");
+			return false;
+		}
+
+		outIndex = std::move(index);
+		return true;
+	}
+
+	void AssetManager::saveAssetIndex()
+	{
+		ZoneScoped;
+
+		const auto path = getAssetIndexPath();
+		std::filesystem::create_directories(path.parent_path());
+
+		if (!saveAsset(m_assetIndex, path, false))
+		{
+			LOG_ERROR("Save project asset index {} failed.", utf8::utf16to8(path.u16string()));
+		}
+
+		m_bAssetIndexDirty = false;
+	}
+
+	AssetIndexEntry AssetManager::buildAssetIndexEntry(
+		std::shared_ptr<AssetInterface> asset, const std::filesystem::path& savePath) const
+	{
+		AssetIndexEntry entry { };
+
+		entry.uuid = asset->getSaveInfo().getUUID();
+		entry.type = asset->getType();
+		entry.name = asset->getName();
+		asset->collectDependencies(entry.dependencies);
+		getAssetFileStamp(savePath, entry.fileTime, entry.fileSize);
+		entry.importSource = asset->getImportSource();
+
+		return entry;
+	}
+
+	void AssetManager::registerIndexedAsset(const AssetIndexEntry& entry)
+	{
+		const std::filesystem::path storePath = utf8::utf8to16(entry.uuid);
+
+		m_assetIndex.entries[entry.uuid] = entry;
+		m_assetTypeMap[storePath.extension().string()].insert(entry.uuid);
+	}
+
+	void AssetManager::updateAssetIndex(std::shared_ptr<AssetInterface> asset)
+	{
+		if (!m_bProjectSetup || asset->getSaveInfo().isTemp())
+		{
+			return;
+		}
+
+		m_assetIndex.entries[asset->getSaveInfo().getUUID()] = buildAssetIndexEntry(asset, asset->getSavePath());
+		m_bAssetIndexDirty = true;
+	}
+
 	void AssetManager::onAssetDirty(std::shared_ptr<AssetInterface> asset)
 	{
 		std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
@@ -82,6 +831,12 @@ namespace engine
 		// You must mark asset self dirty before register in manager.
 		CHECK(asset->isDirty());
 
+		// Reimport asset build aside, import job save it directly.
+		if (isReimportAsset(asset))
+		{
+			return;
+		}
+
 		// Asset must exist.
 		CHECK(m_assets.at(id));
 
@@ -112,19 +867,32 @@ namespace engine
 
 		const auto& id = asset->getSaveInfo().getUUID();
 
-		// Must dirty before call discard.
-		CHECK(m_dirtyAssetIds.contains(id));
+		// Reimport asset never register dirty.
+		if (!isReimportAsset(asset))
+		{
+			// Must dirty before call discard.
+			CHECK(m_dirtyAssetIds.contains(id));
+
+			// Clear cache in dirty asset map and asset map.
+			m_dirtyAssetIds.erase(id);
+		}
 
-		// Clear cache in dirty asset map and asset map.
-		m_dirtyAssetIds.erase(id);
+		// Saved asset file changed, refresh its index entry. Reimport asset refresh when commit.
+		if (!isReimportAsset(asset))
+		{
+			updateAssetIndex(asset);
+		}
 	}
 
 	std::shared_ptr<AssetInterface> AssetManager::removeAsset(const UUID& id, bool bClearDirty)
 	{
 		std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
 
-		if (std::shared_ptr<AssetInterface> asset = m_assets[id])
+		auto iter = m_assets.find(id);
+		if (iter != m_assets.end() && iter->second)
 		{
+			std::shared_ptr<AssetInterface> asset = iter->second;
+
 			std::filesystem::path savePath = asset->getSaveInfo().getStorePath();
 
 			if (bClearDirty)
@@ -133,7 +901,12 @@ namespace engine
 			}
 
 			m_assets.erase(id);
-			m_assetTypeMap[savePath.extension().string()].erase(id);
+
+			// Asset still in disk keep registered by project index, can deserialize again.
+			if (!m_assetIndex.entries.contains(id))
+			{
+				m_assetTypeMap[savePath.extension().string()].erase(id);
+			}
 
 			return asset;
 		}
@@ -154,6 +927,12 @@ namespace engine
 		}
 	}
 
+	bool AssetManager::isReimportAsset(std::shared_ptr<AssetInterface> asset) const
+	{
+		auto iter = m_reimportAssets.find(asset->getSaveInfo().getUUID());
+		return iter != m_reimportAssets.end() && iter->second == asset;
+	}
+
 	void AssetManager::onAssetUnload(std::shared_ptr<AssetInterface> asset)
 	{
 		std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
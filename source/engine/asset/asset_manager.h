@@ -18,28 +18,82 @@ namespace engine
 		std::u16string configPath;
 		std::u16string logPath;
 		std::u16string cachePath;
+
+		// Pack archives mount when project setup, see asset_pack.h.
+		std::u16string packPath;
+	};
+
+	// Light weight asset record store in project index, enough to register asset without deserialize it.
+	struct AssetIndexEntry
+	{
+		UUID uuid = {};
+		EAssetType type = EAssetType::max;
+
+		// Asset name, same with save info name.
+		u8str name = {};
+
+		// Other project assets this asset reference.
+		std::vector<UUID> dependencies = {};
+
+		// Asset file state when index entry build, used to detect out of date entry.
+		int64_t fileTime = 0;
+		uint64_t fileSize = 0;
+
+		// Raw source of imported asset, so source change detect without deserialize asset.
+		AssetImportSource importSource = {};
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			uint32_t typeValue = (uint32_t)type;
+			archive(uuid, typeValue, name, dependencies, fileTime, fileSize, importSource);
+			type = (EAssetType)typeValue;
+		}
+	};
+
+	struct AssetIndex
+	{
+		// Index format version, mismatch version will rebuild whole index.
+		static const uint32_t kVersion;
+
+		uint32_t version = kVersion;
+		uint32_t assetVersion = kAssetVersion;
+
+		std::unordered_map<UUID, AssetIndexEntry> entries;
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			archive(version, assetVersion, entries);
+		}
 	};
 
+	class ImportJobGraph;
+
 	class AssetManager : public IRuntimeModule
 	{
 		friend AssetInterface;
 
 	public:
-		explicit AssetManager(Engine* engine) : IRuntimeModule(engine) { }
-		virtual ~AssetManager() = default;
+		explicit AssetManager(Engine* engine);
+		virtual ~AssetManager();
 
 		virtual void registerCheck(Engine* engine) override;
 		virtual bool init() override;
 		virtual bool tick(const RuntimeModuleTickData& tickData) override;
+		virtual void registerTickTasks(FrameTaskGraph& graph) override;
 		virtual bool beforeRelease() override;
 		virtual bool release() override;
 
 		const ProjectConfig& getProjectConfig() const { return m_projectConfig; }
+
+		// May call on other thread, project config and index publish under lock, setup flag set last.
 		void setupProject(const std::filesystem::path& inProjectPath);
 
-		void setupProjectRecursive(const std::filesystem::path& path);
-		
-		bool isProjectSetup() const { return m_bProjectSetup; }
+		// Project setup progress, (finished asset count, total asset count), broadcast on setup thread.
+		MulticastDelegate<size_t, size_t> onProjectSetupProgress;
+
+		bool isProjectSetup() const { return m_bProjectSetup.load(std::memory_order_acquire); }
 
 		template<typename T>
 		std::vector<std::weak_ptr<T>> getDirtyAsset() const
@@ -68,7 +122,7 @@ namespace engine
 		{
 			std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
 
-			return m_assets.contains(info.getUUID());
+			return m_assets.contains(info.getUUID()) || m_assetIndex.entries.contains(info.getUUID());
 		}
 
 		template<typename T>
@@ -96,6 +150,53 @@ namespace engine
 			return std::dynamic_pointer_cast<T>(newAsset);
 		}
 
+		// Reimport build new asset aside with same save info, so uuid keep stable and exist asset still usable
+		// when importing, new asset replace exist one in commitReimportAssets. Create new asset when not reimport.
+		// Reimport asset save files aside, exist asset may still map them, rename when commit.
+		template<typename T>
+		std::shared_ptr<T> createImportAsset(const AssetSaveInfo& saveInfo, bool bReimport)
+		{
+			std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+
+			if (!bReimport || !isAssetSavePathExist(saveInfo))
+			{
+				return createAsset<T>(saveInfo).lock();
+			}
+
+			auto newAsset = std::make_shared<T>(saveInfo);
+			newAsset->m_bSaveAside = true;
+			m_reimportAssets[saveInfo.getUUID()] = newAsset;
+
+			newAsset->onPostAssetConstruct();
+			return newAsset;
+		}
+
+		// Check import source of all imported assets, reimport changed ones in background.
+		// Return false if project not setup or last reimport still running.
+		bool reimportChangedAssets();
+
+		bool isReimporting() const
+		{
+			std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+
+			return m_reimportGraph != nullptr || !m_reimportAssets.empty();
+		}
+
+		// Replace exist assets with reimported assets, refresh version of them and their dependents.
+		// Call on main thread after reimport jobs finish, tick call it for background reimport.
+		// Asset whose old files still in use stay pending, tick commit it again later.
+		void commitReimportAssets();
+
+		// Version increase when asset or its dependency reimport, zero if never reimport.
+		// User which cache asset data should rebuild cache when version change.
+		uint64_t getAssetRefreshVersion(const UUID& id) const
+		{
+			std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+
+			auto iter = m_assetRefreshVersions.find(id);
+			return iter != m_assetRefreshVersions.end() ? iter->second : 0;
+		}
+
 		template<typename T>
 		std::weak_ptr<T> getOrLoadAsset(const std::filesystem::path& savePath)
 		{
@@ -108,8 +209,51 @@ namespace engine
 		MulticastDelegate<std::shared_ptr<AssetInterface>> onAssetNewlySavedToDisk;
 
 		const auto& getAssetTypeMap(const std::string& type) { return m_assetTypeMap[type]; }
-		std::shared_ptr<AssetInterface> getAsset(const UUID& id) const { return m_assets.at(id); }
+
+		// Get asset by uuid, asset only registered in project index will deserialize here.
+		std::shared_ptr<AssetInterface> getAsset(const UUID& id);
+
+		// Asset already deserialized or still only registered in project index.
+		bool isAssetLoaded(const UUID& id) const
+		{
+			std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+
+			auto iter = m_assets.find(id);
+			return iter != m_assets.end() && iter->second;
+		}
+
+		// Get project index entry, return nullptr if asset not in index, pointer invalid after index update.
+		const AssetIndexEntry* getAssetIndexEntry(const UUID& id) const
+		{
+			std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
+
+			auto iter = m_assetIndex.entries.find(id);
+			return iter != m_assetIndex.entries.end() ? &iter->second : nullptr;
+		}
+
+		std::filesystem::path getAssetIndexPath() const;
+
 	private:
+		// Collect all asset file paths under root path, scan on thread pool.
+		void scanProjectAssetPaths(const std::filesystem::path& rootPath, std::vector<std::filesystem::path>& outAssetPaths);
+
+		bool loadAssetIndex(AssetIndex& outIndex) const;
+		void saveAssetIndex();
+
+		// Save project index when some asset saved, thread safe, tick it on worker.
+		void flushAssetIndex();
+
+		// Reimport commit and cmds, tick on main thread.
+		bool tickAssets(const RuntimeModuleTickData& tickData);
+
+		// Build index entry from a deserialized asset and its file on disk.
+		AssetIndexEntry buildAssetIndexEntry(std::shared_ptr<AssetInterface> asset, const std::filesystem::path& savePath) const;
+
+		// Register asset only with index entry, no deserialize.
+		void registerIndexedAsset(const AssetIndexEntry& entry);
+
+		void updateAssetIndex(std::shared_ptr<AssetInterface> asset);
+
 		std::shared_ptr<AssetInterface> tryLoadAsset(const std::filesystem::path& savePath)
 		{
 			std::lock_guard<std::recursive_mutex> lock(m_assetManagerMutex);
@@ -118,15 +262,17 @@ namespace engine
 			const UUID& uuid = saveInfo.getUUID();
 			CHECK(saveInfo.alreadyInDisk());
 
-			if (!m_assets[uuid])
+			auto iter = m_assets.find(uuid);
+			if (iter != m_assets.end() && iter->second)
 			{
-				std::shared_ptr<AssetInterface> asset;
-				CHECK(loadAsset(asset, savePath));
-
-				insertAsset(uuid, asset, false);
+				return iter->second;
 			}
 
-			return m_assets[uuid];
+			std::shared_ptr<AssetInterface> asset;
+			CHECK(loadAsset(asset, savePath));
+
+			insertAsset(uuid, asset, false);
+			return asset;
 		}
 
 		// Discard asset edited or created state.
@@ -143,9 +289,12 @@ namespace engine
 		std::shared_ptr<AssetInterface> removeAsset(const UUID& id, bool bClearDirty);
 		void insertAsset(const UUID& uuid, std::shared_ptr<AssetInterface> asset, bool bCareDirtyState);
 
+		// Asset create by createImportAsset and not commit yet.
+		bool isReimportAsset(std::shared_ptr<AssetInterface> asset) const;
+
 
 	protected:
-		bool m_bProjectSetup = false;
+		std::atomic<bool> m_bProjectSetup = false;
 
 		ProjectConfig m_projectConfig;
 
@@ -157,6 +306,17 @@ namespace engine
 		// Map store all engine assetes.
 		std::unordered_map<UUID, std::shared_ptr<AssetInterface>> m_assets;
 		std::unordered_map<std::string, std::unordered_set<UUID>> m_assetTypeMap;
+
+		// Project index of all assets in disk, asset deserialize lazily from it.
+		AssetIndex m_assetIndex;
+		bool m_bAssetIndexDirty = false;
+
+		// Background reimport of changed assets, and assets it build aside.
+		std::unique_ptr<ImportJobGraph> m_reimportGraph;
+		std::unordered_map<UUID, std::shared_ptr<AssetInterface>> m_reimportAssets;
+
+		uint64_t m_refreshVersion = 0;
+		std::unordered_map<UUID, uint64_t> m_assetRefreshVersions;
 	};
 
 	extern AssetManager* getAssetManager();
@@ -24,6 +24,23 @@ namespace engine
 		return icon;
 	}
 
+	void AssetMaterial::collectDependencies(std::vector<UUID>& outDependencies) const
+	{
+		for (const UUID* uuid : { &baseColorTexture, &normalTexture, &metalRoughnessTexture, &emissiveTexture, &aoTexture })
+		{
+			// Builtin texture no exist in project.
+			if (uuid->empty() || uuid->starts_with(AssetSaveInfo::kBuiltinFileStartChar))
+			{
+				continue;
+			}
+
+			if (std::find(outDependencies.begin(), outDependencies.end(), *uuid) == outDependencies.end())
+			{
+				outDependencies.push_back(*uuid);
+			}
+		}
+	}
+
 	const AssetReflectionInfo& AssetMaterial::uiGetAssetReflectionInfo()
 	{
 		const static AssetReflectionInfo kInfo =
@@ -158,4 +175,153 @@ namespace engine
 
 		return outHandle;
 	}
+
+	UUID StaticMeshMaterialImporter::addTextureJob(
+		const StaticMeshMaterialTextureDesc& texture,
+		ImportJobGraph& graph,
+		TextureJobMap& textureJobs,
+		std::vector<ImportJobGraph::JobId>& outDependencies)
+	{
+		if (texture.path.empty())
+		{
+			return {};
+		}
+
+		std::filesystem::path texPath = m_rawMeshPath.parent_path() / utf8::utf8to16(texture.path);
+
+		if (!m_texPathUUIDMap[texPath].empty())
+		{
+			LOG_TRACE("Texture {} is reusing in material.", texture.path);
+		}
+		else
+		{
+			auto filename = texPath.filename();
+			auto saveTexturePath = m_textureSavePath / filename.replace_extension();
+
+			{
+				auto name = saveTexturePath.filename().u16string() + utf8::utf8to16(AssetTexture::getCDO()->getSuffix());
+				auto relativePathUtf8 = buildRelativePathUtf8(getAssetManager()->getProjectConfig().assetPath, saveTexturePath.parent_path());
+
+				m_texPathUUIDMap[texPath] = AssetSaveInfo(utf8::utf16to8(name), relativePathUtf8).getUUID();
+			}
+
+			auto config = std::make_shared<AssetTextureImportConfig>();
+			config->path = { texPath, saveTexturePath };
+			config->bGenerateMipmap = true;
+			config->bSRGB = texture.bSRGB;
+			config->alphaMipmapCutoff = texture.cutoff;
+			config->format = texture.format;
+			config->bReimport = m_bReimport;
+
+			textureJobs[texPath] = graph.addJob(EImportJobStage::Texture, texture.path, [config]()
+			{
+				return AssetTexture::uiGetAssetReflectionInfo().importConfig.importAssetFromConfigThreadSafe(config);
+			});
+		}
+
+		// Texture import by earlier graph no need wait.
+		if (const auto iter = textureJobs.find(texPath); iter != textureJobs.end())
+		{
+			if (std::find(outDependencies.begin(), outDependencies.end(), iter->second) == outDependencies.end())
+			{
+				outDependencies.push_back(iter->second);
+			}
+		}
+
+		return m_texPathUUIDMap.at(texPath);
+	}
+
+	std::shared_ptr<std::vector<UUID>> StaticMeshMaterialImporter::addImportJobs(
+		const std::vector<StaticMeshMaterialDesc>& descs,
+		ImportJobGraph& graph,
+		std::vector<ImportJobGraph::JobId>& outMaterialJobs)
+	{
+		ZoneScoped;
+
+		auto materialUUIDs = std::make_shared<std::vector<UUID>>(descs.size());
+
+		// Group desc by material save path first, same name material only write once.
+		std::vector<std::filesystem::path> materialSavePaths { };
+		std::unordered_map<std::filesystem::path, std::vector<size_t>> materialDescIndices { };
+		for (size_t i = 0; i < descs.size(); i++)
+		{
+			auto materialSavePath = m_materialSavePath / utf8::utf8to16(descs[i].name);
+			if (const auto iter = m_materialPathUUIDMap.find(materialSavePath); iter != m_materialPathUUIDMap.end())
+			{
+				(*materialUUIDs)[i] = iter->second;
+				continue;
+			}
+
+			auto& indices = materialDescIndices[materialSavePath];
+			if (indices.empty())
+			{
+				materialSavePaths.push_back(materialSavePath);
+			}
+			indices.push_back(i);
+		}
+
+		TextureJobMap textureJobs { };
+		for (const auto& materialSavePath : materialSavePaths)
+		{
+			const auto& descIndices = materialDescIndices.at(materialSavePath);
+			const auto& desc = descs[descIndices.front()];
+
+			AssetSaveInfo materialSaveInfo(desc.name,
+				buildRelativePathUtf8(getAssetManager()->getProjectConfig().assetPath,
+					materialSavePath.parent_path()));
+
+			const UUID materialUUID = materialSaveInfo.getUUID();
+			m_materialPathUUIDMap[materialSavePath] = materialUUID;
+			for (size_t index : descIndices)
+			{
+				(*materialUUIDs)[index] = materialUUID;
+			}
+
+			std::vector<ImportJobGraph::JobId> dependencies { };
+			const UUID baseColorTexture      = addTextureJob(desc.baseColor, graph, textureJobs, dependencies);
+			const UUID normalTexture         = addTextureJob(desc.normal, graph, textureJobs, dependencies);
+			const UUID metalRoughnessTexture = addTextureJob(desc.metalRoughness, graph, textureJobs, dependencies);
+			const UUID aoTexture             = addTextureJob(desc.ao, graph, textureJobs, dependencies);
+			const UUID emissiveTexture       = addTextureJob(desc.emissive, graph, textureJobs, dependencies);
+
+			// Material only reference texture uuid, texture import fail not stop material write.
+			const bool bReimport = m_bReimport;
+			auto writeMaterial = [=]()
+			{
+				auto newMaterial = getAssetManager()->createImportAsset<AssetMaterial>(materialSaveInfo, bReimport);
+				newMaterial->markDirty();
+
+				newMaterial->cutoff       = desc.cutoff;
+				newMaterial->baseColorMul = desc.baseColorMul;
+				newMaterial->emissiveMul  = desc.emissiveMul;
+				newMaterial->emissiveAdd  = desc.emissiveAdd;
+				newMaterial->metalMul     = desc.metalMul;
+				newMaterial->roughnessMul = desc.roughnessMul;
+
+				newMaterial->baseColorTexture      = baseColorTexture;
+				newMaterial->normalTexture         = normalTexture;
+				newMaterial->metalRoughnessTexture = metalRoughnessTexture;
+				newMaterial->aoTexture             = aoTexture;
+				newMaterial->emissiveTexture       = emissiveTexture;
+
+				if (newMaterial->save())
+				{
+					return true;
+				}
+
+				LOG_ERROR("Failed to save material meta asset, the material {} import fail!",
+					utf8::utf16to8(materialSavePath.u16string()));
+
+				for (size_t index : descIndices)
+				{
+					(*materialUUIDs)[index] = {};
+				}
+				return false;
+			};
+
+			outMaterialJobs.push_back(graph.addJob(EImportJobStage::Material, desc.name, writeMaterial, dependencies));
+		}
+
+		return materialUUIDs;
+	}
 }
\ No newline at end of file
@@ -2,11 +2,15 @@
 
 #include "asset.h"
 #include "asset_common.h"
+#include "texture_helper.h"
+#include "import_job_graph.h"
 #include <common_header.h>
 #include "../graphics/context.h"
 
 namespace engine
 {
+	struct AssetTextureImportConfig;
+
 	extern BSDFMaterialInfo buildDefaultBSDFMaterialInfo();
 
 	struct BSDFMaterialTextureHandle
@@ -35,6 +39,7 @@ namespace engine
 		}
 		virtual void onPostAssetConstruct() override;
 		virtual VulkanImage* getSnapshotImage() override;
+		virtual void collectDependencies(std::vector<UUID>& outDependencies) const override;
 		// ~AssetInterface virtual function.
 
 		static const AssetReflectionInfo& uiGetAssetReflectionInfo();
@@ -81,5 +86,99 @@ namespace engine
 		float cutoff = 0.5f;
 		EShadingModelType shadingModelType = EShadingModelType_DefaultLit;
 	};
-}
 
+	// Texture reference of imported material, path is relative to raw mesh folder.
+	struct StaticMeshMaterialTextureDesc
+	{
+		std::string path = {};
+		bool bSRGB = false;
+		float cutoff = 1.0f;
+		ETextureFormat format = ETextureFormat::BC3;
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			uint32_t formatValue = (uint32_t)format;
+			archive(path, bSRGB, cutoff, formatValue);
+			format = (ETextureFormat)formatValue;
+		}
+	};
+
+	// Material parse from raw mesh, enough to rebuild material asset without parse raw mesh again.
+	struct StaticMeshMaterialDesc
+	{
+		// Material asset name, include suffix.
+		std::string name = {};
+
+		math::vec4 baseColorMul = math::vec4{ 1.0f };
+		math::vec4 emissiveMul = math::vec4{ 1.0f };
+		math::vec4 emissiveAdd = math::vec4{ 0.0f };
+
+		float metalMul = 1.0f;
+		float roughnessMul = 1.0f;
+		float cutoff = 0.5f;
+
+		StaticMeshMaterialTextureDesc baseColor;
+		StaticMeshMaterialTextureDesc normal;
+		StaticMeshMaterialTextureDesc metalRoughness;
+		StaticMeshMaterialTextureDesc ao;
+		StaticMeshMaterialTextureDesc emissive;
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			archive(name, baseColorMul, emissiveMul, emissiveAdd, metalMul, roughnessMul, cutoff);
+			archive(baseColor, normal, metalRoughness, ao, emissive);
+		}
+	};
+
+	// Create material asset from desc and import textures it reference, shared by mesh importers.
+	class StaticMeshMaterialImporter
+	{
+	public:
+		StaticMeshMaterialImporter() = default;
+
+		// Reimport write materials and textures into exist assets, keep their uuid.
+		explicit StaticMeshMaterialImporter(
+			const std::filesystem::path& rawMeshPath,
+			const std::filesystem::path& saveMaterialsPath,
+			const std::filesystem::path& saveTexturesPath,
+			bool bReimport = false)
+			: m_rawMeshPath(rawMeshPath)
+			, m_materialSavePath(saveMaterialsPath)
+			, m_textureSavePath(saveTexturesPath)
+			, m_bReimport(bReimport)
+		{
+
+		}
+
+		// Add texture import jobs and material write jobs into graph, material write after its textures import,
+		// textures dedup across materials. Material write job id append to outMaterialJobs.
+		// Return material uuid of each desc, material job reset its uuids to empty when fail, so only read after jobs finish.
+		std::shared_ptr<std::vector<UUID>> addImportJobs(
+			const std::vector<StaticMeshMaterialDesc>& descs, 
+			ImportJobGraph& graph, 
+			std::vector<ImportJobGraph::JobId>& outMaterialJobs);
+
+	private:
+		using TextureJobMap = std::unordered_map<std::filesystem::path, ImportJobGraph::JobId>;
+
+		// Add texture import job if texture not import yet, return texture uuid, empty if no texture.
+		// Texture job add in this graph append to outDependencies.
+		UUID addTextureJob(
+			const StaticMeshMaterialTextureDesc& texture, 
+			ImportJobGraph& graph, 
+			TextureJobMap& textureJobs,
+			std::vector<ImportJobGraph::JobId>& outDependencies);
+
+	private:
+		std::filesystem::path m_rawMeshPath;
+		std::filesystem::path m_materialSavePath;
+		std::filesystem::path m_textureSavePath;
+
+		bool m_bReimport = false;
+
+		std::unordered_map<std::filesystem::path, UUID> m_texPathUUIDMap { };
+		std::unordered_map<std::filesystem::path, UUID> m_materialPathUUIDMap { };
+	};
+}
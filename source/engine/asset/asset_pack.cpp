@@ -0,0 +1,703 @@
+#include "asset_pack.h"
+#include "asset_common.h"
+#include "asset_manager.h"
+#include "../engine.h"
+
+#include <lz4.h>
+#include <xxhash.h>
+#include <shared_mutex>
+#include <limits>
+
+namespace engine
+{
+	static AutoCVarInt32 cVarAssetPackLooseOverride(
+		"asset.pack.looseOverride",
+		"Loose asset file override packed file when exist, shipping build set 0 so packed file read without file stat.",
+		"Asset",
+		1,
+		CVarFlags::ReadAndWrite);
+
+	static const std::string kPackCommand = "--pack";
+	static const std::string kPackOutputOption = "--output";
+
+	// Entry data align inside pack.
+	static const uint64_t kAssetPackAlignment = 16;
+
+	struct AssetPackMount
+	{
+		std::u16string rootPath;
+		std::vector<std::unique_ptr<AssetPack>> packs;
+	};
+
+	static std::shared_mutex sAssetPackMutex;
+	static AssetPackMount sAssetPackMount;
+
+	static uint64_t hashAssetPackKey(std::string_view key)
+	{
+		return XXH64(key.data(), key.size(), 0);
+	}
+
+	// Return false if path not inside root.
+	static bool buildAssetPackKey(const std::u16string& rootPath, const std::filesystem::path& path, std::string& outKey)
+	{
+		const std::u16string path16 = std::filesystem::absolute(path).u16string();
+		if (path16.size() <= rootPath.size() || !path16.starts_with(rootPath))
+		{
+			return false;
+		}
+
+		outKey = utf8::utf16to8(path16.substr(rootPath.size()));
+		std::replace(outKey.begin(), outKey.end(), '\\', '/');
+
+		if (outKey.starts_with("/"))
+		{
+			outKey.erase(0, 1);
+		}
+
+		return true;
+	}
+
+	bool AssetPack::open(const std::filesystem::path& path)
+	{
+		m_entries = nullptr;
+		m_entryCount = 0;
+		m_keys = nullptr;
+
+		if (!m_file.open(path))
+		{
+			return false;
+		}
+
+		const uint8_t* data = m_file.getData();
+		const size_t fileSize = m_file.getSize();
+		if (fileSize < sizeof(AssetPackHeader))
+		{
+			return false;
+		}
+
+		AssetPackHeader header;
+		memcpy(&header, data, sizeof(header));
+
+		if (header.magic != kAssetPackMagic || header.version != kAssetPackVersion)
+		{
+			LOG_ERROR("Pack {} version un-support!", utf8::utf16to8(path.u16string()));
+			return false;
+		}
+
+		const size_t entryTableSize = sizeof(AssetPackEntry) * header.entryCount;
+		if (fileSize < sizeof(AssetPackHeader) + entryTableSize ||
+			header.keyBlobOffset > fileSize || header.keyBlobSize > fileSize - header.keyBlobOffset)
+		{
+			return false;
+		}
+
+		// Entry table follow header, mapping is page align so table use in place.
+		const AssetPackEntry* entries = (const AssetPackEntry*)(data + sizeof(AssetPackHeader));
+		for (uint32_t i = 0; i < header.entryCount; i++)
+		{
+			// Range check no overflow, stored entry read size bytes in place, lz4 entry size pass as int.
+			const auto& entry = entries[i];
+			const bool bSizeValid = (entry.compression == EAssetPackCompression::Stored)
+				? (entry.size == entry.packedSize)
+				: (entry.size <= uint64_t(std::numeric_limits<int>::max()) && entry.packedSize <= uint64_t(std::numeric_limits<int>::max()));
+
+			if (!bSizeValid ||
+				entry.offset > fileSize || entry.packedSize > fileSize - entry.offset ||
+				(uint64_t)entry.keyOffset + entry.keySize > header.keyBlobSize ||
+				entry.compression > EAssetPackCompression::LZ4 ||
+				(i > 0 && entries[i - 1].keyHash > entry.keyHash))
+			{
+				LOG_ERROR("Pack {} index broken!", utf8::utf16to8(path.u16string()));
+				return false;
+			}
+		}
+
+		m_entries = entries;
+		m_entryCount = header.entryCount;
+		m_keys = (const char*)(data + header.keyBlobOffset);
+
+		return true;
+	}
+
+	const AssetPackEntry* AssetPack::find(std::string_view key) const
+	{
+		const uint64_t hash = hashAssetPackKey(key);
+
+		const AssetPackEntry* end = m_entries + m_entryCount;
+		const AssetPackEntry* iter = std::lower_bound(m_entries, end, hash, [](const AssetPackEntry& entry, uint64_t value)
+		{
+			return entry.keyHash < value;
+		});
+
+		for (; iter != end && iter->keyHash == hash; iter++)
+		{
+			if (getKey(*iter) == key)
+			{
+				return iter;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void engine::mountAssetPacks(const std::filesystem::path& packFolder, const std::filesystem::path& rootPath)
+	{
+		ZoneScoped;
+
+		std::vector<std::filesystem::path> packPaths { };
+		{
+			std::error_code ec;
+			for (const auto& entry : std::filesystem::directory_iterator(packFolder, ec))
+			{
+				if (entry.is_regular_file(ec) && entry.path().extension() == kAssetPackSuffix)
+				{
+					packPaths.push_back(entry.path());
+				}
+			}
+		}
+		std::sort(packPaths.begin(), packPaths.end());
+
+		std::unique_lock<std::shared_mutex> lock(sAssetPackMutex);
+		sAssetPackMount = { };
+		sAssetPackMount.rootPath = std::filesystem::absolute(rootPath).u16string();
+
+		for (const auto& packPath : packPaths)
+		{
+			auto pack = std::make_unique<AssetPack>();
+			if (!pack->open(packPath))
+			{
+				LOG_ERROR("Mount pack {} fail, skip.", utf8::utf16to8(packPath.u16string()));
+				continue;
+			}
+
+			LOG_INFO("Mount pack {} with {} files.", utf8::utf16to8(packPath.u16string()), pack->getEntryCount());
+			sAssetPackMount.packs.push_back(std::move(pack));
+		}
+	}
+
+	void engine::unmountAssetPacks()
+	{
+		std::unique_lock<std::shared_mutex> lock(sAssetPackMutex);
+		sAssetPackMount = { };
+	}
+
+	bool engine::isAssetPackMounted()
+	{
+		std::shared_lock<std::shared_mutex> lock(sAssetPackMutex);
+		return !sAssetPackMount.packs.empty();
+	}
+
+	bool engine::findAssetPackFile(const std::filesystem::path& path, AssetPackFile& out)
+	{
+		std::shared_lock<std::shared_mutex> lock(sAssetPackMutex);
+		if (sAssetPackMount.packs.empty())
+		{
+			return false;
+		}
+
+		std::string key;
+		if (!buildAssetPackKey(sAssetPackMount.rootPath, path, key))
+		{
+			return false;
+		}
+
+		// Later mount pack override former.
+		for (auto iter = sAssetPackMount.packs.rbegin(); iter != sAssetPackMount.packs.rend(); iter++)
+		{
+			if (const auto* entry = (*iter)->find(key))
+			{
+				out = { iter->get(), entry };
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool engine::isAssetLooseFileOverride()
+	{
+		return cVarAssetPackLooseOverride.get() != 0;
+	}
+
+	bool engine::isAssetFileExist(const std::filesystem::path& path)
+	{
+		AssetPackFile packFile;
+		return findAssetPackFile(path, packFile) || std::filesystem::exists(path);
+	}
+
+	void engine::getAssetFileStamp(const std::filesystem::path& path, int64_t& outTime, uint64_t& outSize)
+	{
+		auto statLooseFile = [&]()
+		{
+			std::error_code ec;
+			outTime = (int64_t)std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+			outSize = (uint64_t)std::filesystem::file_size(path, ec);
+			return !ec;
+		};
+
+		const bool bLooseFirst = isAssetLooseFileOverride() || !isAssetPackMounted();
+		if (bLooseFirst && statLooseFile())
+		{
+			return;
+		}
+
+		AssetPackFile packFile;
+		if (findAssetPackFile(path, packFile))
+		{
+			outTime = packFile.entry->fileTime;
+			outSize = packFile.entry->size;
+			return;
+		}
+
+		if (!bLooseFirst)
+		{
+			statLooseFile();
+		}
+	}
+
+	void engine::collectAssetPackFiles(
+		const std::filesystem::path& folder,
+		const std::string& extensionPrefix,
+		std::vector<std::filesystem::path>& outPaths)
+	{
+		std::shared_lock<std::shared_mutex> lock(sAssetPackMutex);
+
+		std::string folderKey;
+		if (sAssetPackMount.packs.empty() || !buildAssetPackKey(sAssetPackMount.rootPath, folder, folderKey))
+		{
+			return;
+		}
+		folderKey += "/";
+
+		const std::filesystem::path rootPath = sAssetPackMount.rootPath;
+		std::unordered_set<std::string_view> keys { };
+		for (const auto& pack : sAssetPackMount.packs)
+		{
+			for (uint32_t i = 0; i < pack->getEntryCount(); i++)
+			{
+				const std::string_view key = pack->getKey(pack->getEntry(i));
+				if (!key.starts_with(folderKey) || keys.contains(key))
+				{
+					continue;
+				}
+
+				const size_t extensionPos = key.find_last_of("./");
+				if (extensionPos == std::string_view::npos || key[extensionPos] != '.' ||
+					!key.substr(extensionPos).starts_with(extensionPrefix))
+				{
+					continue;
+				}
+
+				keys.insert(key);
+				outPaths.push_back((rootPath / utf8::utf8to16(std::string(key))).make_preferred());
+			}
+		}
+	}
+
+	bool AssetFileView::open(const std::filesystem::path& path)
+	{
+		close();
+
+		const bool bLooseFirst = isAssetLooseFileOverride() || !isAssetPackMounted();
+		if (bLooseFirst && m_file.open(path))
+		{
+			m_data = m_file.getData();
+			m_size = m_file.getSize();
+			return true;
+		}
+
+		AssetPackFile packFile;
+		if (findAssetPackFile(path, packFile))
+		{
+			const auto& entry = *packFile.entry;
+			const uint8_t* data = packFile.pack->getEntryData(entry);
+
+			if (entry.compression == EAssetPackCompression::Stored)
+			{
+				m_data = data;
+				m_size = (size_t)entry.size;
+			}
+			else
+			{
+				m_decompressed.resize(entry.size);
+				const int decompressSize = LZ4_decompress_safe(
+					(const char*)data,
+					(char*)m_decompressed.data(),
+					(int)entry.packedSize,
+					(int)entry.size);
+
+				if (decompressSize != (int)entry.size)
+				{
+					LOG_ERROR("Packed file {} broken!", utf8::utf16to8(path.u16string()));
+					m_decompressed.clear();
+					return false;
+				}
+
+				m_data = m_decompressed.data();
+				m_size = m_decompressed.size();
+			}
+
+			m_bPacked = true;
+			return true;
+		}
+
+		// Miss in packs, fallback to loose file.
+		if (!bLooseFirst && m_file.open(path))
+		{
+			m_data = m_file.getData();
+			m_size = m_file.getSize();
+			return true;
+		}
+
+		return false;
+	}
+
+	void AssetFileView::close()
+	{
+		m_file.close();
+		m_decompressed.clear();
+
+		m_data = nullptr;
+		m_size = 0;
+		m_bPacked = false;
+	}
+
+	struct AssetPackItem
+	{
+		std::filesystem::path path;
+		std::string key;
+		uint64_t keyHash;
+	};
+
+	static bool writeAssetPack(std::vector<AssetPackItem>& items, const std::filesystem::path& outputPath)
+	{
+		ZoneScoped;
+
+		std::sort(items.begin(), items.end(), [](const AssetPackItem& a, const AssetPackItem& b)
+		{
+			return a.keyHash != b.keyHash ? a.keyHash < b.keyHash : a.key < b.key;
+		});
+
+		auto alignOffset = [](uint64_t offset)
+		{
+			return (offset + kAssetPackAlignment - 1) / kAssetPackAlignment * kAssetPackAlignment;
+		};
+
+		std::string keyBlob;
+		std::vector<AssetPackEntry> entries(items.size());
+		for (size_t i = 0; i < items.size(); i++)
+		{
+			entries[i] = { };
+			entries[i].keyHash = items[i].keyHash;
+			entries[i].keyOffset = (uint32_t)keyBlob.size();
+			entries[i].keySize = (uint32_t)items[i].key.size();
+
+			keyBlob += items[i].key;
+		}
+
+		AssetPackHeader header { };
+		header.magic = kAssetPackMagic;
+		header.version = kAssetPackVersion;
+		header.entryCount = (uint32_t)entries.size();
+		header.keyBlobOffset = sizeof(AssetPackHeader) + sizeof(AssetPackEntry) * entries.size();
+		header.keyBlobSize = keyBlob.size();
+
+		std::filesystem::path tempPath = outputPath;
+		tempPath += ".tmp";
+
+		std::ofstream os(tempPath, std::ios::binary | std::ios::trunc);
+		if (!os)
+		{
+			LOG_ERROR("Pack {} can't create.", utf8::utf16to8(tempPath.u16string()));
+			return false;
+		}
+
+		// Index write last, reserve space first.
+		uint64_t offset = alignOffset(header.keyBlobOffset + header.keyBlobSize);
+		os.write(std::string(offset, '\0').data(), offset);
+
+		std::vector<char> compressed;
+		for (size_t i = 0; i < items.size(); i++)
+		{
+			const auto& path = items[i].path;
+			auto& entry = entries[i];
+
+			std::error_code ec;
+			entry.fileTime = (int64_t)std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+			entry.size = (uint64_t)std::filesystem::file_size(path, ec);
+			if (ec)
+			{
+				LOG_ERROR("Pack file {} miss.", utf8::utf16to8(path.u16string()));
+				return false;
+			}
+
+			entry.offset = offset;
+			if (entry.size == 0)
+			{
+				continue;
+			}
+
+			MappedFile file(path);
+			if (!file.isValid())
+			{
+				LOG_ERROR("Pack file {} can't open.", utf8::utf16to8(path.u16string()));
+				return false;
+			}
+
+			const char* data = (const char*)file.getData();
+			uint64_t packedSize = entry.size;
+
+			// Binary stream container already compress per chunk, no compress twice.
+			uint32_t magic = 0;
+			if (file.getSize() >= sizeof(uint32_t))
+			{
+				memcpy(&magic, data, sizeof(uint32_t));
+			}
+
+			if (magic != kAssetBinaryStreamMagic && file.getSize() < (size_t)LZ4_MAX_INPUT_SIZE)
+			{
+				compressed.resize(LZ4_compressBound((int)file.getSize()));
+				const int compressedSize = LZ4_compress_default(data, compressed.data(), (int)file.getSize(), (int)compressed.size());
+
+				if (compressedSize > 0 && (uint64_t)compressedSize < entry.size)
+				{
+					entry.compression = EAssetPackCompression::LZ4;
+					data = compressed.data();
+					packedSize = (uint64_t)compressedSize;
+				}
+			}
+
+			entry.packedSize = packedSize;
+			os.write(data, packedSize);
+
+			const uint64_t alignedEnd = alignOffset(offset + packedSize);
+			os.write(std::string(alignedEnd - offset - packedSize, '\0').data(), alignedEnd - offset - packedSize);
+			offset = alignedEnd;
+		}
+
+		os.seekp(0);
+		os.write((const char*)&header, sizeof(header));
+		os.write((const char*)entries.data(), sizeof(AssetPackEntry) * entries.size());
+		os.write(keyBlob.data(), keyBlob.size());
+		os.close();
+
+		if (!os)
+		{
+			LOG_ERROR("Pack {} write fail.", utf8::utf16to8(tempPath.u16string()));
+			return false;
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, outputPath, ec);
+		if (ec)
+		{
+			LOG_ERROR("Pack {} replace fail: {}.", utf8::utf16to8(outputPath.u16string()), ec.message());
+			return false;
+		}
+
+		return true;
+	}
+
+	// Compare open cost of each packed file, loose path exist check and map per file, pack map once and binary search.
+	// Cold run evict page cache of all files first so it count disk access, warm run is per file open and lookup overhead.
+	static void benchmarkAssetPackOpen(const std::vector<AssetPackItem>& items, const std::filesystem::path& packPath)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		auto getMilliseconds = [](Clock::time_point start)
+		{
+			return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		};
+
+		// Touch first byte, so page fault also count.
+		volatile uint8_t sink = 0;
+
+		auto openLooseFiles = [&]()
+		{
+			const auto startTime = Clock::now();
+			for (const auto& item : items)
+			{
+				if (std::filesystem::exists(item.path))
+				{
+					MappedFile file(item.path);
+					if (file.isValid())
+					{
+						sink = sink ^ file.getData()[0];
+					}
+				}
+			}
+			return getMilliseconds(startTime);
+		};
+
+		auto openPack = [&]()
+		{
+			const auto startTime = Clock::now();
+
+			AssetPack pack;
+			if (pack.open(packPath))
+			{
+				for (const auto& item : items)
+				{
+					const auto* entry = pack.find(item.key);
+					if (entry && entry->packedSize > 0)
+					{
+						sink = sink ^ pack.getEntryData(*entry)[0];
+					}
+				}
+			}
+			return getMilliseconds(startTime);
+		};
+
+		// Cold open measure disk access, drop page cache of all files before each run.
+		auto evictAll = [&]()
+		{
+			bool bSucceed = evictFileCache(packPath);
+			for (const auto& item : items)
+			{
+				bSucceed = evictFileCache(item.path) && bSucceed;
+			}
+			return bSucceed;
+		};
+
+		const bool bColdLoose = evictAll();
+		const double coldLooseTime = openLooseFiles();
+
+		const bool bColdPack = evictAll();
+		const double coldPackTime = openPack();
+
+		// Previous runs leave all files in page cache.
+		const double warmLooseTime = openLooseFiles();
+		const double warmPackTime = openPack();
+
+		if (!bColdLoose || !bColdPack)
+		{
+			LOG_WARN("Page cache evict fail for some files, cold time may include cached files.");
+		}
+
+		const double fileCount = (double)std::max(items.size(), size_t(1));
+		LOG_INFO("Pack open benchmark: {0} files.", items.size());
+		LOG_INFO("  Loose files cold: {0:.2f} ms, {1:.2f} us per file.", coldLooseTime, coldLooseTime * 1000.0 / fileCount);
+		LOG_INFO("  Pack cold: {0:.2f} ms, {1:.2f} us per file.", coldPackTime, coldPackTime * 1000.0 / fileCount);
+		LOG_INFO("  Loose files warm: {0:.2f} ms, {1:.2f} us per file.", warmLooseTime, warmLooseTime * 1000.0 / fileCount);
+		LOG_INFO("  Pack warm: {0:.2f} ms, {1:.2f} us per file.", warmPackTime, warmPackTime * 1000.0 / fileCount);
+	}
+
+	bool engine::isAssetPackCommandLine(int argc, char** argv)
+	{
+		return argc > 1 && kPackCommand == argv[1];
+	}
+
+	int engine::runAssetPackCommandLine(int argc, char** argv)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		const auto packStartTime = Clock::now();
+
+		CHECK(isAssetPackCommandLine(argc, argv));
+		if (argc < 3)
+		{
+			LOG_ERROR("Usage: dark --pack <project.dark> [--output <path>].");
+			return 1;
+		}
+
+		const std::filesystem::path projectPath = std::filesystem::absolute(utf8::utf8to16(argv[2]));
+		if (!std::filesystem::is_regular_file(projectPath))
+		{
+			LOG_ERROR("Project file {} not exist, pack fail.", argv[2]);
+			return 1;
+		}
+
+		std::filesystem::path outputPath = projectPath.parent_path() / "pack" / projectPath.stem();
+		outputPath += kAssetPackSuffix;
+		for (int i = 3; i < argc; i++)
+		{
+			if (kPackOutputOption == argv[i] && i + 1 < argc)
+			{
+				outputPath = std::filesystem::absolute(utf8::utf8to16(argv[++i]));
+			}
+			else
+			{
+				LOG_WARN("Unknown pack option {}, skip.", argv[i]);
+			}
+		}
+
+		if (!Engine::get()->initHeadless())
+		{
+			LOG_ERROR("Headless engine init fail, pack fail.");
+			return 1;
+		}
+
+		// Setup rebuild stale project index, so packed index match packed asset files.
+		getAssetManager()->setupProject(projectPath);
+
+		// Pack build from loose files, and output pack may mount by setup.
+		unmountAssetPacks();
+
+		const auto& config = getAssetManager()->getProjectConfig();
+		const std::u16string rootPath = std::filesystem::absolute(config.rootPath).u16string();
+		const std::filesystem::path indexPath = getAssetManager()->getAssetIndexPath();
+
+		std::vector<AssetPackItem> items { };
+		auto addItem = [&](const std::filesystem::path& path)
+		{
+			AssetPackItem item { };
+			item.path = path;
+			if (buildAssetPackKey(rootPath, path, item.key))
+			{
+				item.keyHash = hashAssetPackKey(item.key);
+				items.push_back(std::move(item));
+			}
+		};
+
+		{
+			std::error_code ec;
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(config.assetPath, ec))
+			{
+				if (entry.is_regular_file(ec) && entry.path().extension().string().starts_with(".dark"))
+				{
+					addItem(entry.path());
+				}
+			}
+
+			// Cache folder also keep temp files, only pack bins, snapshots and index.
+			for (const auto& entry : std::filesystem::directory_iterator(config.cachePath, ec))
+			{
+				const std::string name = utf8::utf16to8(entry.path().filename().u16string());
+				if (entry.is_regular_file(ec) &&
+					(name.ends_with("_BinFile") || name.ends_with("_SnapShotImage") || entry.path() == indexPath))
+				{
+					addItem(entry.path());
+				}
+			}
+		}
+
+		bool bSucceed = !items.empty();
+		if (!bSucceed)
+		{
+			LOG_ERROR("Project {} has no asset file to pack.", utf8::utf16to8(projectPath.u16string()));
+		}
+		else
+		{
+			std::error_code ec;
+			std::filesystem::create_directories(outputPath.parent_path(), ec);
+
+			bSucceed = writeAssetPack(items, outputPath);
+		}
+
+		if (bSucceed)
+		{
+			const double packTime = std::chrono::duration<double, std::milli>(Clock::now() - packStartTime).count();
+			LOG_INFO("Pack {} files into {} in {:.2f} ms, {:.2f} MB.",
+				items.size(), utf8::utf16to8(outputPath.u16string()), packTime,
+				std::filesystem::file_size(outputPath) / (1024.0 * 1024.0));
+
+			benchmarkAssetPackOpen(items, outputPath);
+		}
+
+		if (!Engine::get()->releaseHeadless())
+		{
+			LOG_ERROR("Headless engine release fail.");
+			return 1;
+		}
+
+		return bSucceed ? 0 : 1;
+	}
+}
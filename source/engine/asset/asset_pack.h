@@ -0,0 +1,142 @@
+#pragma once
+
+#include "../utils/utils.h"
+
+namespace engine
+{
+	// Pack archive of project asset files and cache bins, used when shipping project with lots of small assets.
+	// Layout: AssetPackHeader | AssetPackEntry[entryCount] sorted by key hash | key blob | entry data.
+	// Key is file path relative to project root in utf8 with '/' separator, such as "asset/a/b.darktexture".
+	// Asset files and bins already store in compressed binary stream format, so they pack stored as is,
+	// other files compress with lz4 when it save space.
+	static const uint32_t kAssetPackMagic = 0x4B415044; // "DPAK"
+	static const uint32_t kAssetPackVersion = 1;
+	constexpr const char* kAssetPackSuffix = ".dpak";
+
+	enum class EAssetPackCompression : uint32_t
+	{
+		Stored = 0,
+		LZ4,
+	};
+
+	struct AssetPackHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t flags;
+
+		uint64_t keyBlobOffset;
+		uint64_t keyBlobSize;
+	};
+	static_assert(sizeof(AssetPackHeader) == 32);
+
+	struct AssetPackEntry
+	{
+		// xxhash64 of key.
+		uint64_t keyHash;
+
+		// Offset from pack start.
+		uint64_t offset;
+		uint64_t packedSize;
+
+		// Loose file state when pack, used as file stamp of packed file.
+		uint64_t size;
+		int64_t fileTime;
+
+		// Offset in key blob.
+		uint32_t keyOffset;
+		uint32_t keySize;
+
+		EAssetPackCompression compression;
+		uint32_t padding;
+	};
+	static_assert(sizeof(AssetPackEntry) == 56);
+
+	class AssetPack : NonCopyable
+	{
+	public:
+		// Map whole pack and validate index, return false if file miss or broken.
+		bool open(const std::filesystem::path& path);
+
+		uint32_t getEntryCount() const { return m_entryCount; }
+		const AssetPackEntry& getEntry(uint32_t index) const { return m_entries[index]; }
+
+		std::string_view getKey(const AssetPackEntry& entry) const { return { m_keys + entry.keyOffset, entry.keySize }; }
+		const uint8_t* getEntryData(const AssetPackEntry& entry) const { return m_file.getData() + entry.offset; }
+
+		// Binary search in sorted index, return nullptr if miss.
+		const AssetPackEntry* find(std::string_view key) const;
+
+	private:
+		MappedFile m_file;
+
+		const AssetPackEntry* m_entries = nullptr;
+		uint32_t m_entryCount = 0;
+		const char* m_keys = nullptr;
+	};
+
+	struct AssetPackFile
+	{
+		const AssetPack* pack = nullptr;
+		const AssetPackEntry* entry = nullptr;
+	};
+
+	// Mount all packs inside folder, pack sort by name and later one override former, such as patch pack.
+	// Mount and unmount only when no asset file read in flight, such as project setup.
+	extern void mountAssetPacks(const std::filesystem::path& packFolder, const std::filesystem::path& rootPath);
+	extern void unmountAssetPacks();
+	extern bool isAssetPackMounted();
+
+	// Find file inside mounted packs, path is absolute path of loose file.
+	extern bool findAssetPackFile(const std::filesystem::path& path, AssetPackFile& out);
+
+	// Loose file override packed file when exist, for development iteration.
+	extern bool isAssetLooseFileOverride();
+
+	// Exist in mounted packs or as loose file, packed file no touch disk.
+	extern bool isAssetFileExist(const std::filesystem::path& path);
+
+	// Write time and size of loose file, or of packed file when loose file not used.
+	extern void getAssetFileStamp(const std::filesystem::path& path, int64_t& outTime, uint64_t& outSize);
+
+	// Append packed files under folder with extension start with prefix, path as loose file path.
+	extern void collectAssetPackFiles(
+		const std::filesystem::path& folder,
+		const std::string& extensionPrefix,
+		std::vector<std::filesystem::path>& outPaths);
+
+	// Read only view of asset file, map loose file or point into mounted pack.
+	class AssetFileView : NonCopyable
+	{
+	public:
+		// Return false if file miss in both loose files and packs.
+		bool open(const std::filesystem::path& path);
+		void close();
+
+		bool isValid() const { return m_data != nullptr; }
+		bool isPacked() const { return m_bPacked; }
+
+		const uint8_t* getData() const { return m_data; }
+		size_t getSize() const { return m_size; }
+
+	private:
+		MappedFile m_file;
+
+		// Compressed packed file decompress here.
+		std::vector<uint8_t> m_decompressed;
+
+		const uint8_t* m_data = nullptr;
+		size_t m_size = 0;
+		bool m_bPacked = false;
+	};
+
+	// Headless pack tool, pack project asset files, bins, snapshots and index into one archive.
+	// Usage: dark --pack <project.dark> [--output <path>]
+	//   output: pack path, default is <project name>.dpak in pack folder beside project file.
+	// After pack, log open time of all packed files from loose files and from pack.
+	extern bool isAssetPackCommandLine(int argc, char** argv);
+
+	// Return process exit code, zero when pack succeed.
+	extern int runAssetPackCommandLine(int argc, char** argv);
+}
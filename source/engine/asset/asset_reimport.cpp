@@ -0,0 +1,236 @@
+#include "asset_reimport.h"
+#include "asset_texture.h"
+#include "asset_staticmesh.h"
+#include "import_job_graph.h"
+
+#include <xxhash.h>
+
+namespace engine
+{
+	// Return false if source or any dependency miss.
+	static bool getImportSourceWriteTime(
+		const std::filesystem::path& srcPath,
+		const std::vector<u8str>& dependencies,
+		int64_t& outWriteTime)
+	{
+		std::error_code ec;
+
+		outWriteTime = (int64_t)std::filesystem::last_write_time(srcPath, ec).time_since_epoch().count();
+		if (ec)
+		{
+			return false;
+		}
+
+		for (const auto& dependency : dependencies)
+		{
+			const int64_t writeTime = (int64_t)std::filesystem::last_write_time(srcPath.parent_path() / utf8::utf8to16(dependency), ec).time_since_epoch().count();
+			if (ec)
+			{
+				return false;
+			}
+			outWriteTime = std::max(outWriteTime, writeTime);
+		}
+
+		return true;
+	}
+
+	// Hash is stable across asset and cooker version, so version bump not reimport whole project.
+	static bool hashImportSource(
+		const std::filesystem::path& srcPath,
+		const std::vector<u8str>& dependencies,
+		std::string& outHash)
+	{
+		ZoneScoped;
+
+		XXH64_state_s* state = XXH64_createState();
+		XXH64_reset(state, 0);
+
+		auto appendFile = [&](const std::filesystem::path& path)
+		{
+			MappedFile file;
+			if (!file.open(path))
+			{
+				return false;
+			}
+
+			const uint64_t size = file.getSize();
+			XXH64_update(state, &size, sizeof(size));
+			XXH64_update(state, file.getData(), file.getSize());
+			return true;
+		};
+
+		bool bSucceed = appendFile(srcPath);
+		for (const auto& dependency : dependencies)
+		{
+			bSucceed = bSucceed && appendFile(srcPath.parent_path() / utf8::utf8to16(dependency));
+		}
+
+		outHash = std::format("{:016x}", XXH64_digest(state));
+		XXH64_freeState(state);
+
+		return bSucceed;
+	}
+
+	AssetImportSource engine::buildAssetImportSource(
+		const AssetImportConfigInterface& config,
+		const std::vector<std::filesystem::path>& dependencies)
+	{
+		const std::filesystem::path srcPath = std::filesystem::absolute(config.path.first);
+
+		AssetImportSource source { };
+		for (const auto& dependency : dependencies)
+		{
+			source.dependencies.push_back(utf8::utf16to8(dependency.u16string()));
+		}
+
+		if (!getImportSourceWriteTime(srcPath, source.dependencies, source.writeTime) ||
+			!hashImportSource(srcPath, source.dependencies, source.hash))
+		{
+			LOG_WARN("Import source {} can't read, asset can't reimport when source change.", utf8::utf16to8(srcPath.u16string()));
+			return { };
+		}
+
+		std::string settings;
+		{
+			std::stringstream ss;
+			cereal::BinaryOutputArchive archive(ss);
+			config.saveSettings(archive);
+			settings = std::move(ss.str());
+		}
+
+		source.path = utf8::utf16to8(srcPath.u16string());
+		source.settings = std::vector<uint8_t>(settings.begin(), settings.end());
+
+		return source;
+	}
+
+	EAssetImportSourceState engine::checkAssetImportSource(const AssetImportSource& source)
+	{
+		CHECK(!source.empty());
+		const std::filesystem::path srcPath = utf8::utf8to16(source.path);
+
+		int64_t writeTime;
+		if (!getImportSourceWriteTime(srcPath, source.dependencies, writeTime))
+		{
+			return EAssetImportSourceState::Missing;
+		}
+
+		if (writeTime == source.writeTime)
+		{
+			return EAssetImportSourceState::Unchanged;
+		}
+
+		// Source touch but content same, such as checkout again.
+		std::string hash;
+		if (!hashImportSource(srcPath, source.dependencies, hash))
+		{
+			return EAssetImportSourceState::Missing;
+		}
+
+		return hash == source.hash ? EAssetImportSourceState::Unchanged : EAssetImportSourceState::Changed;
+	}
+
+	static const AssetReflectionInfo* getReimportReflectionInfo(EAssetType type)
+	{
+		switch (type)
+		{
+		case EAssetType::darktexture:    return &AssetTexture::uiGetAssetReflectionInfo();
+		case EAssetType::darkstaticmesh: return &AssetStaticMesh::uiGetAssetReflectionInfo();
+		default: break;
+		}
+
+		return nullptr;
+	}
+
+	// Import save path, texture asset file is save path with suffix, static mesh save path is its folder.
+	static std::filesystem::path getReimportSavePath(const AssetIndexEntry& entry)
+	{
+		std::filesystem::path assetFilePath =
+			std::filesystem::path(getAssetManager()->getProjectConfig().assetPath) / utf8::utf8to16(entry.uuid);
+
+		return entry.type == EAssetType::darkstaticmesh ? assetFilePath.parent_path() : assetFilePath.replace_extension();
+	}
+
+	static bool isPathUnderFolder(const std::filesystem::path& path, const std::filesystem::path& folder)
+	{
+		const auto [folderIter, pathIter] = std::mismatch(folder.begin(), folder.end(), path.begin(), path.end());
+		return folderIter == folder.end();
+	}
+
+	void engine::buildReimportChangedJobs(std::vector<AssetIndexEntry>&& inEntries, ImportJobGraph& graph)
+	{
+		auto entries = std::make_shared<std::vector<AssetIndexEntry>>(std::move(inEntries));
+		auto states = std::make_shared<std::vector<EAssetImportSourceState>>(entries->size(), EAssetImportSourceState::Unchanged);
+
+		// Source check may hash big raw file, check each entry in own job.
+		std::vector<ImportJobGraph::JobId> checkJobs(entries->size());
+		for (size_t i = 0; i < entries->size(); i++)
+		{
+			checkJobs[i] = graph.addJob(EImportJobStage::Decode, (*entries)[i].name, [entries, states, i]()
+			{
+				(*states)[i] = checkAssetImportSource((*entries)[i].importSource);
+				return true;
+			});
+		}
+
+		graph.addJob(EImportJobStage::Decode, "Reimport changed assets", [entries, states, &graph]()
+		{
+			std::vector<std::filesystem::path> changedMeshFolders { };
+			uint32_t missingCount = 0;
+			for (size_t i = 0; i < entries->size(); i++)
+			{
+				const auto& entry = (*entries)[i];
+				if ((*states)[i] == EAssetImportSourceState::Missing)
+				{
+					LOG_WARN("Import source {} of asset {} miss, skip reimport.", entry.importSource.path, entry.uuid);
+					missingCount++;
+				}
+				else if ((*states)[i] == EAssetImportSourceState::Changed && entry.type == EAssetType::darkstaticmesh)
+				{
+					changedMeshFolders.push_back(getReimportSavePath(entry));
+				}
+			}
+
+			uint32_t reimportCount = 0;
+			for (size_t i = 0; i < entries->size(); i++)
+			{
+				const auto& entry = (*entries)[i];
+				const auto* info = getReimportReflectionInfo(entry.type);
+				if ((*states)[i] != EAssetImportSourceState::Changed || !info)
+				{
+					continue;
+				}
+
+				const auto savePath = getReimportSavePath(entry);
+				const bool bInsideChangedMesh = std::any_of(changedMeshFolders.begin(), changedMeshFolders.end(), [&](const auto& folder)
+				{
+					return folder != savePath && isPathUnderFolder(savePath, folder);
+				});
+
+				if (bInsideChangedMesh)
+				{
+					continue;
+				}
+
+				auto config = info->importConfig.buildAssetImportConfig();
+				config->path = { utf8::utf8to16(entry.importSource.path), savePath };
+				config->bReimport = true;
+				{
+					const auto& settings = entry.importSource.settings;
+
+					MemoryViewStreamBuffer buffer(settings.data(), settings.size());
+					std::istream is(&buffer);
+					cereal::BinaryInputArchive archive(is);
+					config->loadSettings(archive);
+				}
+
+				LOG_INFO("Reimport asset {} from changed source {}.", entry.uuid, entry.importSource.path);
+				buildAssetImportJobs(*info, config, graph);
+				reimportCount++;
+			}
+
+			LOG_INFO("Reimport {} changed assets, {} checked, {} source miss.", reimportCount, entries->size(), missingCount);
+			return true;
+		}, checkJobs);
+	}
+}
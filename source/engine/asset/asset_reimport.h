@@ -0,0 +1,29 @@
+#pragma once
+
+#include "asset_manager.h"
+
+namespace engine
+{
+	class ImportJobGraph;
+
+	// Record raw source of import config, hash source and dependencies content, capture config settings.
+	// Dependencies relative to source folder. Return empty source if source file can't open.
+	extern AssetImportSource buildAssetImportSource(
+		const AssetImportConfigInterface& config,
+		const std::vector<std::filesystem::path>& dependencies = {});
+
+	enum class EAssetImportSourceState
+	{
+		Unchanged,
+		Changed,
+		Missing,
+	};
+
+	// Compare write time first, only hash content when write time changed.
+	extern EAssetImportSourceState checkAssetImportSource(const AssetImportSource& source);
+
+	// Add jobs which check import source of entries and reimport changed assets into graph.
+	// Asset inside a changed static mesh folder reimport with the static mesh, no reimport twice.
+	// Reimport assets build aside with same uuid, replace exist assets when AssetManager::commitReimportAssets.
+	extern void buildReimportChangedJobs(std::vector<AssetIndexEntry>&& entries, ImportJobGraph& graph);
+}
@@ -3,7 +3,13 @@
 
 #include <rttr/registration.h>
 #include "assimp_import.h"
+#include "gltf_import.h"
+#include "mesh_helper.h"
 #include "asset_manager.h"
+#include "derived_data_cache.h"
+#include "asset_reimport.h"
+#include "import_job_graph.h"
+#include "../engine.h"
 #include "../serialization/serialization.h"
 #include "graphics/context.h"
 #include <renderer/render_scene.h>
@@ -21,6 +27,28 @@ namespace engine
 
 	}
 
+	void AssetStaticMesh::collectDependencies(std::vector<UUID>& outDependencies) const
+	{
+		for (const auto& subMesh : m_subMeshes)
+		{
+			if (!subMesh.material.empty() && 
+				std::find(outDependencies.begin(), outDependencies.end(), subMesh.material) == outDependencies.end())
+			{
+				outDependencies.push_back(subMesh.material);
+			}
+		}
+	}
+
+	size_t AssetStaticMesh::getMeshletsCount() const
+	{
+		size_t meshletsCount = 0;
+		for (const auto& subMesh : m_subMeshes)
+		{
+			meshletsCount += subMesh.meshletCount;
+		}
+		return meshletsCount;
+	}
+
 	const AssetStaticMesh* AssetStaticMesh::getCDO()
 	{
 		static AssetStaticMesh mesh{ };
@@ -55,37 +83,173 @@ namespace engine
 		ImGui::Separator();
 	}
 
-	static bool importStaticMeshFromConfigThreadSafe(
-		std::shared_ptr<AssetImportConfigInterface> inPtr)
+	static AutoCVarInt32 cVarNativeGLTFImport(
+		"asset.import.nativeGLTF",
+		"Import gltf/glb static mesh by native gltf importer, fallback to assimp when 0.",
+		"Asset",
+		1,
+		CVarFlags::ReadAndWrite);
+
+	// Static mesh cooker version, bump when assimp process flags or mesh cook code change.
+	static const uint32_t kStaticMeshCookerVersion = 8;
+
+	// Static mesh meta and material descs store in derived data cache, bin store as payload.
+	// Submesh material store as material desc index, -1 if no material.
+	struct StaticMeshDerivedData
+	{
+		std::vector<StaticMeshSubMesh> subMeshes;
+		std::vector<int32_t> subMeshMaterials;
+		std::vector<StaticMeshMaterialDesc> materials;
+
+		uint64_t indicesCount = 0;
+		uint64_t indicesWordsCount = 0;
+		uint64_t verticesCount = 0;
+		EVertexFormat vertexFormat = EVertexFormat_Float;
+
+		math::vec3 minPosition = {};
+		math::vec3 maxPosition = {};
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			archive(subMeshes, subMeshMaterials, materials, indicesCount, indicesWordsCount, verticesCount, vertexFormat, minPosition, maxPosition);
+		}
+	};
+
+	// Import state shared by all jobs of one static mesh.
+	struct StaticMeshImportContext
 	{
-		auto ptr = std::static_pointer_cast<AssetStaticMeshImportConfig>(inPtr);
+		std::shared_ptr<AssetStaticMeshImportConfig> config = nullptr;
+		std::chrono::high_resolution_clock::time_point importStartTime;
 
-		const std::filesystem::path& srcPath = ptr->path.first;
-		const std::filesystem::path& savePath = ptr->path.second;
+		bool bNativeGLTF = false;
+		std::string derivedDataKey = {};
 
+		// Only parse raw mesh when derived data miss, release after geometry cook.
 		Assimp::Importer importer;
-		const aiScene* scene = importer.ReadFile(srcPath.string(),
-			aiProcessPreset_TargetRealtime_Quality |
-			aiProcess_FlipUVs | 
-			aiProcess_GenBoundingBoxes);
+		const aiScene* scene = nullptr;
+		std::unique_ptr<GLTFStaticMeshImporter> gltfProcessor = nullptr;
+		std::unique_ptr<AssimpStaticMeshImporter> assimpProcessor = nullptr;
+
+		std::shared_ptr<AssetStaticMesh> meshPtr = nullptr;
+		StaticMeshDerivedData derivedData { };
+
+		// Material uuid of each derived data material desc, write by material jobs.
+		std::shared_ptr<std::vector<UUID>> materialUUIDs = nullptr;
+
+		// Cooked data fetch from derived data cache.
+		bool bDerivedDataHit = false;
+
+		const std::filesystem::path& getSrcPath() const { return config->path.first; }
+		const std::filesystem::path& getSavePath() const { return config->path.second; }
 
-		if (scene == nullptr)
+		bool parseRawMesh();
+		void logImportTime() const;
+
+		// Parse raw mesh and create asset, then add geometry, material and save jobs.
+		static bool decode(std::shared_ptr<StaticMeshImportContext> context, ImportJobGraph& graph);
+
+		// Process raw mesh, cook and save bin, store derived data.
+		bool cookGeometry();
+
+		// Assign submesh material and save asset.
+		bool save();
+	};
+
+	bool StaticMeshImportContext::parseRawMesh()
+	{
+		const auto& srcPath = getSrcPath();
+		const auto rawAssetFolderPath = getSavePath() / "raw";
+
+		if (bNativeGLTF)
 		{
-			LOG_ERROR("Mesh {} import fail.", utf8::utf16to8(srcPath.u16string()));
-			return false;
+			gltfProcessor = std::make_unique<GLTFStaticMeshImporter>(srcPath, rawAssetFolderPath);
+			if (gltfProcessor->load())
+			{
+				return true;
+			}
+		}
+		else
+		{
+			scene = importer.ReadFile(srcPath.string(), kAssimpStaticMeshImportFlags);
+			if (scene != nullptr)
+			{
+				assimpProcessor = std::make_unique<AssimpStaticMeshImporter>(srcPath, true);
+				return true;
+			}
 		}
 
-		std::string assetNameUtf8 = utf8::utf16to8(savePath.filename().u16string());
+		LOG_ERROR("Mesh {} import fail.", utf8::utf16to8(srcPath.u16string()));
+		return false;
+	}
+
+	void StaticMeshImportContext::logImportTime() const
+	{
+		const char* importerName = bNativeGLTF ? "gltf" : "assimp";
+		const char* source = bDerivedDataHit ? "derived data cache" : "raw mesh";
 
-		if (std::filesystem::exists(savePath))
+		const auto importTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - importStartTime).count();
+		LOG_INFO("Mesh {} import by {} from {} cost {:.2f} ms.", utf8::utf16to8(getSrcPath().u16string()), importerName, source, importTime);
+	}
+
+	bool StaticMeshImportContext::decode(std::shared_ptr<StaticMeshImportContext> context, ImportJobGraph& graph)
+	{
+		const std::filesystem::path& srcPath = context->getSrcPath();
+		const std::filesystem::path& savePath = context->getSavePath();
+
+		context->importStartTime = std::chrono::high_resolution_clock::now();
+		context->bNativeGLTF = (cVarNativeGLTFImport.get() != 0) && GLTFStaticMeshImporter::isGLTF(srcPath);
+
+		// Raw dependencies relative to raw mesh folder, obj material file or gltf external buffers.
+		std::vector<std::filesystem::path> rawDependencies;
+		if (GLTFStaticMeshImporter::isGLTF(srcPath))
 		{
-			LOG_ERROR("Path {0} already exist, asset {1} import fail!", utf8::utf16to8(savePath.u16string()), assetNameUtf8);
-			return false;
+			GLTFStaticMeshImporter::collectExternalBuffers(srcPath, rawDependencies);
+		}
+		else
+		{
+			std::filesystem::path mtlName = srcPath.filename().stem();
+			mtlName += ".mtl";
+			if (std::filesystem::exists(srcPath.parent_path() / mtlName))
+			{
+				rawDependencies.push_back(mtlName);
+			}
 		}
 
-		if (!std::filesystem::create_directory(savePath))
+		// Reuse cooked data from derived data cache when raw mesh content unchanged.
+		DerivedDataCache* derivedDataCache = getDerivedDataCache();
+		std::string& derivedDataKey = context->derivedDataKey;
+		if (derivedDataCache)
 		{
-			LOG_ERROR("Folder {0} create failed, asset {1} import fail!", utf8::utf16to8(savePath.u16string()), assetNameUtf8);
+			DerivedDataKeyBuilder keyBuilder("staticmesh", kStaticMeshCookerVersion);
+
+			bool bKeyValid = keyBuilder.appendFile(srcPath);
+			for (const auto& dependency : rawDependencies)
+			{
+				bKeyValid = bKeyValid && keyBuilder.appendFile(srcPath.parent_path() / dependency);
+			}
+
+			if (bKeyValid)
+			{
+				keyBuilder.append(context->bNativeGLTF);
+				keyBuilder.append(isStaticMeshOptimizeEnable());
+				keyBuilder.append(isStaticMeshMeshletEnable());
+				keyBuilder.append(isStaticMeshCompactVertexEnable());
+				keyBuilder.append(isStaticMeshLodEnable());
+				keyBuilder.append(getStaticMeshLodCount());
+				keyBuilder.append(getStaticMeshLodMaxError());
+				keyBuilder.append(kAssimpStaticMeshImportFlags);
+				derivedDataKey = keyBuilder.build();
+			}
+		}
+
+		std::string assetNameUtf8 = utf8::utf16to8(savePath.filename().u16string());
+
+		// Reimport write into exist folder, keep uuid of mesh, materials and textures.
+		const bool bReimport = context->config->bReimport;
+		if (!bReimport && std::filesystem::exists(savePath))
+		{
+			LOG_ERROR("Path {0} already exist, asset {1} import fail!", utf8::utf16to8(savePath.u16string()), assetNameUtf8);
 			return false;
 		}
 
@@ -93,6 +257,18 @@ namespace engine
 		const auto materialFolderPath = savePath / "materials";
 		const auto rawAssetFolderPath = savePath / "raw";
 
+		const bool bDerivedDataExist = !derivedDataKey.empty() && derivedDataCache->contains(derivedDataKey);
+		if (!bDerivedDataExist && !context->parseRawMesh())
+		{
+			return false;
+		}
+
+		if (!std::filesystem::create_directory(savePath) && !bReimport)
+		{
+			LOG_ERROR("Folder {0} create failed, asset {1} import fail!", utf8::utf16to8(savePath.u16string()), assetNameUtf8);
+			return false;
+		}
+
 		std::filesystem::create_directory(textureFolderPath);
 		std::filesystem::create_directory(materialFolderPath);
 		std::filesystem::create_directory(rawAssetFolderPath);
@@ -101,41 +277,99 @@ namespace engine
 		const auto relativePathUtf8 = buildRelativePathUtf8(getAssetManager()->getProjectConfig().assetPath, savePath);
 
 		auto saveInfo = AssetSaveInfo(utf8::utf16to8(name), relativePathUtf8);
-		auto meshPtr = getAssetManager()->createAsset<AssetStaticMesh>(saveInfo).lock();
+		auto meshPtr = getAssetManager()->createImportAsset<AssetStaticMesh>(saveInfo, bReimport);
 		meshPtr->markDirty();
+		context->meshPtr = meshPtr;
 
-		// Copy raw asset.
+		// Copy raw asset, reimport overwrite old copy.
 		{
+			const auto copyOptions = bReimport ? std::filesystem::copy_options::overwrite_existing : std::filesystem::copy_options::none;
+
 			auto copyDest = rawAssetFolderPath / srcPath.filename();
-			std::filesystem::copy(srcPath, copyDest);
+			std::filesystem::copy(srcPath, copyDest, copyOptions);
 
-			// Copy material path.
+			// Copy dependencies, keep relative path so raw asset can reimport.
+			for (const auto& dependency : rawDependencies)
 			{
-				auto fileName = srcPath.filename();
-				auto mtlFileName = fileName.stem();
-				mtlFileName += ".mtl";
-
-				std::filesystem::path mtlPath = srcPath.parent_path();
-				mtlPath /= mtlFileName;
+				const auto copyDestDependency = rawAssetFolderPath / dependency;
 
-				if (std::filesystem::exists(mtlPath))
-				{
-					auto copyDestMtl = rawAssetFolderPath / mtlPath.filename();
-					std::filesystem::copy(mtlPath, copyDestMtl);
-				}
+				std::error_code ec;
+				std::filesystem::create_directories(copyDestDependency.parent_path(), ec);
+				std::filesystem::copy(srcPath.parent_path() / dependency, copyDestDependency,
+					bReimport ? std::filesystem::copy_options::overwrite_existing : std::filesystem::copy_options::skip_existing, ec);
 			}
 
 			meshPtr->m_rawAssetPath = buildRelativePathUtf8(getAssetManager()->getProjectConfig().assetPath, rawAssetFolderPath);
+			meshPtr->m_importSource = buildAssetImportSource(*context->config, rawDependencies);
 		}
 
-		AssimpStaticMeshImporter processor(srcPath, materialFolderPath, textureFolderPath);
-		processor.processNode(scene->mRootNode, scene);
+		StaticMeshDerivedData& derivedData = context->derivedData;
+		std::vector<ImportJobGraph::JobId> saveDependencies { };
+		if (!derivedDataKey.empty() && derivedDataCache->fetch(derivedDataKey, derivedData, { meshPtr->getBinPath() }))
+		{
+			context->bDerivedDataHit = true;
+
+			meshPtr->m_subMeshes     = derivedData.subMeshes;
+			meshPtr->m_indicesCount  = derivedData.indicesCount;
+			meshPtr->m_indicesWordsCount = derivedData.indicesWordsCount;
+			meshPtr->m_verticesCount = derivedData.verticesCount;
+			meshPtr->m_vertexFormat  = derivedData.vertexFormat;
+			meshPtr->m_minPosition   = derivedData.minPosition;
+			meshPtr->m_maxPosition   = derivedData.maxPosition;
+		}
+		else
+		{
+			// Entry evict between contains and fetch, parse raw mesh now.
+			if (bDerivedDataExist && !context->parseRawMesh())
+			{
+				return false;
+			}
+
+			// Layout pass build material descs, so material jobs can run concurrently with geometry cook.
+			if (context->bNativeGLTF)
+			{
+				context->gltfProcessor->collectScene();
+				derivedData.subMeshMaterials = context->gltfProcessor->getSubMeshMaterialDescIndices();
+				derivedData.materials        = context->gltfProcessor->getMaterialDescs();
+			}
+			else
+			{
+				context->assimpProcessor->collectMeshes(context->scene->mRootNode, context->scene);
+				derivedData.subMeshMaterials = context->assimpProcessor->getSubMeshMaterialDescIndices();
+				derivedData.materials        = context->assimpProcessor->getMaterialDescs();
+			}
+		}
 
-		// Save asset meta.
-		processor.fillMeshAssetMeta(*meshPtr);
+		// Material jobs add before geometry job, so geometry job own derived data once it start.
+		// Derived data hit rebuild materials from desc, textures also reuse derived data cache.
+		StaticMeshMaterialImporter materialImporter(srcPath, materialFolderPath, textureFolderPath, bReimport);
+		context->materialUUIDs = materialImporter.addImportJobs(derivedData.materials, graph, saveDependencies);
+
+		if (!context->bDerivedDataHit)
+		{
+			saveDependencies.push_back(graph.addJob(EImportJobStage::Geometry, assetNameUtf8, [context]()
+			{
+				return context->cookGeometry();
+			}));
+		}
+
+		graph.addJob(EImportJobStage::Save, assetNameUtf8, [context]()
+		{
+			return context->save();
+		}, saveDependencies);
+
+		return true;
+	}
+
+	bool StaticMeshImportContext::cookGeometry()
+	{
+		const auto& srcPath = getSrcPath();
 
-		// Save static mesh binary file.
+		// Fill asset meta and save bin, same for both importer.
+		auto cookMesh = [&](auto& processor)
 		{
+			processor.fillMeshAssetMeta(*meshPtr);
+
 			StaticMeshBin meshBin{};
 			meshBin.indices = processor.moveIndices();
 			meshBin.tangents = processor.moveTangents();
@@ -143,12 +377,116 @@ namespace engine
 			meshBin.uv0s = processor.moveUv0s();
 			meshBin.positions = processor.movePositions();
 
-			saveAsset(meshBin, meshPtr->getBinPath(), false);
+			// Reorder for vertex cache, overdraw and vertex fetch, submesh ranges no change.
+			const auto debugName = utf8::utf16to8(srcPath.filename().u16string());
+			optimizeStaticMesh(meshPtr->m_subMeshes, meshBin, debugName);
+
+			// LODs simplify from optimized LOD0, submesh index ranges rebuild.
+			buildStaticMeshLods(meshPtr->m_subMeshes, meshBin, debugName);
+			meshPtr->m_indicesCount = meshBin.indices.size();
+
+			// Meshlet split keep index order, so build after optimize.
+			buildStaticMeshMeshlets(meshPtr->m_subMeshes, meshBin, debugName);
+
+			// Compact encode relative to final submesh bounds, shared vertices may duplicate.
+			if (compactStaticMeshVertices(meshPtr->m_subMeshes, meshBin, debugName))
+			{
+				meshPtr->m_vertexFormat  = EVertexFormat_Compact;
+				meshPtr->m_verticesCount = meshBin.positionsCompact.size();
+			}
+
+			// Indices final, pack to submesh local.
+			packStaticMeshIndices(meshPtr->m_subMeshes, meshBin, debugName);
+			meshPtr->m_indicesWordsCount = meshBin.indicesPacked.empty() ? meshBin.indices.size() : meshBin.indicesPacked.size();
+
+			meshBin.saveBinaryStreams(meshPtr->getBinPath());
+		};
+
+		// Embedded gltf images extract into project raw folder, material desc can't reuse by other project.
+		bool bStoreDerivedData = !derivedDataKey.empty();
+		if (bNativeGLTF)
+		{
+			if (!gltfProcessor->processPrimitives())
+			{
+				LOG_ERROR("Mesh {} has invalid primitive, import fail.", utf8::utf16to8(srcPath.u16string()));
+				return false;
+			}
+			cookMesh(*gltfProcessor);
+
+			bStoreDerivedData = bStoreDerivedData && !gltfProcessor->hasEmbeddedImages();
+		}
+		else
+		{
+			assimpProcessor->processMeshes();
+			cookMesh(*assimpProcessor);
 		}
 
+		// Raw mesh no longer used, release before other heavy jobs start.
+		gltfProcessor = nullptr;
+		assimpProcessor = nullptr;
+		importer.FreeScene();
+		scene = nullptr;
+
+		// Store derived data, material uuid is project relative so store desc index instead.
+		if (bStoreDerivedData)
+		{
+			derivedData.subMeshes        = meshPtr->m_subMeshes;
+			derivedData.indicesCount     = meshPtr->m_indicesCount;
+			derivedData.indicesWordsCount = meshPtr->m_indicesWordsCount;
+			derivedData.verticesCount    = meshPtr->m_verticesCount;
+			derivedData.vertexFormat     = meshPtr->m_vertexFormat;
+			derivedData.minPosition      = meshPtr->m_minPosition;
+			derivedData.maxPosition      = meshPtr->m_maxPosition;
+
+			for (auto& subMesh : derivedData.subMeshes)
+			{
+				subMesh.material = {};
+			}
+
+			getDerivedDataCache()->store(derivedDataKey, derivedData, { meshPtr->getBinPath() });
+		}
+
+		return true;
+	}
+
+	bool StaticMeshImportContext::save()
+	{
+		const auto& materialUUIDs = *this->materialUUIDs;
+		for (size_t i = 0; i < meshPtr->m_subMeshes.size(); i++)
+		{
+			const int32_t materialIndex = derivedData.subMeshMaterials[i];
+			meshPtr->m_subMeshes[i].material = materialIndex >= 0 ? materialUUIDs[materialIndex] : UUID{};
+		}
+
+		logImportTime();
 		return meshPtr->save();
 	}
 
+	static void buildStaticMeshImportJobs(
+		std::shared_ptr<AssetImportConfigInterface> inPtr, ImportJobGraph& graph)
+	{
+		auto context = std::make_shared<StaticMeshImportContext>();
+		context->config = std::static_pointer_cast<AssetStaticMeshImportConfig>(inPtr);
+
+		const auto nameUtf8 = utf8::utf16to8(context->getSrcPath().filename().u16string());
+		graph.addJob(EImportJobStage::Decode, nameUtf8, [context, &graph]()
+		{
+			return StaticMeshImportContext::decode(context, graph);
+		});
+	}
+
+	static bool importStaticMeshFromConfigThreadSafe(
+		std::shared_ptr<AssetImportConfigInterface> inPtr)
+	{
+		ImportJobGraph graph;
+		buildStaticMeshImportJobs(inPtr, graph);
+
+		graph.execute();
+		graph.wait();
+
+		return graph.getFailedCount() == 0;
+	}
+
 	const AssetReflectionInfo& AssetStaticMesh::uiGetAssetReflectionInfo()
 	{
 		const static AssetReflectionInfo kInfo =
@@ -159,7 +497,7 @@ namespace engine
 			.importConfig =
 			{
 				.bImportable = true,
-				.importRawAssetExtension = "obj",
+				.importRawAssetExtension = "obj,gltf,glb;obj;gltf,glb",
 				.buildAssetImportConfig = []() 
 				{ 
 					return std::make_shared<AssetStaticMeshImportConfig>(); 
@@ -172,6 +510,10 @@ namespace engine
 				{ 
 					return importStaticMeshFromConfigThreadSafe(ptr); 
 				},
+				.buildImportJobs = [](AssetReflectionInfo::ImportConfigPtr ptr, ImportJobGraph& graph)
+				{
+					buildStaticMeshImportJobs(ptr, graph);
+				},
 			}
 		};
 		return kInfo;
@@ -195,21 +537,17 @@ namespace engine
 		RHICommandBufferBase& commandBuffer, 
 		VulkanBuffer& stageBuffer)
 	{
-		StaticMeshBin meshBin{};
-		if (!std::filesystem::exists(cachePtr->getBinPath()))
+		if (!isAssetFileExist(cachePtr->getBinPath()))
 		{
 			UN_IMPLEMENT();
 		}
-		else
-		{
-			LOG_TRACE("Found bin for asset {} cache in disk so just load.",
-				utf8::utf16to8(cachePtr->getSaveInfo().getStorePath()));
-			loadAsset(meshBin, cachePtr->getBinPath());
-		}
+
+		LOG_TRACE("Found bin for asset {} cache in disk so just load.",
+			utf8::utf16to8(cachePtr->getSaveInfo().getStorePath()));
 
 		uint32_t sizeAccumulate = 0;
 
-		auto copyBuffer = [&](const GPUStaticMeshAsset::ComponentBuffer& comp, const void* data)
+		auto copyBuffer = [&](const GPUStaticMeshAsset::ComponentBuffer& comp, std::function<void(void* dest, size_t size)>&& fillFunc)
 		{
 			VkBufferCopy regionCopy{ };
 
@@ -217,18 +555,62 @@ namespace engine
 			regionCopy.srcOffset = stageBufferOffset + sizeAccumulate;
 			regionCopy.dstOffset = 0;
 
-			memcpy((void*)((char*)bufferPtrStart + sizeAccumulate), data, regionCopy.size);
+			fillFunc((void*)((char*)bufferPtrStart + sizeAccumulate), regionCopy.size);
 
 			vkCmdCopyBuffer(commandBuffer.cmd, stageBuffer, comp.buffer->getVkBuffer(), 1, &regionCopy);
 
 			sizeAccumulate += regionCopy.size;
 		};
 
-		copyBuffer(meshAssetGPU->getIndices(),   meshBin.indices.data());
-		copyBuffer(meshAssetGPU->getPositions(), meshBin.positions.data());
-		copyBuffer(meshAssetGPU->getNormals(),   meshBin.normals.data());
-		copyBuffer(meshAssetGPU->getUV0s(),      meshBin.uv0s.data());
-		copyBuffer(meshAssetGPU->getTangents(),  meshBin.tangents.data());
+		AssetBinaryStreamReader reader{};
+		if (reader.open(cachePtr->getBinPath()))
+		{
+			// Stream order same with upload order, decompress from file mapping into stage buffer directly.
+			uint32_t streamIndex = 0;
+			auto decompressBuffer = [&](const GPUStaticMeshAsset::ComponentBuffer& comp)
+			{
+				copyBuffer(comp, [&](void* dest, size_t size)
+				{
+					ASSERT(reader.getStreamSize(streamIndex) == size, "Static mesh stream size un-match!");
+					CHECK(reader.decompressStream(streamIndex, dest, Engine::get()->getThreadPool()));
+				});
+				streamIndex++;
+			};
+
+			decompressBuffer(meshAssetGPU->getIndices());
+			decompressBuffer(meshAssetGPU->getPositions());
+			decompressBuffer(meshAssetGPU->getNormals());
+			decompressBuffer(meshAssetGPU->getUV0s());
+			decompressBuffer(meshAssetGPU->getTangents());
+
+			// Meshlet stream is optional.
+			if (meshAssetGPU->getMeshlets().buffer)
+			{
+				ASSERT(reader.getStreamCount() > streamIndex, "Static mesh meshlet stream miss!");
+				decompressBuffer(meshAssetGPU->getMeshlets());
+			}
+		}
+		else
+		{
+			// Fallback to legacy cereal bin file.
+			StaticMeshBin meshBin{};
+			loadAsset(meshBin, cachePtr->getBinPath());
+
+			auto memcpyBuffer = [&](const GPUStaticMeshAsset::ComponentBuffer& comp, const void* data)
+			{
+				copyBuffer(comp, [&](void* dest, size_t size) { memcpy(dest, data, size); });
+			};
+
+			memcpyBuffer(meshAssetGPU->getIndices(),   meshBin.indices.data());
+			memcpyBuffer(meshAssetGPU->getPositions(), meshBin.positions.data());
+			memcpyBuffer(meshAssetGPU->getNormals(),   meshBin.normals.data());
+			memcpyBuffer(meshAssetGPU->getUV0s(),      meshBin.uv0s.data());
+			memcpyBuffer(meshAssetGPU->getTangents(),  meshBin.tangents.data());
+
+			// Legacy bin never cook with meshlet or compact vertex.
+			CHECK(meshAssetGPU->getMeshlets().buffer == nullptr);
+			CHECK(meshAssetGPU->getVertexFormat() == EVertexFormat_Float);
+		}
 
 		ASSERT(uploadSize() == sizeAccumulate, "Static mesh size un-match!");
 	}
@@ -241,7 +623,9 @@ namespace engine
 			getContext()->getBuiltinStaticMeshBox().get(),
 			meta->getSaveInfo().getName(),
 			meta->getVerticesCount(),
-			meta->getIndicesCount()
+			meta->getIndicesWordsCount(),
+			meta->getMeshletsCount(),
+			meta->getVertexFormat()
 		);
 
 		getContext()->insertLRUAsset(meta->getBinUUID(), newAsset);
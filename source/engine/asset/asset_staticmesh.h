@@ -10,6 +10,16 @@ namespace engine
 	struct AssetStaticMeshImportConfig : public AssetImportConfigInterface
 	{
 		bool bImportMaterial = false;
+
+		virtual void saveSettings(cereal::BinaryOutputArchive& archive) const override
+		{
+			archive(bImportMaterial);
+		}
+
+		virtual void loadSettings(cereal::BinaryInputArchive& archive) override
+		{
+			archive(bImportMaterial);
+		}
 	};
 
 	class AssetStaticMesh : public AssetInterface
@@ -17,7 +27,8 @@ namespace engine
 		REGISTER_BODY_DECLARE(AssetInterface);
 
 		friend class AssimpStaticMeshImporter;
-		friend bool importStaticMeshFromConfigThreadSafe(std::shared_ptr<AssetImportConfigInterface> ptr);
+		friend class GLTFStaticMeshImporter;
+		friend struct StaticMeshImportContext;
 
 	public:
 		AssetStaticMesh() = default;
@@ -28,6 +39,7 @@ namespace engine
 		// ~AssetInterface virtual function.
 		virtual EAssetType getType() const override { return EAssetType::darkstaticmesh; }
 		virtual void onPostAssetConstruct() override;
+		virtual void collectDependencies(std::vector<UUID>& outDependencies) const override;
 		// ~AssetInterface virtual function.
 
 		// ~Asset import reflection functions.
@@ -46,6 +58,15 @@ namespace engine
 		size_t getVerticesCount() const { return m_verticesCount; }
 		size_t getIndicesCount() const { return m_indicesCount; }
 
+		// Index buffer size in words, less than indices count when submesh use 16 bit indices.
+		size_t getIndicesWordsCount() const { return m_indicesWordsCount; }
+
+		// Total meshlet count of all submeshes.
+		size_t getMeshletsCount() const;
+
+		// Compact vertex position is relative to submesh bounds.
+		EVertexFormat getVertexFormat() const { return m_vertexFormat; }
+
 		static bool isStaticMesh(const char* ext)
 		{
 			if (ext == getCDO()->getSuffix())
@@ -67,8 +88,12 @@ namespace engine
 	private:
 		std::vector<StaticMeshSubMesh> m_subMeshes = {};
 		size_t m_indicesCount;
+		size_t m_indicesWordsCount;
 		size_t m_verticesCount;
 
+		// Vertex streams format choose when cook.
+		EVertexFormat m_vertexFormat = EVertexFormat_Float;
+
 		// AABB bounds.
 		math::vec3 m_minPosition = {};
 		math::vec3 m_maxPosition = {};
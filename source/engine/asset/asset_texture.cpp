@@ -4,137 +4,17 @@
 #include <rttr/registration.h>
 #include <nameof/nameof.hpp>
 #include "asset_manager.h"
+#include "derived_data_cache.h"
+#include "asset_reimport.h"
+#include "import_job_graph.h"
+#include "../engine.h"
 #include <stb/stb_image.h>
 #include <stb/stb_image_resize.h>
+#include <tinyexr/tinyexr.h>
 #include <renderer/render_scene.h>
 
 namespace engine
 {
-	template<typename T> 
-	inline float getQuantifySize() 
-	{ 
-		CHECK(false);
-		return 0.0f; 
-	}
-
-	template<> 
-	inline float getQuantifySize<uint8_t>() 
-	{ 
-		return float(1 << 8) - 1.0f; 
-	}
-
-	template<> 
-	inline float getQuantifySize<uint16_t>() 
-	{ 
-		return float(1 << 16) - 1.0f; 
-	}
-
-	template<> 
-	inline float getQuantifySize<float>() 
-	{
-		return 1.0f; 
-	}
-
-	// Genric mipmap data generation.
-	template<typename T>
-	void buildMipmapData(
-		T* srcPixels, 
-		const AssetTexture& meta, 
-		AssetTextureBin& outBinData, 
-		uint32_t channelCount, 
-		uint32_t channelOffset)
-	{
-		const float kQuantitySize = getQuantifySize<T>();
-
-		if (meta.getAlphaMipmapCutOff() < 1.0f)
-		{
-			LOG_WARN("Texture {0} build mipmap with alpha cutoff {1}, but don't support alpha scale yet.", 
-				meta.getName(), meta.getAlphaMipmapCutOff());
-		}
-
-		if (meta.isSRGB())
-		{
-			LOG_WARN("Texture {0} build mipmap require srgb convert, but don't support here!",
-				meta.getName());
-		}
-
-		// Prepare mipmap datas.
-		outBinData.mipmapDatas.resize(meta.getMipmapCount());
-
-		// Get strip size.
-		const auto kStripSize = sizeof(T) * channelCount;
-
-		// Now build each mipmap.
-		for (size_t mip = 0; mip < outBinData.mipmapDatas.size(); mip++)
-		{
-			auto& destMipData = outBinData.mipmapDatas[mip];
-
-			// Allocate memory.
-			uint32_t destWidth  = math::max<uint32_t>(meta.getDimension().x >> mip, 1);
-			uint32_t destHeight = math::max<uint32_t>(meta.getDimension().y >> mip, 1);
-			destMipData.resize(destWidth * destHeight * kStripSize);
-
-			T* pDestData = (T*)destMipData.data();
-
-			if (mip == 0)
-			{
-				for (size_t i = 0; i < destWidth * destHeight; i++)
-				{
-					for (size_t j = 0; j < channelCount; j++)
-					{
-						pDestData[i * channelCount + j] = srcPixels[i * 4 + j + channelOffset];
-					}
-				}
-			}
-			else
-			{
-				const size_t srcMip = mip - 1;
-				const auto& srcMipData = outBinData.mipmapDatas[srcMip];
-				for (size_t y = 0; y < destHeight; y++)
-				{
-					for (size_t x = 0; x < destWidth; x++)
-					{
-						// Get src data.
-						uint32_t srcWidth  = std::max<uint32_t>(meta.getDimension().x >> srcMip, 1);
-						uint32_t srcHeight = std::max<uint32_t>(meta.getDimension().y >> srcMip, 1);
-
-						// Clamp src data fetech edge.
-						size_t srcX0 = (size_t)std::min<uint32_t>(uint32_t(x * 2 + 0), srcWidth  - 1);
-						size_t srcX1 = (size_t)std::min<uint32_t>(uint32_t(x * 2 + 1), srcWidth  - 1);
-						size_t srcY0 = (size_t)std::min<uint32_t>(uint32_t(y * 2 + 0), srcHeight - 1);
-						size_t srcY1 = (size_t)std::min<uint32_t>(uint32_t(y * 2 + 1), srcHeight - 1);
-						size_t srcPixelStart[] =
-						{
-							(srcY0 * srcWidth + srcX0) * channelCount, // X0Y0
-							(srcY0 * srcWidth + srcX1) * channelCount, // X1Y0
-							(srcY1 * srcWidth + srcX0) * channelCount, // X0Y1
-							(srcY1 * srcWidth + srcX1) * channelCount, // X1Y1
-						};
-
-						const T* pSrcData = (const T*)srcMipData.data();
-						size_t destPixelPosStart = (y * destWidth + x) * channelCount;
-
-						for (size_t channelId = 0; channelId < channelCount; channelId++)
-						{
-							float sumValue = 0.0f;
-							for (size_t srcPixelId = 0; srcPixelId < 4; srcPixelId++)
-							{
-								const T& valueLoad = pSrcData[srcPixelStart[srcPixelId] + channelId];
-								const float v = float(valueLoad) / kQuantitySize;
-
-								sumValue += v;
-							}
-							sumValue *= 0.25f;
-
-							pDestData[destPixelPosStart + channelId] = T(sumValue * kQuantitySize);
-						}
-					}
-				}
-			}
-			CHECK(destHeight * destWidth * kStripSize == destMipData.size());
-		}
-	}
-
 	static inline void getChannelCountOffset(uint32_t& channelCount, uint32_t& pixelSampleOffset, ETextureFormat format)
 	{
 		switch (format)
@@ -143,6 +23,8 @@ namespace engine
 		case engine::ETextureFormat::R8G8B8A8:
 		case engine::ETextureFormat::BC3:
 		case engine::ETextureFormat::BC1:
+		case engine::ETextureFormat::BC7:
+		case engine::ETextureFormat::BC6H:
 		{ 
 			channelCount = 4; 
 			pixelSampleOffset = 0; 
@@ -233,6 +115,24 @@ namespace engine
 				ImGui::TableSetColumnIndex(1);
 				ImGui::SliderFloat("##AlphaCutoff", &config->alphaMipmapCutoff, 0.0f, 1.0f, "%.2f");
 
+				int filterValue = (int)config->mipmapFilter;
+
+				std::array<std::string, (size_t)EMipmapFilter::Max> filterList { };
+				std::array<const char*, (size_t)EMipmapFilter::Max> filterListChar { };
+				for (size_t i = 0; i < filterList.size(); i++)
+				{
+					std::string prefix = (filterValue == i) ? "  * " : "    ";
+					filterList[i] = std::format("{0} {1}", prefix, nameof::nameof_enum(EMipmapFilter(i)));
+					filterListChar[i] = filterList[i].c_str();
+				}
+
+				ImGui::TableNextRow();
+				ImGui::TableSetColumnIndex(0);
+				ImGui::Text("Mipmap Filter");
+				ImGui::TableSetColumnIndex(1);
+				ImGui::Combo("##MipmapFilter", &filterValue, filterListChar.data(), filterListChar.size());
+				config->mipmapFilter = EMipmapFilter(filterValue);
+
 				int formatValue = (int)config->format;
 
 				std::array<std::string, (size_t)ETextureFormat::Max> formatList { };
@@ -251,6 +151,27 @@ namespace engine
 				ImGui::Combo("##Format", &formatValue, formatListChar.data(), formatListChar.size());
 				config->format = ETextureFormat(formatValue);
 
+				if (config->format == ETextureFormat::BC7)
+				{
+					int qualityValue = (int)config->bc7Quality;
+
+					std::array<std::string, (size_t)EBC7Quality::Max> qualityList { };
+					std::array<const char*, (size_t)EBC7Quality::Max> qualityListChar { };
+					for (size_t i = 0; i < qualityList.size(); i++)
+					{
+						std::string prefix = (qualityValue == i) ? "  * " : "    ";
+						qualityList[i] = std::format("{0} {1}", prefix, nameof::nameof_enum(EBC7Quality(i)));
+						qualityListChar[i] = qualityList[i].c_str();
+					}
+
+					ImGui::TableNextRow();
+					ImGui::TableSetColumnIndex(0);
+					ImGui::Text("BC7 Quality");
+					ImGui::TableSetColumnIndex(1);
+					ImGui::Combo("##BC7Quality", &qualityValue, qualityListChar.data(), qualityListChar.size());
+					config->bc7Quality = EBC7Quality(qualityValue);
+				}
+
 				ImGui::EndTable();
 			}
 		}
@@ -326,10 +247,48 @@ namespace engine
 			return VK_FORMAT_R8G8_UNORM;
 		}
 
+		if (ETextureFormat::BC7 == config.format)
+		{
+			if (bCanCompressed)
+			{
+				return config.bSRGB ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+			}
+			return config.bSRGB ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+		}
+
+		if (ETextureFormat::BC6H == config.format)
+		{
+			// Hdr source keep half float when can't compress, half size of float and still cover hdr range.
+			if (bCanCompressed)
+			{
+				return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+			}
+			return VK_FORMAT_R16G16B16A16_SFLOAT;
+		}
+
 		CHECK_ENTRY();
 		return VK_FORMAT_R8_UNORM;
 	}
 
+	// Texture cooker version, bump when mipmap generate or compress code change.
+	static const uint32_t kTextureCookerVersion = 5;
+
+	// Asset texture basic info store in derived data cache, bin and snapshot store as payloads.
+	struct TextureDerivedData
+	{
+		bool bSRGB = false;
+		uint32_t mipmapCount = 1;
+		uint32_t format = 0;
+		math::uvec3 dimension = {};
+		float alphaMipmapCutoff = 1.0f;
+
+		template<class Archive>
+		void serialize(Archive& archive)
+		{
+			archive(bSRGB, mipmapCount, format, dimension, alphaMipmapCutoff);
+		}
+	};
+
 	static bool loadLdrTexture(std::shared_ptr<AssetImportConfigInterface> ptr)
 	{
 		const std::filesystem::path& srcPath = ptr->path.first;
@@ -407,7 +366,8 @@ namespace engine
 					texturePtr->m_mipmapCount,
 					texturePtr->m_dimension.x,
 					texturePtr->m_dimension.y,
-					texturePtr->m_alphaMipmapCutoff);
+					texturePtr->m_alphaMipmapCutoff,
+					config->mipmapFilter);
 
 				switch (texturePtr->getFormat())
 				{
@@ -424,15 +384,17 @@ namespace engine
 				case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
 				case VK_FORMAT_BC5_UNORM_BLOCK:
 				case VK_FORMAT_BC4_UNORM_BLOCK:
+				case VK_FORMAT_BC7_UNORM_BLOCK:
+				case VK_FORMAT_BC7_SRGB_BLOCK:
 				{
 					CHECK(bCanCompressed);
-					mipmapCompressBC(bin, *texturePtr);
+					mipmapCompressBC(bin, *texturePtr, config->bc7Quality);
 				}
 				break;
 				default: UN_IMPLEMENT();
 				}
 
-				saveAsset(bin, texturePtr->getBinPath(), false);
+				bin.saveBinaryStreams(texturePtr->getBinPath());
 			}
 		}
 		stbi_image_free(pixels);
@@ -449,6 +411,9 @@ namespace engine
 
 		auto config = std::static_pointer_cast<AssetTextureImportConfig>(ptr);
 
+		// Record before import, mipmap state may override by texture dimension.
+		AssetImportSource importSource = buildAssetImportSource(*config);
+
 		// Build texture ptr.
 		const auto name = savePath.filename().u16string() + utf8::utf8to16(AssetTexture::getCDO()->getSuffix());
 		const auto relativePathUtf8 =
@@ -456,7 +421,7 @@ namespace engine
 
 		// Create asset texture.
 		AssetSaveInfo saveInfo(utf8::utf16to8(name), relativePathUtf8);
-		std::shared_ptr<AssetTexture> texturePtr = getAssetManager()->createAsset<AssetTexture>(saveInfo).lock();
+		std::shared_ptr<AssetTexture> texturePtr = getAssetManager()->createImportAsset<AssetTexture>(saveInfo, config->bReimport);
 		texturePtr->markDirty();
 
 		uint32_t channelCount;
@@ -504,7 +469,8 @@ namespace engine
 						texturePtr->m_mipmapCount,
 						texturePtr->m_dimension.x,
 						texturePtr->m_dimension.y,
-						texturePtr->m_alphaMipmapCutoff);
+						texturePtr->m_alphaMipmapCutoff,
+					config->mipmapFilter);
 
 					switch (texturePtr->getFormat())
 					{
@@ -521,15 +487,17 @@ namespace engine
 					case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
 					case VK_FORMAT_BC5_UNORM_BLOCK:
 					case VK_FORMAT_BC4_UNORM_BLOCK:
+					case VK_FORMAT_BC7_UNORM_BLOCK:
+					case VK_FORMAT_BC7_SRGB_BLOCK:
 					{
 						CHECK(bCanCompressed);
-						mipmapCompressBC(bin, *texturePtr);
+						mipmapCompressBC(bin, *texturePtr, config->bc7Quality);
 					}
 					break;
 					default: UN_IMPLEMENT();
 					}
 
-					saveAsset(bin, texturePtr->getBinPath(), false);
+					bin.saveBinaryStreams(texturePtr->getBinPath());
 				}
 			}
 			stbi_image_free(pixels);
@@ -600,64 +568,250 @@ namespace engine
 			// Build mipmap.
 			{
 				AssetTextureBin bin{};
-				buildMipmapData<uint16_t>(pixels, *texturePtr, bin, channelCount, pixelSampleOffset);
-				saveAsset(bin, texturePtr->getBinPath(), false);
+				buildMipmapData16Bit(channelCount, pixelSampleOffset, pixels, bin,
+					texturePtr->m_mipmapCount,
+					texturePtr->m_dimension.x,
+					texturePtr->m_dimension.y,
+					config->mipmapFilter);
+				bin.saveBinaryStreams(texturePtr->getBinPath());
 			}
 
 			stbi_image_free(pixels);
 			return true;
 		};
 
-		bool bImportSucceed = false;
-		switch (config->format)
+		// Float RGBA source from exr or 16 bit file, mipmap build in float then compress to BC6H.
+		auto importHdrTexture = [&]() -> bool
 		{
-		case ETextureFormat::R8G8B8A8:
-		case ETextureFormat::BC3:
-		case ETextureFormat::BC1:
-		case ETextureFormat::BC5:
-		case ETextureFormat::R8G8:
-		case ETextureFormat::Greyscale:
-		case ETextureFormat::R8:
-		case ETextureFormat::G8:
-		case ETextureFormat::B8:
-		case ETextureFormat::A8:
-		case ETextureFormat::BC4Greyscale:
-		case ETextureFormat::BC4R8:
-		case ETextureFormat::BC4G8:
-		case ETextureFormat::BC4B8:
-		case ETextureFormat::BC4A8:
+			int32_t texWidth, texHeight;
+			std::vector<float> pixels;
+
+			if (srcPath.extension() == ".exr")
+			{
+				float* exrPixels = nullptr;
+				const char* err = nullptr;
+				if (TINYEXR_SUCCESS != LoadEXR(&exrPixels, &texWidth, &texHeight, srcPath.string().c_str(), &err))
+				{
+					if (err)
+					{
+						LOG_ERROR("Err import exr: {}.", err);
+						FreeEXRErrorMessage(err);
+					}
+					return false;
+				}
+
+				pixels.assign(exrPixels, exrPixels + size_t(texWidth) * texHeight * 4);
+				free(exrPixels);
+			}
+			else
+			{
+				int32_t texChannels;
+				stbi_us* halfPixels = stbi_load_16(srcPath.string().c_str(), &texWidth, &texHeight, &texChannels, 4);
+				if (!halfPixels)
+				{
+					return false;
+				}
+
+				pixels.resize(size_t(texWidth) * texHeight * 4);
+				for (size_t i = 0; i < pixels.size(); i++)
+				{
+					pixels[i] = float(halfPixels[i]) / 65535.0f;
+				}
+				stbi_image_free(halfPixels);
+			}
+
+			// Texture is power of two.
+			const bool bPOT = isPOT(texWidth) && isPOT(texHeight);
+
+			// Override mipmap state by texture dimension.
+			config->bGenerateMipmap = bPOT ? config->bGenerateMipmap : false;
+
+			const bool bCanCompressed = bPOT && (texWidth >= 4) && (texHeight >= 4);
+
+			texturePtr->initBasicInfo(
+				false, // No srgb for hdr texture.
+				config->bGenerateMipmap ? getMipLevelsCount(texWidth, texHeight) : 1U,
+				getFormatFromConfig(*config, bCanCompressed),
+				{ texWidth, texHeight, 1 },
+				1.0f); // No alpha cutoff for mipmap.
+
+			// Build snapshot, clamp to ldr range.
+			{
+				std::vector<uint8_t> ldrPixels(pixels.size());
+				for (size_t i = 0; i < ldrPixels.size(); i++)
+				{
+					ldrPixels[i] = uint8_t(math::clamp(pixels[i], 0.0f, 1.0f) * 255.0f);
+				}
+
+				std::vector<uint8_t> data{};
+				texturePtr->buildSnapshot(data, ldrPixels.data(), 4);
+				saveAsset(data, texturePtr->getSnapshotPath(), false);
+			}
+
+			// Build mipmap.
+			{
+				AssetTextureBin bin{};
+				buildMipmapDataFloat(4, 0, pixels.data(), bin,
+					texturePtr->m_mipmapCount,
+					texturePtr->m_dimension.x,
+					texturePtr->m_dimension.y,
+					config->mipmapFilter);
+
+				if (texturePtr->getFormat() == VK_FORMAT_BC6H_UFLOAT_BLOCK)
+				{
+					mipmapCompressBC(bin, *texturePtr);
+				}
+				else
+				{
+					// Float mip convert to half, clamp to half max so no inf.
+					for (auto& mipData : bin.mipmapDatas)
+					{
+						const float* src = (const float*)mipData.data();
+						const size_t pairCount = mipData.size() / (2 * sizeof(float));
+
+						std::vector<uint8_t> halfData(pairCount * sizeof(uint32_t));
+						uint32_t* dest = (uint32_t*)halfData.data();
+						for (size_t i = 0; i < pairCount; i++)
+						{
+							dest[i] = math::packHalf2x16(math::clamp(math::vec2(src[i * 2 + 0], src[i * 2 + 1]), -65504.0f, 65504.0f));
+						}
+
+						mipData = std::move(halfData);
+					}
+				}
+
+				bin.saveBinaryStreams(texturePtr->getBinPath());
+			}
+
+			return true;
+		};
+
+		// Reuse cooked data from derived data cache when source content and import settings unchanged.
+		DerivedDataCache* derivedDataCache = getDerivedDataCache();
+		std::string derivedDataKey;
+		if (derivedDataCache)
 		{
-			bImportSucceed = importLdrTexture();
-			break;
+			DerivedDataKeyBuilder keyBuilder("texture", kTextureCookerVersion);
+			if (keyBuilder.appendFile(srcPath))
+			{
+				keyBuilder.append(config->format);
+				keyBuilder.append(config->bSRGB);
+				keyBuilder.append(config->bGenerateMipmap);
+				keyBuilder.append(config->alphaMipmapCutoff);
+				keyBuilder.append(config->bc7Quality);
+				keyBuilder.append(config->mipmapFilter);
+
+				derivedDataKey = keyBuilder.build();
+			}
 		}
-		case ETextureFormat::RGBA16Unorm:
-		case ETextureFormat::R16Unorm:
+
+		const std::vector<std::filesystem::path> derivedDataPayloads = { texturePtr->getBinPath(), texturePtr->getSnapshotPath() };
+
+		bool bImportSucceed = false;
+		TextureDerivedData derivedData { };
+		if (!derivedDataKey.empty() && derivedDataCache->fetch(derivedDataKey, derivedData, derivedDataPayloads))
 		{
-			bImportSucceed = importHalfTexture();
-			break;
+			texturePtr->initBasicInfo(
+				derivedData.bSRGB,
+				derivedData.mipmapCount,
+				(VkFormat)derivedData.format,
+				derivedData.dimension,
+				derivedData.alphaMipmapCutoff);
+
+			bImportSucceed = true;
 		}
-		default:
+		else
 		{
-			CHECK_ENTRY();
-			break;
-		}
+			switch (config->format)
+			{
+			case ETextureFormat::R8G8B8A8:
+			case ETextureFormat::BC3:
+			case ETextureFormat::BC1:
+			case ETextureFormat::BC5:
+			case ETextureFormat::R8G8:
+			case ETextureFormat::Greyscale:
+			case ETextureFormat::R8:
+			case ETextureFormat::G8:
+			case ETextureFormat::B8:
+			case ETextureFormat::A8:
+			case ETextureFormat::BC4Greyscale:
+			case ETextureFormat::BC4R8:
+			case ETextureFormat::BC4G8:
+			case ETextureFormat::BC4B8:
+			case ETextureFormat::BC4A8:
+			case ETextureFormat::BC7:
+			{
+				bImportSucceed = importLdrTexture();
+				break;
+			}
+			case ETextureFormat::BC6H:
+			{
+				bImportSucceed = importHdrTexture();
+				break;
+			}
+			case ETextureFormat::RGBA16Unorm:
+			case ETextureFormat::R16Unorm:
+			{
+				bImportSucceed = importHalfTexture();
+				break;
+			}
+			default:
+			{
+				CHECK_ENTRY();
+				break;
+			}
+			}
+
+			if (bImportSucceed && !derivedDataKey.empty())
+			{
+				derivedData.bSRGB             = texturePtr->m_bSRGB;
+				derivedData.mipmapCount       = texturePtr->m_mipmapCount;
+				derivedData.format            = (uint32_t)texturePtr->m_format;
+				derivedData.dimension         = texturePtr->m_dimension;
+				derivedData.alphaMipmapCutoff = texturePtr->m_alphaMipmapCutoff;
+
+				derivedDataCache->store(derivedDataKey, derivedData, derivedDataPayloads);
+			}
 		}
 
-		// Copy raw asset to project asset.
+		// Copy raw asset to project asset, reimport overwrite old copy.
 		if (bImportSucceed)
 		{
 			auto copyDest = savePath.u16string() + srcPath.filename().extension().u16string();
-			ASSERT(!std::filesystem::exists(copyDest), "Can't copy same resource multi times.");
-			std::filesystem::copy(srcPath, copyDest);
+			if (config->bReimport)
+			{
+				std::filesystem::copy(srcPath, copyDest, std::filesystem::copy_options::overwrite_existing);
+			}
+			else
+			{
+				ASSERT(!std::filesystem::exists(copyDest), "Can't copy same resource multi times.");
+				std::filesystem::copy(srcPath, copyDest);
+			}
 			std::filesystem::path copyDestPath = copyDest;
 
 			texturePtr->m_rawAssetPath = buildRelativePathUtf8(getAssetManager()->getProjectConfig().assetPath, copyDestPath);
+			texturePtr->m_importSource = std::move(importSource);
+		}
+		else if (config->bReimport)
+		{
+			// Failed reimport never overwrite exist asset.
+			return false;
 		}
 
 		return texturePtr->save();
 	}
 
 
+	bool AssetTextureBin::saveBinaryStreams(const std::filesystem::path& savePath) const
+	{
+		std::vector<AssetBinaryStreamView> streams(mipmapDatas.size());
+		for (size_t i = 0; i < mipmapDatas.size(); i++)
+		{
+			streams[i] = buildBinaryStreamView(mipmapDatas[i]);
+		}
+		return saveAssetBinaryStreams(streams, savePath, false);
+	}
+
 	AssetTexture::AssetTexture(const AssetSaveInfo& saveInfo)
 		: AssetInterface(saveInfo)
 	{
@@ -733,6 +887,13 @@ namespace engine
 				{
 					return importTextureFromConfigThreadSafe(ptr);
 				},
+				.buildImportJobs = [](AssetReflectionInfo::ImportConfigPtr ptr, ImportJobGraph& graph)
+				{
+					graph.addJob(EImportJobStage::Texture, utf8::utf16to8(ptr->path.first.filename().u16string()), [ptr]()
+					{
+						return importTextureFromConfigThreadSafe(ptr);
+					});
+				},
 			}
 		};
 		return kInfo;
@@ -763,7 +924,7 @@ namespace engine
 		VulkanBuffer& stageBuffer)
 	{
 		std::vector<uint8_t> snapshotData { };
-		if (!std::filesystem::exists(cacheAsset->getSnapshotPath()))
+		if (!isAssetFileExist(cacheAsset->getSnapshotPath()))
 		{
 			// TODO:
 			UN_IMPLEMENT();
@@ -832,13 +993,37 @@ namespace engine
 	{
 		auto* fallbackWhite = getContext()->getBuiltinTextureWhite().get();
 
-		auto newAsset = std::make_shared<GPUImageAsset>(
-			fallbackWhite,
-			this->getFormat(),
-			this->getSaveInfo().getName(),
-			this->getMipmapCount(),
-			this->getDimension()
-		);
+		// Streaming texture only load tail mips, detail mips stream in when visible.
+		const uint32_t tailFirstMip = TextureStreamingManager::isEnable() 
+			? TextureStreamingManager::getTailFirstMip(this->getDimension(), this->getMipmapCount()) 
+			: 0;
+
+		std::shared_ptr<GPUImageAsset> newAsset = nullptr;
+		if (tailFirstMip > 0)
+		{
+			auto streamingAsset = std::make_shared<StreamingImageAsset>(
+				fallbackWhite,
+				getptr<AssetTexture>(),
+				this->getFormat(),
+				this->getSaveInfo().getName(),
+				this->getMipmapCount(),
+				this->getDimension(),
+				tailFirstMip
+			);
+
+			getContext()->getTextureStreaming().registerTexture(streamingAsset);
+			newAsset = streamingAsset;
+		}
+		else
+		{
+			newAsset = std::make_shared<GPUImageAsset>(
+				fallbackWhite,
+				this->getFormat(),
+				this->getSaveInfo().getName(),
+				this->getMipmapCount(),
+				this->getDimension()
+			);
+		}
 
 		getContext()->insertLRUAsset(this->getBinUUID(), newAsset);
 
@@ -876,32 +1061,21 @@ namespace engine
 		);
 	}
 
-	void AssetTextureCacheLoadTask::uploadFunction(
-		uint32_t stageBufferOffset, 
-		void* bufferPtrStart, 
-		RHICommandBufferBase& commandBuffer, 
+	// Upload texture bin mips from first mip to the smallest one, image mip 0 is texture first mip.
+	static void uploadTextureMips(
+		const AssetTexture& texture,
+		VulkanImage& image,
+		uint32_t firstMip,
+		uint32_t uploadSize,
+		uint32_t stageBufferOffset,
+		void* bufferPtrStart,
+		RHICommandBufferBase& commandBuffer,
 		VulkanBuffer& stageBuffer)
 	{
-
-		AssetTextureBin textureBin{};
-		if (!std::filesystem::exists(cacheAsset->getBinPath()))
-		{
-			UN_IMPLEMENT();
-		}
-		else
-		{
-			LOG_TRACE("Found bin for asset {} cache in disk so just load.",
-				utf8::utf16to8(cacheAsset->getSaveInfo().getStorePath()));
-
-			// Just load from cache file.
-			loadAsset(textureBin, cacheAsset->getBinPath());
-		}
-		
-
 		VkImageSubresourceRange rangeAllMips = buildBasicImageSubresource();
-		rangeAllMips.levelCount = cacheAsset->getMipmapCount();
+		rangeAllMips.levelCount = texture.getMipmapCount() - firstMip;
 
-		imageAssetGPU->prepareToUpload(commandBuffer, rangeAllMips);
+		image.transitionLayout(commandBuffer, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, rangeAllMips);
 
 		uint32_t bufferOffset = 0;
 		uint32_t bufferSize = 0;
@@ -916,36 +1090,96 @@ namespace engine
 
 		std::vector<VkBufferImageCopy> copyRegions{};
 
-		const auto& mipmapDatas = textureBin.mipmapDatas;
-		for (uint32_t level = 0; level < cacheAsset->getMipmapCount(); level++)
+		auto addMipRegion = [&](uint32_t level, uint32_t currentMipSize)
 		{
-			const auto& currentMip = mipmapDatas.at(level);
-			const uint32_t currentMipSize = (uint32_t)currentMip.size();
-
-			uint32_t mipWidth  = std::max<uint32_t>(cacheAsset->getDimension().x >> level, 1);
-			uint32_t mipHeight = std::max<uint32_t>(cacheAsset->getDimension().y >> level, 1);
-
-			memcpy((void*)((char*)bufferPtrStart + bufferOffset), currentMip.data(), currentMipSize);
+			uint32_t mipWidth  = std::max<uint32_t>(texture.getDimension().x >> level, 1);
+			uint32_t mipHeight = std::max<uint32_t>(texture.getDimension().y >> level, 1);
 
 			region.bufferOffset = stageBufferOffset + bufferOffset;
-			region.imageSubresource.mipLevel = level;
+			region.imageSubresource.mipLevel = level - firstMip;
 			region.imageExtent = { mipWidth, mipHeight, 1 };
 
 			copyRegions.push_back(region);
 
 			bufferOffset += currentMipSize;
 			bufferSize += currentMipSize;
+		};
+
+		if (!isAssetFileExist(texture.getBinPath()))
+		{
+			UN_IMPLEMENT();
 		}
-		ASSERT(uploadSize() >= bufferSize, "Upload size must bigger than buffer size!");
+
+		LOG_TRACE("Found bin for asset {} cache in disk so just load.",
+			utf8::utf16to8(texture.getSaveInfo().getStorePath()));
+
+		AssetBinaryStreamReader reader{};
+		if (reader.open(texture.getBinPath()))
+		{
+			// Decompress each mipmap from file mapping into stage buffer directly, chunks decompress parallel.
+			CHECK(reader.getStreamCount() >= texture.getMipmapCount());
+			for (uint32_t level = firstMip; level < texture.getMipmapCount(); level++)
+			{
+				const uint32_t currentMipSize = (uint32_t)reader.getStreamSize(level);
+				ASSERT(uploadSize >= bufferSize + currentMipSize, "Upload size must bigger than buffer size!");
+
+				CHECK(reader.decompressStream(level, (char*)bufferPtrStart + bufferOffset, Engine::get()->getThreadPool()));
+				addMipRegion(level, currentMipSize);
+			}
+		}
+		else
+		{
+			// Fallback to legacy cereal bin file.
+			AssetTextureBin textureBin{};
+			loadAsset(textureBin, texture.getBinPath());
+
+			const auto& mipmapDatas = textureBin.mipmapDatas;
+			for (uint32_t level = firstMip; level < texture.getMipmapCount(); level++)
+			{
+				const auto& currentMip = mipmapDatas.at(level);
+				const uint32_t currentMipSize = (uint32_t)currentMip.size();
+
+				memcpy((void*)((char*)bufferPtrStart + bufferOffset), currentMip.data(), currentMipSize);
+				addMipRegion(level, currentMipSize);
+			}
+		}
+		ASSERT(uploadSize >= bufferSize, "Upload size must bigger than buffer size!");
 
 		vkCmdCopyBufferToImage(
 			commandBuffer.cmd, 
 			stageBuffer, 
-			imageAssetGPU->getSelfImage().getImage(),
+			image.getImage(),
 			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 
 			(uint32_t)copyRegions.size(), 
 			copyRegions.data());
 
-		imageAssetGPU->finishUpload(commandBuffer, rangeAllMips);
+		image.transitionLayout(commandBuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, rangeAllMips);
+	}
+
+	void AssetTextureCacheLoadTask::uploadFunction(
+		uint32_t stageBufferOffset, 
+		void* bufferPtrStart, 
+		RHICommandBufferBase& commandBuffer, 
+		VulkanBuffer& stageBuffer)
+	{
+		// Streaming texture image only hold tail mips when load.
+		auto& image = imageAssetGPU->getSelfImage();
+		const uint32_t firstMip = cacheAsset->getMipmapCount() - image.getInfo().mipLevels;
+
+		uploadTextureMips(*cacheAsset, image, firstMip, uploadSize(), stageBufferOffset, bufferPtrStart, commandBuffer, stageBuffer);
+	}
+
+	void AssetTextureStreamingLoadTask::uploadFunction(
+		uint32_t stageBufferOffset,
+		void* bufferPtrStart,
+		RHICommandBufferBase& commandBuffer,
+		VulkanBuffer& stageBuffer)
+	{
+		uploadTextureMips(*cacheAsset, *image, firstMip, uploadSize(), stageBufferOffset, bufferPtrStart, commandBuffer, stageBuffer);
+	}
+
+	void AssetTextureStreamingLoadTask::finishCallback()
+	{
+		getContext()->getTextureStreaming().onStreamingFinished(texture, std::move(image), firstMip);
 	}
 }
\ No newline at end of file
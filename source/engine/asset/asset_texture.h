@@ -20,8 +20,24 @@ namespace engine
 		// Alpha coverage mipmap cutoff.
 		float alphaMipmapCutoff = 0.5f;
 
+		// Mipmap downsample filter.
+		EMipmapFilter mipmapFilter = EMipmapFilter::Box;
+
 		// Texture format.
 		ETextureFormat format;
+
+		// BC7 encoder quality, only used when format is BC7.
+		EBC7Quality bc7Quality = EBC7Quality::Normal;
+
+		virtual void saveSettings(cereal::BinaryOutputArchive& archive) const override
+		{
+			archive(bSRGB, bGenerateMipmap, alphaMipmapCutoff, mipmapFilter, format, bc7Quality);
+		}
+
+		virtual void loadSettings(cereal::BinaryInputArchive& archive) override
+		{
+			archive(bSRGB, bGenerateMipmap, alphaMipmapCutoff, mipmapFilter, format, bc7Quality);
+		}
 	};
 
 	// Load from asset header snapshot data, no compress, cache in lru map.
@@ -51,6 +67,32 @@ namespace engine
 		std::shared_ptr<AssetTexture> cacheAsset;
 	};
 
+	// Upload mips from first mip into new image, then swap into streaming texture.
+	struct AssetTextureStreamingLoadTask : public AssetLoadTask
+	{
+	public:
+		virtual void finishCallback() override;
+
+		virtual uint32_t uploadSize() const override
+		{
+			return uint32_t(image->getSize());
+		}
+
+		virtual void uploadFunction(
+			uint32_t stageBufferOffset,
+			void* bufferPtrStart,
+			RHICommandBufferBase& commandBuffer,
+			VulkanBuffer& stageBuffer) override;
+
+	public:
+		std::shared_ptr<StreamingImageAsset> texture = nullptr;
+		std::shared_ptr<AssetTexture> cacheAsset = nullptr;
+
+		// New image hold mips from first mip.
+		std::unique_ptr<VulkanImage> image = nullptr;
+		uint32_t firstMip;
+	};
+
 	class AssetTexture : public AssetInterface
 	{
 		REGISTER_BODY_DECLARE(AssetInterface);
@@ -139,6 +181,9 @@ namespace engine
 	{
 		std::vector<std::vector<uint8_t>> mipmapDatas;
 
+		// Save as binary stream file, one stream per mipmap.
+		bool saveBinaryStreams(const std::filesystem::path& savePath) const;
+
 		template<class Archive> 
 		void serialize(Archive& archive, std::uint32_t const version)
 		{
@@ -3,6 +3,7 @@
 #include "asset_texture.h"
 
 #include <execution>
+#include <numeric>
 #include "asset_manager.h"
 
 #pragma warning(disable: 4172)
@@ -13,6 +14,7 @@ namespace engine
     {
         mesh.m_subMeshes     = getSubmeshInfo();
         mesh.m_indicesCount  = getIndicesCount();
+        mesh.m_indicesWordsCount = getIndicesCount();
         mesh.m_verticesCount = getVerticesCount();
 
         mesh.m_minPosition = vec3(std::numeric_limits<float>::max());
@@ -45,19 +47,93 @@ namespace engine
     std::vector<VertexUv0>&& AssimpStaticMeshImporter::moveUv0s() { return std::move(m_uv0s); }
     std::vector<VertexPosition>&& AssimpStaticMeshImporter::movePositions() { return std::move(m_positions); }
 
-    StaticMeshSubMesh AssimpStaticMeshImporter::processMesh(aiMesh* mesh, const aiScene* scene)
+    void AssimpStaticMeshImporter::processNode(aiNode* node, const aiScene* scene)
     {
-        // Add a new submesh.
-        StaticMeshSubMesh subMeshInfo
-        { 
-            .indicesStart = (uint32_t)m_indices.size(),
-        };
+        collectMeshes(node, scene);
+        processMeshes();
+    }
+
+    void AssimpStaticMeshImporter::collectMeshes(aiNode* node, const aiScene* scene)
+    {
+        ZoneScoped;
+
+        // First pass, collect meshes and layout their ranges in output arrays.
+        m_meshInstances.clear();
+        collectNode(node, scene);
+
+        uint32_t vertexCount = 0;
+        uint32_t indicesCount = 0;
+        for (auto& instance : m_meshInstances)
+        {
+            instance.vertexStart = vertexCount;
+            instance.indicesStart = indicesCount;
+
+            vertexCount += instance.mesh->mNumVertices;
+            indicesCount += instance.indicesCount;
+        }
+
+        m_indices.resize(indicesCount);
+        m_positions.resize(vertexCount);
+        m_tangents.resize(vertexCount);
+        m_normals.resize(vertexCount);
+        m_uv0s.resize(vertexCount);
+        m_subMeshInfos.resize(m_meshInstances.size());
+
+        // Material descs dedup across all meshes, import by caller so it can run concurrently with geometry process.
+        m_subMeshMaterialDescIndices.assign(m_meshInstances.size(), -1);
+        if (m_bBuildMaterialDescs)
+        {
+            for (size_t i = 0; i < m_meshInstances.size(); i++)
+            {
+                m_subMeshMaterialDescIndices[i] = getOrBuildMaterialDesc(m_meshInstances[i].mesh, scene);
+            }
+        }
+    }
+
+    void AssimpStaticMeshImporter::processMeshes()
+    {
+        // Second pass, each mesh fill its own range in place.
+        ZoneScoped;
+
+        std::vector<size_t> instanceIndices(m_meshInstances.size());
+        std::iota(instanceIndices.begin(), instanceIndices.end(), 0);
+
+        std::for_each(std::execution::par, instanceIndices.begin(), instanceIndices.end(), [&](size_t i)
+        {
+            processMesh(m_meshInstances[i], m_subMeshInfos[i]);
+        });
+    }
+
+    void AssimpStaticMeshImporter::collectNode(const aiNode* node, const aiScene* scene)
+    {
+        for (unsigned int i = 0; i < node->mNumMeshes; i++)
+        {
+            MeshInstance instance{ };
+            instance.mesh = scene->mMeshes[node->mMeshes[i]];
+
+            for (unsigned int j = 0; j < instance.mesh->mNumFaces; j++)
+            {
+                instance.indicesCount += instance.mesh->mFaces[j].mNumIndices;
+            }
+
+            m_meshInstances.push_back(instance);
+        }
+
+        for (unsigned int i = 0; i < node->mNumChildren; i++)
+        {
+            collectNode(node->mChildren[i], scene);
+        }
+    }
+
+    void AssimpStaticMeshImporter::processMesh(const MeshInstance& instance, StaticMeshSubMesh& outSubMesh)
+    {
+        const aiMesh* mesh = instance.mesh;
 
-        // load vertices.
-        std::vector<VertexTangent> tangents(mesh->mNumVertices);
-        std::vector<VertexNormal> normals(mesh->mNumVertices);
-        std::vector<VertexUv0> uv0s(mesh->mNumVertices);
-        std::vector<VertexPosition> positions(mesh->mNumVertices);
+        // Load vertices into mesh range directly.
+        VertexTangent* tangents = m_tangents.data() + instance.vertexStart;
+        VertexNormal* normals = m_normals.data() + instance.vertexStart;
+        VertexUv0* uv0s = m_uv0s.data() + instance.vertexStart;
+        VertexPosition* positions = m_positions.data() + instance.vertexStart;
         for (unsigned int i = 0; i < mesh->mNumVertices; i++)
         {
             positions[i] = { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z };
@@ -85,185 +161,119 @@ namespace engine
 
                 tangents[i] = { tangentLoaded, signTangent };
             }
+            else
+            {
+                tangents[i] = VertexTangent(0.0f);
+            }
         }
 
         // Load indices.
-        std::vector<VertexIndexType> indices;
-        indices.reserve(mesh->mNumFaces * 3);
-
-        const uint32_t indexOffset = static_cast<uint32_t>(m_positions.size());
+        VertexIndexType* indices = m_indices.data() + instance.indicesStart;
+        uint32_t indicesCount = 0;
         for (unsigned int i = 0; i < mesh->mNumFaces; i++)
         {
-            aiFace face = mesh->mFaces[i];
+            const aiFace& face = mesh->mFaces[i];
             for (unsigned int j = 0; j < face.mNumIndices; j++)
             {
-                indices.push_back(indexOffset + face.mIndices[j]);
+                indices[indicesCount++] = instance.vertexStart + face.mIndices[j];
             }
         }
 
-        // Insert to data array.
-        m_indices.insert(m_indices.end(), indices.begin(), indices.end());
-        m_positions.insert(m_positions.end(), positions.begin(), positions.end());
-        m_tangents.insert(m_tangents.end(), tangents.begin(), tangents.end());
-        m_normals.insert(m_normals.end(), normals.begin(), normals.end());
-        m_uv0s.insert(m_uv0s.end(), uv0s.begin(), uv0s.end());
-
-        // Now fill indices count of the submesh.
-        subMeshInfo.indicesCount = static_cast<uint32_t>(indices.size());
+        outSubMesh.indicesStart = instance.indicesStart;
+        outSubMesh.indicesCount = instance.indicesCount;
+        outSubMesh.indicesWordStart = instance.indicesStart;
 
         // aabb bounds process.
         auto aabbExt = (mesh->mAABB.mMax - mesh->mAABB.mMin) * 0.5f;
         auto aabbCenter = aabbExt + mesh->mAABB.mMin;
-        subMeshInfo.bounds = 
+        outSubMesh.bounds = 
         {
             .origin = { aabbCenter.x, aabbCenter.y, aabbCenter.z },
             .extents = { aabbExt.x, aabbExt.y, aabbExt.z},
-            .radius = math::distance(math::vec3(mesh->mAABB.mMax.x, mesh->mAABB.mMax.y, mesh->mAABB.mMax.z), subMeshInfo.bounds.origin)
+            .radius = math::distance(
+                math::vec3(mesh->mAABB.mMax.x, mesh->mAABB.mMax.y, mesh->mAABB.mMax.z), 
+                math::vec3(aabbCenter.x, aabbCenter.y, aabbCenter.z))
         };
+    }
 
-        // standard pbr texture prepare.
-        aiString baseColorTextures{};
-        aiString normalTextures{};
-        aiString metalRoughnessTextures{};
-        aiString aoTextures{};
-        aiString emissiveTextures{};
-
-        struct ImageImportConfig
+    int32_t AssimpStaticMeshImporter::getOrBuildMaterialDesc(const aiMesh* mesh, const aiScene* scene)
+    {
+        if (const auto cacheIter = m_materialIndexDescMap.find(mesh->mMaterialIndex); cacheIter != m_materialIndexDescMap.end())
         {
-            UUID uuid;
-            std::shared_ptr<AssetTextureImportConfig> config;
-        };
+            return cacheIter->second;
+        }
 
-        std::vector<ImageImportConfig> imagePendingConfigs{ };
+        static const std::string materialPrefixName = "Material_";
 
-        auto tryFetechTexture = [&](const char* pathIn, UUID& outUUID, bool bSrgb, float cutoff, ETextureFormat format)
+        aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+        const std::string materialName = materialPrefixName + material->GetName().C_Str() + AssetMaterial::getCDO()->getSuffix();
+
+        auto iter = std::find_if(m_materialDescs.begin(), m_materialDescs.end(), [&](const StaticMeshMaterialDesc& desc) 
+        { 
+            return desc.name == materialName; 
+        });
+
+        int32_t descIndex = -1;
+        if (iter != m_materialDescs.end())
+        {
+            descIndex = (int32_t)std::distance(m_materialDescs.begin(), iter);
+        }
+        else
         {
-            std::filesystem::path texPath = m_rawMeshPath.parent_path() / utf8::utf8to16(pathIn);
+            descIndex = (int32_t)m_materialDescs.size();
+            m_materialDescs.push_back(buildMaterialDesc(material, materialName));
+        }
 
-            auto filename = texPath.filename();
-            auto saveTexturePath = m_textureSavePath / filename.replace_extension();
+        m_materialIndexDescMap[mesh->mMaterialIndex] = descIndex;
+        return descIndex;
+    }
 
-            if (m_texPathUUIDMap[texPath].empty())
-            {
-                ImageImportConfig newConfig { };
-
-                {
-                    auto name = saveTexturePath.filename().u16string() + utf8::utf8to16(AssetTexture::getCDO()->getSuffix());
-                    auto relativePathUtf8 = buildRelativePathUtf8(getAssetManager()->getProjectConfig().assetPath, saveTexturePath.parent_path());
-
-                    newConfig.uuid = AssetSaveInfo(utf8::utf16to8(name), relativePathUtf8).getUUID();
-                }
-                
-                newConfig.config = std::make_shared<AssetTextureImportConfig>();
-                newConfig.config->path = { texPath, saveTexturePath };
-                newConfig.config->bGenerateMipmap = true;
-                newConfig.config->bSRGB = bSrgb;
-                newConfig.config->alphaMipmapCutoff = cutoff;
-                newConfig.config->format = format;
-
-                m_texPathUUIDMap[texPath] = newConfig.uuid;
-                imagePendingConfigs.push_back(newConfig);
-            }
-            else
+    StaticMeshMaterialDesc AssimpStaticMeshImporter::buildMaterialDesc(aiMaterial* material, const std::string& materialName) const
+    {
+        StaticMeshMaterialDesc desc { };
+        desc.name = materialName;
+
+        auto fetchTexture = [&](aiTextureType type, StaticMeshMaterialTextureDesc& outTexture, bool bSrgb, float cutoff, ETextureFormat format)
+        {
+            if (material->GetTextureCount(type) > 0)
             {
-                LOG_TRACE("Texture {} is reusing in material.", pathIn);
-            }
+                aiString texturePath{};
+                material->GetTexture(type, 0, &texturePath);
 
-            outUUID = m_texPathUUIDMap.at(texPath);
+                outTexture.path = texturePath.C_Str();
+                outTexture.bSRGB = bSrgb;
+                outTexture.cutoff = cutoff;
+                outTexture.format = format;
+            }
         };
 
-        if (mesh->mMaterialIndex >= 0 && m_bImportMaterials)
+        // Diffuse map, SRGB, 0.5 cut off alpha, BC3 format.
+        desc.cutoff = 0.5f;
+        fetchTexture(aiTextureType_DIFFUSE, desc.baseColor, true, 0.5f, ETextureFormat::BC3);
         {
-            static const std::string materialPrefixName = "Material_";
-
-            aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-            const std::string materialName = materialPrefixName + material->GetName().C_Str() + AssetMaterial::getCDO()->getSuffix();
-            auto materialSavePath = m_materialSavePath / utf8::utf8to16(materialName);
-
-            if(m_materialPathUUIDMap.contains(materialSavePath))
-            {
-                subMeshInfo.material = m_materialPathUUIDMap.at(materialSavePath);
-            }
-            else
+            C_STRUCT aiColor4D diffuse;
+            if (AI_SUCCESS == aiGetMaterialColor(material, AI_MATKEY_COLOR_DIFFUSE, &diffuse))
             {
-                AssetSaveInfo materialSaveInfo(materialName, 
-                    buildRelativePathUtf8(getAssetManager()->getProjectConfig().assetPath, 
-                        materialSavePath.parent_path()));
-                auto newMaterial = getAssetManager()->createAsset<AssetMaterial>(materialSaveInfo).lock();
-                newMaterial->markDirty();
-
-                // Diffuse map, SRGB, 0.5 cut off alpha, BC3 format.
-                newMaterial->cutoff = 0.5f;
-                if (material->GetTextureCount(aiTextureType_DIFFUSE) > 0)
-                {
-                    material->GetTexture(aiTextureType_DIFFUSE, 0, &baseColorTextures);
-                    tryFetechTexture(baseColorTextures.C_Str(), newMaterial->baseColorTexture, true, 0.5f, ETextureFormat::BC3); 
-                }
-                {
-                    C_STRUCT aiColor4D diffuse;
-                    if (AI_SUCCESS == aiGetMaterialColor(material, AI_MATKEY_COLOR_DIFFUSE, &diffuse))
-                    {
-                        newMaterial->baseColorMul.x = diffuse.r;
-                        newMaterial->baseColorMul.y = diffuse.g;
-                        newMaterial->baseColorMul.z = diffuse.b;
-                        newMaterial->baseColorMul.w = diffuse.a;
-                    }
-                }
-
-
-                // Normal map, linear, 1.0 cut off alpha, BC5 format.
-                if (material->GetTextureCount(aiTextureType_HEIGHT) > 0)
-                {
-                    material->GetTexture(aiTextureType_HEIGHT, 0, &normalTextures);
-                    tryFetechTexture(normalTextures.C_Str(), newMaterial->normalTexture, false, 1.0f, ETextureFormat::BC5);
-                }
-
-                // MetalRoughness,  linear, 1.0 cut off alpha, used in GB channel, don't care alpha, so use BC1 default.
-                if (material->GetTextureCount(aiTextureType_SPECULAR) > 0)
-                {
-                    material->GetTexture(aiTextureType_SPECULAR, 0, &metalRoughnessTextures);
-                    tryFetechTexture(metalRoughnessTextures.C_Str(), newMaterial->metalRoughnessTexture, false, 1.0f, ETextureFormat::BC1);
-                }
-
-                // Ambient,  linear, 1.0 cut off alpha.
-                if (material->GetTextureCount(aiTextureType_AMBIENT) > 0)
-                {
-                    material->GetTexture(aiTextureType_AMBIENT, 0, &aoTextures);
-                    tryFetechTexture(aoTextures.C_Str(), newMaterial->aoTexture, false, 1.0f, ETextureFormat::BC4R8);
-                }
-
-                // Emissive, SRGB, don't care alpha, so use BC1 default.
-                if (material->GetTextureCount(aiTextureType_EMISSIVE) > 0)
-                {
-                    material->GetTexture(aiTextureType_EMISSIVE, 0, &emissiveTextures);
-                    tryFetechTexture(emissiveTextures.C_Str(), newMaterial->emissiveTexture, true, 1.0f, ETextureFormat::BC1);
-                }
-
-                subMeshInfo.material = newMaterial->getSaveInfo().getUUID();
-                if (newMaterial->save())
-                {
-                    m_materialPathUUIDMap[materialSavePath] = newMaterial->getSaveInfo().getUUID();
-                }
-                else
-                {
-                    LOG_ERROR("Failed to save material meta asset, the material {} import fail!", 
-                        utf8::utf16to8(materialSavePath.u16string()));
-                    subMeshInfo.material = {};
-                }
+                desc.baseColorMul.x = diffuse.r;
+                desc.baseColorMul.y = diffuse.g;
+                desc.baseColorMul.z = diffuse.b;
+                desc.baseColorMul.w = diffuse.a;
             }
-            
-            const auto& meta = AssetTexture::uiGetAssetReflectionInfo();
-            std::for_each(std::execution::par, imagePendingConfigs.begin(), imagePendingConfigs.end(), [&](const ImageImportConfig& item)
-            {
-                meta.importConfig.importAssetFromConfigThreadSafe(item.config);
-            });
-        }
-        else // No material found, keep empty.
-        {
-            subMeshInfo.material = {};
         }
 
-        return subMeshInfo;
+        // Normal map, linear, 1.0 cut off alpha, BC5 format.
+        fetchTexture(aiTextureType_HEIGHT, desc.normal, false, 1.0f, ETextureFormat::BC5);
+
+        // MetalRoughness,  linear, 1.0 cut off alpha, used in GB channel, don't care alpha, so use BC1 default.
+        fetchTexture(aiTextureType_SPECULAR, desc.metalRoughness, false, 1.0f, ETextureFormat::BC1);
+
+        // Ambient,  linear, 1.0 cut off alpha.
+        fetchTexture(aiTextureType_AMBIENT, desc.ao, false, 1.0f, ETextureFormat::BC4R8);
+
+        // Emissive, SRGB, don't care alpha, so use BC1 default.
+        fetchTexture(aiTextureType_EMISSIVE, desc.emissive, true, 1.0f, ETextureFormat::BC1);
+
+        return desc;
     }
 
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "asset_staticmesh.h"
+#include "asset_material.h"
 
 #include <engine/utils/utils.h>
 
@@ -11,43 +12,30 @@
 
 namespace engine
 {
+	// Assimp post process flags of static mesh import.
+	static const uint32_t kAssimpStaticMeshImportFlags =
+		aiProcessPreset_TargetRealtime_Quality |
+		aiProcess_FlipUVs |
+		aiProcess_GenBoundingBoxes;
+
     // Import static mesh by assimp.
 	class AssimpStaticMeshImporter
 	{
 	public:
-		explicit AssimpStaticMeshImporter(const std::filesystem::path& inRawMeshPath)
-			: m_bImportMaterials(false)
-		{
-
-		}
-
-		explicit AssimpStaticMeshImporter(
-			const std::filesystem::path& inRawMeshPath, 
-			const std::filesystem::path& saveMaterialsPath,
-			const std::filesystem::path& saveTexturesPath)
+		explicit AssimpStaticMeshImporter(const std::filesystem::path& inRawMeshPath, bool bBuildMaterialDescs = false)
 			: m_rawMeshPath(inRawMeshPath)
-			, m_textureSavePath(saveTexturesPath)
-			, m_materialSavePath(saveMaterialsPath)
-			, m_bImportMaterials(true)
+			, m_bBuildMaterialDescs(bBuildMaterialDescs)
 		{
 
 		}
 
 		void fillMeshAssetMeta(AssetStaticMesh& mesh) const;
 
-		void processNode(aiNode* node, const aiScene* scene)
-		{
-			for (unsigned int i = 0; i < node->mNumMeshes; i++)
-			{
-				aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-				m_subMeshInfos.push_back(processMesh(mesh, scene));
-			}
-
-			for (unsigned int i = 0; i < node->mNumChildren; i++)
-			{
-				processNode(node->mChildren[i], scene);
-			}
-		}
+		// Two pass import, first pass layout all meshes in output arrays and build material descs, 
+		// second pass fill arrays in parallel. Scene must keep alive until second pass finish.
+		void processNode(aiNode* node, const aiScene* scene);
+		void collectMeshes(aiNode* node, const aiScene* scene);
+		void processMeshes();
 
 		// NOTE: Exist one warning here, we use move below avoid vector copy.
 		const std::vector<StaticMeshSubMesh>& getSubmeshInfo() const;
@@ -67,18 +55,36 @@ namespace engine
 		std::vector<VertexNormal>&& moveNormals();
 		std::vector<VertexPosition>&& movePositions();
 
+		// Material descs and submesh material desc index, -1 if submesh no material.
+		const std::vector<StaticMeshMaterialDesc>& getMaterialDescs() const { return m_materialDescs; }
+		const std::vector<int32_t>& getSubMeshMaterialDescIndices() const { return m_subMeshMaterialDescIndices; }
+
 	private:
-		StaticMeshSubMesh processMesh(aiMesh* mesh, const aiScene* scene);
+		// Mesh reference by node, vertex and index range in output arrays.
+		struct MeshInstance
+		{
+			const aiMesh* mesh = nullptr;
+
+			uint32_t vertexStart = 0;
+			uint32_t indicesStart = 0;
+			uint32_t indicesCount = 0;
+		};
+
+		void collectNode(const aiNode* node, const aiScene* scene);
+
+		void processMesh(const MeshInstance& instance, StaticMeshSubMesh& outSubMesh);
+		int32_t getOrBuildMaterialDesc(const aiMesh* mesh, const aiScene* scene);
+		StaticMeshMaterialDesc buildMaterialDesc(aiMaterial* material, const std::string& materialName) const;
 
 	private:
-		bool m_bImportMaterials;
+		bool m_bBuildMaterialDescs;
 
 		// Raw mesh path.
 		std::filesystem::path m_rawMeshPath;
-		std::filesystem::path m_textureSavePath;
-		std::filesystem::path m_materialSavePath;
 
-		// Submeshes info.
+		std::vector<MeshInstance> m_meshInstances = { };
+
+		// Submeshes info, one per mesh instance.
 		std::vector<StaticMeshSubMesh> m_subMeshInfos = { };
 
 		// Indices.
@@ -90,7 +96,9 @@ namespace engine
 		std::vector<VertexUv0> m_uv0s = { };
 		std::vector<VertexNormal> m_normals = { };
 
-		std::unordered_map<std::filesystem::path, UUID> m_texPathUUIDMap{ };
-		std::unordered_map<std::filesystem::path, UUID> m_materialPathUUIDMap { };
+		// Material descs parse from raw mesh, and cache of assimp material index to desc index.
+		std::vector<StaticMeshMaterialDesc> m_materialDescs { };
+		std::vector<int32_t> m_subMeshMaterialDescIndices { };
+		std::unordered_map<uint32_t, int32_t> m_materialIndexDescMap { };
 	};
 }
\ No newline at end of file
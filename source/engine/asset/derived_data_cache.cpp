@@ -0,0 +1,361 @@
+#include "derived_data_cache.h"
+#include "../engine.h"
+
+#include <xxhash.h>
+
+namespace engine
+{
+	static AutoCVarInt32 cVarDerivedDataCacheEnable(
+		"asset.ddc.enable",
+		"Enable local derived data cache of imported mesh and texture.",
+		"Asset",
+		1,
+		CVarFlags::ReadAndWrite);
+
+	static AutoCVarInt32 cVarDerivedDataCacheMaxSizeMB(
+		"asset.ddc.maxSizeMB",
+		"Derived data cache size budget in MB, least recently used entries evict when exceed.",
+		"Asset",
+		4096,
+		CVarFlags::ReadAndWrite);
+
+	static const char* kDerivedDataMetaName = "meta";
+	static const char* kDerivedDataTempSuffix = ".tmp";
+
+	DerivedDataKeyBuilder::DerivedDataKeyBuilder(const char* cookerName, uint32_t cookerVersion)
+	{
+		m_states[0] = XXH64_createState();
+		m_states[1] = XXH64_createState();
+
+		XXH64_reset(m_states[0], 0);
+		XXH64_reset(m_states[1], 0x9E3779B97F4A7C15ULL);
+
+		appendString(cookerName);
+		append(cookerVersion);
+
+		// Cooked payload store in asset binary stream format, so format change also invalid cache.
+		append(kAssetVersion);
+		append(kAssetBinaryStreamVersion);
+	}
+
+	DerivedDataKeyBuilder::~DerivedDataKeyBuilder()
+	{
+		XXH64_freeState(m_states[0]);
+		XXH64_freeState(m_states[1]);
+	}
+
+	bool DerivedDataKeyBuilder::appendFile(const std::filesystem::path& path)
+	{
+		ZoneScoped;
+
+		MappedFile file;
+		if (!file.open(path))
+		{
+			return false;
+		}
+
+		append((uint64_t)file.getSize());
+		appendData(file.getData(), file.getSize());
+		return true;
+	}
+
+	void DerivedDataKeyBuilder::appendData(const void* data, size_t size)
+	{
+		XXH64_update(m_states[0], data, size);
+		XXH64_update(m_states[1], data, size);
+	}
+
+	void DerivedDataKeyBuilder::appendString(const std::string& str)
+	{
+		append((uint64_t)str.size());
+		appendData(str.data(), str.size());
+	}
+
+	std::string DerivedDataKeyBuilder::build() const
+	{
+		return std::format("{:016x}{:016x}", XXH64_digest(m_states[0]), XXH64_digest(m_states[1]));
+	}
+
+	DerivedDataCache::DerivedDataCache(const std::filesystem::path& folder)
+		: m_folder(folder)
+	{
+
+	}
+
+	std::filesystem::path DerivedDataCache::getEntryPath(const std::string& key) const
+	{
+		// Two level folder avoid too many entries in one folder.
+		return m_folder / key.substr(0, 2) / key;
+	}
+
+	void DerivedDataCache::scanEntries()
+	{
+		if (m_bScanned)
+		{
+			return;
+		}
+		m_bScanned = true;
+
+		ZoneScoped;
+
+		std::error_code ec;
+		std::filesystem::create_directories(m_folder, ec);
+
+		for (const auto& bucket : std::filesystem::directory_iterator(m_folder, ec))
+		{
+			if (!bucket.is_directory())
+			{
+				continue;
+			}
+
+			for (const auto& entryFolder : std::filesystem::directory_iterator(bucket.path(), ec))
+			{
+				const auto& entryPath = entryFolder.path();
+				const auto metaPath = entryPath / kDerivedDataMetaName;
+
+				// Clear temp folder or broken entry which crash when store.
+				if (entryPath.extension() == kDerivedDataTempSuffix || !std::filesystem::exists(metaPath))
+				{
+					std::filesystem::remove_all(entryPath, ec);
+					continue;
+				}
+
+				Entry entry { };
+				entry.lastAccessTime = std::filesystem::last_write_time(metaPath, ec);
+				for (const auto& file : std::filesystem::directory_iterator(entryPath, ec))
+				{
+					entry.size += file.file_size(ec);
+				}
+
+				m_totalBytes += entry.size;
+				m_entries[entryPath.filename().string()] = entry;
+			}
+		}
+
+		LOG_INFO("Derived data cache contain {} entries, {:.2f} MB in disk.", m_entries.size(), double(m_totalBytes) / 1024.0 / 1024.0);
+	}
+
+	bool DerivedDataCache::contains(const std::string& key)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		scanEntries();
+
+		return m_entries.contains(key);
+	}
+
+	bool DerivedDataCache::fetch(
+		const std::string& key,
+		std::vector<uint8_t>& outMeta,
+		const std::vector<std::filesystem::path>& destPaths)
+	{
+		ZoneScoped;
+
+		// Shared lock avoid entry evict when copy.
+		std::shared_lock<std::shared_mutex> fileLock(m_fileMutex);
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			scanEntries();
+
+			if (!m_entries.contains(key))
+			{
+				m_missCount++;
+				return false;
+			}
+		}
+
+		const auto entryPath = getEntryPath(key);
+		if (!loadAsset(outMeta, entryPath / kDerivedDataMetaName))
+		{
+			LOG_WARN("Derived data cache entry {} meta broken, treat as miss.", key);
+			m_missCount++;
+			return false;
+		}
+
+		uint64_t copyBytes = 0;
+		for (size_t i = 0; i < destPaths.size(); i++)
+		{
+			const auto payloadPath = entryPath / std::to_string(i);
+
+			std::error_code ec;
+			if (!std::filesystem::copy_file(payloadPath, destPaths[i], std::filesystem::copy_options::overwrite_existing, ec))
+			{
+				LOG_WARN("Derived data cache entry {} payload {} copy fail: {}, treat as miss.", key, i, ec.message());
+				m_missCount++;
+				return false;
+			}
+			copyBytes += std::filesystem::file_size(payloadPath, ec);
+		}
+
+		// Touch meta file as last access time, used for lru evict.
+		{
+			const auto now = std::filesystem::file_time_type::clock::now();
+
+			std::error_code ec;
+			std::filesystem::last_write_time(entryPath / kDerivedDataMetaName, now, ec);
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto iter = m_entries.find(key);
+			if (iter != m_entries.end())
+			{
+				iter->second.lastAccessTime = now;
+			}
+		}
+
+		m_hitCount++;
+		m_hitBytes += copyBytes;
+
+		LOG_TRACE("Derived data cache hit {}.", key);
+		return true;
+	}
+
+	bool DerivedDataCache::store(
+		const std::string& key,
+		const std::vector<uint8_t>& meta,
+		const std::vector<std::filesystem::path>& srcPaths)
+	{
+		ZoneScoped;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			scanEntries();
+
+			// Other thread already cook same content.
+			if (m_entries.contains(key))
+			{
+				return true;
+			}
+		}
+
+		const auto entryPath = getEntryPath(key);
+
+		// Write to temp folder first, then rename, so reader never see half write entry.
+		auto tempPath = entryPath;
+		tempPath += std::format("_{}{}", std::hash<std::thread::id>{}(std::this_thread::get_id()), kDerivedDataTempSuffix);
+
+		std::error_code ec;
+		std::filesystem::remove_all(tempPath, ec);
+		if (!std::filesystem::create_directories(tempPath, ec))
+		{
+			LOG_WARN("Derived data cache folder {} create fail: {}.", utf8::utf16to8(tempPath.u16string()), ec.message());
+			return false;
+		}
+
+		Entry entry { };
+		for (size_t i = 0; i < srcPaths.size(); i++)
+		{
+			if (!std::filesystem::copy_file(srcPaths[i], tempPath / std::to_string(i), ec))
+			{
+				LOG_WARN("Derived data cache store {} fail: {}.", utf8::utf16to8(srcPaths[i].u16string()), ec.message());
+				std::filesystem::remove_all(tempPath, ec);
+				return false;
+			}
+			entry.size += std::filesystem::file_size(srcPaths[i], ec);
+		}
+
+		if (!saveAsset(meta, tempPath / kDerivedDataMetaName, false))
+		{
+			std::filesystem::remove_all(tempPath, ec);
+			return false;
+		}
+		entry.size += std::filesystem::file_size(tempPath / kDerivedDataMetaName, ec);
+		entry.lastAccessTime = std::filesystem::file_time_type::clock::now();
+
+		{
+			std::unique_lock<std::shared_mutex> fileLock(m_fileMutex);
+			std::filesystem::rename(tempPath, entryPath, ec);
+			if (ec)
+			{
+				// Same entry store by other thread or process.
+				std::filesystem::remove_all(tempPath, ec);
+				return std::filesystem::exists(entryPath / kDerivedDataMetaName);
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_entries[key] = entry;
+			m_totalBytes += entry.size;
+		}
+
+		m_storeCount++;
+
+		trim(uint64_t(std::max(cVarDerivedDataCacheMaxSizeMB.get(), 0)) * 1024 * 1024);
+		return true;
+	}
+
+	void DerivedDataCache::trim(uint64_t maxBytes)
+	{
+		std::unique_lock<std::shared_mutex> fileLock(m_fileMutex);
+		std::lock_guard<std::mutex> lock(m_mutex);
+		scanEntries();
+
+		if (m_totalBytes <= maxBytes)
+		{
+			return;
+		}
+
+		ZoneScoped;
+
+		std::vector<std::pair<std::string, Entry>> sortedEntries(m_entries.begin(), m_entries.end());
+		std::sort(sortedEntries.begin(), sortedEntries.end(), [](const auto& a, const auto& b)
+		{
+			return a.second.lastAccessTime < b.second.lastAccessTime;
+		});
+
+		uint64_t evictCount = 0;
+		for (const auto& [key, entry] : sortedEntries)
+		{
+			if (m_totalBytes <= maxBytes)
+			{
+				break;
+			}
+
+			std::error_code ec;
+			std::filesystem::remove_all(getEntryPath(key), ec);
+
+			m_entries.erase(key);
+			m_totalBytes -= entry.size;
+			evictCount++;
+		}
+
+		m_evictCount += evictCount;
+		LOG_INFO("Derived data cache evict {} entries, remain {:.2f} MB.", evictCount, double(m_totalBytes) / 1024.0 / 1024.0);
+	}
+
+	void DerivedDataCache::clear()
+	{
+		trim(0);
+	}
+
+	DerivedDataCacheStat DerivedDataCache::getStat() const
+	{
+		DerivedDataCacheStat stat { };
+		stat.hitCount   = m_hitCount;
+		stat.missCount  = m_missCount;
+		stat.storeCount = m_storeCount;
+		stat.evictCount = m_evictCount;
+		stat.hitBytes   = m_hitBytes;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		stat.totalBytes = m_totalBytes;
+		stat.entryCount = m_entries.size();
+
+		return stat;
+	}
+
+	void DerivedDataCache::logStat() const
+	{
+		const auto stat = getStat();
+		const uint64_t requestCount = stat.hitCount + stat.missCount;
+		const double hitRate = requestCount > 0 ? double(stat.hitCount) / double(requestCount) * 100.0 : 0.0;
+
+		LOG_INFO("Derived data cache: {} hit, {} miss, hit rate {:.1f}%, {} store, {} evict, {:.2f} MB copy from cache.",
+			stat.hitCount, stat.missCount, hitRate, stat.storeCount, stat.evictCount, double(stat.hitBytes) / 1024.0 / 1024.0);
+		LOG_INFO("Derived data cache: {} entries, {:.2f} MB in disk, budget {} MB.",
+			stat.entryCount, double(stat.totalBytes) / 1024.0 / 1024.0, cVarDerivedDataCacheMaxSizeMB.get());
+	}
+
+	DerivedDataCache* engine::getDerivedDataCache()
+	{
+		static DerivedDataCache cache(kDerivedDataCacheFolder);
+		return cVarDerivedDataCacheEnable.get() != 0 ? &cache : nullptr;
+	}
+}
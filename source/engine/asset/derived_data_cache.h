@@ -0,0 +1,148 @@
+#pragma once
+
+#include "asset_common.h"
+
+struct XXH64_state_s;
+
+namespace engine
+{
+	// Build content address of derived data, hash source file content, import settings and cooker version.
+	// Cooker version must bump when cook code change, otherwise stale derived data will reuse.
+	class DerivedDataKeyBuilder : NonCopyable
+	{
+	public:
+		explicit DerivedDataKeyBuilder(const char* cookerName, uint32_t cookerVersion);
+		~DerivedDataKeyBuilder();
+
+		// Hash whole file content, return false if file can't open.
+		bool appendFile(const std::filesystem::path& path);
+
+		void appendData(const void* data, size_t size);
+		void appendString(const std::string& str);
+
+		template<typename T>
+		void append(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			appendData(&value, sizeof(T));
+		}
+
+		// 32 hex chars key, XXH64 digest of seed 0 then XXH64 digest of seed 0x9E3779B97F4A7C15, not xxhash128.
+		std::string build() const;
+
+	private:
+		// Two XXH64 of same input with different seed, xxhash in lz4 is 0.6 which has no XXH3 128 bit.
+		XXH64_state_s* m_states[2];
+	};
+
+	struct DerivedDataCacheStat
+	{
+		uint64_t hitCount = 0;
+		uint64_t missCount = 0;
+		uint64_t storeCount = 0;
+		uint64_t evictCount = 0;
+
+		// Bytes copy from cache when hit.
+		uint64_t hitBytes = 0;
+
+		// Current cache size in disk.
+		uint64_t totalBytes = 0;
+		uint64_t entryCount = 0;
+	};
+
+	// Local content addressed cache of cooked asset data, shared by all project.
+	// Each entry is a folder contain meta data and payload files, payload files copy out as is when hit.
+	class DerivedDataCache : NonCopyable
+	{
+	public:
+		explicit DerivedDataCache(const std::filesystem::path& folder);
+
+		// Entry exist in cache, entry may still evict before fetch.
+		bool contains(const std::string& key);
+
+		// Fetch entry and copy payloads to dest paths, return false if miss or payload count mismatch.
+		bool fetch(
+			const std::string& key,
+			std::vector<uint8_t>& outMeta,
+			const std::vector<std::filesystem::path>& destPaths);
+
+		// Store entry, copy payloads into cache, trim cache when exceed size budget.
+		bool store(
+			const std::string& key,
+			const std::vector<uint8_t>& meta,
+			const std::vector<std::filesystem::path>& srcPaths);
+
+		// Evict least recently used entries until cache size under budget.
+		void trim(uint64_t maxBytes);
+
+		// Remove all entries.
+		void clear();
+
+		DerivedDataCacheStat getStat() const;
+		void logStat() const;
+
+		template<typename T>
+		bool fetch(const std::string& key, T& outMeta, const std::vector<std::filesystem::path>& destPaths)
+		{
+			std::vector<uint8_t> meta;
+			if (!fetch(key, meta, destPaths))
+			{
+				return false;
+			}
+
+			MemoryViewStreamBuffer buffer(meta.data(), meta.size());
+			std::istream is(&buffer);
+			cereal::BinaryInputArchive archive(is);
+			archive(outMeta);
+			return true;
+		}
+
+		template<typename T>
+		bool store(const std::string& key, const T& meta, const std::vector<std::filesystem::path>& srcPaths)
+		{
+			std::string data;
+			{
+				std::stringstream ss;
+				cereal::BinaryOutputArchive archive(ss);
+				archive(meta);
+				data = std::move(ss.str());
+			}
+
+			return store(key, std::vector<uint8_t>(data.begin(), data.end()), srcPaths);
+		}
+
+	private:
+		struct Entry
+		{
+			uint64_t size = 0;
+			std::filesystem::file_time_type lastAccessTime;
+		};
+
+		std::filesystem::path getEntryPath(const std::string& key) const;
+
+		// Scan cache folder once when first access.
+		void scanEntries();
+
+	private:
+		std::filesystem::path m_folder;
+
+		// Entry files lock, fetch copy under shared lock, evict and rename under unique lock.
+		std::shared_mutex m_fileMutex;
+
+		// Entry map lock.
+		mutable std::mutex m_mutex;
+		bool m_bScanned = false;
+
+		std::unordered_map<std::string, Entry> m_entries;
+		uint64_t m_totalBytes = 0;
+
+		std::atomic<uint64_t> m_hitCount = 0;
+		std::atomic<uint64_t> m_missCount = 0;
+		std::atomic<uint64_t> m_storeCount = 0;
+		std::atomic<uint64_t> m_evictCount = 0;
+		std::atomic<uint64_t> m_hitBytes = 0;
+	};
+
+	// Return nullptr when derived data cache disable.
+	extern DerivedDataCache* getDerivedDataCache();
+}
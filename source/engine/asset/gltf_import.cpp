@@ -1,6 +1,1073 @@
 #include "gltf_import.h"
+#include "assimp_import.h"
+
+#include <execution>
+#include <numeric>
 
 namespace engine
 {
+	// Node hierarchy depth limit, avoid stack overflow on broken file with node cycle.
+	static const uint32_t kGLTFMaxNodeDepth = 256;
+
+	static const uint32_t kGLBMagic     = 0x46546C67; // "glTF"
+	static const uint32_t kGLBChunkJson = 0x4E4F534A; // "JSON"
+
+	static std::string getLowerExtension(const std::filesystem::path& path)
+	{
+		std::string ext = path.extension().string();
+		std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+		return ext;
+	}
+
+	// Skip image decode when parse gltf, texture importer load image from file later.
+	// Data uri image bytes keep in image, buffer view image read from buffer when extract.
+	static bool loadGLTFImageData(
+		tinygltf::Image* image,
+		const int imageIndex,
+		std::string* err,
+		std::string* warn,
+		int reqWidth,
+		int reqHeight,
+		const unsigned char* bytes,
+		int size,
+		void* userData)
+	{
+		if (image->uri.empty() && image->bufferView < 0)
+		{
+			image->image.assign(bytes, bytes + size);
+		}
+		image->as_is = true;
+
+		return true;
+	}
+
+	static float readComponent(const uint8_t* src, int componentType, bool bNormalized)
+	{
+		switch (componentType)
+		{
+		case TINYGLTF_COMPONENT_TYPE_FLOAT:
+		{
+			float value;
+			std::memcpy(&value, src, sizeof(value));
+			return value;
+		}
+		case TINYGLTF_COMPONENT_TYPE_DOUBLE:
+		{
+			double value;
+			std::memcpy(&value, src, sizeof(value));
+			return (float)value;
+		}
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+		{
+			const uint8_t value = *src;
+			return bNormalized ? float(value) / 255.0f : float(value);
+		}
+		case TINYGLTF_COMPONENT_TYPE_BYTE:
+		{
+			const int8_t value = (int8_t)*src;
+			return bNormalized ? math::max(float(value) / 127.0f, -1.0f) : float(value);
+		}
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+		{
+			uint16_t value;
+			std::memcpy(&value, src, sizeof(value));
+			return bNormalized ? float(value) / 65535.0f : float(value);
+		}
+		case TINYGLTF_COMPONENT_TYPE_SHORT:
+		{
+			int16_t value;
+			std::memcpy(&value, src, sizeof(value));
+			return bNormalized ? math::max(float(value) / 32767.0f, -1.0f) : float(value);
+		}
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+		{
+			uint32_t value;
+			std::memcpy(&value, src, sizeof(value));
+			return float(value);
+		}
+		case TINYGLTF_COMPONENT_TYPE_INT:
+		{
+			int32_t value;
+			std::memcpy(&value, src, sizeof(value));
+			return float(value);
+		}
+		}
+
+		return 0.0f;
+	}
+
+	static uint32_t readIndex(const uint8_t* src, int componentType)
+	{
+		switch (componentType)
+		{
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+		{
+			return *src;
+		}
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+		{
+			uint16_t value;
+			std::memcpy(&value, src, sizeof(value));
+			return value;
+		}
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+		{
+			uint32_t value;
+			std::memcpy(&value, src, sizeof(value));
+			return value;
+		}
+		}
+
+		return 0;
+	}
+
+	// Return buffer view data of accessor, nullptr if accessor no buffer view or out of buffer range.
+	static const uint8_t* getAccessorData(const tinygltf::Model& model, const tinygltf::Accessor& accessor, int& outStride)
+	{
+		if (accessor.bufferView < 0 || accessor.bufferView >= (int)model.bufferViews.size())
+		{
+			return nullptr;
+		}
+
+		const auto& view = model.bufferViews[accessor.bufferView];
+		if (view.buffer < 0 || view.buffer >= (int)model.buffers.size())
+		{
+			return nullptr;
+		}
+
+		const auto& buffer = model.buffers[view.buffer];
+
+		const int32_t componentSize = tinygltf::GetComponentSizeInBytes((uint32_t)accessor.componentType);
+		const int32_t componentCount = tinygltf::GetNumComponentsInType((uint32_t)accessor.type);
+		outStride = accessor.ByteStride(view);
+		if (componentSize <= 0 || componentCount <= 0 || outStride <= 0)
+		{
+			return nullptr;
+		}
+
+		const size_t start = view.byteOffset + accessor.byteOffset;
+		const size_t end = accessor.count > 0
+			? start + size_t(outStride) * (accessor.count - 1) + size_t(componentSize) * componentCount
+			: start;
+		if (end > buffer.data.size() || end > view.byteOffset + view.byteLength)
+		{
+			return nullptr;
+		}
+
+		return buffer.data.data() + start;
+	}
+
+	static math::vec3 safeNormalize(const math::vec3& v)
+	{
+		const float len = math::length(v);
+		return len > 0.0f ? v / len : v;
+	}
+
+	// Area weighted vertex normal, used when primitive no normal.
+	static void buildNormals(
+		const VertexPosition* positions,
+		uint32_t vertexCount,
+		const VertexIndexType* indices,
+		uint32_t indicesCount,
+		uint32_t vertexStart,
+		VertexNormal* outNormals)
+	{
+		std::fill(outNormals, outNormals + vertexCount, VertexNormal(0.0f));
+		for (uint32_t i = 0; i + 2 < indicesCount; i += 3)
+		{
+			const uint32_t i0 = indices[i + 0] - vertexStart;
+			const uint32_t i1 = indices[i + 1] - vertexStart;
+			const uint32_t i2 = indices[i + 2] - vertexStart;
+			if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+			{
+				continue;
+			}
+
+			// Cross length is twice of triangle area.
+			const math::vec3 faceNormal = math::cross(positions[i1] - positions[i0], positions[i2] - positions[i0]);
+			outNormals[i0] += faceNormal;
+			outNormals[i1] += faceNormal;
+			outNormals[i2] += faceNormal;
+		}
+
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			const float len = math::length(outNormals[i]);
+			outNormals[i] = len > 0.0f ? outNormals[i] / len : math::vec3(0.0f, 1.0f, 0.0f);
+		}
+	}
+
+	// Uv aligned tangent, w is bitangent sign, used when primitive no tangent.
+	static void buildTangents(
+		const VertexPosition* positions,
+		const VertexNormal* normals,
+		const VertexUv0* uv0s,
+		uint32_t vertexCount,
+		const VertexIndexType* indices,
+		uint32_t indicesCount,
+		uint32_t vertexStart,
+		VertexTangent* outTangents)
+	{
+		std::vector<math::vec3> tangents(vertexCount, math::vec3(0.0f));
+		std::vector<math::vec3> bitangents(vertexCount, math::vec3(0.0f));
+
+		for (uint32_t i = 0; i + 2 < indicesCount; i += 3)
+		{
+			const uint32_t i0 = indices[i + 0] - vertexStart;
+			const uint32_t i1 = indices[i + 1] - vertexStart;
+			const uint32_t i2 = indices[i + 2] - vertexStart;
+			if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+			{
+				continue;
+			}
+
+			const math::vec3 e1 = positions[i1] - positions[i0];
+			const math::vec3 e2 = positions[i2] - positions[i0];
+			const math::vec2 duv1 = uv0s[i1] - uv0s[i0];
+			const math::vec2 duv2 = uv0s[i2] - uv0s[i0];
+
+			const float r = duv1.x * duv2.y - duv2.x * duv1.y;
+			if (math::abs(r) < 1e-12f)
+			{
+				continue;
+			}
+
+			const float invR = 1.0f / r;
+			const math::vec3 tangent = (e1 * duv2.y - e2 * duv1.y) * invR;
+			const math::vec3 bitangent = (e2 * duv1.x - e1 * duv2.x) * invR;
+
+			tangents[i0] += tangent; tangents[i1] += tangent; tangents[i2] += tangent;
+			bitangents[i0] += bitangent; bitangents[i1] += bitangent; bitangents[i2] += bitangent;
+		}
+
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			const math::vec3& n = normals[i];
+
+			// Gram-Schmidt orthogonalize, pick any orthogonal axis when uv degenerate.
+			math::vec3 t = tangents[i] - n * math::dot(n, tangents[i]);
+			if (math::dot(t, t) < 1e-12f)
+			{
+				const math::vec3 axis = math::abs(n.x) < 0.9f ? math::vec3(1.0f, 0.0f, 0.0f) : math::vec3(0.0f, 1.0f, 0.0f);
+				t = math::cross(n, axis);
+			}
+			t = safeNormalize(t);
+
+			const float sign = math::dot(math::cross(n, t), bitangents[i]) < 0.0f ? -1.0f : 1.0f;
+			outTangents[i] = VertexTangent(t, sign);
+		}
+	}
+
+	bool GLTFStaticMeshImporter::isGLTF(const std::filesystem::path& path)
+	{
+		const auto ext = getLowerExtension(path);
+		return ext == ".gltf" || ext == ".glb";
+	}
+
+	bool GLTFStaticMeshImporter::collectExternalBuffers(const std::filesystem::path& path, std::vector<std::filesystem::path>& outPaths)
+	{
+		MappedFile file;
+		if (!file.open(path))
+		{
+			return false;
+		}
+
+		const char* jsonStart = (const char*)file.getData();
+		size_t jsonSize = file.getSize();
+
+		// Glb: 12 bytes header, then json chunk with 8 bytes chunk header.
+		uint32_t magic = 0;
+		if (file.getSize() >= 20 && (std::memcpy(&magic, file.getData(), sizeof(magic)), magic == kGLBMagic))
+		{
+			uint32_t chunkLength;
+			uint32_t chunkType;
+			std::memcpy(&chunkLength, file.getData() + 12, sizeof(chunkLength));
+			std::memcpy(&chunkType, file.getData() + 16, sizeof(chunkType));
+
+			if (chunkType != kGLBChunkJson || 20 + size_t(chunkLength) > file.getSize())
+			{
+				return false;
+			}
+
+			jsonStart = (const char*)file.getData() + 20;
+			jsonSize = chunkLength;
+		}
+
+		const auto json = nlohmann::json::parse(jsonStart, jsonStart + jsonSize, nullptr, false);
+		if (json.is_discarded())
+		{
+			return false;
+		}
+
+		const auto buffers = json.find("buffers");
+		if (buffers == json.end() || !buffers->is_array())
+		{
+			return true;
+		}
+
+		for (const auto& buffer : *buffers)
+		{
+			// Glb binary chunk buffer no uri.
+			const auto uri = buffer.find("uri");
+			if (uri == buffer.end() || !uri->is_string())
+			{
+				continue;
+			}
+
+			const std::string uriString = uri->get<std::string>();
+			if (uriString.rfind("data:", 0) == 0)
+			{
+				continue;
+			}
+
+			std::string decodedUri;
+			if (!tinygltf::URIDecode(uriString, &decodedUri, nullptr))
+			{
+				decodedUri = uriString;
+			}
+			outPaths.push_back(utf8::utf8to16(decodedUri));
+		}
+
+		return true;
+	}
+
+	bool GLTFStaticMeshImporter::load()
+	{
+		ZoneScoped;
+
+		tinygltf::TinyGLTF loader;
+		loader.SetImageLoader(loadGLTFImageData, nullptr);
+
+		std::string err;
+		std::string warn;
+		const std::string pathUtf8 = utf8::utf16to8(m_rawMeshPath.u16string());
+
+		const bool bResult = (getLowerExtension(m_rawMeshPath) == ".glb")
+			? loader.LoadBinaryFromFile(&m_model, &err, &warn, pathUtf8)
+			: loader.LoadASCIIFromFile(&m_model, &err, &warn, pathUtf8);
+
+		if (!warn.empty())
+		{
+			LOG_WARN("Gltf {} load warning: {}", pathUtf8, warn);
+		}
+
+		if (!err.empty())
+		{
+			LOG_ERROR("Gltf {} load error: {}", pathUtf8, err);
+		}
+
+		return bResult;
+	}
+
+	void GLTFStaticMeshImporter::collectNode(int nodeIndex, const math::mat4& parentTransform, uint32_t depth)
+	{
+		if (nodeIndex < 0 || nodeIndex >= (int)m_model.nodes.size())
+		{
+			return;
+		}
+
+		if (depth > kGLTFMaxNodeDepth)
+		{
+			LOG_WARN("Gltf {} node hierarchy too deep, skip node {}.", utf8::utf16to8(m_rawMeshPath.u16string()), nodeIndex);
+			return;
+		}
+
+		const auto& node = m_model.nodes[nodeIndex];
+
+		// Node matrix is column major, same with glm.
+		math::mat4 localTransform = math::mat4(1.0f);
+		if (node.matrix.size() == 16)
+		{
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				localTransform[i / 4][i % 4] = (float)node.matrix[i];
+			}
+		}
+		else
+		{
+			math::vec3 translation = math::vec3(0.0f);
+			math::quat rotation = math::quat(1.0f, 0.0f, 0.0f, 0.0f);
+			math::vec3 scale = math::vec3(1.0f);
+
+			if (node.translation.size() == 3)
+			{
+				translation = { node.translation[0], node.translation[1], node.translation[2] };
+			}
+
+			// Gltf quaternion store as xyzw.
+			if (node.rotation.size() == 4)
+			{
+				rotation = math::quat((float)node.rotation[3], (float)node.rotation[0], (float)node.rotation[1], (float)node.rotation[2]);
+			}
+
+			if (node.scale.size() == 3)
+			{
+				scale = { node.scale[0], node.scale[1], node.scale[2] };
+			}
+
+			localTransform = math::translate(math::mat4(1.0f), translation) * math::mat4_cast(rotation) * math::scale(math::mat4(1.0f), scale);
+		}
+
+		const math::mat4 transform = parentTransform * localTransform;
+		if (node.mesh >= 0)
+		{
+			collectMesh(node.mesh, transform);
+		}
+
+		for (int child : node.children)
+		{
+			collectNode(child, transform, depth + 1);
+		}
+	}
+
+	void GLTFStaticMeshImporter::collectMesh(int meshIndex, const math::mat4& transform)
+	{
+		if (meshIndex < 0 || meshIndex >= (int)m_model.meshes.size())
+		{
+			return;
+		}
+
+		const auto isValidAccessor = [&](int index) { return index >= 0 && index < (int)m_model.accessors.size(); };
+
+		for (const auto& primitive : m_model.meshes[meshIndex].primitives)
+		{
+			// Only triangle list, strip and fan are rare in exporter output.
+			if (primitive.mode != -1 && primitive.mode != TINYGLTF_MODE_TRIANGLES)
+			{
+				LOG_WARN("Gltf {} mesh {} primitive mode {} is not triangles, skip.",
+					utf8::utf16to8(m_rawMeshPath.u16string()), meshIndex, primitive.mode);
+				continue;
+			}
+
+			const auto position = primitive.attributes.find("POSITION");
+			if (position == primitive.attributes.end() || !isValidAccessor(position->second))
+			{
+				LOG_WARN("Gltf {} mesh {} primitive without position, skip.", utf8::utf16to8(m_rawMeshPath.u16string()), meshIndex);
+				continue;
+			}
+
+			if (primitive.indices >= 0 && !isValidAccessor(primitive.indices))
+			{
+				LOG_WARN("Gltf {} mesh {} primitive indices invalid, skip.", utf8::utf16to8(m_rawMeshPath.u16string()), meshIndex);
+				continue;
+			}
+
+			PrimitiveInstance instance { };
+			instance.primitive = &primitive;
+			instance.transform = transform;
+			instance.vertexCount = (uint32_t)m_model.accessors[position->second].count;
+			instance.indicesCount = primitive.indices >= 0 ? (uint32_t)m_model.accessors[primitive.indices].count : instance.vertexCount;
+
+			m_instances.push_back(instance);
+		}
+	}
+
+	void GLTFStaticMeshImporter::readAccessor(int accessorIndex, float* dest, uint32_t componentCount) const
+	{
+		const auto& accessor = m_model.accessors[accessorIndex];
+
+		const uint32_t accessorComponentCount = (uint32_t)tinygltf::GetNumComponentsInType((uint32_t)accessor.type);
+		const int32_t componentSize = tinygltf::GetComponentSizeInBytes((uint32_t)accessor.componentType);
+
+		// Missing component fill 0, tangent w fill 1.
+		const auto getDefault = [](uint32_t component) { return component == 3 ? 1.0f : 0.0f; };
+
+		int stride = 0;
+		const uint8_t* src = getAccessorData(m_model, accessor, stride);
+		if (src == nullptr)
+		{
+			if (accessor.bufferView >= 0)
+			{
+				LOG_WARN("Gltf {} accessor {} out of buffer range.", utf8::utf16to8(m_rawMeshPath.u16string()), accessorIndex);
+			}
+
+			// No buffer view accessor is all zero, sparse may override.
+			for (size_t i = 0; i < accessor.count; i++)
+			{
+				for (uint32_t c = 0; c < componentCount; c++)
+				{
+					dest[i * componentCount + c] = c < accessorComponentCount ? 0.0f : getDefault(c);
+				}
+			}
+		}
+		else if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT &&
+			accessorComponentCount == componentCount &&
+			stride == int(sizeof(float) * componentCount))
+		{
+			// Tight float stream, copy directly.
+			std::memcpy(dest, src, accessor.count * stride);
+		}
+		else
+		{
+			for (size_t i = 0; i < accessor.count; i++)
+			{
+				const uint8_t* element = src + i * stride;
+				for (uint32_t c = 0; c < componentCount; c++)
+				{
+					dest[i * componentCount + c] = c < accessorComponentCount
+						? readComponent(element + c * componentSize, accessor.componentType, accessor.normalized)
+						: getDefault(c);
+				}
+			}
+		}
+
+		// Sparse accessor override part of elements.
+		if (accessor.sparse.isSparse)
+		{
+			const auto& sparse = accessor.sparse;
+
+			const auto isValidView = [&](int index) { return index >= 0 && index < (int)m_model.bufferViews.size(); };
+			const auto isValidBuffer = [&](int index) { return index >= 0 && index < (int)m_model.buffers.size(); };
+			if (!isValidView(sparse.indices.bufferView) || !isValidView(sparse.values.bufferView) || sparse.count < 0)
+			{
+				LOG_WARN("Gltf {} accessor {} sparse view invalid, skip sparse.", utf8::utf16to8(m_rawMeshPath.u16string()), accessorIndex);
+				return;
+			}
+
+			const auto& indexView = m_model.bufferViews[sparse.indices.bufferView];
+			const auto& valueView = m_model.bufferViews[sparse.values.bufferView];
+			if (!isValidBuffer(indexView.buffer) || !isValidBuffer(valueView.buffer))
+			{
+				LOG_WARN("Gltf {} accessor {} sparse buffer invalid, skip sparse.", utf8::utf16to8(m_rawMeshPath.u16string()), accessorIndex);
+				return;
+			}
+
+			const int32_t indexSize = tinygltf::GetComponentSizeInBytes((uint32_t)sparse.indices.componentType);
+			const size_t indexEnd = indexView.byteOffset + sparse.indices.byteOffset + size_t(indexSize) * sparse.count;
+			const size_t valueEnd = valueView.byteOffset + sparse.values.byteOffset + size_t(componentSize) * accessorComponentCount * sparse.count;
+			if (indexSize <= 0 ||
+				indexEnd > m_model.buffers[indexView.buffer].data.size() ||
+				valueEnd > m_model.buffers[valueView.buffer].data.size())
+			{
+				LOG_WARN("Gltf {} accessor {} sparse out of buffer range, skip sparse.", utf8::utf16to8(m_rawMeshPath.u16string()), accessorIndex);
+				return;
+			}
+
+			const uint8_t* indexSrc = m_model.buffers[indexView.buffer].data.data() + indexView.byteOffset + sparse.indices.byteOffset;
+			const uint8_t* valueSrc = m_model.buffers[valueView.buffer].data.data() + valueView.byteOffset + sparse.values.byteOffset;
+
+			for (int i = 0; i < sparse.count; i++)
+			{
+				const uint32_t element = readIndex(indexSrc + i * indexSize, sparse.indices.componentType);
+				if (element >= accessor.count)
+				{
+					continue;
+				}
+
+				for (uint32_t c = 0; c < std::min(componentCount, accessorComponentCount); c++)
+				{
+					const uint8_t* value = valueSrc + (size_t(i) * accessorComponentCount + c) * componentSize;
+					dest[element * componentCount + c] = readComponent(value, accessor.componentType, accessor.normalized);
+				}
+			}
+		}
+	}
+
+	bool GLTFStaticMeshImporter::readIndices(int accessorIndex, VertexIndexType* dest, uint32_t vertexStart, uint32_t vertexCount) const
+	{
+		const auto& accessor = m_model.accessors[accessorIndex];
+
+		int stride = 0;
+		const uint8_t* src = getAccessorData(m_model, accessor, stride);
+		if (src == nullptr)
+		{
+			LOG_WARN("Gltf {} indices accessor {} invalid.", utf8::utf16to8(m_rawMeshPath.u16string()), accessorIndex);
+			std::fill(dest, dest + accessor.count, vertexStart);
+			return true;
+		}
+
+		if (accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT && stride == sizeof(uint32_t))
+		{
+			std::memcpy(dest, src, accessor.count * sizeof(uint32_t));
+		}
+		else
+		{
+			for (size_t i = 0; i < accessor.count; i++)
+			{
+				dest[i] = readIndex(src + i * stride, accessor.componentType);
+			}
+		}
+
+		// Out of range index fetch out of vertex buffer on GPU, and read out of bounds in mesh optimize.
+		for (size_t i = 0; i < accessor.count; i++)
+		{
+			if (dest[i] >= vertexCount)
+			{
+				LOG_ERROR("Gltf {} indices accessor {} index {} out of primitive vertex count {}.",
+					utf8::utf16to8(m_rawMeshPath.u16string()), accessorIndex, dest[i], vertexCount);
+				return false;
+			}
+
+			dest[i] += vertexStart;
+		}
+
+		return true;
+	}
+
+	bool GLTFStaticMeshImporter::processPrimitive(const PrimitiveInstance& instance, StaticMeshSubMesh& outSubMesh)
+	{
+		ZoneScoped;
+
+		const auto& attributes = instance.primitive->attributes;
+		const auto findAttribute = [&](const char* name)
+		{
+			const auto iter = attributes.find(name);
+			return (iter != attributes.end() && iter->second < (int)m_model.accessors.size()) ? iter->second : -1;
+		};
+
+		const uint32_t vertexCount = instance.vertexCount;
+		const uint32_t indicesCount = instance.indicesCount;
+
+		VertexPosition* positions = m_positions.data() + instance.vertexStart;
+		VertexNormal* normals = m_normals.data() + instance.vertexStart;
+		VertexTangent* tangents = m_tangents.data() + instance.vertexStart;
+		VertexUv0* uv0s = m_uv0s.data() + instance.vertexStart;
+		VertexIndexType* indices = m_indices.data() + instance.indicesStart;
+
+		readAccessor(findAttribute("POSITION"), &positions[0].x, 3);
+
+		// Non indexed primitive use sequence list.
+		if (instance.primitive->indices >= 0)
+		{
+			if (!readIndices(instance.primitive->indices, indices, instance.vertexStart, vertexCount))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			std::iota(indices, indices + indicesCount, instance.vertexStart);
+		}
+
+		const int uvAccessor = findAttribute("TEXCOORD_0");
+		const int normalAccessor = findAttribute("NORMAL");
+		const int tangentAccessor = findAttribute("TANGENT");
+
+		// Gltf uv origin is top left, same with engine, no flip.
+		if (uvAccessor >= 0 && m_model.accessors[uvAccessor].count == vertexCount)
+		{
+			readAccessor(uvAccessor, &uv0s[0].x, 2);
+		}
+		else
+		{
+			std::fill(uv0s, uv0s + vertexCount, VertexUv0(0.0f));
+		}
+
+		if (normalAccessor >= 0 && m_model.accessors[normalAccessor].count == vertexCount)
+		{
+			readAccessor(normalAccessor, &normals[0].x, 3);
+		}
+		else
+		{
+			buildNormals(positions, vertexCount, indices, indicesCount, instance.vertexStart, normals);
+		}
+
+		// Gltf tangent w is bitangent sign, same with engine.
+		if (tangentAccessor >= 0 && m_model.accessors[tangentAccessor].count == vertexCount)
+		{
+			readAccessor(tangentAccessor, &tangents[0].x, 4);
+		}
+		else
+		{
+			buildTangents(positions, normals, uv0s, vertexCount, indices, indicesCount, instance.vertexStart, tangents);
+		}
+
+		// Bake node transform, mirror transform flip triangle winding and bitangent sign.
+		if (instance.transform != math::mat4(1.0f))
+		{
+			const math::mat3 tangentMatrix = math::mat3(instance.transform);
+			const math::mat3 normalMatrix = math::inverseTranspose(tangentMatrix);
+			const bool bMirror = math::determinant(tangentMatrix) < 0.0f;
+
+			for (uint32_t i = 0; i < vertexCount; i++)
+			{
+				positions[i] = math::vec3(instance.transform * math::vec4(positions[i], 1.0f));
+				normals[i] = safeNormalize(normalMatrix * normals[i]);
+
+				const math::vec3 tangent = safeNormalize(tangentMatrix * math::vec3(tangents[i]));
+				tangents[i] = VertexTangent(tangent, bMirror ? -tangents[i].w : tangents[i].w);
+			}
+
+			if (bMirror)
+			{
+				for (uint32_t i = 0; i + 2 < indicesCount; i += 3)
+				{
+					std::swap(indices[i + 1], indices[i + 2]);
+				}
+			}
+		}
+
+		// Bounds after transform.
+		math::vec3 minPosition = math::vec3(std::numeric_limits<float>::max());
+		math::vec3 maxPosition = math::vec3(std::numeric_limits<float>::lowest());
+		for (uint32_t i = 0; i < vertexCount; i++)
+		{
+			minPosition = math::min(minPosition, positions[i]);
+			maxPosition = math::max(maxPosition, positions[i]);
+		}
+
+		if (vertexCount == 0)
+		{
+			minPosition = math::vec3(0.0f);
+			maxPosition = math::vec3(0.0f);
+		}
+
+		const auto extents = (maxPosition - minPosition) * 0.5f;
+		const auto origin = minPosition + extents;
+
+		outSubMesh.indicesStart = instance.indicesStart;
+		outSubMesh.indicesCount = indicesCount;
+		outSubMesh.indicesWordStart = instance.indicesStart;
+		outSubMesh.bounds =
+		{
+			.origin = origin,
+			.extents = extents,
+			.radius = math::distance(maxPosition, origin),
+		};
+
+		return true;
+	}
+
+	std::string GLTFStaticMeshImporter::getTexturePath(int textureIndex)
+	{
+		if (textureIndex < 0 || textureIndex >= (int)m_model.textures.size())
+		{
+			return {};
+		}
+
+		const int imageIndex = m_model.textures[textureIndex].source;
+		if (imageIndex < 0 || imageIndex >= (int)m_model.images.size())
+		{
+			return {};
+		}
+
+		if (const auto iter = m_imagePathMap.find(imageIndex); iter != m_imagePathMap.end())
+		{
+			return iter->second;
+		}
+
+		const auto& image = m_model.images[imageIndex];
+
+		std::string path;
+		if (!image.uri.empty())
+		{
+			// External image, path relative to gltf folder.
+			if (!tinygltf::URIDecode(image.uri, &path, nullptr))
+			{
+				path = image.uri;
+			}
+		}
+		else
+		{
+			// Embedded image, extract to file so texture importer can load it.
+			const uint8_t* data = nullptr;
+			size_t size = 0;
+			if (image.bufferView >= 0 && image.bufferView < (int)m_model.bufferViews.size())
+			{
+				const auto& view = m_model.bufferViews[image.bufferView];
+				const auto& buffer = m_model.buffers[view.buffer];
+				if (view.byteOffset + view.byteLength <= buffer.data.size())
+				{
+					data = buffer.data.data() + view.byteOffset;
+					size = view.byteLength;
+				}
+			}
+			else if (!image.image.empty())
+			{
+				data = image.image.data();
+				size = image.image.size();
+			}
+
+			const char* ext = nullptr;
+			if (image.mimeType == "image/png") ext = ".png";
+			else if (image.mimeType == "image/jpeg") ext = ".jpg";
+
+			if (data == nullptr || ext == nullptr)
+			{
+				LOG_WARN("Gltf {} image {} with mime type {} is unsupported, skip.",
+					utf8::utf16to8(m_rawMeshPath.u16string()), imageIndex, image.mimeType);
+			}
+			else
+			{
+				const auto extractPath = m_extractImagesPath /
+					utf8::utf8to16(std::format("{}_image{}{}", utf8::utf16to8(m_rawMeshPath.stem().u16string()), imageIndex, ext));
+
+				std::ofstream os(extractPath, std::ios::binary);
+				os.write((const char*)data, size);
+				if (os)
+				{
+					path = utf8::utf16to8(extractPath.u16string());
+					m_bHasEmbeddedImages = true;
+				}
+			}
+		}
+
+		m_imagePathMap[imageIndex] = path;
+		return path;
+	}
+
+	int32_t GLTFStaticMeshImporter::getOrBuildMaterialDesc(int materialIndex)
+	{
+		if (materialIndex < 0 || materialIndex >= (int)m_model.materials.size())
+		{
+			return -1;
+		}
+
+		if (const auto iter = m_gltfMaterialDescMap.find(materialIndex); iter != m_gltfMaterialDescMap.end())
+		{
+			return iter->second;
+		}
+
+		static const std::string materialPrefixName = "Material_";
+		const auto& material = m_model.materials[materialIndex];
+		const auto& pbr = material.pbrMetallicRoughness;
+
+		StaticMeshMaterialDesc desc { };
+
+		// Gltf material name is optional and not unique.
+		{
+			std::string name = materialPrefixName + (material.name.empty() ? std::to_string(materialIndex) : material.name);
+			const bool bNameExist = std::any_of(m_materialDescs.begin(), m_materialDescs.end(), [&](const StaticMeshMaterialDesc& item)
+			{
+				return item.name == name + AssetMaterial::getCDO()->getSuffix();
+			});
+
+			if (bNameExist)
+			{
+				name += "_" + std::to_string(materialIndex);
+			}
+			desc.name = name + AssetMaterial::getCDO()->getSuffix();
+		}
+
+		if (pbr.baseColorFactor.size() == 4)
+		{
+			desc.baseColorMul = math::vec4(pbr.baseColorFactor[0], pbr.baseColorFactor[1], pbr.baseColorFactor[2], pbr.baseColorFactor[3]);
+		}
+		desc.metalMul = (float)pbr.metallicFactor;
+		desc.roughnessMul = (float)pbr.roughnessFactor;
+
+		// No blend in engine, blend material fallback to default alpha test.
+		if (material.alphaMode == "MASK")
+		{
+			desc.cutoff = (float)material.alphaCutoff;
+		}
+		else if (material.alphaMode == "OPAQUE")
+		{
+			desc.cutoff = 0.0f;
+		}
+		else
+		{
+			desc.cutoff = 0.5f;
+		}
+
+		auto fetchTexture = [&](int textureIndex, StaticMeshMaterialTextureDesc& outTexture, bool bSrgb, float cutoff, ETextureFormat format)
+		{
+			outTexture.path = getTexturePath(textureIndex);
+			outTexture.bSRGB = bSrgb;
+			outTexture.cutoff = cutoff;
+			outTexture.format = format;
+		};
+
+		// Base color, SRGB, alpha coverage keep with material cutoff, BC3 format.
+		fetchTexture(pbr.baseColorTexture.index, desc.baseColor, true, desc.cutoff > 0.0f ? desc.cutoff : 1.0f, ETextureFormat::BC3);
+
+		// Normal map, linear, BC5 format.
+		fetchTexture(material.normalTexture.index, desc.normal, false, 1.0f, ETextureFormat::BC5);
+
+		// Gltf metallic roughness store roughness in G and metallic in B, same with engine, BC1 format.
+		fetchTexture(pbr.metallicRoughnessTexture.index, desc.metalRoughness, false, 1.0f, ETextureFormat::BC1);
+
+		// Occlusion in R channel.
+		fetchTexture(material.occlusionTexture.index, desc.ao, false, 1.0f, ETextureFormat::BC4R8);
+
+		// Emissive, SRGB, don't care alpha, so use BC1 default.
+		fetchTexture(material.emissiveTexture.index, desc.emissive, true, 1.0f, ETextureFormat::BC1);
+
+		// Emissive factor scale emissive texture, or constant emissive when no texture.
+		math::vec3 emissiveFactor = math::vec3(0.0f);
+		if (material.emissiveFactor.size() == 3)
+		{
+			emissiveFactor = { material.emissiveFactor[0], material.emissiveFactor[1], material.emissiveFactor[2] };
+		}
+
+		if (!desc.emissive.path.empty())
+		{
+			desc.emissiveMul = math::vec4(emissiveFactor, 1.0f);
+		}
+		else
+		{
+			desc.emissiveAdd = math::vec4(emissiveFactor, 0.0f);
+		}
+
+		const int32_t descIndex = (int32_t)m_materialDescs.size();
+		m_materialDescs.push_back(desc);
+		m_gltfMaterialDescMap[materialIndex] = descIndex;
+
+		return descIndex;
+	}
+
+	bool GLTFStaticMeshImporter::processScene()
+	{
+		collectScene();
+		return processPrimitives();
+	}
+
+	void GLTFStaticMeshImporter::collectScene()
+	{
+		ZoneScoped;
+
+		// Flatten node hierarchy, mesh reference by multiple nodes expand to multiple submeshes.
+		m_instances.clear();
+		if (!m_model.scenes.empty())
+		{
+			const bool bDefaultSceneValid = m_model.defaultScene >= 0 && m_model.defaultScene < (int)m_model.scenes.size();
+			const auto& scene = m_model.scenes[bDefaultSceneValid ? m_model.defaultScene : 0];
+
+			for (int nodeIndex : scene.nodes)
+			{
+				collectNode(nodeIndex, math::mat4(1.0f), 0);
+			}
+		}
+		else
+		{
+			// No scene, import all meshes without transform.
+			for (int i = 0; i < (int)m_model.meshes.size(); i++)
+			{
+				collectMesh(i, math::mat4(1.0f));
+			}
+		}
+
+		// Layout all primitives in output streams, so each primitive can convert in parallel.
+		uint32_t vertexCount = 0;
+		uint32_t indicesCount = 0;
+		for (auto& instance : m_instances)
+		{
+			instance.vertexStart = vertexCount;
+			instance.indicesStart = indicesCount;
+
+			vertexCount += instance.vertexCount;
+			indicesCount += instance.indicesCount;
+		}
+
+		m_positions.resize(vertexCount);
+		m_normals.resize(vertexCount);
+		m_tangents.resize(vertexCount);
+		m_uv0s.resize(vertexCount);
+		m_indices.resize(indicesCount);
+		m_subMeshInfos.resize(m_instances.size());
+
+		// Material descs build serially, embedded image extract here, import by caller concurrently with geometry convert.
+		m_subMeshMaterialDescIndices.assign(m_instances.size(), -1);
+		if (m_bBuildMaterialDescs)
+		{
+			for (size_t i = 0; i < m_instances.size(); i++)
+			{
+				m_subMeshMaterialDescIndices[i] = getOrBuildMaterialDesc(m_instances[i].primitive->material);
+			}
+		}
+	}
+
+	bool GLTFStaticMeshImporter::processPrimitives()
+	{
+		ZoneScoped;
+
+		std::vector<size_t> instanceIndices(m_instances.size());
+		std::iota(instanceIndices.begin(), instanceIndices.end(), 0);
+
+		std::atomic<bool> bResult = true;
+		std::for_each(std::execution::par, instanceIndices.begin(), instanceIndices.end(), [&](size_t i)
+		{
+			if (!processPrimitive(m_instances[i], m_subMeshInfos[i]))
+			{
+				bResult = false;
+			}
+		});
+
+		return bResult;
+	}
+
+	void GLTFStaticMeshImporter::fillMeshAssetMeta(AssetStaticMesh& mesh) const
+	{
+		mesh.m_subMeshes     = getSubmeshInfo();
+		mesh.m_indicesCount  = getIndicesCount();
+		mesh.m_indicesWordsCount = getIndicesCount();
+		mesh.m_verticesCount = getVerticesCount();
+
+		mesh.m_minPosition = vec3(std::numeric_limits<float>::max());
+		mesh.m_maxPosition = vec3(std::numeric_limits<float>::lowest());
+
+		for (const auto& subMesh : mesh.m_subMeshes)
+		{
+			const auto minPos = subMesh.bounds.origin - subMesh.bounds.extents;
+			const auto maxPos = subMesh.bounds.origin + subMesh.bounds.extents;
+
+			mesh.m_maxPosition = math::max(mesh.m_maxPosition, maxPos);
+			mesh.m_minPosition = math::min(mesh.m_minPosition, minPos);
+		}
+	}
+
+	void engine::benchmarkStaticMeshImport(const std::filesystem::path& rawMeshPath)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		const auto getMilliseconds = [](const Clock::time_point& start)
+		{
+			return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		};
+
+		const std::string pathUtf8 = utf8::utf16to8(rawMeshPath.u16string());
+
+		// Assimp path, same process flags with static mesh import.
+		{
+			const auto parseStart = Clock::now();
+
+			Assimp::Importer importer;
+			const aiScene* scene = importer.ReadFile(rawMeshPath.string(), kAssimpStaticMeshImportFlags);
+			if (scene == nullptr)
+			{
+				LOG_WARN("Assimp fail to import {}.", pathUtf8);
+			}
+			else
+			{
+				const double parseTime = getMilliseconds(parseStart);
+
+				const auto convertStart = Clock::now();
+				AssimpStaticMeshImporter processor(rawMeshPath);
+				processor.processNode(scene->mRootNode, scene);
+				const double convertTime = getMilliseconds(convertStart);
+
+				LOG_INFO("Assimp import {}: parse {:.2f} ms, convert {:.2f} ms, total {:.2f} ms, {} vertices, {} triangles.",
+					pathUtf8, parseTime, convertTime, parseTime + convertTime, processor.getVerticesCount(), processor.getIndicesCount() / 3);
+			}
+		}
+
+		// Native gltf path.
+		if (GLTFStaticMeshImporter::isGLTF(rawMeshPath))
+		{
+			const auto parseStart = Clock::now();
+
+			GLTFStaticMeshImporter processor(rawMeshPath);
+			if (!processor.load())
+			{
+				LOG_WARN("Gltf importer fail to import {}.", pathUtf8);
+			}
+			else
+			{
+				const double parseTime = getMilliseconds(parseStart);
+
+				const auto convertStart = Clock::now();
+				if (!processor.processScene())
+				{
+					LOG_WARN("Gltf importer fail to convert {}.", pathUtf8);
+				}
+				const double convertTime = getMilliseconds(convertStart);
 
-}
\ No newline at end of file
+				LOG_INFO("Gltf import {}: parse {:.2f} ms, convert {:.2f} ms, total {:.2f} ms, {} vertices, {} triangles.",
+					pathUtf8, parseTime, convertTime, parseTime + convertTime, processor.getVerticesCount(), processor.getIndicesCount() / 3);
+			}
+		}
+		else
+		{
+			LOG_INFO("{} is not gltf file, skip native gltf import benchmark.", pathUtf8);
+		}
+	}
+}
@@ -1,9 +1,129 @@
 #pragma once
+#include "asset_staticmesh.h"
+#include "asset_material.h"
 
+#include <engine/utils/utils.h>
 
 // Implement of gltf 2.0 importer.
 
 namespace engine
 {
+	// Import static mesh from gltf/glb by tinygltf, accessor data read into mesh streams directly,
+	// normals, tangents and indices store in file are reused instead of regenerate.
+	class GLTFStaticMeshImporter
+	{
+	public:
+		// Only parse mesh data, no material desc build.
+		explicit GLTFStaticMeshImporter(const std::filesystem::path& inRawMeshPath)
+			: m_rawMeshPath(inRawMeshPath)
+			, m_bBuildMaterialDescs(false)
+		{
 
-}
\ No newline at end of file
+		}
+
+		// Build material descs, embedded images extract to extractImagesPath so they can import as texture.
+		explicit GLTFStaticMeshImporter(
+			const std::filesystem::path& inRawMeshPath,
+			const std::filesystem::path& extractImagesPath)
+			: m_rawMeshPath(inRawMeshPath)
+			, m_extractImagesPath(extractImagesPath)
+			, m_bBuildMaterialDescs(true)
+		{
+
+		}
+
+		static bool isGLTF(const std::filesystem::path& path);
+
+		// Collect external buffer files reference by gltf json, no buffer load, used for raw copy and cache key.
+		static bool collectExternalBuffers(const std::filesystem::path& path, std::vector<std::filesystem::path>& outPaths);
+
+		// Parse gltf file, image not decode here.
+		bool load();
+
+		// Flatten scene node hierarchy and convert all primitives in parallel, return false if any primitive invalid.
+		bool processScene();
+
+		// Two pass of processScene, first pass layout all primitives and build material descs, second pass convert.
+		void collectScene();
+		bool processPrimitives();
+
+		void fillMeshAssetMeta(AssetStaticMesh& mesh) const;
+
+		const std::vector<StaticMeshSubMesh>& getSubmeshInfo() const { return m_subMeshInfos; }
+		const size_t getIndicesCount() const { return m_indices.size(); }
+		const size_t getVerticesCount() const { return m_positions.size(); }
+
+		std::vector<VertexIndexType>&& moveIndices() { return std::move(m_indices); }
+		std::vector<VertexTangent>&& moveTangents() { return std::move(m_tangents); }
+		std::vector<VertexUv0>&& moveUv0s() { return std::move(m_uv0s); }
+		std::vector<VertexNormal>&& moveNormals() { return std::move(m_normals); }
+		std::vector<VertexPosition>&& movePositions() { return std::move(m_positions); }
+
+		// Material descs and submesh material desc index, -1 if submesh no material.
+		const std::vector<StaticMeshMaterialDesc>& getMaterialDescs() const { return m_materialDescs; }
+		const std::vector<int32_t>& getSubMeshMaterialDescIndices() const { return m_subMeshMaterialDescIndices; }
+
+		// Embedded image extract path is project local, so material desc can't reuse by other import.
+		bool hasEmbeddedImages() const { return m_bHasEmbeddedImages; }
+
+	private:
+		struct PrimitiveInstance
+		{
+			const tinygltf::Primitive* primitive = nullptr;
+			math::mat4 transform = math::mat4(1.0f);
+
+			uint32_t vertexStart = 0;
+			uint32_t vertexCount = 0;
+			uint32_t indicesStart = 0;
+			uint32_t indicesCount = 0;
+		};
+
+		void collectNode(int nodeIndex, const math::mat4& parentTransform, uint32_t depth);
+		void collectMesh(int meshIndex, const math::mat4& transform);
+
+		bool processPrimitive(const PrimitiveInstance& instance, StaticMeshSubMesh& outSubMesh);
+
+		// Read accessor as float array, normalized integer convert to [0, 1] or [-1, 1].
+		void readAccessor(int accessorIndex, float* dest, uint32_t componentCount) const;
+		// Read indices offset by vertex start, return false when any index out of primitive vertex count.
+		bool readIndices(int accessorIndex, VertexIndexType* dest, uint32_t vertexStart, uint32_t vertexCount) const;
+
+		int32_t getOrBuildMaterialDesc(int materialIndex);
+		std::string getTexturePath(int textureIndex);
+
+	private:
+		// Raw mesh path.
+		std::filesystem::path m_rawMeshPath;
+		std::filesystem::path m_extractImagesPath;
+
+		tinygltf::Model m_model;
+
+		bool m_bBuildMaterialDescs;
+		bool m_bHasEmbeddedImages = false;
+
+		std::vector<PrimitiveInstance> m_instances = { };
+
+		// Submeshes info, one per primitive instance.
+		std::vector<StaticMeshSubMesh> m_subMeshInfos = { };
+
+		// Indices.
+		std::vector<VertexIndexType> m_indices = { };
+
+		// Vertices.
+		std::vector<VertexPosition> m_positions = { };
+		std::vector<VertexTangent> m_tangents = { };
+		std::vector<VertexUv0> m_uv0s = { };
+		std::vector<VertexNormal> m_normals = { };
+
+		// Material descs parse from gltf, and cache of gltf material index to desc index.
+		std::vector<StaticMeshMaterialDesc> m_materialDescs { };
+		std::vector<int32_t> m_subMeshMaterialDescIndices { };
+		std::unordered_map<int, int32_t> m_gltfMaterialDescMap { };
+
+		// Gltf image index to texture path.
+		std::unordered_map<int, std::string> m_imagePathMap { };
+	};
+
+	// Parse and convert same raw mesh by assimp and native gltf path, log time of each stage.
+	extern void benchmarkStaticMeshImport(const std::filesystem::path& rawMeshPath);
+}
@@ -0,0 +1,429 @@
+#include "import_job_graph.h"
+#include "../engine.h"
+
+#include <profile/profile.h>
+
+namespace engine
+{
+	static AutoCVarInt32 cVarImportMaxHeavyJobs(
+		"asset.import.maxHeavyJobs",
+		"Max concurrent memory heavy import jobs (decode, geometry, texture), 0 is half of worker threads.",
+		"Asset",
+		0,
+		CVarFlags::ReadAndWrite);
+
+	// Group of job running on this thread, so jobs add inside it inherit the group.
+	static thread_local const ImportJobGraph* sRunningGraph = nullptr;
+	static thread_local int32_t sRunningGroup = -1;
+
+	// Nested job time of running job in ms, job run inline when other job help while waiting.
+	static thread_local double* sRunningNestedTime = nullptr;
+
+	// Set running job of this thread, restore outer job on exit.
+	class RunningJobScope : NonCopyable
+	{
+	public:
+		explicit RunningJobScope(const ImportJobGraph* graph, int32_t group)
+			: m_prevGraph(sRunningGraph)
+			, m_prevGroup(sRunningGroup)
+			, m_prevNestedTime(sRunningNestedTime)
+		{
+			sRunningGraph = graph;
+			sRunningGroup = group;
+			sRunningNestedTime = &m_nestedTime;
+		}
+
+		~RunningJobScope()
+		{
+			sRunningGraph = m_prevGraph;
+			sRunningGroup = m_prevGroup;
+			sRunningNestedTime = m_prevNestedTime;
+		}
+
+		double getNestedTime() const { return m_nestedTime; }
+
+		// Exclude this job time from outer job.
+		void addToOuterNestedTime(double time) const
+		{
+			if (m_prevNestedTime)
+			{
+				*m_prevNestedTime += time;
+			}
+		}
+
+	private:
+		const ImportJobGraph* m_prevGraph;
+		int32_t m_prevGroup;
+		double* m_prevNestedTime;
+
+		double m_nestedTime = 0.0;
+	};
+
+	ImportJobGraph::~ImportJobGraph()
+	{
+		if (m_bExecuting)
+		{
+			wait();
+		}
+	}
+
+	bool ImportJobGraph::isHeavyStage(EImportJobStage stage)
+	{
+		return
+			stage == EImportJobStage::Decode ||
+			stage == EImportJobStage::Geometry ||
+			stage == EImportJobStage::Texture;
+	}
+
+	const char* ImportJobGraph::getStageName(EImportJobStage stage)
+	{
+		switch (stage)
+		{
+		case EImportJobStage::Decode:   return "Decode";
+		case EImportJobStage::Geometry: return "Geometry";
+		case EImportJobStage::Texture:  return "Texture";
+		case EImportJobStage::Material: return "Material";
+		case EImportJobStage::Save:     return "Save";
+		}
+
+		CHECK_ENTRY();
+		return "Unknown";
+	}
+
+	ImportJobGraph::JobId ImportJobGraph::addJob(
+		EImportJobStage stage,
+		const std::string& name,
+		std::function<bool()>&& function,
+		const std::vector<JobId>& dependencies)
+	{
+		CHECK(stage != EImportJobStage::Max);
+		CHECK(function);
+
+		std::lock_guard<std::mutex> lock(m_lock);
+
+		const JobId id = JobId(m_jobs.size());
+		{
+			Job& job = m_jobs.emplace_back();
+			job.stage = stage;
+			job.name = name;
+			job.function = std::move(function);
+			job.group = (sRunningGraph == this) ? sRunningGroup : m_buildingGroup;
+
+			if (job.group >= 0)
+			{
+				m_groups[job.group].stat.jobCount ++;
+			}
+
+			for (JobId dependency : dependencies)
+			{
+				CHECK(dependency < id);
+
+				Job& dependencyJob = m_jobs[dependency];
+				if (!dependencyJob.bFinished)
+				{
+					dependencyJob.dependents.push_back(id);
+					job.unfinishedDependencyCount ++;
+				}
+			}
+		}
+
+		m_stageProgress[size_t(stage)].total ++;
+		m_unfinishedCount ++;
+
+		if (m_jobs[id].unfinishedDependencyCount == 0)
+		{
+			if (m_bCancelled)
+			{
+				finishJob(id, true);
+			}
+			else
+			{
+				m_readyJobs[size_t(stage)].push_back(id);
+				dispatchJobs();
+			}
+		}
+
+		return id;
+	}
+
+	void ImportJobGraph::execute()
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_bExecuting = true;
+
+		dispatchJobs();
+	}
+
+	void ImportJobGraph::cancel()
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_bCancelled = true;
+
+		// Ready jobs skip now, their dependents skip when finish.
+		for (auto& readyJobs : m_readyJobs)
+		{
+			const auto skipJobs = std::move(readyJobs);
+			readyJobs.clear();
+
+			for (JobId id : skipJobs)
+			{
+				finishJob(id, true);
+			}
+		}
+	}
+
+	bool ImportJobGraph::isFinished() const
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		return m_unfinishedCount == 0;
+	}
+
+	void ImportJobGraph::wait()
+	{
+		std::unique_lock<std::mutex> lock(m_lock);
+		CHECK(m_bExecuting || m_unfinishedCount == 0);
+
+		m_finishedCondition.wait(lock, [this]() { return m_unfinishedCount == 0; });
+	}
+
+	float ImportJobGraph::getProgress() const
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+
+		uint32_t total = 0;
+		uint32_t finished = 0;
+		for (const auto& progress : m_stageProgress)
+		{
+			total += progress.total;
+			finished += progress.finished;
+		}
+
+		return total > 0 ? float(finished) / float(total) : 1.0f;
+	}
+
+	ImportJobGraph::StageProgress ImportJobGraph::getStageProgress(EImportJobStage stage) const
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		return m_stageProgress[size_t(stage)];
+	}
+
+	uint32_t ImportJobGraph::getFailedCount() const
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		return m_failedCount;
+	}
+
+	void ImportJobGraph::beginGroup(const std::string& name)
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		CHECK(m_buildingGroup < 0);
+
+		m_buildingGroup = int32_t(m_groups.size());
+		m_groups.emplace_back().stat.name = name;
+	}
+
+	void ImportJobGraph::endGroup()
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		CHECK(m_buildingGroup >= 0);
+
+		m_buildingGroup = -1;
+	}
+
+	std::vector<ImportJobGraph::GroupStat> ImportJobGraph::getGroupStats() const
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+
+		std::vector<GroupStat> result(m_groups.size());
+		for (size_t i = 0; i < m_groups.size(); i++)
+		{
+			const auto& group = m_groups[i];
+
+			result[i] = group.stat;
+			if (group.bStarted)
+			{
+				result[i].wallTime = std::chrono::duration<double, std::milli>(group.finishTime - group.startTime).count();
+			}
+		}
+
+		return result;
+	}
+
+	void ImportJobGraph::dispatchJobs()
+	{
+		if (!m_bExecuting)
+		{
+			return;
+		}
+
+		auto* threadPool = Engine::get()->getThreadPool();
+
+		// Leave one worker free for nested parallel loop inside jobs.
+		const uint32_t threadCount = threadPool->getThreadCount();
+		const uint32_t maxRunningCount = threadCount > 1 ? threadCount - 1 : 1;
+
+		const int32_t heavyCVar = cVarImportMaxHeavyJobs.get();
+		const uint32_t maxHeavyRunningCount = heavyCVar > 0
+			? std::min(uint32_t(heavyCVar), maxRunningCount)
+			: std::max(maxRunningCount / 2, 1U);
+
+		// Later stage first, finish started asset before decode new one, keep peak memory low.
+		for (int32_t stageIndex = int32_t(EImportJobStage::Max) - 1; stageIndex >= 0; stageIndex--)
+		{
+			const bool bHeavy = isHeavyStage(EImportJobStage(stageIndex));
+			auto& readyJobs = m_readyJobs[stageIndex];
+
+			while (!readyJobs.empty() && m_runningCount < maxRunningCount)
+			{
+				if (bHeavy && m_heavyRunningCount >= maxHeavyRunningCount)
+				{
+					break;
+				}
+
+				const JobId id = readyJobs.front();
+				readyJobs.pop_front();
+
+				m_runningCount ++;
+				m_heavyRunningCount += bHeavy ? 1 : 0;
+				m_stageProgress[stageIndex].running ++;
+
+				threadPool->pushTask([this, id]() { runJob(id); });
+			}
+		}
+	}
+
+	void ImportJobGraph::runJob(JobId id)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+
+		std::function<bool()> function;
+		std::string name;
+		int32_t group;
+		const auto startTime = Clock::now();
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+
+			Job& job = m_jobs[id];
+			function = std::move(job.function);
+			name = job.name;
+			group = job.group;
+
+			if (group >= 0 && !m_groups[group].bStarted)
+			{
+				m_groups[group].bStarted = true;
+				m_groups[group].startTime = startTime;
+			}
+		}
+
+		// Job dispatch before cancel just skip.
+		bool bSucceed = true;
+		double jobTime = 0.0;
+		Clock::time_point finishTime;
+		{
+			RunningJobScope scope(this, group);
+			if (!m_bCancelled)
+			{
+				ZoneScopedN("ImportJobGraph::runJob");
+				ZoneText(name.c_str(), name.size());
+
+				bSucceed = function();
+				if (!bSucceed)
+				{
+					LOG_ERROR("Import job {} fail.", name);
+				}
+			}
+
+			// Release job captures before finish, graph may destroy after finish.
+			function = nullptr;
+			finishTime = Clock::now();
+
+			const double totalTime = std::chrono::duration<double, std::milli>(finishTime - startTime).count();
+			jobTime = std::max(0.0, totalTime - scope.getNestedTime());
+			scope.addToOuterNestedTime(totalTime);
+		}
+
+		std::lock_guard<std::mutex> lock(m_lock);
+		const EImportJobStage stage = m_jobs[id].stage;
+
+		m_runningCount --;
+		m_heavyRunningCount -= isHeavyStage(stage) ? 1 : 0;
+		m_stageProgress[size_t(stage)].running --;
+
+		if (group >= 0)
+		{
+			auto& groupInfo = m_groups[group];
+			groupInfo.stat.jobTime += jobTime;
+			groupInfo.stat.failedCount += bSucceed ? 0 : 1;
+			groupInfo.finishTime = std::max(groupInfo.finishTime, finishTime);
+		}
+
+		finishJob(id, bSucceed);
+		dispatchJobs();
+	}
+
+	void ImportJobGraph::finishJob(JobId id, bool bSucceed)
+	{
+		if (!bSucceed)
+		{
+			m_failedCount ++;
+		}
+
+		// Dependents of job skip by cancel also skip.
+		std::vector<JobId> finishedJobs = { id };
+		while (!finishedJobs.empty())
+		{
+			const JobId finishedId = finishedJobs.back();
+			finishedJobs.pop_back();
+
+			Job& job = m_jobs[finishedId];
+			job.bFinished = true;
+			job.function = nullptr;
+
+			m_stageProgress[size_t(job.stage)].finished ++;
+			m_unfinishedCount --;
+
+			if (job.group >= 0)
+			{
+				m_groups[job.group].stat.finishedCount ++;
+			}
+
+			for (JobId dependentId : job.dependents)
+			{
+				Job& dependent = m_jobs[dependentId];
+
+				dependent.unfinishedDependencyCount --;
+				if (dependent.unfinishedDependencyCount == 0)
+				{
+					if (m_bCancelled)
+					{
+						finishedJobs.push_back(dependentId);
+					}
+					else
+					{
+						m_readyJobs[size_t(dependent.stage)].push_back(dependentId);
+					}
+				}
+			}
+		}
+
+		if (m_unfinishedCount == 0)
+		{
+			m_finishedCondition.notify_all();
+		}
+	}
+
+	void engine::buildAssetImportJobs(const AssetReflectionInfo& info, std::shared_ptr<AssetImportConfigInterface> config, ImportJobGraph& graph)
+	{
+		if (info.importConfig.buildImportJobs)
+		{
+			info.importConfig.buildImportJobs(config, graph);
+			return;
+		}
+
+		CHECK(info.importConfig.importAssetFromConfigThreadSafe);
+		graph.addJob(EImportJobStage::Decode, utf8::utf16to8(config->path.first.filename().u16string()), [info, config]()
+		{
+			return info.importConfig.importAssetFromConfigThreadSafe(config);
+		});
+	}
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "asset_common.h"
+
+#include <array>
+#include <deque>
+
+namespace engine
+{
+	// Stage of import job, also the default dependency order of one asset import.
+	enum class EImportJobStage
+	{
+		Decode = 0, // Parse raw source file.
+		Geometry,   // Mesh process and cook.
+		Texture,    // Texture decode, mipmap and compress.
+		Material,   // Material asset write.
+		Save,       // Final asset save.
+
+		Max
+	};
+
+	// Asset import jobs with dependency, execute on engine thread pool.
+	// Memory heavy stages (decode, geometry, texture) limit concurrency, total running jobs always leave one free
+	// worker, so job which wait nested parallel loop inside still can finish.
+	// Job can add new jobs to graph when it running, such as decode job add cook jobs after raw file parsed.
+	class ImportJobGraph : NonCopyable
+	{
+	public:
+		using JobId = uint32_t;
+
+		struct StageProgress
+		{
+			uint32_t total = 0;
+			uint32_t finished = 0;
+			uint32_t running = 0;
+		};
+
+		struct GroupStat
+		{
+			std::string name;
+
+			uint32_t jobCount = 0;
+			uint32_t finishedCount = 0;
+			uint32_t failedCount = 0;
+
+			// Milliseconds from first job start to last job finish, and sum of job run time.
+			double wallTime = 0.0;
+			double jobTime = 0.0;
+		};
+
+		explicit ImportJobGraph() = default;
+
+		// Wait all running jobs finish.
+		~ImportJobGraph();
+
+		// Thread safe, job run after all dependencies finish, dependency must add before.
+		// Dependency fail not skip the job, job which need upstream output should check it self.
+		JobId addJob(EImportJobStage stage, const std::string& name, std::function<bool()>&& function, const std::vector<JobId>& dependencies = {});
+
+		// Start dispatch ready jobs to thread pool, later added jobs dispatch when ready.
+		void execute();
+
+		// Jobs not start yet will skip, running jobs keep going until finish.
+		void cancel();
+		bool isCancelled() const { return m_bCancelled; }
+
+		// All jobs finish or skip.
+		bool isFinished() const;
+		void wait();
+
+		// Finished jobs rate of all jobs, new added jobs may make it go back.
+		float getProgress() const;
+		StageProgress getStageProgress(EImportJobStage stage) const;
+
+		uint32_t getFailedCount() const;
+
+		// Jobs add by this thread between beginGroup and endGroup belong to the group, such as all jobs of one asset.
+		// Jobs add by a running job belong to the group of that job.
+		void beginGroup(const std::string& name);
+		void endGroup();
+
+		std::vector<GroupStat> getGroupStats() const;
+
+		static const char* getStageName(EImportJobStage stage);
+
+	private:
+		struct Job
+		{
+			EImportJobStage stage;
+			std::string name;
+			std::function<bool()> function;
+
+			// Jobs wait for this job.
+			std::vector<JobId> dependents;
+			uint32_t unfinishedDependencyCount = 0;
+
+			bool bFinished = false;
+
+			// Group index, -1 when no group.
+			int32_t group = -1;
+		};
+
+		struct Group
+		{
+			GroupStat stat;
+
+			bool bStarted = false;
+			std::chrono::high_resolution_clock::time_point startTime;
+			std::chrono::high_resolution_clock::time_point finishTime;
+		};
+
+		static bool isHeavyStage(EImportJobStage stage);
+
+		// Move ready jobs to thread pool, require lock.
+		void dispatchJobs();
+
+		void runJob(JobId id);
+		void finishJob(JobId id, bool bSucceed);
+
+	private:
+		mutable std::mutex m_lock;
+		std::condition_variable m_finishedCondition;
+
+		// Deque so job reference keep valid when new job add.
+		std::deque<Job> m_jobs;
+
+		// Ready jobs per stage.
+		std::array<std::deque<JobId>, size_t(EImportJobStage::Max)> m_readyJobs;
+		std::array<StageProgress, size_t(EImportJobStage::Max)> m_stageProgress;
+
+		std::vector<Group> m_groups;
+		int32_t m_buildingGroup = -1;
+
+		uint32_t m_unfinishedCount = 0;
+		uint32_t m_runningCount = 0;
+		uint32_t m_heavyRunningCount = 0;
+		uint32_t m_failedCount = 0;
+
+		bool m_bExecuting = false;
+		std::atomic<bool> m_bCancelled = false;
+	};
+
+	// Add import jobs of asset type, fallback one job call importAssetFromConfigThreadSafe when type no custom jobs.
+	extern void buildAssetImportJobs(const AssetReflectionInfo& info, std::shared_ptr<AssetImportConfigInterface> config, ImportJobGraph& graph);
+}
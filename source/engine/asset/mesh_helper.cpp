@@ -0,0 +1,1562 @@
+#include "mesh_helper.h"
+#include "../engine.h"
+
+#include <execution>
+#include <numeric>
+
+namespace engine
+{
+	static AutoCVarInt32 cVarMeshOptimizeEnable(
+		"asset.import.optimizeMesh",
+		"Enable vertex cache, overdraw and vertex fetch optimize when import static mesh.",
+		"Asset",
+		1,
+		CVarFlags::ReadAndWrite);
+
+	static AutoCVarInt32 cVarMeshletBuildEnable(
+		"asset.import.buildMeshlet",
+		"Enable meshlet build when import static mesh, mesh without meshlet only cull per object.",
+		"Asset",
+		1,
+		CVarFlags::ReadAndWrite);
+
+	static AutoCVarInt32 cVarCompactVertexEnable(
+		"asset.import.compactVertex",
+		"Enable compact vertex format when import static mesh, quantize position, octahedral normal and tangent, half float uv.",
+		"Asset",
+		0,
+		CVarFlags::ReadAndWrite);
+
+	static AutoCVarInt32 cVarLodBuildEnable(
+		"asset.import.buildLod",
+		"Enable LOD chain build when import static mesh, LODs simplify from LOD0 and share vertices.",
+		"Asset",
+		1,
+		CVarFlags::ReadAndWrite);
+
+	static AutoCVarInt32 cVarLodCount(
+		"asset.import.lodCount",
+		"Max LOD count include LOD0 when import static mesh, clamp to [1, 4].",
+		"Asset",
+		4,
+		CVarFlags::ReadAndWrite);
+
+	static AutoCVarFloat cVarLodMaxError(
+		"asset.import.lodMaxError",
+		"Max simplify error of coarsest LOD, relative to submesh bounds radius.",
+		"Asset",
+		0.05f,
+		CVarFlags::ReadAndWrite);
+
+	// Forsyth's recommend tuning value, cache size is bigger than hardware so optimize result also fine with fifo cache.
+	static const uint32_t kForsythCacheSize      = 32;
+	static const uint32_t kForsythMaxValenceScore = 32;
+	static const float kForsythCacheDecayPower   = 1.5f;
+	static const float kForsythLastTriScore      = 0.75f;
+	static const float kForsythValenceBoostScale = 2.0f;
+	static const float kForsythValenceBoostPower = 0.5f;
+
+	// Fifo cache size used when split overdraw clusters.
+	static const uint32_t kOverdrawCacheSize = 16;
+
+	struct ForsythScoreTable
+	{
+		float cache[kForsythCacheSize];
+		float valence[kForsythMaxValenceScore];
+
+		ForsythScoreTable()
+		{
+			for (uint32_t i = 0; i < kForsythCacheSize; i++)
+			{
+				// Vertices used in the last triangle get fixed score, avoid favour the same triangle edge.
+				cache[i] = (i < 3)
+					? kForsythLastTriScore
+					: std::pow(1.0f - float(i - 3) / float(kForsythCacheSize - 3), kForsythCacheDecayPower);
+			}
+
+			valence[0] = 0.0f;
+			for (uint32_t i = 1; i < kForsythMaxValenceScore; i++)
+			{
+				valence[i] = kForsythValenceBoostScale * std::pow(float(i), -kForsythValenceBoostPower);
+			}
+		}
+
+		float getScore(int32_t cachePosition, uint32_t remainingValence) const
+		{
+			// No triangle remain, vertex never use again.
+			if (remainingValence == 0)
+			{
+				return -1.0f;
+			}
+
+			float score = cachePosition >= 0 ? cache[cachePosition] : 0.0f;
+			score += remainingValence < kForsythMaxValenceScore
+				? valence[remainingValence]
+				: kForsythValenceBoostScale * std::pow(float(remainingValence), -kForsythValenceBoostPower);
+
+			return score;
+		}
+	};
+
+	// Fifo cache simulate by timestamp, vertex hit if it miss within last cacheSize misses.
+	class FifoCacheSimulator
+	{
+	public:
+		explicit FifoCacheSimulator(size_t vertexCount, uint32_t cacheSize)
+			: m_timestamps(vertexCount, 0)
+			, m_cacheSize(cacheSize)
+			, m_timestamp(cacheSize + 1)
+		{
+
+		}
+
+		// Return miss count of this triangle.
+		uint32_t access(uint32_t a, uint32_t b, uint32_t c)
+		{
+			return accessVertex(a) + accessVertex(b) + accessVertex(c);
+		}
+
+		void reset()
+		{
+			// Jump over cache size so all vertices miss.
+			m_timestamp += m_cacheSize + 1;
+		}
+
+	private:
+		uint32_t accessVertex(uint32_t v)
+		{
+			if (m_timestamp - m_timestamps[v] > m_cacheSize)
+			{
+				m_timestamps[v] = m_timestamp++;
+				return 1;
+			}
+			return 0;
+		}
+
+	private:
+		std::vector<uint32_t> m_timestamps;
+		uint32_t m_cacheSize;
+		uint32_t m_timestamp;
+	};
+
+	VertexCacheStat engine::analyzeVertexCache(
+		const VertexIndexType* indices,
+		size_t indicesCount,
+		size_t vertexCount,
+		uint32_t cacheSize)
+	{
+		VertexCacheStat stat { };
+		if (indicesCount < 3 || vertexCount == 0)
+		{
+			return stat;
+		}
+
+		FifoCacheSimulator cache(vertexCount, cacheSize);
+		std::vector<uint8_t> referenced(vertexCount, 0);
+
+		size_t misses = 0;
+		size_t uniqueCount = 0;
+		for (size_t i = 0; i + 2 < indicesCount; i += 3)
+		{
+			misses += cache.access(indices[i + 0], indices[i + 1], indices[i + 2]);
+
+			for (size_t j = 0; j < 3; j++)
+			{
+				if (!referenced[indices[i + j]])
+				{
+					referenced[indices[i + j]] = 1;
+					uniqueCount++;
+				}
+			}
+		}
+
+		stat.acmr = float(misses) / float(indicesCount / 3);
+		stat.atvr = uniqueCount > 0 ? float(misses) / float(uniqueCount) : 0.0f;
+
+		return stat;
+	}
+
+	void engine::optimizeVertexCache(
+		VertexIndexType* indices,
+		size_t indicesCount,
+		uint32_t vertexStart,
+		uint32_t vertexCount)
+	{
+		const size_t triangleCount = indicesCount / 3;
+		if (triangleCount < 2 || vertexCount == 0)
+		{
+			return;
+		}
+
+		static const ForsythScoreTable kScoreTable { };
+
+		// Local vertex id of each corner.
+		std::vector<uint32_t> corners(triangleCount * 3);
+		for (size_t i = 0; i < triangleCount * 3; i++)
+		{
+			corners[i] = indices[i] - vertexStart;
+		}
+
+		// Vertex to triangle adjacency, triangles of vertex v in [offsets[v], offsets[v] + remainingValences[v]).
+		std::vector<uint32_t> remainingValences(vertexCount, 0);
+		for (uint32_t v : corners)
+		{
+			remainingValences[v]++;
+		}
+
+		std::vector<uint32_t> offsets(vertexCount, 0);
+		for (uint32_t v = 1; v < vertexCount; v++)
+		{
+			offsets[v] = offsets[v - 1] + remainingValences[v - 1];
+		}
+
+		std::vector<uint32_t> adjacency(corners.size());
+		{
+			std::vector<uint32_t> fillCounts(vertexCount, 0);
+			for (size_t i = 0; i < corners.size(); i++)
+			{
+				const uint32_t v = corners[i];
+				adjacency[offsets[v] + fillCounts[v]++] = uint32_t(i / 3);
+			}
+		}
+
+		std::vector<int32_t> cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+		for (uint32_t v = 0; v < vertexCount; v++)
+		{
+			vertexScores[v] = kScoreTable.getScore(-1, remainingValences[v]);
+		}
+
+		std::vector<float> triangleScores(triangleCount);
+		std::vector<uint8_t> emitted(triangleCount, 0);
+		for (size_t t = 0; t < triangleCount; t++)
+		{
+			triangleScores[t] = vertexScores[corners[t * 3 + 0]] + vertexScores[corners[t * 3 + 1]] + vertexScores[corners[t * 3 + 2]];
+		}
+
+		// Lru cache, three more slots for vertices push out by new triangle.
+		uint32_t cache[kForsythCacheSize + 3];
+		uint32_t cacheCount = 0;
+
+		std::vector<VertexIndexType> result;
+		result.reserve(triangleCount * 3);
+
+		int64_t bestTriangle = -1;
+		size_t inputCursor = 0;
+		for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+		{
+			// No candidate in cache, pick next triangle in input order.
+			if (bestTriangle < 0)
+			{
+				while (emitted[inputCursor])
+				{
+					inputCursor++;
+				}
+				bestTriangle = int64_t(inputCursor);
+			}
+
+			const uint32_t* triangle = &corners[bestTriangle * 3];
+			emitted[bestTriangle] = 1;
+
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				const uint32_t v = triangle[i];
+				result.push_back(v + vertexStart);
+
+				// Remove emitted triangle from vertex adjacency.
+				uint32_t* vertexTriangles = &adjacency[offsets[v]];
+				for (uint32_t j = 0; j < remainingValences[v]; j++)
+				{
+					if (vertexTriangles[j] == uint32_t(bestTriangle))
+					{
+						std::swap(vertexTriangles[j], vertexTriangles[remainingValences[v] - 1]);
+						remainingValences[v]--;
+						break;
+					}
+				}
+			}
+
+			// Push triangle vertices to cache front.
+			uint32_t newCache[kForsythCacheSize + 3];
+			uint32_t newCacheCount = 0;
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				newCache[newCacheCount++] = triangle[i];
+			}
+
+			for (uint32_t i = 0; i < cacheCount; i++)
+			{
+				const uint32_t v = cache[i];
+				if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+				{
+					newCache[newCacheCount++] = v;
+				}
+			}
+
+			// Update vertex score, vertices out of cache also need update.
+			for (uint32_t i = 0; i < newCacheCount; i++)
+			{
+				const uint32_t v = newCache[i];
+				cachePositions[v] = i < kForsythCacheSize ? int32_t(i) : -1;
+
+				const float newScore = kScoreTable.getScore(cachePositions[v], remainingValences[v]);
+				const float scoreDiff = newScore - vertexScores[v];
+				vertexScores[v] = newScore;
+
+				const uint32_t* vertexTriangles = &adjacency[offsets[v]];
+				for (uint32_t j = 0; j < remainingValences[v]; j++)
+				{
+					triangleScores[vertexTriangles[j]] += scoreDiff;
+				}
+			}
+
+			// Next best triangle only search in triangles reference cache vertices.
+			bestTriangle = -1;
+			float bestScore = -1.0f;
+
+			cacheCount = std::min(newCacheCount, kForsythCacheSize);
+			for (uint32_t i = 0; i < cacheCount; i++)
+			{
+				const uint32_t v = newCache[i];
+				cache[i] = v;
+
+				const uint32_t* vertexTriangles = &adjacency[offsets[v]];
+				for (uint32_t j = 0; j < remainingValences[v]; j++)
+				{
+					const uint32_t t = vertexTriangles[j];
+					if (triangleScores[t] > bestScore)
+					{
+						bestScore = triangleScores[t];
+						bestTriangle = t;
+					}
+				}
+			}
+		}
+
+		std::memcpy(indices, result.data(), result.size() * sizeof(VertexIndexType));
+	}
+
+	void engine::optimizeOverdraw(
+		VertexIndexType* indices,
+		size_t indicesCount,
+		const VertexPosition* positions,
+		uint32_t vertexStart,
+		uint32_t vertexCount,
+		float threshold)
+	{
+		const size_t triangleCount = indicesCount / 3;
+		if (triangleCount < 2 || vertexCount == 0)
+		{
+			return;
+		}
+
+		// Hard boundary where all triangle vertices miss, reorder there no change cache efficiency.
+		std::vector<size_t> hardBoundaries;
+		{
+			FifoCacheSimulator cache(size_t(vertexStart) + vertexCount, kOverdrawCacheSize);
+			for (size_t t = 0; t < triangleCount; t++)
+			{
+				const uint32_t misses = cache.access(indices[t * 3 + 0], indices[t * 3 + 1], indices[t * 3 + 2]);
+				if (t == 0 || misses == 3)
+				{
+					hardBoundaries.push_back(t);
+				}
+			}
+			hardBoundaries.push_back(triangleCount);
+		}
+
+		// Soft boundary split hard clusters further, when acmr of cluster prefix already good enough.
+		std::vector<size_t> clusters;
+		{
+			FifoCacheSimulator cache(size_t(vertexStart) + vertexCount, kOverdrawCacheSize);
+			for (size_t i = 0; i + 1 < hardBoundaries.size(); i++)
+			{
+				const size_t start = hardBoundaries[i];
+				const size_t end = hardBoundaries[i + 1];
+
+				cache.reset();
+				uint32_t clusterMisses = 0;
+				for (size_t t = start; t < end; t++)
+				{
+					clusterMisses += cache.access(indices[t * 3 + 0], indices[t * 3 + 1], indices[t * 3 + 2]);
+				}
+				const float targetAcmr = float(clusterMisses) / float(end - start) * threshold;
+
+				cache.reset();
+				clusters.push_back(start);
+
+				size_t subStart = start;
+				uint32_t subMisses = 0;
+				for (size_t t = start; t < end; t++)
+				{
+					subMisses += cache.access(indices[t * 3 + 0], indices[t * 3 + 1], indices[t * 3 + 2]);
+
+					const float subAcmr = float(subMisses) / float(t + 1 - subStart);
+					if (t + 1 < end && subAcmr <= targetAcmr)
+					{
+						clusters.push_back(t + 1);
+						subStart = t + 1;
+						subMisses = 0;
+						cache.reset();
+					}
+				}
+			}
+			clusters.push_back(triangleCount);
+		}
+
+		const size_t clusterCount = clusters.size() - 1;
+		if (clusterCount < 2)
+		{
+			return;
+		}
+
+		// Mesh centroid.
+		math::vec3 meshCentroid = math::vec3(0.0f);
+		for (uint32_t v = 0; v < vertexCount; v++)
+		{
+			meshCentroid += positions[vertexStart + v];
+		}
+		meshCentroid /= float(vertexCount);
+
+		// Cluster facing outside and far from center draw first, occlude more pixels.
+		std::vector<float> sortKeys(clusterCount);
+		for (size_t i = 0; i < clusterCount; i++)
+		{
+			math::vec3 centroid = math::vec3(0.0f);
+			math::vec3 normal = math::vec3(0.0f);
+			float area = 0.0f;
+
+			for (size_t t = clusters[i]; t < clusters[i + 1]; t++)
+			{
+				const math::vec3& p0 = positions[indices[t * 3 + 0]];
+				const math::vec3& p1 = positions[indices[t * 3 + 1]];
+				const math::vec3& p2 = positions[indices[t * 3 + 2]];
+
+				// Cross length is twice of triangle area.
+				const math::vec3 faceNormal = math::cross(p1 - p0, p2 - p0);
+				const float faceArea = math::length(faceNormal);
+
+				centroid += (p0 + p1 + p2) * (faceArea / 3.0f);
+				normal += faceNormal;
+				area += faceArea;
+			}
+
+			const float normalLength = math::length(normal);
+			if (area <= 0.0f || normalLength <= 0.0f)
+			{
+				sortKeys[i] = 0.0f;
+				continue;
+			}
+
+			centroid /= area;
+			sortKeys[i] = math::dot(centroid - meshCentroid, normal / normalLength);
+		}
+
+		std::vector<size_t> order(clusterCount);
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sortKeys[a] > sortKeys[b]; });
+
+		std::vector<VertexIndexType> result;
+		result.reserve(triangleCount * 3);
+		for (size_t i : order)
+		{
+			result.insert(result.end(), indices + clusters[i] * 3, indices + clusters[i + 1] * 3);
+		}
+
+		std::memcpy(indices, result.data(), result.size() * sizeof(VertexIndexType));
+	}
+
+	void engine::optimizeVertexFetch(StaticMeshBin& inOutBin)
+	{
+		static const uint32_t kUnused = ~0u;
+
+		const size_t vertexCount = inOutBin.positions.size();
+		std::vector<uint32_t> remap(vertexCount, kUnused);
+
+		uint32_t nextVertex = 0;
+		for (auto& index : inOutBin.indices)
+		{
+			if (remap[index] == kUnused)
+			{
+				remap[index] = nextVertex++;
+			}
+			index = remap[index];
+		}
+
+		for (auto& item : remap)
+		{
+			if (item == kUnused)
+			{
+				item = nextVertex++;
+			}
+		}
+
+		auto remapStream = [&](auto& stream)
+		{
+			std::remove_reference_t<decltype(stream)> newStream(stream.size());
+			for (size_t i = 0; i < stream.size(); i++)
+			{
+				newStream[remap[i]] = stream[i];
+			}
+			stream = std::move(newStream);
+		};
+
+		remapStream(inOutBin.positions);
+		remapStream(inOutBin.normals);
+		remapStream(inOutBin.tangents);
+		remapStream(inOutBin.uv0s);
+	}
+
+	bool engine::isStaticMeshOptimizeEnable()
+	{
+		return cVarMeshOptimizeEnable.get() != 0;
+	}
+
+	void engine::optimizeStaticMesh(const std::vector<StaticMeshSubMesh>& subMeshes, StaticMeshBin& inOutBin, const std::string& debugName)
+	{
+		if (!isStaticMeshOptimizeEnable())
+		{
+			return;
+		}
+
+		ZoneScoped;
+		const auto startTime = std::chrono::high_resolution_clock::now();
+
+		const size_t vertexCount = inOutBin.positions.size();
+		const bool bStreamsMatch =
+			inOutBin.normals.size()  == vertexCount &&
+			inOutBin.tangents.size() == vertexCount &&
+			inOutBin.uv0s.size()     == vertexCount;
+
+		const bool bIndicesValid = std::all_of(inOutBin.indices.begin(), inOutBin.indices.end(), [&](VertexIndexType index)
+		{
+			return index < vertexCount;
+		});
+
+		if (!bStreamsMatch || !bIndicesValid)
+		{
+			LOG_WARN("Mesh {} vertex streams or indices invalid, skip optimize.", debugName);
+			return;
+		}
+
+		const auto statBefore = analyzeVertexCache(inOutBin.indices.data(), inOutBin.indices.size(), vertexCount);
+
+		// Submesh index ranges are disjoint, optimize in parallel.
+		std::for_each(std::execution::par, subMeshes.begin(), subMeshes.end(), [&](const StaticMeshSubMesh& subMesh)
+		{
+			// Only triangle list can reorder.
+			if (subMesh.indicesCount % 3 != 0 || size_t(subMesh.indicesStart) + subMesh.indicesCount > inOutBin.indices.size())
+			{
+				return;
+			}
+
+			VertexIndexType* indices = inOutBin.indices.data() + subMesh.indicesStart;
+			const auto [minIter, maxIter] = std::minmax_element(indices, indices + subMesh.indicesCount);
+			if (minIter == indices + subMesh.indicesCount)
+			{
+				return;
+			}
+
+			const uint32_t vertexStart = *minIter;
+			const uint32_t subMeshVertexCount = *maxIter - *minIter + 1;
+
+			optimizeVertexCache(indices, subMesh.indicesCount, vertexStart, subMeshVertexCount);
+			optimizeOverdraw(indices, subMesh.indicesCount, inOutBin.positions.data(), vertexStart, subMeshVertexCount);
+		});
+
+		// Vertex remap is global, submesh may share vertices.
+		optimizeVertexFetch(inOutBin);
+
+		const auto statAfter = analyzeVertexCache(inOutBin.indices.data(), inOutBin.indices.size(), vertexCount);
+		const auto costTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+		LOG_TRACE("Mesh {} optimize: acmr {:.3f} -> {:.3f}, atvr {:.3f} -> {:.3f}, cost {:.2f} ms.",
+			debugName, statBefore.acmr, statAfter.acmr, statBefore.atvr, statAfter.atvr, costTime);
+	}
+
+	bool engine::isStaticMeshLodEnable()
+	{
+		return cVarLodBuildEnable.get() != 0;
+	}
+
+	uint32_t engine::getStaticMeshLodCount()
+	{
+		return uint32_t(math::clamp(cVarLodCount.get(), 1, int32_t(kStaticMeshMaxLodCount)));
+	}
+
+	float engine::getStaticMeshLodMaxError()
+	{
+		return math::max(cVarLodMaxError.get(), 0.0f);
+	}
+
+	// Symmetric 4x4 error quadric of planes, weighted by triangle area, so error is average squared distance to planes.
+	struct Quadric
+	{
+		double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+		double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+		double c = 0.0;
+		double w = 0.0;
+
+		static Quadric fromTriangle(const math::vec3& p0, const math::vec3& p1, const math::vec3& p2)
+		{
+			Quadric q { };
+
+			const math::dvec3 cross = math::cross(math::dvec3(p1 - p0), math::dvec3(p2 - p0));
+			const double length = math::length(cross);
+			if (length <= 0.0)
+			{
+				return q;
+			}
+
+			const math::dvec3 n = cross / length;
+			const double d = -math::dot(n, math::dvec3(p0));
+			const double area = length * 0.5;
+
+			q.a00 = area * n.x * n.x; q.a01 = area * n.x * n.y; q.a02 = area * n.x * n.z;
+			q.a11 = area * n.y * n.y; q.a12 = area * n.y * n.z; q.a22 = area * n.z * n.z;
+			q.b0  = area * n.x * d;   q.b1  = area * n.y * d;   q.b2  = area * n.z * d;
+			q.c   = area * d * d;
+			q.w   = area;
+
+			return q;
+		}
+
+		void add(const Quadric& q)
+		{
+			a00 += q.a00; a01 += q.a01; a02 += q.a02; a11 += q.a11; a12 += q.a12; a22 += q.a22;
+			b0  += q.b0;  b1  += q.b1;  b2  += q.b2;
+			c   += q.c;
+			w   += q.w;
+		}
+
+		// Squared distance error of position p.
+		double error(const math::vec3& p) const
+		{
+			const double x = p.x, y = p.y, z = p.z;
+			const double e =
+				a00 * x * x + a11 * y * y + a22 * z * z +
+				2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+				2.0 * (b0 * x + b1 * y + b2 * z) + c;
+
+			return w > 0.0 ? math::abs(e) / w : 0.0;
+		}
+	};
+
+	float engine::simplifyMesh(
+		std::vector<VertexIndexType>& inOutIndices,
+		const VertexPosition* positions,
+		uint32_t vertexStart,
+		uint32_t vertexCount,
+		size_t targetIndicesCount,
+		float maxError)
+	{
+		ZoneScoped;
+
+		if (inOutIndices.size() % 3 != 0 || inOutIndices.size() <= targetIndicesCount || maxError <= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		std::vector<uint32_t> indices(inOutIndices.size());
+		for (size_t i = 0; i < inOutIndices.size(); i++)
+		{
+			indices[i] = inOutIndices[i] - vertexStart;
+		}
+
+		auto getPosition = [&](uint32_t v) -> const math::vec3& { return positions[vertexStart + v]; };
+
+		// Vertices split by normal or uv share same position, collapse them tear attribute seam, so lock.
+		std::vector<uint8_t> locked(vertexCount, 0);
+		{
+			std::vector<uint32_t> sortedVertices(vertexCount);
+			std::iota(sortedVertices.begin(), sortedVertices.end(), 0);
+
+			auto positionLess = [&](uint32_t a, uint32_t b)
+			{
+				const auto& pa = getPosition(a);
+				const auto& pb = getPosition(b);
+				return pa.x != pb.x ? pa.x < pb.x : (pa.y != pb.y ? pa.y < pb.y : pa.z < pb.z);
+			};
+			std::sort(sortedVertices.begin(), sortedVertices.end(), positionLess);
+
+			for (size_t i = 1; i < sortedVertices.size(); i++)
+			{
+				if (getPosition(sortedVertices[i - 1]) == getPosition(sortedVertices[i]))
+				{
+					locked[sortedVertices[i - 1]] = 1;
+					locked[sortedVertices[i]] = 1;
+				}
+			}
+		}
+
+		// Border edge reference by one triangle and non-manifold edge reference by more than two, lock vertices on it.
+		{
+			std::vector<uint64_t> edges;
+			edges.reserve(indices.size());
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				for (uint32_t e = 0; e < 3; e++)
+				{
+					const uint64_t a = indices[i + e];
+					const uint64_t b = indices[i + (e + 1) % 3];
+					edges.push_back(a < b ? (a << 32) | b : (b << 32) | a);
+				}
+			}
+			std::sort(edges.begin(), edges.end());
+
+			for (size_t i = 0; i < edges.size();)
+			{
+				size_t j = i + 1;
+				while (j < edges.size() && edges[j] == edges[i])
+				{
+					j++;
+				}
+
+				if (j - i != 2)
+				{
+					locked[uint32_t(edges[i] >> 32)] = 1;
+					locked[uint32_t(edges[i] & 0xFFFFFFFFu)] = 1;
+				}
+				i = j;
+			}
+		}
+
+		std::vector<Quadric> quadrics(vertexCount);
+		for (size_t i = 0; i < indices.size(); i += 3)
+		{
+			const Quadric q = Quadric::fromTriangle(getPosition(indices[i + 0]), getPosition(indices[i + 1]), getPosition(indices[i + 2]));
+			quadrics[indices[i + 0]].add(q);
+			quadrics[indices[i + 1]].add(q);
+			quadrics[indices[i + 2]].add(q);
+		}
+
+		struct Collapse
+		{
+			uint32_t from;
+			uint32_t to;
+			double error;
+		};
+
+		const double maxErrorSquare = double(maxError) * double(maxError);
+		double resultError = 0.0;
+
+		std::vector<uint32_t> remap(vertexCount);
+		std::iota(remap.begin(), remap.end(), 0);
+
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+		std::vector<uint32_t> adjacency;
+		std::vector<Collapse> collapses;
+		std::vector<uint8_t> passLocked(vertexCount);
+		std::vector<uint32_t> ring;
+
+		// Each pass collapse independent edges in error order, 1-ring of collapsed vertex lock until next pass,
+		// so flip and topology check always see current triangles.
+		while (indices.size() > targetIndicesCount)
+		{
+			// Vertex to triangles adjacency.
+			std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+			for (uint32_t index : indices)
+			{
+				adjacencyOffsets[index + 1]++;
+			}
+			for (uint32_t v = 0; v < vertexCount; v++)
+			{
+				adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+			}
+
+			adjacency.resize(indices.size());
+			{
+				std::vector<uint32_t> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+				for (size_t i = 0; i < indices.size(); i++)
+				{
+					adjacency[fillOffsets[indices[i]]++] = uint32_t(i / 3);
+				}
+			}
+
+			// Interior edge visit twice with opposite direction, only keep one.
+			collapses.clear();
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				for (uint32_t e = 0; e < 3; e++)
+				{
+					const uint32_t a = indices[i + e];
+					const uint32_t b = indices[i + (e + 1) % 3];
+					if (a > b)
+					{
+						continue;
+					}
+
+					Quadric q = quadrics[a];
+					q.add(quadrics[b]);
+
+					if (!locked[a])
+					{
+						collapses.push_back({ a, b, q.error(getPosition(b)) });
+					}
+					if (!locked[b])
+					{
+						collapses.push_back({ b, a, q.error(getPosition(a)) });
+					}
+				}
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+			std::fill(passLocked.begin(), passLocked.end(), 0);
+			const size_t removeTriangleTarget = (indices.size() - targetIndicesCount) / 3;
+			size_t removeTriangleCount = 0;
+			size_t collapseCount = 0;
+
+			for (const auto& collapse : collapses)
+			{
+				if (collapse.error > maxErrorSquare || removeTriangleCount >= removeTriangleTarget)
+				{
+					break;
+				}
+
+				const uint32_t from = collapse.from;
+				const uint32_t to = collapse.to;
+				if (passLocked[from] || passLocked[to])
+				{
+					continue;
+				}
+
+				// Link condition, edge only share two opposite vertices, otherwise collapse create non-manifold.
+				ring.clear();
+				for (uint32_t t = adjacencyOffsets[from]; t < adjacencyOffsets[from + 1]; t++)
+				{
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						const uint32_t v = indices[adjacency[t] * 3 + k];
+						if (v != from && v != to && std::find(ring.begin(), ring.end(), v) == ring.end())
+						{
+							ring.push_back(v);
+						}
+					}
+				}
+
+				uint32_t sharedCount = 0;
+				for (uint32_t t = adjacencyOffsets[to]; t < adjacencyOffsets[to + 1]; t++)
+				{
+					for (uint32_t k = 0; k < 3; k++)
+					{
+						const uint32_t v = indices[adjacency[t] * 3 + k];
+						auto iter = std::find(ring.begin(), ring.end(), v);
+						if (iter != ring.end())
+						{
+							// Remove so vertex count once.
+							*iter = ring.back();
+							ring.pop_back();
+							sharedCount++;
+						}
+					}
+				}
+
+				if (sharedCount > 2)
+				{
+					continue;
+				}
+
+				// Triangle normal flip check, also reject triangles become sliver.
+				bool bValid = true;
+				uint32_t removeCount = 0;
+				for (uint32_t t = adjacencyOffsets[from]; t < adjacencyOffsets[from + 1] && bValid; t++)
+				{
+					const uint32_t* tri = &indices[adjacency[t] * 3];
+					if (tri[0] == to || tri[1] == to || tri[2] == to)
+					{
+						removeCount++;
+						continue;
+					}
+
+					const math::vec3 p0 = getPosition(tri[0]);
+					const math::vec3 p1 = getPosition(tri[1]);
+					const math::vec3 p2 = getPosition(tri[2]);
+
+					const math::vec3 n0 = math::cross(p1 - p0, p2 - p0);
+					const math::vec3 n1 = math::cross(
+						(tri[1] == from ? getPosition(to) : p1) - (tri[0] == from ? getPosition(to) : p0),
+						(tri[2] == from ? getPosition(to) : p2) - (tri[0] == from ? getPosition(to) : p0));
+
+					bValid = math::dot(n0, n1) > 0.25f * math::length(n0) * math::length(n1);
+				}
+
+				if (!bValid)
+				{
+					continue;
+				}
+
+				remap[from] = to;
+				quadrics[to].add(quadrics[from]);
+
+				for (uint32_t t = adjacencyOffsets[from]; t < adjacencyOffsets[from + 1]; t++)
+				{
+					passLocked[indices[adjacency[t] * 3 + 0]] = 1;
+					passLocked[indices[adjacency[t] * 3 + 1]] = 1;
+					passLocked[indices[adjacency[t] * 3 + 2]] = 1;
+				}
+
+				removeTriangleCount += removeCount;
+				resultError = math::max(resultError, collapse.error);
+				collapseCount++;
+			}
+
+			if (collapseCount == 0)
+			{
+				break;
+			}
+
+			// Apply collapse and remove degenerate triangles.
+			size_t writeCount = 0;
+			for (size_t i = 0; i < indices.size(); i += 3)
+			{
+				const uint32_t a = remap[indices[i + 0]];
+				const uint32_t b = remap[indices[i + 1]];
+				const uint32_t c = remap[indices[i + 2]];
+
+				if (a != b && b != c && a != c)
+				{
+					indices[writeCount + 0] = a;
+					indices[writeCount + 1] = b;
+					indices[writeCount + 2] = c;
+					writeCount += 3;
+				}
+			}
+			indices.resize(writeCount);
+		}
+
+		inOutIndices.resize(indices.size());
+		for (size_t i = 0; i < indices.size(); i++)
+		{
+			inOutIndices[i] = indices[i] + vertexStart;
+		}
+
+		return float(std::sqrt(resultError));
+	}
+
+	// Each LOD target half triangles of previous, stop chain when simplify can't reduce enough.
+	static const float kLodTriangleRatio  = 0.5f;
+	static const float kLodMinReduceRatio = 0.85f;
+
+	void engine::buildStaticMeshLods(std::vector<StaticMeshSubMesh>& inOutSubMeshes, StaticMeshBin& inOutBin, const std::string& debugName)
+	{
+		for (auto& subMesh : inOutSubMeshes)
+		{
+			subMesh.lods.clear();
+		}
+
+		const uint32_t lodCount = getStaticMeshLodCount();
+		if (!isStaticMeshLodEnable() || lodCount <= 1)
+		{
+			return;
+		}
+
+		ZoneScoped;
+		const auto startTime = std::chrono::high_resolution_clock::now();
+
+		const size_t vertexCount = inOutBin.positions.size();
+		const bool bIndicesValid = std::all_of(inOutBin.indices.begin(), inOutBin.indices.end(), [&](VertexIndexType index)
+		{
+			return index < vertexCount;
+		});
+
+		const bool bRangeValid = std::all_of(inOutSubMeshes.begin(), inOutSubMeshes.end(), [&](const StaticMeshSubMesh& subMesh)
+		{
+			return size_t(subMesh.indicesStart) + subMesh.indicesCount <= inOutBin.indices.size();
+		});
+
+		if (!bIndicesValid || !bRangeValid)
+		{
+			LOG_WARN("Mesh {} indices or submesh range invalid, skip LOD build.", debugName);
+			return;
+		}
+
+		const float maxErrorRelative = getStaticMeshLodMaxError();
+
+		// Simplify per submesh in parallel, each LOD simplify from previous one.
+		std::vector<std::vector<std::vector<VertexIndexType>>> subMeshLodIndices(inOutSubMeshes.size());
+		std::vector<size_t> subMeshIndices(inOutSubMeshes.size());
+		std::iota(subMeshIndices.begin(), subMeshIndices.end(), 0);
+
+		std::for_each(std::execution::par, subMeshIndices.begin(), subMeshIndices.end(), [&](size_t i)
+		{
+			auto& subMesh = inOutSubMeshes[i];
+			if (subMesh.indicesCount == 0 || subMesh.indicesCount % 3 != 0)
+			{
+				return;
+			}
+
+			const VertexIndexType* indices = inOutBin.indices.data() + subMesh.indicesStart;
+			const auto [minIter, maxIter] = std::minmax_element(indices, indices + subMesh.indicesCount);
+
+			const uint32_t vertexStart = *minIter;
+			const uint32_t subMeshVertexCount = *maxIter - *minIter + 1;
+
+			// Error bound relative to submesh size, LOD error accumulate along chain.
+			const float maxError = maxErrorRelative * subMesh.bounds.radius;
+			float error = 0.0f;
+
+			std::vector<VertexIndexType> lodIndices(indices, indices + subMesh.indicesCount);
+			for (uint32_t lod = 1; lod < lodCount; lod++)
+			{
+				const size_t prevIndicesCount = lodIndices.size();
+				const size_t targetIndicesCount = size_t(float(prevIndicesCount / 3) * kLodTriangleRatio) * 3;
+
+				const float lodError = simplifyMesh(lodIndices, inOutBin.positions.data(), vertexStart, subMeshVertexCount, targetIndicesCount, maxError - error);
+				if (lodIndices.empty() || float(lodIndices.size()) > float(prevIndicesCount) * kLodMinReduceRatio)
+				{
+					break;
+				}
+
+				optimizeVertexCache(lodIndices.data(), lodIndices.size(), vertexStart, subMeshVertexCount);
+				error += lodError;
+
+				subMesh.lods.push_back({ .indicesCount = uint32_t(lodIndices.size()), .error = error });
+				subMeshLodIndices[i].push_back(lodIndices);
+			}
+		});
+
+		// Rebuild indices, submesh LOD0 and LODs continuous so packed indices still map by logical position.
+		std::vector<VertexIndexType> newIndices;
+		std::array<size_t, kStaticMeshMaxLodCount> lodTriangleCounts { };
+		for (size_t i = 0; i < inOutSubMeshes.size(); i++)
+		{
+			auto& subMesh = inOutSubMeshes[i];
+
+			const uint32_t newStart = uint32_t(newIndices.size());
+			newIndices.insert(newIndices.end(), inOutBin.indices.begin() + subMesh.indicesStart, inOutBin.indices.begin() + subMesh.indicesStart + subMesh.indicesCount);
+			subMesh.indicesStart = newStart;
+			lodTriangleCounts[0] += subMesh.indicesCount / 3;
+
+			for (size_t lod = 0; lod < subMesh.lods.size(); lod++)
+			{
+				subMesh.lods[lod].indicesStart = uint32_t(newIndices.size());
+				newIndices.insert(newIndices.end(), subMeshLodIndices[i][lod].begin(), subMeshLodIndices[i][lod].end());
+				lodTriangleCounts[lod + 1] += subMesh.lods[lod].indicesCount / 3;
+			}
+		}
+		inOutBin.indices = std::move(newIndices);
+
+		const auto costTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+		LOG_TRACE("Mesh {} build LODs, triangles per LOD {} / {} / {} / {}, cost {:.2f} ms.",
+			debugName, lodTriangleCounts[0], lodTriangleCounts[1], lodTriangleCounts[2], lodTriangleCounts[3], costTime);
+	}
+
+	bool engine::isStaticMeshMeshletEnable()
+	{
+		return cVarMeshletBuildEnable.get() != 0;
+	}
+
+	// Normal cone is useless when triangle normals spread too much, same threshold as meshoptimizer.
+	static const float kMeshletConeMinDot = 0.1f;
+
+	static StaticMeshMeshlet buildMeshlet(
+		const StaticMeshBin& bin,
+		uint32_t indicesStart,
+		uint32_t triangleCount,
+		uint32_t vertexCount)
+	{
+		const VertexIndexType* indices = bin.indices.data() + indicesStart;
+		const VertexPosition* positions = bin.positions.data();
+
+		StaticMeshMeshlet meshlet { };
+		meshlet.indicesStart  = indicesStart;
+		meshlet.triangleCount = triangleCount;
+		meshlet.vertexCount   = vertexCount;
+
+		// Sphere bounds center on aabb center.
+		math::vec3 minPos = positions[indices[0]];
+		math::vec3 maxPos = positions[indices[0]];
+		for (uint32_t i = 1; i < triangleCount * 3; i++)
+		{
+			minPos = math::min(minPos, positions[indices[i]]);
+			maxPos = math::max(maxPos, positions[indices[i]]);
+		}
+
+		const math::vec3 center = (minPos + maxPos) * 0.5f;
+		float radius = 0.0f;
+		for (uint32_t i = 0; i < triangleCount * 3; i++)
+		{
+			radius = math::max(radius, math::length(positions[indices[i]] - center));
+		}
+		meshlet.sphereBounds = math::vec4(center, radius);
+
+		// Normal cone from normalized face normals, degenerate triangles skip.
+		std::array<math::vec3, kMeshletMaxTriangles> normals;
+		std::array<bool, kMeshletMaxTriangles> normalValids;
+
+		math::vec3 normalSum = math::vec3(0.0f);
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			const math::vec3& p0 = positions[indices[i * 3 + 0]];
+			const math::vec3& p1 = positions[indices[i * 3 + 1]];
+			const math::vec3& p2 = positions[indices[i * 3 + 2]];
+
+			const math::vec3 normal = math::cross(p1 - p0, p2 - p0);
+			const float area = math::length(normal);
+
+			normalValids[i] = area > 1e-12f;
+			normals[i] = normalValids[i] ? normal / area : math::vec3(0.0f);
+			normalSum += normals[i];
+		}
+
+		// Degenerate cone never cull, zero axis make dot always less than cutoff.
+		meshlet.coneApex = center;
+		meshlet.coneAxisCutoff = math::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+		const float normalSumLength = math::length(normalSum);
+		if (normalSumLength <= 1e-6f)
+		{
+			return meshlet;
+		}
+
+		const math::vec3 axis = normalSum / normalSumLength;
+
+		float minDot = 1.0f;
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			if (normalValids[i])
+			{
+				minDot = math::min(minDot, math::dot(normals[i], axis));
+			}
+		}
+
+		if (minDot <= kMeshletConeMinDot)
+		{
+			return meshlet;
+		}
+
+		// Move apex back along axis until all triangle planes are in front of it, so the test is view position based.
+		float maxT = 0.0f;
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			if (normalValids[i])
+			{
+				const math::vec3& p0 = positions[indices[i * 3 + 0]];
+				const float t = math::dot(center - p0, normals[i]) / math::dot(axis, normals[i]);
+				maxT = math::max(maxT, t);
+			}
+		}
+
+		meshlet.coneApex = center - axis * maxT;
+		meshlet.coneAxisCutoff = math::vec4(axis, std::sqrt(1.0f - minDot * minDot));
+
+		return meshlet;
+	}
+
+	static void buildSubMeshMeshlets(
+		const StaticMeshBin& bin,
+		const StaticMeshSubMesh& subMesh,
+		std::vector<StaticMeshMeshlet>& outMeshlets)
+	{
+		std::array<VertexIndexType, kMeshletMaxVertices> meshletVertices;
+		uint32_t meshletVertexCount = 0;
+		uint32_t meshletTriangleCount = 0;
+		uint32_t meshletIndicesStart = subMesh.indicesStart;
+
+		auto isVertexInMeshlet = [&](VertexIndexType index)
+		{
+			return std::find(meshletVertices.begin(), meshletVertices.begin() + meshletVertexCount, index) != meshletVertices.begin() + meshletVertexCount;
+		};
+
+		const uint32_t triangleCount = subMesh.indicesCount / 3;
+		for (uint32_t i = 0; i < triangleCount; i++)
+		{
+			const VertexIndexType* triangle = bin.indices.data() + subMesh.indicesStart + i * 3;
+
+			const bool bNew0 = !isVertexInMeshlet(triangle[0]);
+			const bool bNew1 = !isVertexInMeshlet(triangle[1]) && triangle[1] != triangle[0];
+			const bool bNew2 = !isVertexInMeshlet(triangle[2]) && triangle[2] != triangle[0] && triangle[2] != triangle[1];
+			const uint32_t newVertexCount = uint32_t(bNew0) + uint32_t(bNew1) + uint32_t(bNew2);
+
+			// Flush when current meshlet full.
+			if (meshletVertexCount + newVertexCount > kMeshletMaxVertices || meshletTriangleCount >= kMeshletMaxTriangles)
+			{
+				outMeshlets.push_back(buildMeshlet(bin, meshletIndicesStart, meshletTriangleCount, meshletVertexCount));
+
+				meshletIndicesStart += meshletTriangleCount * 3;
+				meshletTriangleCount = 0;
+				meshletVertexCount = 0;
+
+				// All vertices are new for empty meshlet.
+				meshletVertices[meshletVertexCount++] = triangle[0];
+				if (triangle[1] != triangle[0]) { meshletVertices[meshletVertexCount++] = triangle[1]; }
+				if (triangle[2] != triangle[0] && triangle[2] != triangle[1]) { meshletVertices[meshletVertexCount++] = triangle[2]; }
+			}
+			else
+			{
+				if (bNew0) { meshletVertices[meshletVertexCount++] = triangle[0]; }
+				if (bNew1) { meshletVertices[meshletVertexCount++] = triangle[1]; }
+				if (bNew2) { meshletVertices[meshletVertexCount++] = triangle[2]; }
+			}
+
+			meshletTriangleCount++;
+		}
+
+		if (meshletTriangleCount > 0)
+		{
+			outMeshlets.push_back(buildMeshlet(bin, meshletIndicesStart, meshletTriangleCount, meshletVertexCount));
+		}
+	}
+
+	void engine::buildStaticMeshMeshlets(std::vector<StaticMeshSubMesh>& inOutSubMeshes, StaticMeshBin& inOutBin, const std::string& debugName)
+	{
+		inOutBin.meshlets.clear();
+		for (auto& subMesh : inOutSubMeshes)
+		{
+			subMesh.meshletStart = 0;
+			subMesh.meshletCount = 0;
+		}
+
+		if (!isStaticMeshMeshletEnable())
+		{
+			return;
+		}
+
+		ZoneScoped;
+		const auto startTime = std::chrono::high_resolution_clock::now();
+
+		const size_t vertexCount = inOutBin.positions.size();
+		const bool bIndicesValid = std::all_of(inOutBin.indices.begin(), inOutBin.indices.end(), [&](VertexIndexType index)
+		{
+			return index < vertexCount;
+		});
+
+		if (!bIndicesValid)
+		{
+			LOG_WARN("Mesh {} indices invalid, skip meshlet build.", debugName);
+			return;
+		}
+
+		// Build per submesh in parallel, then flatten.
+		std::vector<std::vector<StaticMeshMeshlet>> subMeshMeshlets(inOutSubMeshes.size());
+		std::vector<size_t> subMeshIndices(inOutSubMeshes.size());
+		std::iota(subMeshIndices.begin(), subMeshIndices.end(), 0);
+
+		std::for_each(std::execution::par, subMeshIndices.begin(), subMeshIndices.end(), [&](size_t i)
+		{
+			const auto& subMesh = inOutSubMeshes[i];
+
+			// Submesh without meshlet fallback to whole submesh draw.
+			if (subMesh.indicesCount == 0 || subMesh.indicesCount % 3 != 0 || size_t(subMesh.indicesStart) + subMesh.indicesCount > inOutBin.indices.size())
+			{
+				return;
+			}
+
+			buildSubMeshMeshlets(inOutBin, subMesh, subMeshMeshlets[i]);
+		});
+
+		uint32_t coneValidCount = 0;
+		for (size_t i = 0; i < inOutSubMeshes.size(); i++)
+		{
+			inOutSubMeshes[i].meshletStart = uint32_t(inOutBin.meshlets.size());
+			inOutSubMeshes[i].meshletCount = uint32_t(subMeshMeshlets[i].size());
+
+			for (const auto& meshlet : subMeshMeshlets[i])
+			{
+				coneValidCount += meshlet.coneAxisCutoff.w < 1.0f ? 1 : 0;
+			}
+
+			inOutBin.meshlets.insert(inOutBin.meshlets.end(), subMeshMeshlets[i].begin(), subMeshMeshlets[i].end());
+		}
+
+		// Meshlets only build for LOD0.
+		size_t triangleCount = 0;
+		for (const auto& subMesh : inOutSubMeshes)
+		{
+			triangleCount += subMesh.indicesCount / 3;
+		}
+
+		const auto costTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+		const size_t meshletCount = inOutBin.meshlets.size();
+
+		LOG_TRACE("Mesh {} build {} meshlets, {:.1f} triangles per meshlet, {:.1f}% meshlets can cone cull, cost {:.2f} ms.",
+			debugName,
+			meshletCount,
+			meshletCount > 0 ? double(triangleCount) / double(meshletCount) : 0.0,
+			meshletCount > 0 ? double(coneValidCount) * 100.0 / double(meshletCount) : 0.0,
+			costTime);
+	}
+
+	bool engine::isStaticMeshCompactVertexEnable()
+	{
+		return cVarCompactVertexEnable.get() != 0;
+	}
+
+	// Avoid zero scale when submesh is flat, also used as dequantize scale of raytracing instance.
+	static const float kCompactPositionMinExtent = 1e-6f;
+
+	// Half float max value.
+	static const float kCompactUvMax = 65504.0f;
+
+	static math::vec2 encodeOctahedral(const math::vec3& v)
+	{
+		const float l1Norm = math::abs(v.x) + math::abs(v.y) + math::abs(v.z);
+		if (l1Norm <= 0.0f)
+		{
+			return math::vec2(0.0f);
+		}
+
+		math::vec3 n = v / l1Norm;
+		if (n.z < 0.0f)
+		{
+			const math::vec2 signNotZero = math::vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+			return (1.0f - math::abs(math::vec2(n.y, n.x))) * signNotZero;
+		}
+		return math::vec2(n.x, n.y);
+	}
+
+	static VertexTangentCompact encodeCompactTangent(const VertexTangent& tangent)
+	{
+		const math::vec2 e = math::clamp(encodeOctahedral(math::vec3(tangent)) * 0.5f + 0.5f, 0.0f, 1.0f);
+
+		const uint32_t x = uint32_t(math::round(e.x * 32767.0f));
+		const uint32_t y = uint32_t(math::round(e.y * 32767.0f));
+		const uint32_t sign = tangent.w < 0.0f ? 1U : 0U;
+
+		return x | (y << 15) | (sign << 31);
+	}
+
+	bool engine::compactStaticMeshVertices(std::vector<StaticMeshSubMesh>& inOutSubMeshes, StaticMeshBin& inOutBin, const std::string& debugName)
+	{
+		inOutBin.positionsCompact.clear();
+		inOutBin.normalsCompact.clear();
+		inOutBin.tangentsCompact.clear();
+		inOutBin.uv0sCompact.clear();
+
+		if (!isStaticMeshCompactVertexEnable())
+		{
+			return false;
+		}
+
+		ZoneScoped;
+		const auto startTime = std::chrono::high_resolution_clock::now();
+
+		const size_t vertexCount = inOutBin.positions.size();
+		if (inOutBin.normals.size() != vertexCount || inOutBin.tangents.size() != vertexCount || inOutBin.uv0s.size() != vertexCount)
+		{
+			LOG_WARN("Mesh {} vertex streams size un-match, keep float vertex format.", debugName);
+			return false;
+		}
+
+		for (const auto& subMesh : inOutSubMeshes)
+		{
+			if (size_t(subMesh.indicesStart) + subMesh.getIndicesCountWithLods() > inOutBin.indices.size())
+			{
+				LOG_WARN("Mesh {} submesh range invalid, keep float vertex format.", debugName);
+				return false;
+			}
+
+			for (uint32_t i = subMesh.indicesStart; i < subMesh.indicesStart + subMesh.getIndicesCountWithLods(); i++)
+			{
+				if (inOutBin.indices[i] >= vertexCount)
+				{
+					LOG_WARN("Mesh {} indices invalid, keep float vertex format.", debugName);
+					return false;
+				}
+			}
+		}
+
+		// Position decode by owner submesh bounds, so vertex shared by other submesh need duplicate.
+		// Duplicate vertices append at the end, first owner keep vertex fetch order.
+		std::vector<uint32_t> owners(vertexCount, ~0U);
+		size_t duplicateCount = 0;
+		for (uint32_t subMeshId = 0; subMeshId < uint32_t(inOutSubMeshes.size()); subMeshId++)
+		{
+			const auto& subMesh = inOutSubMeshes[subMeshId];
+
+			std::unordered_map<VertexIndexType, VertexIndexType> duplicateMap;
+			for (uint32_t i = subMesh.indicesStart; i < subMesh.indicesStart + subMesh.getIndicesCountWithLods(); i++)
+			{
+				VertexIndexType& index = inOutBin.indices[i];
+				if (owners[index] == ~0U)
+				{
+					owners[index] = subMeshId;
+				}
+				else if (owners[index] != subMeshId)
+				{
+					auto iter = duplicateMap.find(index);
+					if (iter == duplicateMap.end())
+					{
+						const VertexIndexType newIndex = VertexIndexType(inOutBin.positions.size());
+
+						inOutBin.positions.push_back(inOutBin.positions[index]);
+						inOutBin.normals.push_back(inOutBin.normals[index]);
+						inOutBin.tangents.push_back(inOutBin.tangents[index]);
+						inOutBin.uv0s.push_back(inOutBin.uv0s[index]);
+						owners.push_back(subMeshId);
+
+						iter = duplicateMap.emplace(index, newIndex).first;
+						duplicateCount++;
+					}
+					index = iter->second;
+				}
+			}
+		}
+
+		// Expand submesh bounds to cover all owned vertices, importer bounds may not exactly match final vertices.
+		{
+			std::vector<math::vec3> boundsMin(inOutSubMeshes.size(), math::vec3(std::numeric_limits<float>::max()));
+			std::vector<math::vec3> boundsMax(inOutSubMeshes.size(), math::vec3(std::numeric_limits<float>::lowest()));
+			for (size_t i = 0; i < owners.size(); i++)
+			{
+				if (owners[i] != ~0U)
+				{
+					boundsMin[owners[i]] = math::min(boundsMin[owners[i]], inOutBin.positions[i]);
+					boundsMax[owners[i]] = math::max(boundsMax[owners[i]], inOutBin.positions[i]);
+				}
+			}
+
+			for (size_t i = 0; i < inOutSubMeshes.size(); i++)
+			{
+				auto& bounds = inOutSubMeshes[i].bounds;
+				if (boundsMin[i].x > boundsMax[i].x)
+				{
+					// Submesh no vertex, still keep valid dequantize scale.
+					bounds.extents = math::max(bounds.extents, math::vec3(kCompactPositionMinExtent));
+					continue;
+				}
+
+				const math::vec3 subMeshMin = bounds.origin - bounds.extents;
+				const math::vec3 subMeshMax = bounds.origin + bounds.extents;
+				if (math::any(math::lessThan(boundsMin[i], subMeshMin)) || math::any(math::greaterThan(boundsMax[i], subMeshMax)))
+				{
+					const math::vec3 newMin = math::min(subMeshMin, boundsMin[i]);
+					const math::vec3 newMax = math::max(subMeshMax, boundsMax[i]);
+
+					bounds.origin  = (newMax + newMin) * 0.5f;
+					bounds.extents = (newMax - newMin) * 0.5f;
+					bounds.radius  = math::length(bounds.extents);
+				}
+
+				bounds.extents = math::max(bounds.extents, math::vec3(kCompactPositionMinExtent));
+			}
+		}
+
+		const size_t compactVertexCount = inOutBin.positions.size();
+		inOutBin.positionsCompact.resize(compactVertexCount, VertexPositionCompact(0));
+		inOutBin.normalsCompact.resize(compactVertexCount, 0);
+		inOutBin.tangentsCompact.resize(compactVertexCount, 0);
+		inOutBin.uv0sCompact.resize(compactVertexCount, 0);
+
+		std::vector<size_t> vertexIndices(compactVertexCount);
+		std::iota(vertexIndices.begin(), vertexIndices.end(), 0);
+
+		std::for_each(std::execution::par, vertexIndices.begin(), vertexIndices.end(), [&](size_t i)
+		{
+			// Unreferenced vertex keep zero.
+			if (owners[i] == ~0U)
+			{
+				return;
+			}
+
+			const auto& bounds = inOutSubMeshes[owners[i]].bounds;
+			const math::vec3 position = math::clamp((inOutBin.positions[i] - bounds.origin) / bounds.extents, -1.0f, 1.0f);
+
+			inOutBin.positionsCompact[i].x = math::packSnorm2x16(math::vec2(position.x, position.y));
+			inOutBin.positionsCompact[i].y = math::packSnorm2x16(math::vec2(position.z, 0.0f));
+
+			inOutBin.normalsCompact[i]  = math::packSnorm2x16(encodeOctahedral(inOutBin.normals[i]));
+			inOutBin.tangentsCompact[i] = encodeCompactTangent(inOutBin.tangents[i]);
+			inOutBin.uv0sCompact[i]     = math::packHalf2x16(math::clamp(inOutBin.uv0s[i], -kCompactUvMax, kCompactUvMax));
+		});
+
+		// Float streams no longer used.
+		inOutBin.positions = {};
+		inOutBin.normals   = {};
+		inOutBin.tangents  = {};
+		inOutBin.uv0s      = {};
+
+		float maxExtent = 0.0f;
+		for (const auto& subMesh : inOutSubMeshes)
+		{
+			maxExtent = math::max(maxExtent, math::max(subMesh.bounds.extents.x, math::max(subMesh.bounds.extents.y, subMesh.bounds.extents.z)));
+		}
+
+		const size_t floatBytes = vertexCount * (sizeof(VertexPosition) + sizeof(VertexNormal) + sizeof(VertexTangent) + sizeof(VertexUv0));
+		const size_t compactBytes = compactVertexCount *
+			(sizeof(VertexPositionCompact) + sizeof(VertexNormalCompact) + sizeof(VertexTangentCompact) + sizeof(VertexUv0Compact));
+
+		const auto costTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+		LOG_TRACE("Mesh {} compact {} vertices ({} duplicate), vertex streams {:.2f} MB -> {:.2f} MB, max position step {:.5f}, cost {:.2f} ms.",
+			debugName,
+			compactVertexCount,
+			duplicateCount,
+			double(floatBytes) / 1024.0 / 1024.0,
+			double(compactBytes) / 1024.0 / 1024.0,
+			maxExtent / 32767.0f,
+			costTime);
+
+		return true;
+	}
+
+	void engine::packStaticMeshIndices(std::vector<StaticMeshSubMesh>& inOutSubMeshes, StaticMeshBin& inOutBin, const std::string& debugName)
+	{
+		ZoneScoped;
+
+		inOutBin.indicesPacked.clear();
+		for (auto& subMesh : inOutSubMeshes)
+		{
+			subMesh.vertexStart = 0;
+			subMesh.indicesWordStart = subMesh.indicesStart;
+			subMesh.bIndex16 = false;
+		}
+
+		const bool bRangeValid = std::all_of(inOutSubMeshes.begin(), inOutSubMeshes.end(), [&](const StaticMeshSubMesh& subMesh)
+		{
+			return size_t(subMesh.indicesStart) + subMesh.getIndicesCountWithLods() <= inOutBin.indices.size();
+		});
+
+		if (!bRangeValid)
+		{
+			// Keep absolute 32 bit indices.
+			LOG_WARN("Mesh {} submesh range invalid, skip indices pack.", debugName);
+			return;
+		}
+
+		inOutBin.indicesPacked.reserve(inOutBin.indices.size());
+
+		uint32_t index16SubMeshCount = 0;
+		for (auto& subMesh : inOutSubMeshes)
+		{
+			const VertexIndexType* indices = inOutBin.indices.data() + subMesh.indicesStart;
+			const uint32_t indicesCount = subMesh.getIndicesCountWithLods();
+
+			subMesh.indicesWordStart = uint32_t(inOutBin.indicesPacked.size());
+			if (indicesCount == 0)
+			{
+				continue;
+			}
+
+			const auto [minIter, maxIter] = std::minmax_element(indices, indices + indicesCount);
+			subMesh.vertexStart = *minIter;
+			subMesh.bIndex16 = (*maxIter - *minIter) < kIndex16MaxVertices;
+
+			if (subMesh.bIndex16)
+			{
+				index16SubMeshCount++;
+				for (uint32_t i = 0; i < indicesCount; i += 2)
+				{
+					const uint32_t low  = indices[i] - subMesh.vertexStart;
+					const uint32_t high = (i + 1 < indicesCount) ? indices[i + 1] - subMesh.vertexStart : 0;
+
+					inOutBin.indicesPacked.push_back(low | (high << 16));
+				}
+			}
+			else
+			{
+				for (uint32_t i = 0; i < indicesCount; i++)
+				{
+					inOutBin.indicesPacked.push_back(indices[i] - subMesh.vertexStart);
+				}
+			}
+		}
+
+		LOG_TRACE("Mesh {} pack indices, {}/{} submeshes use 16 bit indices, index buffer {:.2f} MB -> {:.2f} MB.",
+			debugName,
+			index16SubMeshCount,
+			inOutSubMeshes.size(),
+			double(inOutBin.indices.size() * sizeof(VertexIndexType)) / 1024.0 / 1024.0,
+			double(inOutBin.indicesPacked.size() * sizeof(uint32_t)) / 1024.0 / 1024.0);
+	}
+}
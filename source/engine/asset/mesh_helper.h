@@ -0,0 +1,96 @@
+#pragma once
+
+#include "asset_common.h"
+
+namespace engine
+{
+	// Post transform vertex cache statistics, simulate with fifo cache.
+	struct VertexCacheStat
+	{
+		// Average cache miss per triangle, best is 0.5, worst is 3.0.
+		float acmr = 0.0f;
+
+		// Average cache miss per referenced vertex, best is 1.0.
+		float atvr = 0.0f;
+	};
+
+	// Simulate fifo cache of cacheSize, indices must be triangle list.
+	extern VertexCacheStat analyzeVertexCache(
+		const VertexIndexType* indices,
+		size_t indicesCount,
+		size_t vertexCount,
+		uint32_t cacheSize = 16);
+
+	// Reorder triangles for post transform vertex cache, Tom Forsyth's linear-speed vertex cache optimisation.
+	// Indices reference vertex in [vertexStart, vertexStart + vertexCount).
+	extern void optimizeVertexCache(
+		VertexIndexType* indices,
+		size_t indicesCount,
+		uint32_t vertexStart,
+		uint32_t vertexCount);
+
+	// Split cache optimized triangles into clusters, and sort clusters front to back by cluster normal,
+	// cluster split when acmr no worse than threshold * origin acmr, so vertex cache efficiency mostly keep.
+	extern void optimizeOverdraw(
+		VertexIndexType* indices,
+		size_t indicesCount,
+		const VertexPosition* positions,
+		uint32_t vertexStart,
+		uint32_t vertexCount,
+		float threshold = 1.05f);
+
+	// Reorder vertices by first reference order of indices, indices remap in place.
+	// Unreferenced vertices keep at the end.
+	extern void optimizeVertexFetch(StaticMeshBin& inOutBin);
+
+	// Import optimize switch, also part of static mesh derived data key.
+	extern bool isStaticMeshOptimizeEnable();
+
+	// Vertex cache, overdraw and vertex fetch optimize of whole static mesh, per submesh index range.
+	// Index ranges of submeshes keep same, so bin format no change.
+	extern void optimizeStaticMesh(const std::vector<StaticMeshSubMesh>& subMeshes, StaticMeshBin& inOutBin, const std::string& debugName);
+
+	// Import LOD build switch, also part of static mesh derived data key with LOD count and max error.
+	extern bool isStaticMeshLodEnable();
+
+	// LOD count include LOD0, clamp to kStaticMeshMaxLodCount.
+	extern uint32_t getStaticMeshLodCount();
+
+	// Max simplify error of coarsest LOD relative to submesh bounds radius.
+	extern float getStaticMeshLodMaxError();
+
+	// Quadric error metric edge collapse, vertex only collapse into its neighbor so result share vertices with source.
+	// Border, non-manifold and attribute seam vertices keep lock. Indices reference vertex in [vertexStart, vertexStart + vertexCount).
+	// Stop when indices count reach target or collapse error exceed maxError, return max collapse error in position unit.
+	extern float simplifyMesh(
+		std::vector<VertexIndexType>& inOutIndices,
+		const VertexPosition* positions,
+		uint32_t vertexStart,
+		uint32_t vertexCount,
+		size_t targetIndicesCount,
+		float maxError);
+
+	// Build submesh LOD chain, each LOD simplify from previous one. Indices rebuild so each submesh LOD0 and LODs
+	// are continuous, build after optimizeStaticMesh and before meshlets, submesh indicesStart may change.
+	extern void buildStaticMeshLods(std::vector<StaticMeshSubMesh>& inOutSubMeshes, StaticMeshBin& inOutBin, const std::string& debugName);
+
+	// Import meshlet build switch, also part of static mesh derived data key.
+	extern bool isStaticMeshMeshletEnable();
+
+	// Split submesh triangles into meshlets in current index order, so each meshlet is a continuous index range,
+	// build after optimizeStaticMesh to get compact meshlets. Submesh meshlet range write back, meshlets store in bin.
+	extern void buildStaticMeshMeshlets(std::vector<StaticMeshSubMesh>& inOutSubMeshes, StaticMeshBin& inOutBin, const std::string& debugName);
+
+	// Import compact vertex switch, also part of static mesh derived data key.
+	extern bool isStaticMeshCompactVertexEnable();
+
+	// Encode float vertex streams into compact streams, position quantize relative to owner submesh bounds,
+	// vertex shared by multiple submeshes duplicate, submesh bounds expand if vertex out of it.
+	// Build after meshlets, return false if mesh keep float vertex format.
+	extern bool compactStaticMeshVertices(std::vector<StaticMeshSubMesh>& inOutSubMeshes, StaticMeshBin& inOutBin, const std::string& debugName);
+
+	// Pack submesh indices relative to submesh min vertex, use 16 bit indices when vertex range fit kIndex16MaxVertices.
+	// Last step of cook, submesh logical index range keep same, base vertex and word offset write back.
+	// LODs pack with LOD0 as one range, so they share base vertex, index format and logical to word mapping.
+	extern void packStaticMeshIndices(std::vector<StaticMeshSubMesh>& inOutSubMeshes, StaticMeshBin& inOutBin, const std::string& debugName);
+}
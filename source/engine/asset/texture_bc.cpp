@@ -0,0 +1,980 @@
+#include "texture_bc.h"
+#include "../engine.h"
+
+#include <stb/stb_dxt.h>
+#include <stb/stb_image.h>
+#include "nameof/nameof.hpp"
+
+#if defined(_M_X64) || defined(__x86_64__)
+	#include <immintrin.h>
+	#ifdef _MSC_VER
+		#include <intrin.h>
+	#endif
+#endif
+
+// MSVC x64 always can compile sse and avx intrinsics, GCC and Clang compile them per function by target attribute,
+// so binary build without -msse4.1 or -mavx2 still dispatch by cpu support.
+#if defined(_M_X64) || defined(__x86_64__)
+	#define BC_ENCODER_SSE41 1
+	#define BC_ENCODER_AVX2 1
+#else
+	#define BC_ENCODER_SSE41 0
+	#define BC_ENCODER_AVX2 0
+#endif
+
+// Encoder entry of one instruction set flatten all lane calls, lane functions inline into target function.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+	#define BC_TARGET_SSE41 __attribute__((target("sse4.1")))
+	#define BC_TARGET_AVX2 __attribute__((target("avx2")))
+	#define BC_FLATTEN __attribute__((flatten))
+#else
+	#define BC_TARGET_SSE41
+	#define BC_TARGET_AVX2
+	#define BC_FLATTEN
+#endif
+
+namespace engine
+{
+	static AutoCVarInt32 cVarBCEncoderSimd(
+		"asset.import.bcEncoderSimd",
+		"Max instruction set of block compression encoder, 0 is scalar, 1 is SSE4.1, 2 is AVX2.",
+		"Asset",
+		2,
+		CVarFlags::ReadAndWrite);
+
+	constexpr uint32_t kBCBlockPixelCount = 16;
+
+	// Least squares refine iteration count of color endpoints.
+	constexpr uint32_t kBCColorRefineCount = 2;
+
+	// Power iteration count to find principal axis of block colors.
+	constexpr uint32_t kBCPowerIterationCount = 4;
+
+	// Lane types used by encoder template, one lane encode one block.
+	// Mask lane is not zero when true, select return a when mask true.
+	struct LaneScalar
+	{
+		static constexpr size_t kWidth = 1;
+		float v;
+
+		static LaneScalar load(const float* p) { return { p[0] }; }
+		static LaneScalar splat(float x) { return { x }; }
+		void store(float* p) const { p[0] = v; }
+	};
+
+	inline LaneScalar operator+(LaneScalar a, LaneScalar b) { return { a.v + b.v }; }
+	inline LaneScalar operator-(LaneScalar a, LaneScalar b) { return { a.v - b.v }; }
+	inline LaneScalar operator*(LaneScalar a, LaneScalar b) { return { a.v * b.v }; }
+	inline LaneScalar operator/(LaneScalar a, LaneScalar b) { return { a.v / b.v }; }
+	inline LaneScalar laneMin(LaneScalar a, LaneScalar b) { return { std::min(a.v, b.v) }; }
+	inline LaneScalar laneMax(LaneScalar a, LaneScalar b) { return { std::max(a.v, b.v) }; }
+	inline LaneScalar laneSqrt(LaneScalar a) { return { std::sqrt(a.v) }; }
+	inline LaneScalar laneFloor(LaneScalar a) { return { std::floor(a.v) }; }
+	inline LaneScalar laneAbs(LaneScalar a) { return { std::abs(a.v) }; }
+	inline LaneScalar laneLess(LaneScalar a, LaneScalar b) { return { a.v < b.v ? 1.0f : 0.0f }; }
+	inline LaneScalar laneSelect(LaneScalar mask, LaneScalar a, LaneScalar b) { return mask.v != 0.0f ? a : b; }
+
+#if BC_ENCODER_SSE41
+	struct LaneSSE41
+	{
+		static constexpr size_t kWidth = 4;
+		__m128 v;
+
+		BC_TARGET_SSE41 static LaneSSE41 load(const float* p) { return { _mm_loadu_ps(p) }; }
+		BC_TARGET_SSE41 static LaneSSE41 splat(float x) { return { _mm_set1_ps(x) }; }
+		BC_TARGET_SSE41 void store(float* p) const { _mm_storeu_ps(p, v); }
+	};
+
+	BC_TARGET_SSE41 inline LaneSSE41 operator+(LaneSSE41 a, LaneSSE41 b) { return { _mm_add_ps(a.v, b.v) }; }
+	BC_TARGET_SSE41 inline LaneSSE41 operator-(LaneSSE41 a, LaneSSE41 b) { return { _mm_sub_ps(a.v, b.v) }; }
+	BC_TARGET_SSE41 inline LaneSSE41 operator*(LaneSSE41 a, LaneSSE41 b) { return { _mm_mul_ps(a.v, b.v) }; }
+	BC_TARGET_SSE41 inline LaneSSE41 operator/(LaneSSE41 a, LaneSSE41 b) { return { _mm_div_ps(a.v, b.v) }; }
+	BC_TARGET_SSE41 inline LaneSSE41 laneMin(LaneSSE41 a, LaneSSE41 b) { return { _mm_min_ps(a.v, b.v) }; }
+	BC_TARGET_SSE41 inline LaneSSE41 laneMax(LaneSSE41 a, LaneSSE41 b) { return { _mm_max_ps(a.v, b.v) }; }
+	BC_TARGET_SSE41 inline LaneSSE41 laneSqrt(LaneSSE41 a) { return { _mm_sqrt_ps(a.v) }; }
+	BC_TARGET_SSE41 inline LaneSSE41 laneFloor(LaneSSE41 a) { return { _mm_floor_ps(a.v) }; }
+	BC_TARGET_SSE41 inline LaneSSE41 laneAbs(LaneSSE41 a) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+	BC_TARGET_SSE41 inline LaneSSE41 laneLess(LaneSSE41 a, LaneSSE41 b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+	BC_TARGET_SSE41 inline LaneSSE41 laneSelect(LaneSSE41 mask, LaneSSE41 a, LaneSSE41 b) { return { _mm_blendv_ps(b.v, a.v, mask.v) }; }
+#endif
+
+#if BC_ENCODER_AVX2
+	struct LaneAVX2
+	{
+		static constexpr size_t kWidth = 8;
+		__m256 v;
+
+		BC_TARGET_AVX2 static LaneAVX2 load(const float* p) { return { _mm256_loadu_ps(p) }; }
+		BC_TARGET_AVX2 static LaneAVX2 splat(float x) { return { _mm256_set1_ps(x) }; }
+		BC_TARGET_AVX2 void store(float* p) const { _mm256_storeu_ps(p, v); }
+	};
+
+	BC_TARGET_AVX2 inline LaneAVX2 operator+(LaneAVX2 a, LaneAVX2 b) { return { _mm256_add_ps(a.v, b.v) }; }
+	BC_TARGET_AVX2 inline LaneAVX2 operator-(LaneAVX2 a, LaneAVX2 b) { return { _mm256_sub_ps(a.v, b.v) }; }
+	BC_TARGET_AVX2 inline LaneAVX2 operator*(LaneAVX2 a, LaneAVX2 b) { return { _mm256_mul_ps(a.v, b.v) }; }
+	BC_TARGET_AVX2 inline LaneAVX2 operator/(LaneAVX2 a, LaneAVX2 b) { return { _mm256_div_ps(a.v, b.v) }; }
+	BC_TARGET_AVX2 inline LaneAVX2 laneMin(LaneAVX2 a, LaneAVX2 b) { return { _mm256_min_ps(a.v, b.v) }; }
+	BC_TARGET_AVX2 inline LaneAVX2 laneMax(LaneAVX2 a, LaneAVX2 b) { return { _mm256_max_ps(a.v, b.v) }; }
+	BC_TARGET_AVX2 inline LaneAVX2 laneSqrt(LaneAVX2 a) { return { _mm256_sqrt_ps(a.v) }; }
+	BC_TARGET_AVX2 inline LaneAVX2 laneFloor(LaneAVX2 a) { return { _mm256_floor_ps(a.v) }; }
+	BC_TARGET_AVX2 inline LaneAVX2 laneAbs(LaneAVX2 a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v) }; }
+	BC_TARGET_AVX2 inline LaneAVX2 laneLess(LaneAVX2 a, LaneAVX2 b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+	BC_TARGET_AVX2 inline LaneAVX2 laneSelect(LaneAVX2 mask, LaneAVX2 a, LaneAVX2 b) { return { _mm256_blendv_ps(b.v, a.v, mask.v) }; }
+#endif
+
+	template<typename L>
+	inline L laneClamp(L x, float minValue, float maxValue)
+	{
+		return laneMin(laneMax(x, L::splat(minValue)), L::splat(maxValue));
+	}
+
+	template<typename L>
+	inline L laneRound(L x)
+	{
+		return laneFloor(x + L::splat(0.5f));
+	}
+
+	// Encoder of one batch, block data is float of all lanes, [channel][pixel] per lane.
+	template<typename L>
+	struct BCBatchEncoder
+	{
+		// Color endpoints quantized to 565 in value range of each channel, indices along q0 -> q1 in [0, 3].
+		struct ColorFit
+		{
+			L q0[3];
+			L q1[3];
+			L indices[kBCBlockPixelCount];
+			L error;
+		};
+
+		static void selectColorFit(L mask, const ColorFit& a, ColorFit& inOutB)
+		{
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				inOutB.q0[c] = laneSelect(mask, a.q0[c], inOutB.q0[c]);
+				inOutB.q1[c] = laneSelect(mask, a.q1[c], inOutB.q1[c]);
+			}
+			for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+			{
+				inOutB.indices[p] = laneSelect(mask, a.indices[p], inOutB.indices[p]);
+			}
+			inOutB.error = laneSelect(mask, a.error, inOutB.error);
+		}
+
+		static void quantize565(const L e[3], L outQ[3])
+		{
+			static const float kMaxValue[3] = { 31.0f, 63.0f, 31.0f };
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				outQ[c] = laneRound(laneClamp(e[c], 0.0f, 255.0f) * L::splat(kMaxValue[c] / 255.0f));
+			}
+		}
+
+		// Same as hardware bit replicate expand.
+		static void expand565(const L q[3], L outE[3])
+		{
+			outE[0] = q[0] * L::splat(8.0f) + laneFloor(q[0] * L::splat(0.25f));
+			outE[1] = q[1] * L::splat(4.0f) + laneFloor(q[1] * L::splat(1.0f / 16.0f));
+			outE[2] = q[2] * L::splat(8.0f) + laneFloor(q[2] * L::splat(0.25f));
+		}
+
+		// Select nearest palette color for each pixel.
+		static void fitIndices(const L rgb[3][kBCBlockPixelCount], ColorFit& inOutFit)
+		{
+			L e0[3], e1[3];
+			expand565(inOutFit.q0, e0);
+			expand565(inOutFit.q1, e1);
+
+			L palette[4][3];
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				palette[0][c] = e0[c];
+				palette[1][c] = (e0[c] * L::splat(2.0f) + e1[c]) * L::splat(1.0f / 3.0f);
+				palette[2][c] = (e0[c] + e1[c] * L::splat(2.0f)) * L::splat(1.0f / 3.0f);
+				palette[3][c] = e1[c];
+			}
+
+			inOutFit.error = L::splat(0.0f);
+			for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+			{
+				L bestDistance = L::splat(std::numeric_limits<float>::max());
+				L bestIndex = L::splat(0.0f);
+				for (uint32_t j = 0; j < 4; j++)
+				{
+					const L dr = rgb[0][p] - palette[j][0];
+					const L dg = rgb[1][p] - palette[j][1];
+					const L db = rgb[2][p] - palette[j][2];
+					const L distance = dr * dr + dg * dg + db * db;
+
+					const L mask = laneLess(distance, bestDistance);
+					bestDistance = laneSelect(mask, distance, bestDistance);
+					bestIndex = laneSelect(mask, L::splat(float(j)), bestIndex);
+				}
+
+				inOutFit.indices[p] = bestIndex;
+				inOutFit.error = inOutFit.error + bestDistance;
+			}
+		}
+
+		// Least squares endpoints of current indices, keep fallback when all pixels select same index.
+		static void refineEndpoints(const L rgb[3][kBCBlockPixelCount], const L indices[kBCBlockPixelCount], L inOutE0[3], L inOutE1[3])
+		{
+			L alpha2 = L::splat(0.0f);
+			L beta2 = L::splat(0.0f);
+			L alphaBeta = L::splat(0.0f);
+			L alphaX[3] = { L::splat(0.0f), L::splat(0.0f), L::splat(0.0f) };
+			L betaX[3] = { L::splat(0.0f), L::splat(0.0f), L::splat(0.0f) };
+
+			for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+			{
+				const L beta = indices[p] * L::splat(1.0f / 3.0f);
+				const L alpha = L::splat(1.0f) - beta;
+
+				alpha2 = alpha2 + alpha * alpha;
+				beta2 = beta2 + beta * beta;
+				alphaBeta = alphaBeta + alpha * beta;
+
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					alphaX[c] = alphaX[c] + alpha * rgb[c][p];
+					betaX[c] = betaX[c] + beta * rgb[c][p];
+				}
+			}
+
+			const L det = alpha2 * beta2 - alphaBeta * alphaBeta;
+			const L valid = laneLess(L::splat(1e-4f), det);
+			const L invDet = L::splat(1.0f) / laneSelect(valid, det, L::splat(1.0f));
+
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				const L e0 = (alphaX[c] * beta2 - betaX[c] * alphaBeta) * invDet;
+				const L e1 = (betaX[c] * alpha2 - alphaX[c] * alphaBeta) * invDet;
+
+				inOutE0[c] = laneSelect(valid, e0, inOutE0[c]);
+				inOutE1[c] = laneSelect(valid, e1, inOutE1[c]);
+			}
+		}
+
+		static void encodeColor(const L rgb[3][kBCBlockPixelCount], ColorFit& outFit)
+		{
+			// Mean and covariance of block colors.
+			L mean[3] = { L::splat(0.0f), L::splat(0.0f), L::splat(0.0f) };
+			for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+			{
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					mean[c] = mean[c] + rgb[c][p];
+				}
+			}
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				mean[c] = mean[c] * L::splat(1.0f / float(kBCBlockPixelCount));
+			}
+
+			// rr, rg, rb, gg, gb, bb.
+			L cov[6] = { L::splat(0.0f), L::splat(0.0f), L::splat(0.0f), L::splat(0.0f), L::splat(0.0f), L::splat(0.0f) };
+			for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+			{
+				const L r = rgb[0][p] - mean[0];
+				const L g = rgb[1][p] - mean[1];
+				const L b = rgb[2][p] - mean[2];
+
+				cov[0] = cov[0] + r * r;
+				cov[1] = cov[1] + r * g;
+				cov[2] = cov[2] + r * b;
+				cov[3] = cov[3] + g * g;
+				cov[4] = cov[4] + g * b;
+				cov[5] = cov[5] + b * b;
+			}
+
+			// Principal axis by power iteration, start from covariance row sum.
+			L axis[3] =
+			{
+				cov[0] + cov[1] + cov[2],
+				cov[1] + cov[3] + cov[4],
+				cov[2] + cov[4] + cov[5],
+			};
+			for (uint32_t i = 0; i < kBCPowerIterationCount; i++)
+			{
+				const L x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+				const L y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+				const L z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+
+				const L scale = L::splat(1.0f) / laneMax(laneMax(laneAbs(x), laneAbs(y)), laneMax(laneAbs(z), L::splat(1e-8f)));
+				axis[0] = x * scale;
+				axis[1] = y * scale;
+				axis[2] = z * scale;
+			}
+
+			const L axisLength2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+			const L invAxisLength = L::splat(1.0f) / laneSqrt(laneMax(axisLength2, L::splat(1e-8f)));
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				axis[c] = axis[c] * invAxisLength;
+			}
+
+			// Endpoints from projection range on principal axis.
+			L minT = L::splat(std::numeric_limits<float>::max());
+			L maxT = L::splat(std::numeric_limits<float>::lowest());
+			for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+			{
+				const L t =
+					(rgb[0][p] - mean[0]) * axis[0] +
+					(rgb[1][p] - mean[1]) * axis[1] +
+					(rgb[2][p] - mean[2]) * axis[2];
+
+				minT = laneMin(minT, t);
+				maxT = laneMax(maxT, t);
+			}
+
+			L e0[3], e1[3];
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				e0[c] = mean[c] + axis[c] * minT;
+				e1[c] = mean[c] + axis[c] * maxT;
+			}
+
+			quantize565(e0, outFit.q0);
+			quantize565(e1, outFit.q1);
+			fitIndices(rgb, outFit);
+
+			ColorFit refineFit;
+			for (uint32_t i = 0; i < kBCColorRefineCount; i++)
+			{
+				refineEndpoints(rgb, outFit.indices, e0, e1);
+
+				quantize565(e0, refineFit.q0);
+				quantize565(e1, refineFit.q1);
+				fitIndices(rgb, refineFit);
+
+				selectColorFit(laneLess(refineFit.error, outFit.error), refineFit, outFit);
+			}
+		}
+
+		// Endpoints are block min max, indices along min -> max in [0, 7].
+		static void encodeAlpha(const L values[kBCBlockPixelCount], L& outMin, L& outMax, L outIndices[kBCBlockPixelCount])
+		{
+			outMin = values[0];
+			outMax = values[0];
+			for (uint32_t p = 1; p < kBCBlockPixelCount; p++)
+			{
+				outMin = laneMin(outMin, values[p]);
+				outMax = laneMax(outMax, values[p]);
+			}
+
+			const L range = outMax - outMin;
+			const L scale = L::splat(7.0f) / laneSelect(laneLess(L::splat(0.0f), range), range, L::splat(1.0f));
+			for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+			{
+				outIndices[p] = laneClamp(laneRound((values[p] - outMin) * scale), 0.0f, 7.0f);
+			}
+		}
+	};
+
+	static void packBC1(uint8_t* dest, const float q0[3], const float q1[3], const float indices[kBCBlockPixelCount])
+	{
+		// Internal index along e0 -> e1 to bc1 code.
+		static const uint32_t kCodes[4] = { 0, 2, 3, 1 };
+
+		uint16_t c0 = uint16_t((uint32_t(q0[0]) << 11) | (uint32_t(q0[1]) << 5) | uint32_t(q0[2]));
+		uint16_t c1 = uint16_t((uint32_t(q1[0]) << 11) | (uint32_t(q1[1]) << 5) | uint32_t(q1[2]));
+
+		// Four color mode need c0 > c1, all pixels use c0 when endpoints same.
+		uint32_t bits = 0;
+		if (c0 != c1)
+		{
+			const bool bSwap = c0 < c1;
+			for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+			{
+				const uint32_t j = uint32_t(indices[p]);
+				bits |= kCodes[bSwap ? 3 - j : j] << (p * 2);
+			}
+
+			if (bSwap)
+			{
+				std::swap(c0, c1);
+			}
+		}
+
+		dest[0] = uint8_t(c0 & 0xff);
+		dest[1] = uint8_t(c0 >> 8);
+		dest[2] = uint8_t(c1 & 0xff);
+		dest[3] = uint8_t(c1 >> 8);
+		dest[4] = uint8_t((bits >>  0) & 0xff);
+		dest[5] = uint8_t((bits >>  8) & 0xff);
+		dest[6] = uint8_t((bits >> 16) & 0xff);
+		dest[7] = uint8_t((bits >> 24) & 0xff);
+	}
+
+	static void packBC4(uint8_t* dest, float minValue, float maxValue, const float indices[kBCBlockPixelCount])
+	{
+		const uint8_t a0 = uint8_t(maxValue);
+		const uint8_t a1 = uint8_t(minValue);
+
+		// Eight value mode, code 0 is max, code 1 is min, code 2-7 lerp from max to min.
+		uint64_t bits = 0;
+		if (a0 > a1)
+		{
+			for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+			{
+				const uint32_t j = uint32_t(indices[p]);
+				const uint64_t code = (j == 7) ? 0 : (j == 0 ? 1 : 8 - j);
+				bits |= code << (p * 3);
+			}
+		}
+
+		dest[0] = a0;
+		dest[1] = a1;
+		for (uint32_t i = 0; i < 6; i++)
+		{
+			dest[2 + i] = uint8_t((bits >> (i * 8)) & 0xff);
+		}
+	}
+
+	// Encode color of blockCount blocks, source pixel stride in bytes, dest stride per block in bytes.
+	template<typename L>
+	static void encodeColorBlocks(uint8_t* dest, size_t destStride, const uint8_t* src, size_t blockCount)
+	{
+		constexpr size_t kWidth = L::kWidth;
+		constexpr size_t kPixelStride = 4;
+
+		alignas(32) float gather[3][kBCBlockPixelCount][kWidth];
+		alignas(32) float q0[3][kWidth], q1[3][kWidth];
+		alignas(32) float indices[kBCBlockPixelCount][kWidth];
+
+		for (size_t base = 0; base < blockCount; base += kWidth)
+		{
+			const size_t laneCount = std::min(kWidth, blockCount - base);
+
+			// Tail lanes repeat last block.
+			for (size_t lane = 0; lane < kWidth; lane++)
+			{
+				const uint8_t* block = src + (base + std::min(lane, laneCount - 1)) * kBCBlockPixelCount * kPixelStride;
+				for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+				{
+					for (uint32_t c = 0; c < 3; c++)
+					{
+						gather[c][p][lane] = float(block[p * kPixelStride + c]);
+					}
+				}
+			}
+
+			L rgb[3][kBCBlockPixelCount];
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+				{
+					rgb[c][p] = L::load(gather[c][p]);
+				}
+			}
+
+			typename BCBatchEncoder<L>::ColorFit fit;
+			BCBatchEncoder<L>::encodeColor(rgb, fit);
+
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				fit.q0[c].store(q0[c]);
+				fit.q1[c].store(q1[c]);
+			}
+			for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+			{
+				fit.indices[p].store(indices[p]);
+			}
+
+			for (size_t lane = 0; lane < laneCount; lane++)
+			{
+				const float laneQ0[3] = { q0[0][lane], q0[1][lane], q0[2][lane] };
+				const float laneQ1[3] = { q1[0][lane], q1[1][lane], q1[2][lane] };
+
+				float laneIndices[kBCBlockPixelCount];
+				for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+				{
+					laneIndices[p] = indices[p][lane];
+				}
+
+				packBC1(dest + (base + lane) * destStride, laneQ0, laneQ1, laneIndices);
+			}
+		}
+	}
+
+	// Encode one channel of blockCount blocks.
+	template<typename L>
+	static void encodeAlphaBlocks(uint8_t* dest, size_t destStride, const uint8_t* src, size_t pixelStride, size_t channel, size_t blockCount)
+	{
+		constexpr size_t kWidth = L::kWidth;
+
+		alignas(32) float gather[kBCBlockPixelCount][kWidth];
+		alignas(32) float minValues[kWidth], maxValues[kWidth];
+		alignas(32) float indices[kBCBlockPixelCount][kWidth];
+
+		for (size_t base = 0; base < blockCount; base += kWidth)
+		{
+			const size_t laneCount = std::min(kWidth, blockCount - base);
+
+			for (size_t lane = 0; lane < kWidth; lane++)
+			{
+				const uint8_t* block = src + (base + std::min(lane, laneCount - 1)) * kBCBlockPixelCount * pixelStride;
+				for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+				{
+					gather[p][lane] = float(block[p * pixelStride + channel]);
+				}
+			}
+
+			L values[kBCBlockPixelCount];
+			for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+			{
+				values[p] = L::load(gather[p]);
+			}
+
+			L minValue, maxValue;
+			L laneIndices[kBCBlockPixelCount];
+			BCBatchEncoder<L>::encodeAlpha(values, minValue, maxValue, laneIndices);
+
+			minValue.store(minValues);
+			maxValue.store(maxValues);
+			for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+			{
+				laneIndices[p].store(indices[p]);
+			}
+
+			for (size_t lane = 0; lane < laneCount; lane++)
+			{
+				float blockIndices[kBCBlockPixelCount];
+				for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+				{
+					blockIndices[p] = indices[p][lane];
+				}
+
+				packBC4(dest + (base + lane) * destStride, minValues[lane], maxValues[lane], blockIndices);
+			}
+		}
+	}
+
+	static EBCEncoderSimd detectBCEncoderSimd()
+	{
+		bool bSSE41 = false;
+		bool bAVX2 = false;
+
+#if defined(_M_X64)
+		int info[4];
+		__cpuid(info, 1);
+		bSSE41 = (info[2] & (1 << 19)) != 0;
+
+		// Os must save ymm state.
+		const bool bOSXSave = (info[2] & (1 << 27)) != 0;
+		const bool bAVX = (info[2] & (1 << 28)) != 0;
+		if (bOSXSave && bAVX && (_xgetbv(0) & 0x6) == 0x6)
+		{
+			__cpuidex(info, 7, 0);
+			bAVX2 = (info[1] & (1 << 5)) != 0;
+		}
+#elif defined(__x86_64__)
+		bSSE41 = __builtin_cpu_supports("sse4.1");
+		bAVX2 = __builtin_cpu_supports("avx2");
+#endif
+
+		if (bAVX2 && BC_ENCODER_AVX2)
+		{
+			return EBCEncoderSimd::AVX2;
+		}
+		if (bSSE41 && BC_ENCODER_SSE41)
+		{
+			return EBCEncoderSimd::SSE41;
+		}
+		return EBCEncoderSimd::Scalar;
+	}
+
+	bool engine::isBCEncoderSimdSupported(EBCEncoderSimd simd)
+	{
+		static const EBCEncoderSimd kSupported = detectBCEncoderSimd();
+		return simd <= kSupported;
+	}
+
+	EBCEncoderSimd engine::getBCEncoderSimd()
+	{
+		const int32_t level = math::clamp(cVarBCEncoderSimd.get(), 0, int32_t(EBCEncoderSimd::Max) - 1);
+		for (int32_t i = level; i > 0; i--)
+		{
+			if (isBCEncoderSimdSupported(EBCEncoderSimd(i)))
+			{
+				return EBCEncoderSimd(i);
+			}
+		}
+		return EBCEncoderSimd::Scalar;
+	}
+
+#if BC_ENCODER_AVX2
+	template<template<typename> typename F, typename... Args>
+	BC_TARGET_AVX2 BC_FLATTEN static void runBCEncoderAVX2(Args&&... args)
+	{
+		F<LaneAVX2>::run(std::forward<Args>(args)...);
+	}
+#endif
+
+#if BC_ENCODER_SSE41
+	template<template<typename> typename F, typename... Args>
+	BC_TARGET_SSE41 BC_FLATTEN static void runBCEncoderSSE41(Args&&... args)
+	{
+		F<LaneSSE41>::run(std::forward<Args>(args)...);
+	}
+#endif
+
+	template<template<typename> typename F, typename... Args>
+	static void dispatchBCEncoder(EBCEncoderSimd simd, Args&&... args)
+	{
+		if (!isBCEncoderSimdSupported(simd))
+		{
+			simd = EBCEncoderSimd::Scalar;
+		}
+
+		switch (simd)
+		{
+#if BC_ENCODER_AVX2
+		case EBCEncoderSimd::AVX2:  runBCEncoderAVX2<F>(std::forward<Args>(args)...); return;
+#endif
+#if BC_ENCODER_SSE41
+		case EBCEncoderSimd::SSE41: runBCEncoderSSE41<F>(std::forward<Args>(args)...); return;
+#endif
+		default:                    F<LaneScalar>::run(std::forward<Args>(args)...); return;
+		}
+	}
+
+	template<typename L>
+	struct BC1Task
+	{
+		static void run(uint8_t* dest, const uint8_t* src, size_t blockCount)
+		{
+			encodeColorBlocks<L>(dest, 8, src, blockCount);
+		}
+	};
+
+	template<typename L>
+	struct BC3Task
+	{
+		static void run(uint8_t* dest, const uint8_t* src, size_t blockCount)
+		{
+			encodeAlphaBlocks<L>(dest, 16, src, 4, 3, blockCount);
+			encodeColorBlocks<L>(dest + 8, 16, src, blockCount);
+		}
+	};
+
+	template<typename L>
+	struct BC4Task
+	{
+		static void run(uint8_t* dest, const uint8_t* src, size_t blockCount)
+		{
+			encodeAlphaBlocks<L>(dest, 8, src, 1, 0, blockCount);
+		}
+	};
+
+	template<typename L>
+	struct BC5Task
+	{
+		static void run(uint8_t* dest, const uint8_t* src, size_t blockCount)
+		{
+			encodeAlphaBlocks<L>(dest + 0, 16, src, 2, 0, blockCount);
+			encodeAlphaBlocks<L>(dest + 8, 16, src, 2, 1, blockCount);
+		}
+	};
+
+	void engine::encodeBC1Blocks(uint8_t* dest, const uint8_t* src, size_t blockCount, EBCEncoderSimd simd)
+	{
+		dispatchBCEncoder<BC1Task>(simd, dest, src, blockCount);
+	}
+
+	void engine::encodeBC3Blocks(uint8_t* dest, const uint8_t* src, size_t blockCount, EBCEncoderSimd simd)
+	{
+		dispatchBCEncoder<BC3Task>(simd, dest, src, blockCount);
+	}
+
+	void engine::encodeBC4Blocks(uint8_t* dest, const uint8_t* src, size_t blockCount, EBCEncoderSimd simd)
+	{
+		dispatchBCEncoder<BC4Task>(simd, dest, src, blockCount);
+	}
+
+	void engine::encodeBC5Blocks(uint8_t* dest, const uint8_t* src, size_t blockCount, EBCEncoderSimd simd)
+	{
+		dispatchBCEncoder<BC5Task>(simd, dest, src, blockCount);
+	}
+
+	void engine::decodeBC1Block(uint8_t* dest, const uint8_t* src, uint32_t pixelStride)
+	{
+		const uint16_t c0 = uint16_t(src[0] | (src[1] << 8));
+		const uint16_t c1 = uint16_t(src[2] | (src[3] << 8));
+
+		auto expand = [](uint16_t c, uint32_t* rgb)
+		{
+			const uint32_t r = (c >> 11) & 31;
+			const uint32_t g = (c >>  5) & 63;
+			const uint32_t b = (c >>  0) & 31;
+
+			rgb[0] = (r << 3) | (r >> 2);
+			rgb[1] = (g << 2) | (g >> 4);
+			rgb[2] = (b << 3) | (b >> 2);
+		};
+
+		uint32_t palette[4][4];
+		expand(c0, palette[0]);
+		expand(c1, palette[1]);
+		palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			if (c0 > c1)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+			else
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+				palette[3][c] = 0;
+			}
+		}
+
+		if (c0 <= c1)
+		{
+			palette[3][3] = 0;
+		}
+
+		const uint32_t bits = src[4] | (src[5] << 8) | (src[6] << 16) | (uint32_t(src[7]) << 24);
+		for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+		{
+			const uint32_t code = (bits >> (p * 2)) & 3;
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				dest[p * pixelStride + c] = uint8_t(palette[code][c]);
+			}
+		}
+	}
+
+	void engine::decodeBC4Block(uint8_t* dest, const uint8_t* src, uint32_t pixelStride)
+	{
+		const uint32_t a0 = src[0];
+		const uint32_t a1 = src[1];
+
+		uint32_t palette[8] = { a0, a1 };
+		if (a0 > a1)
+		{
+			for (uint32_t k = 2; k < 8; k++)
+			{
+				palette[k] = ((8 - k) * a0 + (k - 1) * a1 + 3) / 7;
+			}
+		}
+		else
+		{
+			for (uint32_t k = 2; k < 6; k++)
+			{
+				palette[k] = ((6 - k) * a0 + (k - 1) * a1 + 2) / 5;
+			}
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+
+		uint64_t bits = 0;
+		for (uint32_t i = 0; i < 6; i++)
+		{
+			bits |= uint64_t(src[2 + i]) << (i * 8);
+		}
+
+		for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+		{
+			dest[p * pixelStride] = uint8_t(palette[(bits >> (p * 3)) & 7]);
+		}
+	}
+
+	void engine::benchmarkBCEncode(const std::filesystem::path& imageFolder)
+	{
+		// Images store as blocks, crop to block aligned size.
+		struct BenchmarkImage
+		{
+			std::vector<uint8_t> blocksRGBA;
+			std::vector<uint8_t> blocksR;
+			std::vector<uint8_t> blocksRG;
+			size_t blockCount = 0;
+		};
+
+		std::vector<std::filesystem::path> imagePaths;
+		for (const auto& entry : std::filesystem::directory_iterator(imageFolder))
+		{
+			auto extension = entry.path().extension().string();
+			std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+			if (extension == ".png" || extension == ".jpg" || extension == ".jpeg" || extension == ".tga" || extension == ".bmp")
+			{
+				imagePaths.push_back(entry.path());
+			}
+		}
+
+		// Fixed order so result comparable between runs.
+		std::sort(imagePaths.begin(), imagePaths.end());
+
+		std::vector<BenchmarkImage> images;
+		size_t totalBlockCount = 0;
+		for (const auto& path : imagePaths)
+		{
+			int width, height, channels;
+			stbi_uc* pixels = stbi_load(path.string().c_str(), &width, &height, &channels, 4);
+			if (!pixels)
+			{
+				LOG_WARN("Benchmark image {} load fail, skip.", utf8::utf16to8(path.u16string()));
+				continue;
+			}
+
+			const uint32_t blockCountX = uint32_t(width) / 4;
+			const uint32_t blockCountY = uint32_t(height) / 4;
+
+			BenchmarkImage image { };
+			image.blockCount = size_t(blockCountX) * blockCountY;
+			image.blocksRGBA.resize(image.blockCount * kBCBlockPixelCount * 4);
+			image.blocksR.resize(image.blockCount * kBCBlockPixelCount * 1);
+			image.blocksRG.resize(image.blockCount * kBCBlockPixelCount * 2);
+
+			for (uint32_t by = 0; by < blockCountY; by++)
+			{
+				for (uint32_t bx = 0; bx < blockCountX; bx++)
+				{
+					const size_t block = size_t(by) * blockCountX + bx;
+					for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+					{
+						const size_t pixel = (size_t(by * 4 + p / 4) * width + bx * 4 + p % 4) * 4;
+						const size_t dest = block * kBCBlockPixelCount + p;
+
+						memcpy(&image.blocksRGBA[dest * 4], &pixels[pixel], 4);
+						image.blocksR[dest] = pixels[pixel + 0];
+						image.blocksRG[dest * 2 + 0] = pixels[pixel + 0];
+						image.blocksRG[dest * 2 + 1] = pixels[pixel + 1];
+					}
+				}
+			}
+			stbi_image_free(pixels);
+
+			if (image.blockCount > 0)
+			{
+				totalBlockCount += image.blockCount;
+				images.push_back(std::move(image));
+			}
+		}
+
+		if (images.empty())
+		{
+			LOG_WARN("No image found in {}, skip block compression benchmark.", utf8::utf16to8(imageFolder.u16string()));
+			return;
+		}
+
+		struct BenchmarkFormat
+		{
+			const char* name;
+			uint32_t pixelStride;
+			uint32_t blockSize;
+
+			// Channels count into PSNR.
+			uint32_t compareChannelCount;
+
+			std::function<const std::vector<uint8_t>&(const BenchmarkImage&)> getSource;
+			std::function<void(uint8_t*, const uint8_t*)> stbEncode;
+			std::function<void(uint8_t*, const uint8_t*, size_t, EBCEncoderSimd)> encode;
+			std::function<void(uint8_t*, const uint8_t*)> decode;
+		};
+
+		const std::vector<BenchmarkFormat> formats =
+		{
+			{
+				"BC1", 4, 8, 3,
+				[](const BenchmarkImage& image) -> const std::vector<uint8_t>& { return image.blocksRGBA; },
+				[](uint8_t* dest, const uint8_t* src) { stb_compress_dxt_block(dest, src, 0, STB_DXT_HIGHQUAL); },
+				[](uint8_t* dest, const uint8_t* src, size_t count, EBCEncoderSimd simd) { encodeBC1Blocks(dest, src, count, simd); },
+				[](uint8_t* dest, const uint8_t* src) { decodeBC1Block(dest, src, 4); },
+			},
+			{
+				"BC3", 4, 16, 4,
+				[](const BenchmarkImage& image) -> const std::vector<uint8_t>& { return image.blocksRGBA; },
+				[](uint8_t* dest, const uint8_t* src) { stb_compress_dxt_block(dest, src, 1, STB_DXT_HIGHQUAL); },
+				[](uint8_t* dest, const uint8_t* src, size_t count, EBCEncoderSimd simd) { encodeBC3Blocks(dest, src, count, simd); },
+				[](uint8_t* dest, const uint8_t* src) { decodeBC1Block(dest, src + 8, 4); decodeBC4Block(dest + 3, src, 4); },
+			},
+			{
+				"BC4", 1, 8, 1,
+				[](const BenchmarkImage& image) -> const std::vector<uint8_t>& { return image.blocksR; },
+				[](uint8_t* dest, const uint8_t* src) { stb_compress_bc4_block(dest, src); },
+				[](uint8_t* dest, const uint8_t* src, size_t count, EBCEncoderSimd simd) { encodeBC4Blocks(dest, src, count, simd); },
+				[](uint8_t* dest, const uint8_t* src) { decodeBC4Block(dest, src, 1); },
+			},
+			{
+				"BC5", 2, 16, 2,
+				[](const BenchmarkImage& image) -> const std::vector<uint8_t>& { return image.blocksRG; },
+				[](uint8_t* dest, const uint8_t* src) { stb_compress_bc5_block(dest, src); },
+				[](uint8_t* dest, const uint8_t* src, size_t count, EBCEncoderSimd simd) { encodeBC5Blocks(dest, src, count, simd); },
+				[](uint8_t* dest, const uint8_t* src) { decodeBC4Block(dest, src, 2); decodeBC4Block(dest + 1, src + 8, 2); },
+			},
+		};
+
+		const double megaPixels = double(totalBlockCount * kBCBlockPixelCount) / 1000000.0;
+		LOG_INFO("Block compression benchmark: {} images, {:.2f} MPix, single thread.", images.size(), megaPixels);
+
+		for (const auto& format : formats)
+		{
+			// Run stb_dxt as baseline, then each supported instruction set.
+			for (int32_t encoder = -1; encoder < int32_t(EBCEncoderSimd::Max); encoder++)
+			{
+				const EBCEncoderSimd simd = EBCEncoderSimd(std::max(encoder, 0));
+				if (encoder >= 0 && !isBCEncoderSimdSupported(simd))
+				{
+					continue;
+				}
+
+				double milliseconds = 0.0;
+				double squareError = 0.0;
+				size_t sampleCount = 0;
+
+				std::vector<uint8_t> compressed;
+				std::vector<uint8_t> decoded(kBCBlockPixelCount * 4);
+				for (const auto& image : images)
+				{
+					const auto& source = format.getSource(image);
+					compressed.resize(image.blockCount * format.blockSize);
+
+					const auto startTime = std::chrono::high_resolution_clock::now();
+					if (encoder < 0)
+					{
+						for (size_t i = 0; i < image.blockCount; i++)
+						{
+							format.stbEncode(&compressed[i * format.blockSize], &source[i * kBCBlockPixelCount * format.pixelStride]);
+						}
+					}
+					else
+					{
+						format.encode(compressed.data(), source.data(), image.blockCount, simd);
+					}
+					milliseconds += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+
+					for (size_t i = 0; i < image.blockCount; i++)
+					{
+						format.decode(decoded.data(), &compressed[i * format.blockSize]);
+
+						const uint8_t* src = &source[i * kBCBlockPixelCount * format.pixelStride];
+						for (uint32_t p = 0; p < kBCBlockPixelCount; p++)
+						{
+							// Decoded BC1 and BC3 is RGBA, other format same layout as source.
+							const uint32_t decodeStride = format.pixelStride;
+							for (uint32_t c = 0; c < format.compareChannelCount; c++)
+							{
+								const double diff = double(decoded[p * decodeStride + c]) - double(src[p * format.pixelStride + c]);
+								squareError += diff * diff;
+							}
+						}
+						sampleCount += kBCBlockPixelCount * format.compareChannelCount;
+					}
+				}
+
+				const double mse = squareError / double(std::max<size_t>(sampleCount, 1));
+				const double psnr = mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+
+				LOG_INFO("  {} {:>8}: {:8.2f} MPix/s, PSNR {:.2f} dB.",
+					format.name,
+					encoder < 0 ? "stb_dxt" : nameof::nameof_enum(simd),
+					megaPixels / (milliseconds / 1000.0),
+					psnr);
+			}
+		}
+	}
+}
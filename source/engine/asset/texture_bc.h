@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+#include "texture_helper.h"
+
+// Block compression encoders of BC1/BC3/BC4/BC5/BC6H/BC7.
+// Encoder process a batch of 4x4 blocks per call, each simd lane encode one block, source pixels store block by block,
+// 16 pixels per block in row order.
+
+namespace engine
+{
+	// Encoder instruction set, selected by cpu support and asset.import.bcEncoderSimd.
+	enum class EBCEncoderSimd
+	{
+		Scalar,
+		SSE41,
+		AVX2,
+
+		Max,
+	};
+
+	// Best instruction set support by cpu and allowed by cvar.
+	extern EBCEncoderSimd getBCEncoderSimd();
+
+	// Whether encoder of this instruction set build and support by cpu, ignore cvar.
+	extern bool isBCEncoderSimdSupported(EBCEncoderSimd simd);
+
+	// Color endpoints fit by principal axis of block colors, then refine by least squares of selected indices.
+	// Source is 16 RGBA8 pixels per block and alpha ignored, dest is 8 bytes per block, always four color mode.
+	extern void encodeBC1Blocks(uint8_t* dest, const uint8_t* src, size_t blockCount, EBCEncoderSimd simd = getBCEncoderSimd());
+
+	// Source is 16 RGBA8 pixels per block, dest is 16 bytes per block.
+	extern void encodeBC3Blocks(uint8_t* dest, const uint8_t* src, size_t blockCount, EBCEncoderSimd simd = getBCEncoderSimd());
+
+	// Source is 16 R8 pixels per block, dest is 8 bytes per block.
+	extern void encodeBC4Blocks(uint8_t* dest, const uint8_t* src, size_t blockCount, EBCEncoderSimd simd = getBCEncoderSimd());
+
+	// Source is 16 RG8 pixels per block, dest is 16 bytes per block.
+	extern void encodeBC5Blocks(uint8_t* dest, const uint8_t* src, size_t blockCount, EBCEncoderSimd simd = getBCEncoderSimd());
+
+	// BC7 use mode 6 for all blocks, mode 1 with two subsets for opaque blocks when quality not fast.
+	// Source is 16 RGBA8 pixels per block, dest is 16 bytes per block.
+	extern void encodeBC7Blocks(uint8_t* dest, const uint8_t* src, size_t blockCount, EBC7Quality quality);
+
+	// BC6H unsigned float use one region mode 11 and mode 12, endpoints fit in half float bits space.
+	// Source is 16 RGBA32F pixels per block and alpha ignored, negative value clamp to zero, dest is 16 bytes per block.
+	extern void encodeBC6HBlocks(uint8_t* dest, const float* src, size_t blockCount);
+
+	// Decode one block to 16 pixels, pixel stride in bytes, used for quality compare.
+	extern void decodeBC1Block(uint8_t* dest, const uint8_t* src, uint32_t pixelStride);
+	extern void decodeBC4Block(uint8_t* dest, const uint8_t* src, uint32_t pixelStride);
+
+	// Encode all images in folder by stb_dxt and every supported instruction set on one thread,
+	// log MPix/s and PSNR of each format.
+	extern void benchmarkBCEncode(const std::filesystem::path& imageFolder);
+}
@@ -0,0 +1,375 @@
+#include "texture_bc.h"
+#include "../engine.h"
+
+namespace engine
+{
+	constexpr uint32_t kBC6HPixelCount = 16;
+
+	// Max finite half float bits.
+	constexpr float kBC6HMaxHalfBits = float(0x7BFF);
+
+	// Least squares refine iteration count of endpoints.
+	constexpr uint32_t kBC6HRefineCount = 2;
+
+	static const int32_t kBC6HWeights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// One region modes, endpoint 1 store as signed delta of endpoint 0 when delta bits not zero.
+	struct BC6HModeDesc
+	{
+		uint32_t modeValue;
+		uint32_t endpointBits;
+		uint32_t deltaBits;
+	};
+
+	static const BC6HModeDesc kBC6HMode11 = { 0x03, 10, 0 };
+	static const BC6HModeDesc kBC6HMode12 = { 0x07, 11, 9 };
+
+	struct BC6HFit
+	{
+		int32_t q[2][3] = { };
+		uint8_t indices[kBC6HPixelCount] = { };
+		float error = std::numeric_limits<float>::max();
+	};
+
+	// Write bits from lsb, dest must clear before.
+	struct BC6HBitWriter
+	{
+		uint8_t* dest;
+		uint32_t position = 0;
+
+		void write(uint32_t value, uint32_t bitCount)
+		{
+			for (uint32_t i = 0; i < bitCount; i++, position++)
+			{
+				dest[position >> 3] |= uint8_t(((value >> i) & 1) << (position & 7));
+			}
+		}
+	};
+
+	static inline int32_t unquantizeBC6H(int32_t q, uint32_t bits)
+	{
+		if (q == 0)
+		{
+			return 0;
+		}
+		if (q == (1 << bits) - 1)
+		{
+			return 0xFFFF;
+		}
+		return ((q << 16) + 0x8000) >> bits;
+	}
+
+	// Unquantized or interpolated value to half float bits.
+	static inline int32_t finishBC6H(int32_t value)
+	{
+		return (value * 31) >> 6;
+	}
+
+	// Endpoint quantize in half float bits space, select nearest one around the estimate.
+	static int32_t quantizeBC6H(float halfBits, uint32_t bits)
+	{
+		const int32_t maxValue = (1 << bits) - 1;
+		const float target = math::clamp(halfBits, 0.0f, kBC6HMaxHalfBits);
+		const float unquantized = target * 64.0f / 31.0f;
+
+		const int32_t estimate = int32_t(math::round((unquantized - float(1 << (15 - bits))) / float(1 << (16 - bits))));
+
+		int32_t best = 0;
+		float bestError = std::numeric_limits<float>::max();
+		for (int32_t q = math::max(estimate - 1, 0); q <= math::min(estimate + 1, maxValue); q++)
+		{
+			const float error = math::abs(float(finishBC6H(unquantizeBC6H(q, bits))) - target);
+			if (error < bestError)
+			{
+				bestError = error;
+				best = q;
+			}
+		}
+		return best;
+	}
+
+	static void quantizeBC6HEndpoints(const BC6HModeDesc& desc, const float endpoints[2][3], BC6HFit& outFit)
+	{
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			outFit.q[0][c] = quantizeBC6H(endpoints[0][c], desc.endpointBits);
+			outFit.q[1][c] = quantizeBC6H(endpoints[1][c], desc.endpointBits);
+
+			// Keep delta in range of both order, anchor fix may swap endpoints.
+			if (desc.deltaBits > 0)
+			{
+				const int32_t maxDelta = (1 << (desc.deltaBits - 1)) - 1;
+				outFit.q[1][c] = outFit.q[0][c] + math::clamp(outFit.q[1][c] - outFit.q[0][c], -maxDelta, maxDelta);
+			}
+		}
+	}
+
+	static void assignBC6HIndices(const BC6HModeDesc& desc, const float pixels[kBC6HPixelCount][3], BC6HFit& inOutFit)
+	{
+		int32_t endpoints[2][3];
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			endpoints[0][c] = unquantizeBC6H(inOutFit.q[0][c], desc.endpointBits);
+			endpoints[1][c] = unquantizeBC6H(inOutFit.q[1][c], desc.endpointBits);
+		}
+
+		float palette[16][3];
+		for (uint32_t j = 0; j < 16; j++)
+		{
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				palette[j][c] = float(finishBC6H(((64 - kBC6HWeights4[j]) * endpoints[0][c] + kBC6HWeights4[j] * endpoints[1][c] + 32) >> 6));
+			}
+		}
+
+		inOutFit.error = 0.0f;
+		for (uint32_t i = 0; i < kBC6HPixelCount; i++)
+		{
+			float bestError = std::numeric_limits<float>::max();
+			uint32_t bestIndex = 0;
+			for (uint32_t j = 0; j < 16; j++)
+			{
+				const float dr = palette[j][0] - pixels[i][0];
+				const float dg = palette[j][1] - pixels[i][1];
+				const float db = palette[j][2] - pixels[i][2];
+				const float distance = dr * dr + dg * dg + db * db;
+				if (distance < bestError)
+				{
+					bestError = distance;
+					bestIndex = j;
+				}
+			}
+
+			inOutFit.indices[i] = uint8_t(bestIndex);
+			inOutFit.error += bestError;
+		}
+	}
+
+	// Pixels are half float bits, fit line by principal axis then refine by least squares.
+	static void fitBC6H(const BC6HModeDesc& desc, const float pixels[kBC6HPixelCount][3], BC6HFit& outFit)
+	{
+		float mean[3] = { };
+		for (uint32_t i = 0; i < kBC6HPixelCount; i++)
+		{
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				mean[c] += pixels[i][c];
+			}
+		}
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			mean[c] /= float(kBC6HPixelCount);
+		}
+
+		float cov[3][3] = { };
+		for (uint32_t i = 0; i < kBC6HPixelCount; i++)
+		{
+			const float d[3] = { pixels[i][0] - mean[0], pixels[i][1] - mean[1], pixels[i][2] - mean[2] };
+			for (uint32_t r = 0; r < 3; r++)
+			{
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					cov[r][c] += d[r] * d[c];
+				}
+			}
+		}
+
+		float axis[3] =
+		{
+			cov[0][0] + cov[0][1] + cov[0][2],
+			cov[1][0] + cov[1][1] + cov[1][2],
+			cov[2][0] + cov[2][1] + cov[2][2],
+		};
+		for (uint32_t iteration = 0; iteration < 8; iteration++)
+		{
+			float next[3] = { };
+			for (uint32_t r = 0; r < 3; r++)
+			{
+				next[r] = cov[r][0] * axis[0] + cov[r][1] * axis[1] + cov[r][2] * axis[2];
+			}
+
+			const float length2 = next[0] * next[0] + next[1] * next[1] + next[2] * next[2];
+			if (length2 < 1e-12f)
+			{
+				break;
+			}
+
+			const float invLength = 1.0f / std::sqrt(length2);
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				axis[c] = next[c] * invLength;
+			}
+		}
+
+		const float axisLength2 = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+		if (axisLength2 < 1e-12f)
+		{
+			// Flat block.
+			axis[0] = axis[1] = axis[2] = 0.57735027f;
+		}
+		else
+		{
+			const float invLength = 1.0f / std::sqrt(axisLength2);
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				axis[c] *= invLength;
+			}
+		}
+
+		float minT = std::numeric_limits<float>::max();
+		float maxT = std::numeric_limits<float>::lowest();
+		for (uint32_t i = 0; i < kBC6HPixelCount; i++)
+		{
+			const float t =
+				(pixels[i][0] - mean[0]) * axis[0] +
+				(pixels[i][1] - mean[1]) * axis[1] +
+				(pixels[i][2] - mean[2]) * axis[2];
+
+			minT = math::min(minT, t);
+			maxT = math::max(maxT, t);
+		}
+
+		float endpoints[2][3];
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			endpoints[0][c] = mean[c] + axis[c] * minT;
+			endpoints[1][c] = mean[c] + axis[c] * maxT;
+		}
+
+		quantizeBC6HEndpoints(desc, endpoints, outFit);
+		assignBC6HIndices(desc, pixels, outFit);
+
+		for (uint32_t iteration = 0; iteration < kBC6HRefineCount; iteration++)
+		{
+			float alpha2 = 0.0f, beta2 = 0.0f, alphaBeta = 0.0f;
+			float alphaX[3] = { }, betaX[3] = { };
+			for (uint32_t i = 0; i < kBC6HPixelCount; i++)
+			{
+				const float beta = float(kBC6HWeights4[outFit.indices[i]]) / 64.0f;
+				const float alpha = 1.0f - beta;
+
+				alpha2 += alpha * alpha;
+				beta2 += beta * beta;
+				alphaBeta += alpha * beta;
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					alphaX[c] += alpha * pixels[i][c];
+					betaX[c] += beta * pixels[i][c];
+				}
+			}
+
+			const float det = alpha2 * beta2 - alphaBeta * alphaBeta;
+			if (det < 1e-4f)
+			{
+				break;
+			}
+
+			const float invDet = 1.0f / det;
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				endpoints[0][c] = (alphaX[c] * beta2 - betaX[c] * alphaBeta) * invDet;
+				endpoints[1][c] = (betaX[c] * alpha2 - alphaX[c] * alphaBeta) * invDet;
+			}
+
+			BC6HFit refineFit { };
+			quantizeBC6HEndpoints(desc, endpoints, refineFit);
+			assignBC6HIndices(desc, pixels, refineFit);
+
+			if (refineFit.error >= outFit.error)
+			{
+				break;
+			}
+			outFit = refineFit;
+		}
+	}
+
+	static void packBC6H(uint8_t* dest, const BC6HModeDesc& desc, BC6HFit fit)
+	{
+		// Anchor index msb must be zero.
+		if (fit.indices[0] >= 8)
+		{
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				std::swap(fit.q[0][c], fit.q[1][c]);
+			}
+			for (uint32_t i = 0; i < kBC6HPixelCount; i++)
+			{
+				fit.indices[i] = uint8_t(15 - fit.indices[i]);
+			}
+		}
+
+		memset(dest, 0, 16);
+		BC6HBitWriter writer { dest };
+
+		writer.write(desc.modeValue, 5);
+		if (desc.deltaBits == 0)
+		{
+			// Mode 11: rw, gw, bw, rx, gx, bx.
+			for (uint32_t e = 0; e < 2; e++)
+			{
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					writer.write(uint32_t(fit.q[e][c]), desc.endpointBits);
+				}
+			}
+		}
+		else
+		{
+			// Mode 12: rw[9:0], gw[9:0], bw[9:0], rx[8:0], rw[10], gx[8:0], gw[10], bx[8:0], bw[10].
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				writer.write(uint32_t(fit.q[0][c]) & 0x3FF, 10);
+			}
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				writer.write(uint32_t(fit.q[1][c] - fit.q[0][c]) & ((1U << desc.deltaBits) - 1), desc.deltaBits);
+				writer.write(uint32_t(fit.q[0][c]) >> 10, 1);
+			}
+		}
+
+		for (uint32_t i = 0; i < kBC6HPixelCount; i++)
+		{
+			writer.write(fit.indices[i], i == 0 ? 3 : 4);
+		}
+		CHECK(writer.position == 128);
+	}
+
+	static inline float floatToHalfBits(float value)
+	{
+		// Unsigned format, negative and nan clamp to zero.
+		const float clampValue = (value > 0.0f) ? math::min(value, 65504.0f) : 0.0f;
+		return float(math::packHalf2x16(math::vec2(clampValue, 0.0f)) & 0xFFFF);
+	}
+
+	void engine::encodeBC6HBlocks(uint8_t* dest, const float* src, size_t blockCount)
+	{
+		for (size_t block = 0; block < blockCount; block++)
+		{
+			const float* blockSrc = src + block * kBC6HPixelCount * 4;
+
+			float pixels[kBC6HPixelCount][3];
+			for (uint32_t i = 0; i < kBC6HPixelCount; i++)
+			{
+				for (uint32_t c = 0; c < 3; c++)
+				{
+					pixels[i][c] = floatToHalfBits(blockSrc[i * 4 + c]);
+				}
+			}
+
+			// Mode 12 has more precision when endpoints are close, mode 11 cover any range.
+			BC6HFit mode11Fit { };
+			BC6HFit mode12Fit { };
+			fitBC6H(kBC6HMode11, pixels, mode11Fit);
+			fitBC6H(kBC6HMode12, pixels, mode12Fit);
+
+			if (mode12Fit.error < mode11Fit.error)
+			{
+				packBC6H(dest + block * 16, kBC6HMode12, mode12Fit);
+			}
+			else
+			{
+				packBC6H(dest + block * 16, kBC6HMode11, mode11Fit);
+			}
+		}
+	}
+}
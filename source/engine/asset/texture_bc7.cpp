@@ -0,0 +1,671 @@
+#include "texture_bc.h"
+#include "../engine.h"
+
+namespace engine
+{
+	constexpr uint32_t kBC7PixelCount = 16;
+
+	// Two subsets partition table, bit i is subset of pixel i.
+	static const uint16_t kBC7Partitions2[64] =
+	{
+		0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+		0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+		0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+		0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+		0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+		0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+		0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+		0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+	};
+
+	// Anchor pixel of second subset, its index store without msb.
+	static const uint8_t kBC7AnchorSecond[64] =
+	{
+		15, 15, 15, 15, 15, 15, 15, 15,
+		15, 15, 15, 15, 15, 15, 15, 15,
+		15,  2,  8,  2,  2,  8,  8, 15,
+		 2,  8,  2,  2,  8,  8,  2,  2,
+		15, 15,  6,  8,  2,  8, 15, 15,
+		 2,  8,  2,  2,  2, 15, 15,  6,
+		 6,  2,  6,  8, 15, 15,  2,  2,
+		15, 15, 15, 15, 15,  2,  2, 15,
+	};
+
+	static const uint32_t kBC7Weights3[8]  = { 0, 9, 18, 27, 37, 46, 55, 64 };
+	static const uint32_t kBC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// Best estimated partitions count which do full fit when quality is normal.
+	constexpr uint32_t kBC7NormalPartitionCount = 8;
+
+	// Endpoint layout of one mode.
+	struct BC7ModeDesc
+	{
+		uint32_t channelCount; // Mode 1 is RGB, mode 6 is RGBA.
+		uint32_t colorBits;    // Endpoint bits without pbit.
+		bool bSharedPBit;      // Two endpoints of subset share one pbit.
+		uint32_t indexBits;
+	};
+
+	static const BC7ModeDesc kBC7Mode1 = { 3, 6, true,  3 };
+	static const BC7ModeDesc kBC7Mode6 = { 4, 7, false, 4 };
+
+	struct BC7SubsetFit
+	{
+		uint32_t q[2][4] = { };
+		uint32_t p[2] = { };
+
+		// Only pixels in subset valid.
+		uint8_t indices[kBC7PixelCount] = { };
+		float error = std::numeric_limits<float>::max();
+	};
+
+	struct BC7Subset
+	{
+		uint8_t pixels[kBC7PixelCount];
+		uint32_t pixelCount = 0;
+	};
+
+	// Write bits from lsb, dest must clear before.
+	struct BC7BitWriter
+	{
+		uint8_t* dest;
+		uint32_t position = 0;
+
+		void write(uint32_t value, uint32_t bitCount)
+		{
+			for (uint32_t i = 0; i < bitCount; i++, position++)
+			{
+				dest[position >> 3] |= uint8_t(((value >> i) & 1) << (position & 7));
+			}
+		}
+	};
+
+	static inline uint32_t expandBC7(uint32_t value, uint32_t bits)
+	{
+		return (value << (8 - bits)) | (value >> (2 * bits - 8));
+	}
+
+	static inline const uint32_t* getBC7Weights(const BC7ModeDesc& desc)
+	{
+		return desc.indexBits == 3 ? kBC7Weights3 : kBC7Weights4;
+	}
+
+	static void unquantizeBC7Endpoints(const BC7ModeDesc& desc, const BC7SubsetFit& fit, uint32_t outEndpoints[2][4])
+	{
+		for (uint32_t e = 0; e < 2; e++)
+		{
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				outEndpoints[e][c] = (c < desc.channelCount) ? expandBC7((fit.q[e][c] << 1) | fit.p[e], desc.colorBits + 1) : 255;
+			}
+		}
+	}
+
+	// Quantize float endpoints with best pbit.
+	static void quantizeBC7Endpoints(const BC7ModeDesc& desc, const float endpoints[2][4], BC7SubsetFit& outFit)
+	{
+		const uint32_t maxValue = (1U << desc.colorBits) - 1;
+		const float scale = float((1U << (desc.colorBits + 1)) - 1) / 255.0f;
+
+		float errors[2][2];
+		uint32_t q[2][2][4];
+		for (uint32_t e = 0; e < 2; e++)
+		{
+			for (uint32_t p = 0; p < 2; p++)
+			{
+				errors[e][p] = 0.0f;
+				for (uint32_t c = 0; c < desc.channelCount; c++)
+				{
+					const float target = math::clamp(endpoints[e][c], 0.0f, 255.0f);
+					const float value = math::round((target * scale - float(p)) * 0.5f);
+
+					q[e][p][c] = uint32_t(math::clamp(value, 0.0f, float(maxValue)));
+
+					const float diff = float(expandBC7((q[e][p][c] << 1) | p, desc.colorBits + 1)) - target;
+					errors[e][p] += diff * diff;
+				}
+			}
+		}
+
+		uint32_t pbits[2];
+		if (desc.bSharedPBit)
+		{
+			pbits[0] = pbits[1] = (errors[0][1] + errors[1][1] < errors[0][0] + errors[1][0]) ? 1 : 0;
+		}
+		else
+		{
+			pbits[0] = errors[0][1] < errors[0][0] ? 1 : 0;
+			pbits[1] = errors[1][1] < errors[1][0] ? 1 : 0;
+		}
+
+		for (uint32_t e = 0; e < 2; e++)
+		{
+			outFit.p[e] = pbits[e];
+			for (uint32_t c = 0; c < desc.channelCount; c++)
+			{
+				outFit.q[e][c] = q[e][pbits[e]][c];
+			}
+		}
+	}
+
+	// Select nearest palette entry for each subset pixel.
+	static void assignBC7Indices(const BC7ModeDesc& desc, const uint8_t* block, const BC7Subset& subset, BC7SubsetFit& inOutFit)
+	{
+		uint32_t endpoints[2][4];
+		unquantizeBC7Endpoints(desc, inOutFit, endpoints);
+
+		const uint32_t* weights = getBC7Weights(desc);
+		const uint32_t paletteCount = 1U << desc.indexBits;
+
+		int32_t palette[16][4];
+		for (uint32_t j = 0; j < paletteCount; j++)
+		{
+			for (uint32_t c = 0; c < desc.channelCount; c++)
+			{
+				palette[j][c] = int32_t(((64 - weights[j]) * endpoints[0][c] + weights[j] * endpoints[1][c] + 32) >> 6);
+			}
+		}
+
+		uint32_t error = 0;
+		for (uint32_t i = 0; i < subset.pixelCount; i++)
+		{
+			const uint8_t* pixel = &block[subset.pixels[i] * 4];
+
+			uint32_t bestError = ~0U;
+			uint32_t bestIndex = 0;
+			for (uint32_t j = 0; j < paletteCount; j++)
+			{
+				uint32_t distance = 0;
+				for (uint32_t c = 0; c < desc.channelCount; c++)
+				{
+					const int32_t diff = palette[j][c] - int32_t(pixel[c]);
+					distance += uint32_t(diff * diff);
+				}
+
+				if (distance < bestError)
+				{
+					bestError = distance;
+					bestIndex = j;
+				}
+			}
+
+			inOutFit.indices[subset.pixels[i]] = uint8_t(bestIndex);
+			error += bestError;
+		}
+
+		// Mode 1 no alpha, decode alpha is 255.
+		if (desc.channelCount == 3)
+		{
+			for (uint32_t i = 0; i < subset.pixelCount; i++)
+			{
+				const int32_t diff = 255 - int32_t(block[subset.pixels[i] * 4 + 3]);
+				error += uint32_t(diff * diff);
+			}
+		}
+
+		inOutFit.error = float(error);
+	}
+
+	// Principal axis of subset pixels by power iteration.
+	static void computeBC7PrincipalAxis(
+		const BC7ModeDesc& desc,
+		const uint8_t* block,
+		const BC7Subset& subset,
+		float outMean[4],
+		float outAxis[4])
+	{
+		const uint32_t channelCount = desc.channelCount;
+
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			outMean[c] = 0.0f;
+			outAxis[c] = 0.0f;
+		}
+
+		for (uint32_t i = 0; i < subset.pixelCount; i++)
+		{
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				outMean[c] += float(block[subset.pixels[i] * 4 + c]);
+			}
+		}
+		for (uint32_t c = 0; c < channelCount; c++)
+		{
+			outMean[c] /= float(math::max(subset.pixelCount, 1U));
+		}
+
+		float cov[4][4] = { };
+		for (uint32_t i = 0; i < subset.pixelCount; i++)
+		{
+			float d[4];
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				d[c] = float(block[subset.pixels[i] * 4 + c]) - outMean[c];
+			}
+
+			for (uint32_t r = 0; r < channelCount; r++)
+			{
+				for (uint32_t c = 0; c < channelCount; c++)
+				{
+					cov[r][c] += d[r] * d[c];
+				}
+			}
+		}
+
+		// Start from covariance row sum, cover most case where channels correlate positive.
+		for (uint32_t r = 0; r < channelCount; r++)
+		{
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				outAxis[r] += cov[r][c];
+			}
+		}
+
+		for (uint32_t iteration = 0; iteration < 8; iteration++)
+		{
+			float next[4] = { };
+			for (uint32_t r = 0; r < channelCount; r++)
+			{
+				for (uint32_t c = 0; c < channelCount; c++)
+				{
+					next[r] += cov[r][c] * outAxis[c];
+				}
+			}
+
+			float length2 = 0.0f;
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				length2 += next[c] * next[c];
+			}
+
+			if (length2 < 1e-12f)
+			{
+				break;
+			}
+
+			const float invLength = 1.0f / std::sqrt(length2);
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				outAxis[c] = next[c] * invLength;
+			}
+		}
+
+		float length2 = 0.0f;
+		for (uint32_t c = 0; c < channelCount; c++)
+		{
+			length2 += outAxis[c] * outAxis[c];
+		}
+
+		if (length2 < 1e-12f)
+		{
+			// Flat subset, any axis works.
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				outAxis[c] = 1.0f / std::sqrt(float(channelCount));
+			}
+		}
+		else
+		{
+			const float invLength = 1.0f / std::sqrt(length2);
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				outAxis[c] *= invLength;
+			}
+		}
+	}
+
+	static void fitBC7Subset(
+		const BC7ModeDesc& desc,
+		const uint8_t* block,
+		const BC7Subset& subset,
+		uint32_t refineCount,
+		BC7SubsetFit& outFit)
+	{
+		const uint32_t channelCount = desc.channelCount;
+
+		float mean[4], axis[4];
+		computeBC7PrincipalAxis(desc, block, subset, mean, axis);
+
+		float minT = std::numeric_limits<float>::max();
+		float maxT = std::numeric_limits<float>::lowest();
+		for (uint32_t i = 0; i < subset.pixelCount; i++)
+		{
+			float t = 0.0f;
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				t += (float(block[subset.pixels[i] * 4 + c]) - mean[c]) * axis[c];
+			}
+
+			minT = math::min(minT, t);
+			maxT = math::max(maxT, t);
+		}
+
+		float endpoints[2][4] = { };
+		for (uint32_t c = 0; c < channelCount; c++)
+		{
+			endpoints[0][c] = mean[c] + axis[c] * minT;
+			endpoints[1][c] = mean[c] + axis[c] * maxT;
+		}
+
+		quantizeBC7Endpoints(desc, endpoints, outFit);
+		assignBC7Indices(desc, block, subset, outFit);
+
+		// Least squares endpoints of selected indices.
+		const uint32_t* weights = getBC7Weights(desc);
+		for (uint32_t iteration = 0; iteration < refineCount; iteration++)
+		{
+			float alpha2 = 0.0f, beta2 = 0.0f, alphaBeta = 0.0f;
+			float alphaX[4] = { }, betaX[4] = { };
+			for (uint32_t i = 0; i < subset.pixelCount; i++)
+			{
+				const uint32_t pixel = subset.pixels[i];
+				const float beta = float(weights[outFit.indices[pixel]]) / 64.0f;
+				const float alpha = 1.0f - beta;
+
+				alpha2 += alpha * alpha;
+				beta2 += beta * beta;
+				alphaBeta += alpha * beta;
+				for (uint32_t c = 0; c < channelCount; c++)
+				{
+					alphaX[c] += alpha * float(block[pixel * 4 + c]);
+					betaX[c] += beta * float(block[pixel * 4 + c]);
+				}
+			}
+
+			const float det = alpha2 * beta2 - alphaBeta * alphaBeta;
+			if (det < 1e-4f)
+			{
+				break;
+			}
+
+			const float invDet = 1.0f / det;
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				endpoints[0][c] = (alphaX[c] * beta2 - betaX[c] * alphaBeta) * invDet;
+				endpoints[1][c] = (betaX[c] * alpha2 - alphaX[c] * alphaBeta) * invDet;
+			}
+
+			BC7SubsetFit refineFit { };
+			quantizeBC7Endpoints(desc, endpoints, refineFit);
+			assignBC7Indices(desc, block, subset, refineFit);
+
+			if (refineFit.error >= outFit.error)
+			{
+				break;
+			}
+			outFit = refineFit;
+		}
+	}
+
+	// Anchor index msb must be zero, otherwise swap endpoints and invert indices of subset.
+	static void fixBC7Anchor(const BC7ModeDesc& desc, const BC7Subset& subset, uint32_t anchor, BC7SubsetFit& inOutFit)
+	{
+		const uint32_t maxIndex = (1U << desc.indexBits) - 1;
+		if (inOutFit.indices[anchor] <= (maxIndex >> 1))
+		{
+			return;
+		}
+
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			std::swap(inOutFit.q[0][c], inOutFit.q[1][c]);
+		}
+		std::swap(inOutFit.p[0], inOutFit.p[1]);
+
+		for (uint32_t i = 0; i < subset.pixelCount; i++)
+		{
+			inOutFit.indices[subset.pixels[i]] = uint8_t(maxIndex - inOutFit.indices[subset.pixels[i]]);
+		}
+	}
+
+	static void buildBC7Subsets(uint32_t partition, BC7Subset outSubsets[2])
+	{
+		outSubsets[0].pixelCount = 0;
+		outSubsets[1].pixelCount = 0;
+		for (uint32_t i = 0; i < kBC7PixelCount; i++)
+		{
+			auto& subset = outSubsets[(kBC7Partitions2[partition] >> i) & 1];
+			subset.pixels[subset.pixelCount++] = uint8_t(i);
+		}
+	}
+
+	static void packBC7Mode6(uint8_t* dest, BC7SubsetFit fit)
+	{
+		BC7Subset subset { };
+		for (uint32_t i = 0; i < kBC7PixelCount; i++)
+		{
+			subset.pixels[subset.pixelCount++] = uint8_t(i);
+		}
+		fixBC7Anchor(kBC7Mode6, subset, 0, fit);
+
+		memset(dest, 0, 16);
+		BC7BitWriter writer { dest };
+
+		writer.write(1U << 6, 7);
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			writer.write(fit.q[0][c], 7);
+			writer.write(fit.q[1][c], 7);
+		}
+		writer.write(fit.p[0], 1);
+		writer.write(fit.p[1], 1);
+
+		for (uint32_t i = 0; i < kBC7PixelCount; i++)
+		{
+			writer.write(fit.indices[i], i == 0 ? 3 : 4);
+		}
+		CHECK(writer.position == 128);
+	}
+
+	static void packBC7Mode1(uint8_t* dest, uint32_t partition, BC7SubsetFit fits[2])
+	{
+		BC7Subset subsets[2];
+		buildBC7Subsets(partition, subsets);
+
+		const uint32_t anchors[2] = { 0, kBC7AnchorSecond[partition] };
+		fixBC7Anchor(kBC7Mode1, subsets[0], anchors[0], fits[0]);
+		fixBC7Anchor(kBC7Mode1, subsets[1], anchors[1], fits[1]);
+
+		memset(dest, 0, 16);
+		BC7BitWriter writer { dest };
+
+		writer.write(1U << 1, 2);
+		writer.write(partition, 6);
+		for (uint32_t c = 0; c < 3; c++)
+		{
+			for (uint32_t s = 0; s < 2; s++)
+			{
+				writer.write(fits[s].q[0][c], 6);
+				writer.write(fits[s].q[1][c], 6);
+			}
+		}
+		writer.write(fits[0].p[0], 1);
+		writer.write(fits[1].p[0], 1);
+
+		for (uint32_t i = 0; i < kBC7PixelCount; i++)
+		{
+			const auto& fit = fits[(kBC7Partitions2[partition] >> i) & 1];
+			writer.write(fit.indices[i], (i == anchors[0] || i == anchors[1]) ? 2 : 3);
+		}
+		CHECK(writer.position == 128);
+	}
+
+	// Color sums of pixels, subset moments get by accumulate or subtract from block moments.
+	struct BC7Moments
+	{
+		float count = 0.0f;
+		float sum[3] = { };
+		float sum2[6] = { }; // rr, rg, rb, gg, gb, bb.
+
+		void add(const uint8_t* pixel)
+		{
+			const float r = float(pixel[0]);
+			const float g = float(pixel[1]);
+			const float b = float(pixel[2]);
+
+			count += 1.0f;
+			sum[0] += r; sum[1] += g; sum[2] += b;
+			sum2[0] += r * r; sum2[1] += r * g; sum2[2] += r * b;
+			sum2[3] += g * g; sum2[4] += g * b; sum2[5] += b * b;
+		}
+
+		BC7Moments operator-(const BC7Moments& o) const
+		{
+			BC7Moments result;
+			result.count = count - o.count;
+			for (uint32_t i = 0; i < 3; i++) { result.sum[i] = sum[i] - o.sum[i]; }
+			for (uint32_t i = 0; i < 6; i++) { result.sum2[i] = sum2[i] - o.sum2[i]; }
+			return result;
+		}
+
+		// Variance off principal axis, estimate of line fit error.
+		float getLineResidual() const
+		{
+			if (count < 2.0f)
+			{
+				return 0.0f;
+			}
+
+			const float invCount = 1.0f / count;
+			const float cov[6] =
+			{
+				sum2[0] - sum[0] * sum[0] * invCount,
+				sum2[1] - sum[0] * sum[1] * invCount,
+				sum2[2] - sum[0] * sum[2] * invCount,
+				sum2[3] - sum[1] * sum[1] * invCount,
+				sum2[4] - sum[1] * sum[2] * invCount,
+				sum2[5] - sum[2] * sum[2] * invCount,
+			};
+
+			float axis[3] = { cov[0] + cov[1] + cov[2], cov[1] + cov[3] + cov[4], cov[2] + cov[4] + cov[5] };
+			float eigenValue = 0.0f;
+			for (uint32_t iteration = 0; iteration < 4; iteration++)
+			{
+				const float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+				const float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+				const float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+
+				const float length2 = x * x + y * y + z * z;
+				if (length2 < 1e-12f)
+				{
+					break;
+				}
+
+				const float invLength = 1.0f / std::sqrt(length2);
+				eigenValue = (x * axis[0] + y * axis[1] + z * axis[2]) / math::max(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2], 1e-12f);
+				axis[0] = x * invLength;
+				axis[1] = y * invLength;
+				axis[2] = z * invLength;
+			}
+
+			return math::max(cov[0] + cov[3] + cov[5] - eigenValue, 0.0f);
+		}
+	};
+
+	static float fitBC7Mode1(const uint8_t* block, uint32_t partition, uint32_t refineCount, BC7SubsetFit outFits[2])
+	{
+		BC7Subset subsets[2];
+		buildBC7Subsets(partition, subsets);
+
+		fitBC7Subset(kBC7Mode1, block, subsets[0], refineCount, outFits[0]);
+		fitBC7Subset(kBC7Mode1, block, subsets[1], refineCount, outFits[1]);
+
+		return outFits[0].error + outFits[1].error;
+	}
+
+	static void encodeBC7Block(uint8_t* dest, const uint8_t* block, EBC7Quality quality)
+	{
+		const uint32_t refineCount = quality == EBC7Quality::Fast ? 1 : (quality == EBC7Quality::Normal ? 2 : 4);
+
+		BC7Subset allPixels { };
+		bool bOpaque = true;
+		for (uint32_t i = 0; i < kBC7PixelCount; i++)
+		{
+			allPixels.pixels[allPixels.pixelCount++] = uint8_t(i);
+			bOpaque &= (block[i * 4 + 3] == 255);
+		}
+
+		BC7SubsetFit mode6Fit { };
+		fitBC7Subset(kBC7Mode6, block, allPixels, refineCount, mode6Fit);
+
+		// Mode 1 only store rgb, and mode 6 already exact for flat block.
+		if (quality == EBC7Quality::Fast || !bOpaque || mode6Fit.error == 0.0f)
+		{
+			packBC7Mode6(dest, mode6Fit);
+			return;
+		}
+
+		// Partitions to fit, normal quality select by line fit residual of subsets.
+		std::array<uint32_t, 64> partitions;
+		uint32_t partitionCount = 0;
+		if (quality == EBC7Quality::Slow)
+		{
+			for (uint32_t i = 0; i < 64; i++)
+			{
+				partitions[partitionCount++] = i;
+			}
+		}
+		else
+		{
+			BC7Moments blockMoments;
+			for (uint32_t i = 0; i < kBC7PixelCount; i++)
+			{
+				blockMoments.add(&block[i * 4]);
+			}
+
+			std::array<std::pair<float, uint32_t>, 64> estimates;
+			for (uint32_t i = 0; i < 64; i++)
+			{
+				BC7Moments subsetMoments;
+				for (uint32_t j = 0; j < kBC7PixelCount; j++)
+				{
+					if ((kBC7Partitions2[i] >> j) & 1)
+					{
+						subsetMoments.add(&block[j * 4]);
+					}
+				}
+
+				estimates[i] = { subsetMoments.getLineResidual() + (blockMoments - subsetMoments).getLineResidual(), i };
+			}
+
+			std::partial_sort(estimates.begin(), estimates.begin() + kBC7NormalPartitionCount, estimates.end());
+			for (uint32_t i = 0; i < kBC7NormalPartitionCount; i++)
+			{
+				partitions[partitionCount++] = estimates[i].second;
+			}
+		}
+
+		float bestError = mode6Fit.error;
+		uint32_t bestPartition = ~0U;
+		BC7SubsetFit bestFits[2];
+		for (uint32_t i = 0; i < partitionCount; i++)
+		{
+			BC7SubsetFit fits[2];
+			const float error = fitBC7Mode1(block, partitions[i], refineCount, fits);
+			if (error < bestError)
+			{
+				bestError = error;
+				bestPartition = partitions[i];
+				bestFits[0] = fits[0];
+				bestFits[1] = fits[1];
+			}
+		}
+
+		if (bestPartition == ~0U)
+		{
+			packBC7Mode6(dest, mode6Fit);
+		}
+		else
+		{
+			packBC7Mode1(dest, bestPartition, bestFits);
+		}
+	}
+
+	void engine::encodeBC7Blocks(uint8_t* dest, const uint8_t* src, size_t blockCount, EBC7Quality quality)
+	{
+		for (size_t i = 0; i < blockCount; i++)
+		{
+			encodeBC7Block(dest + i * 16, src + i * kBC7PixelCount * 4, quality);
+		}
+	}
+}
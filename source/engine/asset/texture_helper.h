@@ -1,5 +1,7 @@
 #pragma once
 
+#include "texture_mipmap.h"
+
 namespace engine
 {
 	struct AssetTextureBin;
@@ -33,23 +35,29 @@ namespace engine
 		RGBA16Unorm,
 		R16Unorm,
 
+		// High quality RGBA, encode speed depend on EBC7Quality.
+		BC7,
+
+		// Unsigned HDR RGB, load from exr or 16 bit file.
+		BC6H,
+
 		Max,
 	};
 
-	extern void buildMipmapData8Bit(
-		uint32_t channelCount,
-		uint32_t pixelOffsetPerSample,
-		unsigned char* srcPixels,
-		AssetTextureBin& outBinData,
-		bool bSRGB,
-		uint32_t mipmapCount,
-		uint32_t inWidth,
-		uint32_t inHeight,
-		float alphaMipmapCutoff = 1.0f);
+	// BC7 encoder quality tier.
+	enum class EBC7Quality
+	{
+		Fast,   // Mode 6 only.
+		Normal, // Mode 6 and mode 1 with best estimated partitions.
+		Slow,   // Mode 6 and mode 1 with all partitions.
+
+		Max,
+	};
 
 	extern void mipmapCompressBC(
 		AssetTextureBin& inOutBin,
-		const AssetTexture& meta);
+		const AssetTexture& meta,
+		EBC7Quality bc7Quality = EBC7Quality::Normal);
 
 
 
@@ -0,0 +1,487 @@
+#include "texture_mipmap.h"
+#include "asset_texture.h"
+#include "../engine.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#include <emmintrin.h>
+	#define MIPMAP_SSE2 1
+#else
+	#define MIPMAP_SSE2 0
+#endif
+
+namespace engine
+{
+	// Linear value quantize count of srgb encode table.
+	static const uint32_t kSRGBEncodeTableSize = 1U << 13;
+
+	struct SRGBTables
+	{
+		float   decode[256];
+		float   linearDecode[256];
+		uint8_t encode[kSRGBEncodeTableSize];
+	};
+
+	static const SRGBTables& getSRGBTables()
+	{
+		static const SRGBTables tables = []()
+		{
+			SRGBTables result { };
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				const float srgb = float(i) / 255.0f;
+
+				result.decode[i] = srgb <= 0.04045f ? srgb / 12.92f : math::pow((srgb + 0.055f) / 1.055f, 2.4f);
+				result.linearDecode[i] = srgb;
+			}
+
+			for (uint32_t i = 0; i < kSRGBEncodeTableSize; i++)
+			{
+				const float lin  = float(i) / float(kSRGBEncodeTableSize - 1);
+				const float srgb = lin <= 0.0031308f ? lin * 12.92f : 1.055f * math::pow(lin, 1.0f / 2.4f) - 0.055f;
+
+				result.encode[i] = uint8_t(math::clamp(srgb * 255.0f + 0.5f, 0.0f, 255.0f));
+			}
+			return result;
+		}();
+		return tables;
+	}
+
+	// Decode one row to float, encode float row back to storage type.
+	template<typename T> struct MipmapCodec;
+
+	template<> struct MipmapCodec<uint8_t>
+	{
+		uint32_t channelCount;
+		bool bSRGB;
+
+		void decode(const uint8_t* src, float* dest, uint32_t pixelCount) const
+		{
+			const auto& tables = getSRGBTables();
+
+			// Alpha always linear.
+			const float* componentTables[4];
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				componentTables[c] = (bSRGB && c < 3) ? tables.decode : tables.linearDecode;
+			}
+
+			for (uint32_t i = 0; i < pixelCount; i++)
+			{
+				for (uint32_t c = 0; c < channelCount; c++)
+				{
+					dest[i * channelCount + c] = componentTables[c][src[i * channelCount + c]];
+				}
+			}
+		}
+
+		void encode(const float* src, uint8_t* dest, uint32_t pixelCount) const
+		{
+			const auto& tables = getSRGBTables();
+			for (uint32_t i = 0; i < pixelCount; i++)
+			{
+				for (uint32_t c = 0; c < channelCount; c++)
+				{
+					const float v = math::clamp(src[i * channelCount + c], 0.0f, 1.0f);
+					dest[i * channelCount + c] = (bSRGB && c < 3)
+						? tables.encode[uint32_t(v * float(kSRGBEncodeTableSize - 1) + 0.5f)]
+						: uint8_t(v * 255.0f + 0.5f);
+				}
+			}
+		}
+	};
+
+	template<> struct MipmapCodec<uint16_t>
+	{
+		uint32_t channelCount;
+
+		void decode(const uint16_t* src, float* dest, uint32_t pixelCount) const
+		{
+			for (size_t i = 0; i < size_t(pixelCount) * channelCount; i++)
+			{
+				dest[i] = float(src[i]) * (1.0f / 65535.0f);
+			}
+		}
+
+		void encode(const float* src, uint16_t* dest, uint32_t pixelCount) const
+		{
+			for (size_t i = 0; i < size_t(pixelCount) * channelCount; i++)
+			{
+				dest[i] = uint16_t(math::clamp(src[i], 0.0f, 1.0f) * 65535.0f + 0.5f);
+			}
+		}
+	};
+
+	template<> struct MipmapCodec<float>
+	{
+		uint32_t channelCount;
+
+		void decode(const float* src, float* dest, uint32_t pixelCount) const
+		{
+			memcpy(dest, src, sizeof(float) * pixelCount * channelCount);
+		}
+
+		void encode(const float* src, float* dest, uint32_t pixelCount) const
+		{
+			memcpy(dest, src, sizeof(float) * pixelCount * channelCount);
+		}
+	};
+
+	static const uint32_t kMaxMipmapKernelTaps = 6;
+
+	// Separable 1D kernel of 2x downsample, dest texel x sample src texel 2x + tapOffset + tap.
+	struct MipmapKernel
+	{
+		int32_t  tapOffset;
+		uint32_t tapCount;
+		float    weights[kMaxMipmapKernelTaps];
+	};
+
+	// Modified bessel function of first kind, order zero.
+	static float besselI0(float x)
+	{
+		float sum  = 1.0f;
+		float term = 1.0f;
+		for (uint32_t k = 1; k < 32; k++)
+		{
+			const float halfX = x * 0.5f / float(k);
+			term *= halfX * halfX;
+			sum  += term;
+
+			if (term < sum * 1e-7f) { break; }
+		}
+		return sum;
+	}
+
+	static const MipmapKernel& getMipmapKernel(EMipmapFilter filter)
+	{
+		static const MipmapKernel kBoxKernel = { 0, 2, { 0.5f, 0.5f } };
+		static const MipmapKernel kKaiserKernel = []()
+		{
+			// Sinc cutoff at half of src frequency, window radius is 3 src texels.
+			constexpr float kAlpha  = 4.0f;
+			constexpr float kRadius = 3.0f;
+
+			MipmapKernel kernel { -2, 6, { } };
+
+			float weightSum = 0.0f;
+			for (uint32_t t = 0; t < kernel.tapCount; t++)
+			{
+				// Distance from src texel center to dest texel center, in src texel.
+				const float d = float(t) + float(kernel.tapOffset) - 0.5f;
+
+				const float x = d * 0.5f * math::pi<float>();
+				const float sinc = math::abs(x) < 1e-6f ? 1.0f : math::sin(x) / x;
+
+				const float r = d / kRadius;
+				const float window = besselI0(kAlpha * math::sqrt(math::max(0.0f, 1.0f - r * r))) / besselI0(kAlpha);
+
+				kernel.weights[t] = sinc * window;
+				weightSum += kernel.weights[t];
+			}
+
+			for (uint32_t t = 0; t < kernel.tapCount; t++)
+			{
+				kernel.weights[t] /= weightSum;
+			}
+			return kernel;
+		}();
+
+		return filter == EMipmapFilter::Kaiser ? kKaiserKernel : kBoxKernel;
+	}
+
+	static void accumulateRow(float* accum, const float* src, float weight, size_t count)
+	{
+		size_t i = 0;
+#if MIPMAP_SSE2
+		const __m128 w = _mm_set1_ps(weight);
+		for (; i + 4 <= count; i += 4)
+		{
+			_mm_storeu_ps(accum + i, _mm_add_ps(_mm_loadu_ps(accum + i), _mm_mul_ps(_mm_loadu_ps(src + i), w)));
+		}
+#endif
+		for (; i < count; i++)
+		{
+			accum[i] += src[i] * weight;
+		}
+	}
+
+	static void filterRowHorizontal(
+		float* dest,
+		const float* src,
+		uint32_t srcWidth,
+		uint32_t destWidth,
+		uint32_t channelCount,
+		const MipmapKernel& kernel)
+	{
+		const int32_t maxX = int32_t(srcWidth) - 1;
+		for (uint32_t x = 0; x < destWidth; x++)
+		{
+			const int32_t srcX = int32_t(x * 2) + kernel.tapOffset;
+
+#if MIPMAP_SSE2
+			if (channelCount == 4)
+			{
+				__m128 sum = _mm_setzero_ps();
+				for (uint32_t t = 0; t < kernel.tapCount; t++)
+				{
+					const int32_t sampleX = math::clamp(srcX + int32_t(t), 0, maxX);
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + sampleX * 4), _mm_set1_ps(kernel.weights[t])));
+				}
+				_mm_storeu_ps(dest + x * 4, sum);
+				continue;
+			}
+#endif
+			for (uint32_t c = 0; c < channelCount; c++)
+			{
+				float sum = 0.0f;
+				for (uint32_t t = 0; t < kernel.tapCount; t++)
+				{
+					const int32_t sampleX = math::clamp(srcX + int32_t(t), 0, maxX);
+					sum += src[sampleX * channelCount + c] * kernel.weights[t];
+				}
+				dest[x * channelCount + c] = sum;
+			}
+		}
+	}
+
+	// Vertical pass accumulate decoded src rows, then horizontal pass downsample to dest row.
+	template<typename T>
+	static void downsampleMip(
+		const T* src,
+		uint32_t srcWidth,
+		uint32_t srcHeight,
+		T* dest,
+		uint32_t destWidth,
+		uint32_t destHeight,
+		uint32_t channelCount,
+		const MipmapCodec<T>& codec,
+		const MipmapKernel& kernel)
+	{
+		const size_t srcRowSize  = size_t(srcWidth)  * channelCount;
+		const size_t destRowSize = size_t(destWidth) * channelCount;
+
+		const auto buildRows = [&](const size_t loopStart, const size_t loopEnd)
+		{
+			std::vector<float> decodeRow(srcRowSize);
+			std::vector<float> accumRow(srcRowSize);
+			std::vector<float> destRow(destRowSize);
+
+			for (size_t y = loopStart; y < loopEnd; y++)
+			{
+				std::fill(accumRow.begin(), accumRow.end(), 0.0f);
+				for (uint32_t t = 0; t < kernel.tapCount; t++)
+				{
+					const int32_t srcY = math::clamp(int32_t(y * 2) + kernel.tapOffset + int32_t(t), 0, int32_t(srcHeight) - 1);
+
+					codec.decode(src + srcY * srcRowSize, decodeRow.data(), srcWidth);
+					accumulateRow(accumRow.data(), decodeRow.data(), kernel.weights[t], srcRowSize);
+				}
+
+				filterRowHorizontal(destRow.data(), accumRow.data(), srcWidth, destWidth, channelCount, kernel);
+				codec.encode(destRow.data(), dest + y * destRowSize, destWidth);
+			}
+		};
+		Engine::get()->getThreadPool()->parallelFor(0, destHeight, buildRows);
+	}
+
+	// Copy selected components to mip 0, then downsample mip by mip, onMipBuilt called after each mip ready.
+	template<typename T, typename F>
+	static void buildMipmapChain(
+		uint32_t channelCount,
+		uint32_t pixelOffsetPerSample,
+		const T* srcPixels,
+		AssetTextureBin& outBinData,
+		const MipmapCodec<T>& codec,
+		uint32_t mipmapCount,
+		uint32_t inWidth,
+		uint32_t inHeight,
+		EMipmapFilter filter,
+		F&& onMipBuilt)
+	{
+		CHECK(channelCount == 1 || channelCount == 2 || channelCount == 4);
+		CHECK(channelCount + pixelOffsetPerSample <= 4);
+
+		const size_t kPixelSize = sizeof(T) * channelCount;
+		const MipmapKernel& kernel = getMipmapKernel(filter);
+
+		outBinData.mipmapDatas.resize(mipmapCount);
+		for (size_t mip = 0; mip < outBinData.mipmapDatas.size(); mip++)
+		{
+			auto& destMipData = outBinData.mipmapDatas[mip];
+
+			const uint32_t destWidth  = math::max<uint32_t>(inWidth  >> mip, 1);
+			const uint32_t destHeight = math::max<uint32_t>(inHeight >> mip, 1);
+
+			destMipData.resize(size_t(destWidth) * destHeight * kPixelSize);
+			T* pDestData = (T*)destMipData.data();
+
+			if (mip == 0)
+			{
+				if (channelCount == 4)
+				{
+					CHECK(pixelOffsetPerSample == 0);
+					memcpy(pDestData, srcPixels, destMipData.size());
+				}
+				else
+				{
+					// De-interval from stb load.
+					for (size_t index = 0; index < size_t(inWidth) * inHeight; index++)
+					{
+						for (size_t i = 0; i < channelCount; i++)
+						{
+							pDestData[index * channelCount + i] = srcPixels[index * 4 + i + pixelOffsetPerSample];
+						}
+					}
+				}
+			}
+			else
+			{
+				const size_t srcMip = mip - 1;
+
+				downsampleMip<T>(
+					(const T*)outBinData.mipmapDatas[srcMip].data(),
+					math::max<uint32_t>(inWidth  >> srcMip, 1),
+					math::max<uint32_t>(inHeight >> srcMip, 1),
+					pDestData,
+					destWidth,
+					destHeight,
+					channelCount,
+					codec,
+					kernel);
+			}
+
+			onMipBuilt(mip, destMipData, destWidth, destHeight);
+		}
+	}
+
+	static const int kFindBestAlphaCount = 50;
+
+	// Coverage is sum of alpha above cutoff after scale, so compute from histogram instead of scan whole mip.
+	static float getAlphaCoverage(const std::array<uint32_t, 256>& histogram, size_t pixelCount, float scale, int cutoff)
+	{
+		// float value may no enough for multi add.
+		double value = 0.0;
+		for (int alpha = 0; alpha < 256; alpha++)
+		{
+			if (histogram[alpha] == 0)
+			{
+				continue;
+			}
+
+			const int scaledAlpha = math::min((int)(scale * (float)alpha), 255);
+			if (scaledAlpha <= cutoff)
+			{
+				continue;
+			}
+
+			value += double(scaledAlpha) * histogram[alpha];
+		}
+		return (float)(value / (pixelCount * 255));
+	}
+
+	static void buildAlphaHistogramRGBA8(std::array<uint32_t, 256>& histogram, const std::vector<uint8_t>& data)
+	{
+		histogram.fill(0);
+		for (size_t i = 3; i < data.size(); i += 4)
+		{
+			histogram[data[i]]++;
+		}
+	}
+
+	void engine::buildMipmapData8Bit(
+		uint32_t channelCount,
+		uint32_t pixelOffsetPerSample,
+		const uint8_t* srcPixels,
+		AssetTextureBin& outBinData,
+		bool bSRGB,
+		uint32_t mipmapCount,
+		uint32_t inWidth,
+		uint32_t inHeight,
+		float alphaMipmapCutoff,
+		EMipmapFilter filter)
+	{
+		const bool bKeepAlphaCoverage = (alphaMipmapCutoff < 1.0f) && (channelCount == 4);
+		const int cutoff = (int)(alphaMipmapCutoff * 255);
+
+		float alphaCoverage = 1.0f;
+		std::array<uint32_t, 256> histogram { };
+
+		const MipmapCodec<uint8_t> codec { channelCount, bSRGB };
+		buildMipmapChain<uint8_t>(channelCount, pixelOffsetPerSample, srcPixels, outBinData, codec, mipmapCount, inWidth, inHeight, filter,
+			[&](size_t mip, std::vector<uint8_t>& mipData, uint32_t width, uint32_t height)
+			{
+				if (!bKeepAlphaCoverage)
+				{
+					return;
+				}
+
+				const size_t pixelCount = size_t(width) * height;
+				buildAlphaHistogramRGBA8(histogram, mipData);
+
+				if (mip == 0)
+				{
+					alphaCoverage = getAlphaCoverage(histogram, pixelCount, 1.0f, cutoff);
+					return;
+				}
+
+				// Find best alpha coverage for mip-map.
+				if (alphaCoverage < 1.0f)
+				{
+					float ini =  0.0f;
+					float fin = 10.0f;
+					float mid;
+
+					for (int iter = 0; iter < kFindBestAlphaCount; iter++)
+					{
+						mid = (ini + fin) / 2;
+						const float alphaPercentage = getAlphaCoverage(histogram, pixelCount, mid, cutoff);
+
+						if (math::abs(alphaPercentage - alphaCoverage) < .001) { break; }
+						if (alphaPercentage > alphaCoverage) { fin = mid; }
+						if (alphaPercentage < alphaCoverage) { ini = mid; }
+					}
+
+					std::array<uint8_t, 256> scaleTable;
+					for (int alpha = 0; alpha < 256; alpha++)
+					{
+						scaleTable[alpha] = uint8_t(math::clamp((int)(mid * (float)alpha), 0, 255));
+					}
+
+					for (size_t i = 3; i < mipData.size(); i += 4)
+					{
+						mipData[i] = scaleTable[mipData[i]];
+					}
+				}
+			});
+	}
+
+	void engine::buildMipmapData16Bit(
+		uint32_t channelCount,
+		uint32_t pixelOffsetPerSample,
+		const uint16_t* srcPixels,
+		AssetTextureBin& outBinData,
+		uint32_t mipmapCount,
+		uint32_t inWidth,
+		uint32_t inHeight,
+		EMipmapFilter filter)
+	{
+		const MipmapCodec<uint16_t> codec { channelCount };
+		buildMipmapChain<uint16_t>(channelCount, pixelOffsetPerSample, srcPixels, outBinData, codec, mipmapCount, inWidth, inHeight, filter,
+			[](size_t, std::vector<uint8_t>&, uint32_t, uint32_t) { });
+	}
+
+	void engine::buildMipmapDataFloat(
+		uint32_t channelCount,
+		uint32_t pixelOffsetPerSample,
+		const float* srcPixels,
+		AssetTextureBin& outBinData,
+		uint32_t mipmapCount,
+		uint32_t inWidth,
+		uint32_t inHeight,
+		EMipmapFilter filter)
+	{
+		const MipmapCodec<float> codec { channelCount };
+		buildMipmapChain<float>(channelCount, pixelOffsetPerSample, srcPixels, outBinData, codec, mipmapCount, inWidth, inHeight, filter,
+			[](size_t, std::vector<uint8_t>&, uint32_t, uint32_t) { });
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+// Mipmap chain generation of 8 bit, 16 bit and float source.
+// Each mip downsample from previous mip by separable filter in linear space, rows of dest mip split to thread pool tasks.
+// Source pixels always RGBA interleaved as stb load, channelCount components start from pixelOffsetPerSample are stored.
+
+namespace engine
+{
+	struct AssetTextureBin;
+
+	// Downsample filter of mip chain.
+	enum class EMipmapFilter
+	{
+		Box,    // 2x2 average.
+		Kaiser, // 6x6 kaiser windowed sinc, sharper but may ringing on hard edge.
+
+		Max,
+	};
+
+	// sRGB decode and alpha coverage keep only support in 8 bit path.
+	extern void buildMipmapData8Bit(
+		uint32_t channelCount,
+		uint32_t pixelOffsetPerSample,
+		const uint8_t* srcPixels,
+		AssetTextureBin& outBinData,
+		bool bSRGB,
+		uint32_t mipmapCount,
+		uint32_t inWidth,
+		uint32_t inHeight,
+		float alphaMipmapCutoff = 1.0f,
+		EMipmapFilter filter = EMipmapFilter::Box);
+
+	extern void buildMipmapData16Bit(
+		uint32_t channelCount,
+		uint32_t pixelOffsetPerSample,
+		const uint16_t* srcPixels,
+		AssetTextureBin& outBinData,
+		uint32_t mipmapCount,
+		uint32_t inWidth,
+		uint32_t inHeight,
+		EMipmapFilter filter = EMipmapFilter::Box);
+
+	// Float result don't clamp, kaiser filter may produce small negative value on hard edge.
+	extern void buildMipmapDataFloat(
+		uint32_t channelCount,
+		uint32_t pixelOffsetPerSample,
+		const float* srcPixels,
+		AssetTextureBin& outBinData,
+		uint32_t mipmapCount,
+		uint32_t inWidth,
+		uint32_t inHeight,
+		EMipmapFilter filter = EMipmapFilter::Box);
+}
@@ -9,6 +9,16 @@
 
 namespace engine
 {
+	static AutoCVarInt32 cVarTickSingleThread(
+		"engine.tick.singleThread",
+		"Run all module tick tasks on main thread by register order, used to debug frame task graph.",
+		"Engine",
+		0,
+		CVarFlags::ReadAndWrite);
+
+	static AutoCVarCmd cVarBenchmarkThreadPool("cmd.engine.benchmarkThreadPool", "Benchmark single queue and work stealing thread pool at 1, 8 and 32 threads.");
+	static AutoCVarCmd cVarBenchmarkParallelFor("cmd.engine.benchmarkParallelFor", "Benchmark parallelizeLoop and parallelFor overhead on small and large loops.");
+
 	inline void tryImportOrCreateIni(const std::string& path)
 	{
 		if (std::filesystem::exists(path))
@@ -29,6 +39,7 @@ namespace engine
 		std::filesystem::create_directories(kLogCacheFolder);
 		std::filesystem::create_directories(kShaderCacheFolder);
 		std::filesystem::create_directories(kConfigCacheFolder);
+		std::filesystem::create_directories(kDerivedDataCacheFolder);
 
 		// Always override cvar configs.
 		CVarSystem::get()->exportAllConfig("config/default.ini");
@@ -93,11 +104,32 @@ namespace engine
 				tickData.gameTickCount = m_gameStates.tickCount;
 			}
 
-			// Modules tick.
-			for (const auto& runtimeModule : m_runtimeModules)
+			CVarCmdHandle(cVarBenchmarkThreadPool, [&]()
+			{
+				benchmarkThreadPool();
+			});
+
+			CVarCmdHandle(cVarBenchmarkParallelFor, [&]()
+			{
+				benchmarkParallelFor();
+			});
+
+			// Rebuild tick tasks when new module register.
+			if (m_frameTaskModuleCount != m_runtimeModules.size())
 			{
-				bContinue &= runtimeModule->tick(tickData);
+				m_frameTaskGraph.clear();
+				for (const auto& runtimeModule : m_runtimeModules)
+				{
+					runtimeModule->registerTickTasks(m_frameTaskGraph);
+				}
+				m_frameTaskGraph.compile();
+				m_frameTaskGraph.logGraph();
+
+				m_frameTaskModuleCount = m_runtimeModules.size();
 			}
+
+			// Modules tick.
+			bContinue &= m_frameTaskGraph.execute(tickData, m_threadPool.get(), cVarTickSingleThread.get() != 0);
 		}
 
 		FrameMark;
@@ -167,6 +199,9 @@ namespace engine
 				}
 
 				m_runtimeModules.clear();
+
+				m_frameTaskGraph.clear();
+				m_frameTaskModuleCount = 0;
 			}
 		}
 
@@ -231,6 +266,31 @@ namespace engine
 		return true;
 	}
 
+	bool Engine::initHeadless()
+	{
+		if (m_windowsInfo.isCompleted())
+		{
+			LOG_ERROR("Can't init headless engine when GLFW windows hook installed!");
+			return false;
+		}
+
+		m_moduleState = EModuleState::Initing;
+
+		// No render loop compete with workers, use all cores.
+		m_timer.init(5.0, 5.0);
+		m_threadPool = std::make_unique<ThreadPool>(false);
+
+		return registerRuntimeModule<AssetManager>();
+	}
+
+	bool Engine::releaseHeadless()
+	{
+		const bool bResult = release();
+		m_threadPool = nullptr;
+
+		return bResult;
+	}
+
 	bool Engine::GLFWWindowsInfo::isCompleted() const
 	{
 		return windows != nullptr
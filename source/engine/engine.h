@@ -2,12 +2,14 @@
 
 #include "utils/utils.h"
 #include "profile/profile.h"
+#include "frame_task_graph.h"
 
 namespace engine
 {
-	static const std::string kShaderCacheFolder = "save/shader/";
-	static const std::string kLogCacheFolder    = "save/log/";
-	static const std::string kConfigCacheFolder = "save/config/";
+	static const std::string kShaderCacheFolder      = "save/shader/";
+	static const std::string kLogCacheFolder         = "save/log/";
+	static const std::string kConfigCacheFolder      = "save/config/";
+	static const std::string kDerivedDataCacheFolder = "save/ddc/";
 
 	extern void initBasicCVarConfigs();
 
@@ -41,6 +43,10 @@ namespace engine
 
 		bool releaseGLFWWindowsHook();
 
+		// Headless engine without window and vulkan context, only asset module init, used by command line tools.
+		bool initHeadless();
+		bool releaseHeadless();
+
 		template<typename T>
 		bool existRegisteredModule()
 		{
@@ -49,7 +55,7 @@ namespace engine
 
 		bool isRuntimeModuleEmpty() const { return m_runtimeModules.empty(); }
 
-		// Runtime module will tick sequence by register time, all run within main thread.
+		// Runtime module tick tasks build into frame task graph by register time, conflict tasks run in that order.
 		template<typename T>
 		[[nodiscard]] bool registerRuntimeModule()
 		{
@@ -131,6 +137,10 @@ namespace engine
 		std::vector<std::unique_ptr<IRuntimeModule>> m_runtimeModules;
 		std::map<std::string, size_t> m_registeredModulesIndexMap;
 
+		// Tick tasks of all runtime modules, rebuild when module register.
+		FrameTaskGraph m_frameTaskGraph;
+		size_t m_frameTaskModuleCount = 0;
+
 		// Engine timer.
 		Timer m_timer;
 
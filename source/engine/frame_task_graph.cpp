@@ -0,0 +1,236 @@
+#include "frame_task_graph.h"
+
+#include <profile/profile.h>
+
+namespace engine
+{
+	void IRuntimeModule::registerTickTasks(FrameTaskGraph& graph)
+	{
+		// Module no declare its tick, conservative write all resources on main thread.
+		FrameTaskGraph::TaskDesc desc { };
+		desc.name = typeid(*this).name();
+		for (size_t i = 0; i < size_t(ETickResource::Max); i++)
+		{
+			desc.writes.push_back(ETickResource(i));
+		}
+		desc.function = [this](const RuntimeModuleTickData& tickData)
+		{
+			return tick(tickData);
+		};
+
+		graph.addTask(std::move(desc));
+	}
+
+	FrameTaskGraph::TaskId FrameTaskGraph::addTask(TaskDesc&& desc)
+	{
+		CHECK(!m_bCompiled);
+
+		Task task { };
+		for (const auto resource : desc.reads)
+		{
+			task.reads.set(size_t(resource));
+		}
+		for (const auto resource : desc.writes)
+		{
+			task.writes.set(size_t(resource));
+		}
+		task.desc = std::move(desc);
+
+		m_tasks.push_back(std::move(task));
+		return TaskId(m_tasks.size() - 1);
+	}
+
+	void FrameTaskGraph::clear()
+	{
+		m_tasks.clear();
+		m_bCompiled = false;
+	}
+
+	void FrameTaskGraph::compile()
+	{
+		for (TaskId id = 0; id < m_tasks.size(); id++)
+		{
+			auto& task = m_tasks[id];
+			task.dependencies.clear();
+			task.dependents.clear();
+
+			// Read after write, write after read and write after write.
+			for (TaskId prevId = 0; prevId < id; prevId++)
+			{
+				const auto& prevTask = m_tasks[prevId];
+				const bool bConflict =
+					(prevTask.writes & (task.reads | task.writes)).any() ||
+					(prevTask.reads & task.writes).any();
+
+				if (bConflict)
+				{
+					task.dependencies.push_back(prevId);
+				}
+			}
+		}
+
+		for (TaskId id = 0; id < m_tasks.size(); id++)
+		{
+			for (const auto dependency : m_tasks[id].dependencies)
+			{
+				m_tasks[dependency].dependents.push_back(id);
+			}
+		}
+
+		m_bCompiled = true;
+	}
+
+	void FrameTaskGraph::logGraph() const
+	{
+		for (TaskId id = 0; id < m_tasks.size(); id++)
+		{
+			const auto& task = m_tasks[id];
+
+			std::string dependencies;
+			for (const auto dependency : task.dependencies)
+			{
+				dependencies += std::format("{}{}", dependencies.empty() ? "" : ", ", m_tasks[dependency].desc.name);
+			}
+
+			LOG_TRACE("Frame task [{}] {} on {} thread, wait for [{}].", id, task.desc.name, task.desc.bMainThread ? "main" : "worker", dependencies);
+		}
+	}
+
+	bool FrameTaskGraph::runTask(TaskId id, const RuntimeModuleTickData& tickData)
+	{
+		const auto& desc = m_tasks[id].desc;
+
+		ZoneScopedN("FrameTaskGraph::runTask");
+		ZoneText(desc.name.c_str(), desc.name.size());
+
+		return desc.function(tickData);
+	}
+
+	bool FrameTaskGraph::execute(const RuntimeModuleTickData& tickData, ThreadPool* pool, bool bSingleThread)
+	{
+		ZoneScopedN("FrameTaskGraph::execute");
+		CHECK(m_bCompiled);
+
+		if (bSingleThread || pool == nullptr)
+		{
+			bool bSucceed = true;
+			for (TaskId id = 0; id < m_tasks.size(); id++)
+			{
+				bSucceed &= runTask(id, tickData);
+			}
+			return bSucceed;
+		}
+
+		std::unique_lock<std::mutex> lock(m_lock);
+
+		m_pool = pool;
+		m_bSucceed = true;
+		m_unfinishedCount = uint32_t(m_tasks.size());
+		m_unfinishedDependencyCounts.resize(m_tasks.size());
+		m_mainThreadReadyTasks.clear();
+		m_workerReadyTasks.clear();
+
+		for (TaskId id = 0; id < m_tasks.size(); id++)
+		{
+			m_unfinishedDependencyCounts[id] = uint32_t(m_tasks[id].dependencies.size());
+		}
+
+		for (TaskId id = 0; id < m_tasks.size(); id++)
+		{
+			if (m_unfinishedDependencyCounts[id] == 0)
+			{
+				dispatchTask(id, tickData);
+			}
+		}
+
+		while (m_unfinishedCount > 0)
+		{
+			// Main thread task first, then worker task pool no pick yet, sleep only when both empty.
+			std::deque<TaskId>* readyTasks = !m_mainThreadReadyTasks.empty() ? &m_mainThreadReadyTasks
+				: (!m_workerReadyTasks.empty() ? &m_workerReadyTasks : nullptr);
+
+			if (readyTasks == nullptr)
+			{
+				m_condition.wait(lock);
+				continue;
+			}
+
+			const TaskId id = readyTasks->front();
+			readyTasks->pop_front();
+
+			lock.unlock();
+			const bool bSucceed = runTask(id, tickData);
+			lock.lock();
+
+			finishTask(id, bSucceed, tickData);
+		}
+		lock.unlock();
+
+		// Pool tasks of worker tasks claim by main thread may still queue, only run them, never other jobs of pool.
+		m_pool->waitForOwnTasks(m_poolTaskCounter);
+
+		m_pool = nullptr;
+		return m_bSucceed;
+	}
+
+	void FrameTaskGraph::dispatchTask(TaskId id, const RuntimeModuleTickData& tickData)
+	{
+		if (m_tasks[id].desc.bMainThread)
+		{
+			m_mainThreadReadyTasks.push_back(id);
+			m_condition.notify_all();
+			return;
+		}
+
+		// Tick data and graph keep alive until execute return, which wait all pool tasks leave.
+		m_workerReadyTasks.push_back(id);
+		m_pool->pushCountedTask(m_poolTaskCounter, [this, &tickData]()
+		{
+			runWorkerTask(tickData);
+		});
+		m_condition.notify_all();
+	}
+
+	void FrameTaskGraph::runWorkerTask(const RuntimeModuleTickData& tickData)
+	{
+		TaskId id;
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			if (m_workerReadyTasks.empty())
+			{
+				return;
+			}
+
+			id = m_workerReadyTasks.front();
+			m_workerReadyTasks.pop_front();
+		}
+
+		const bool bSucceed = runTask(id, tickData);
+
+		std::lock_guard<std::mutex> lock(m_lock);
+		finishTask(id, bSucceed, tickData);
+	}
+
+	void FrameTaskGraph::finishTask(TaskId id, bool bSucceed, const RuntimeModuleTickData& tickData)
+	{
+		if (!bSucceed)
+		{
+			m_bSucceed = false;
+		}
+
+		for (const auto dependent : m_tasks[id].dependents)
+		{
+			if (--m_unfinishedDependencyCounts[dependent] == 0)
+			{
+				dispatchTask(dependent, tickData);
+			}
+		}
+
+		// Notify under lock, graph may destroy once execute return.
+		m_unfinishedCount --;
+		if (m_unfinishedCount == 0)
+		{
+			m_condition.notify_all();
+		}
+	}
+}
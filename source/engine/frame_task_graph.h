@@ -0,0 +1,105 @@
+#pragma once
+
+#include "utils/utils.h"
+
+#include <bitset>
+#include <deque>
+
+namespace engine
+{
+	// Engine state frame tasks read or write, tasks conflict on resource run in add order, others run concurrently.
+	// Thread safe state (such as asset manager lock protected maps) no need declare.
+	enum class ETickResource
+	{
+		Scene = 0,     // Scene node tree and components.
+		Transform,     // World transform of scene nodes.
+		Asset,         // Loaded assets, reimport commit.
+		AssetIndex,    // Project asset index file.
+		GPUAsset,      // Uploader, texture streaming and gpu resources of assets.
+		RenderScene,   // Render scene collect data and per frame gpu buffers.
+		UI,            // ImGui frame and editor widgets.
+		GraphicsQueue, // Swapchain, graphics command record, submit and present.
+
+		Max
+	};
+
+	// Per frame tick tasks of runtime modules, build once and execute every frame on engine thread pool.
+	// Main thread task run on caller of execute, such as glfw, imgui and present work.
+	// Worker task also run on caller when it idle, pool may busy with long import jobs.
+	class FrameTaskGraph : NonCopyable
+	{
+	public:
+		using TaskId = uint32_t;
+		using TickFunction = std::function<bool(const RuntimeModuleTickData&)>;
+
+		struct TaskDesc
+		{
+			std::string name;
+
+			std::vector<ETickResource> reads;
+			std::vector<ETickResource> writes;
+
+			bool bMainThread = true;
+			TickFunction function;
+		};
+
+		// Add before compile, task depend on all former tasks it conflict with.
+		TaskId addTask(TaskDesc&& desc);
+
+		void clear();
+
+		// Build dependency edges of tasks.
+		void compile();
+		bool isCompiled() const { return m_bCompiled; }
+
+		uint32_t getTaskCount() const { return uint32_t(m_tasks.size()); }
+
+		// Return false if any task return false, all tasks still run.
+		// Single thread run all tasks on caller by add order, used to debug.
+		bool execute(const RuntimeModuleTickData& tickData, ThreadPool* pool, bool bSingleThread);
+
+		// Log tasks and dependencies.
+		void logGraph() const;
+
+	private:
+		using Resources = std::bitset<size_t(ETickResource::Max)>;
+
+		struct Task
+		{
+			TaskDesc desc;
+
+			Resources reads;
+			Resources writes;
+
+			std::vector<TaskId> dependencies;
+			std::vector<TaskId> dependents;
+		};
+
+		bool runTask(TaskId id, const RuntimeModuleTickData& tickData);
+
+		// Push task to main thread queue or worker queue, require lock.
+		void dispatchTask(TaskId id, const RuntimeModuleTickData& tickData);
+
+		// Pool task claim one ready worker task, task may already claim by main thread.
+		void runWorkerTask(const RuntimeModuleTickData& tickData);
+		void finishTask(TaskId id, bool bSucceed, const RuntimeModuleTickData& tickData);
+
+	private:
+		std::vector<Task> m_tasks;
+		bool m_bCompiled = false;
+
+		// Execute state.
+		std::mutex m_lock;
+		std::condition_variable m_condition;
+		ThreadPool* m_pool = nullptr;
+
+		std::vector<uint32_t> m_unfinishedDependencyCounts;
+		std::deque<TaskId> m_mainThreadReadyTasks;
+		std::deque<TaskId> m_workerReadyTasks;
+
+		// Pool tasks push this frame, wait them leave graph before execute return.
+		TaskCounter m_poolTaskCounter;
+		uint32_t m_unfinishedCount = 0;
+		bool m_bSucceed = true;
+	};
+}
@@ -46,6 +46,7 @@ namespace engine
 		// Getter.
 		VkDescriptorSet getSet() const;
 		VkDescriptorSetLayout getSetLayout() const;
+		uint32_t getMaxCount() const { return m_maxCountConfig; }
 
 		virtual void init(const char* name) = 0;
 		virtual void release();
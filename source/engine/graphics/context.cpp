@@ -119,6 +119,8 @@ namespace engine
         m_shaderCache          = std::make_unique<ShaderCache>();
         // 1024 MB + 512 MB LRU cache.
         m_lru                  = std::make_unique<LRUAssetCache>(1024, 512); 
+        m_textureStreaming     = std::make_unique<TextureStreamingManager>();
+        m_memoryBudget         = std::make_unique<GPUMemoryBudget>();
         m_passCollector        = std::make_unique<PassCollector>(this);
 
         initBuiltinAssets();
@@ -127,8 +129,37 @@ namespace engine
     }
 
     bool VulkanContext::tick(const RuntimeModuleTickData& tickData)
+    {
+        bool bResult = tickUploader(tickData);
+        bResult &= tickFrameResources(tickData);
+
+        return bResult;
+    }
+
+    void VulkanContext::registerTickTasks(FrameTaskGraph& graph)
+    {
+        graph.addTask({ "VulkanContext::tickUploader", { }, { ETickResource::GPUAsset }, true, [this](const RuntimeModuleTickData& tickData)
+        {
+            return tickUploader(tickData);
+        }});
+
+        graph.addTask({ "VulkanContext::tickFrameResources", { }, { ETickResource::RenderScene, ETickResource::GraphicsQueue }, true, [this](const RuntimeModuleTickData& tickData)
+        {
+            return tickFrameResources(tickData);
+        }});
+    }
+
+    bool VulkanContext::tickUploader(const RuntimeModuleTickData& tickData)
     {
         m_uploader->tick(tickData);
+        m_textureStreaming->tick(tickData);
+        m_memoryBudget->tick(tickData);
+
+        return true;
+    }
+
+    bool VulkanContext::tickFrameResources(const RuntimeModuleTickData& tickData)
+    {
         m_dynamicUniformBuffer->onFrameStart();
 
         CVarCmdHandle(cVarUpdatePasses, [&]() 
@@ -162,6 +193,8 @@ namespace engine
         destroyBuiltinAsset();
 
 
+        m_memoryBudget         = nullptr;
+        m_textureStreaming     = nullptr;
         m_lru                  = nullptr;
         m_shaderCache          = nullptr;
         m_bufferParameters     = nullptr;
@@ -13,6 +13,8 @@
 
 #include <vma/vk_mem_alloc.h>
 #include "gpu_asset.h"
+#include "texture_streaming.h"
+#include "memory_budget.h"
 #include "pass.h"
 #include <profile/profile.h>
 namespace engine
@@ -96,6 +98,7 @@ namespace engine
 		virtual void registerCheck(Engine* engine) override;
 		virtual bool init() override;
 		virtual bool tick(const RuntimeModuleTickData& tickData) override;
+		virtual void registerTickTasks(FrameTaskGraph& graph) override;
 		virtual bool beforeRelease() override;
 		virtual bool release() override;
 
@@ -230,8 +233,12 @@ namespace engine
 			const VkWriteDescriptorSet* pDescriptorWrites);
 
 		const auto& getLRU() const { return m_lru; }
+		TextureStreamingManager& getTextureStreaming() { return *m_textureStreaming; }
+		const TextureStreamingManager& getTextureStreaming() const { return *m_textureStreaming; }
+		const GPUMemoryBudget& getMemoryBudget() const { return *m_memoryBudget; }
 		bool isLRUAssetExist(const UUID& uuid) { return m_lru->contain(uuid); }
 		void insertLRUAsset(const UUID& uuid, std::shared_ptr<StorageInterface> asset) { m_lru->insert(uuid, asset); }
+		void eraseLRUAsset(const UUID& uuid) { m_lru->erase(uuid); }
 
 
 		bool isBuiltinAssetExist(const UUID& uuid) const { return m_builtinAssets.contains(uuid); }
@@ -273,6 +280,12 @@ namespace engine
 		VkPipelineLayout createPipelineLayout(const VkPipelineLayoutCreateInfo& info);
 
 	private:
+		// Uploader, texture streaming and memory budget tick.
+		bool tickUploader(const RuntimeModuleTickData& tickData);
+
+		// Per frame buffers, render target pool and pass cmds tick.
+		bool tickFrameResources(const RuntimeModuleTickData& tickData);
+
 		void initInstance();
 		void destroyInstance();
 
@@ -343,6 +356,8 @@ namespace engine
 		std::unique_ptr<BufferParameterPool>  m_bufferParameters;
 		std::unique_ptr<ShaderCache>          m_shaderCache;
 		std::unique_ptr<LRUAssetCache>        m_lru;
+		std::unique_ptr<TextureStreamingManager> m_textureStreaming;
+		std::unique_ptr<GPUMemoryBudget>      m_memoryBudget;
 		std::unique_ptr<PassCollector>        m_passCollector;
 
 		// Engine builtin assets.
@@ -30,7 +30,15 @@ namespace engine
 	: UploadAssetInterface(fallback)
 	{
 		CHECK(m_image == nullptr && "You must ensure image asset only init once.");
+		m_image = createImage(format, name, mipmapCount, dimension);
+	}
 
+	std::unique_ptr<VulkanImage> GPUImageAsset::createImage(
+		VkFormat format,
+		const std::string& name,
+		uint32_t mipmapCount,
+		math::uvec3 dimension)
+	{
 		VkImageCreateInfo info{};
 		info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 		info.flags = {};
@@ -49,7 +57,7 @@ namespace engine
 		info.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
 		info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
-		m_image = std::make_unique<VulkanImage>
+		return std::make_unique<VulkanImage>
 		(
 			getContext()->getVMAImage(),
 			getRuntimeUniqueGPUAssetName(name).c_str(),
@@ -74,6 +82,117 @@ namespace engine
 		m_image->transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, range);
 	}
 
+	// Bytes of one texel block and block size of formats asset texture may cook.
+	static void getFormatBlockInfo(VkFormat format, uint32_t& outBlockBytes, uint32_t& outBlockDim)
+	{
+		outBlockDim = 1;
+		switch (format)
+		{
+		case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+		case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+		case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+		case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+		case VK_FORMAT_BC4_UNORM_BLOCK:
+		case VK_FORMAT_BC4_SNORM_BLOCK:
+			outBlockBytes = 8;
+			outBlockDim = 4;
+			return;
+		case VK_FORMAT_BC3_UNORM_BLOCK:
+		case VK_FORMAT_BC3_SRGB_BLOCK:
+		case VK_FORMAT_BC5_UNORM_BLOCK:
+		case VK_FORMAT_BC5_SNORM_BLOCK:
+		case VK_FORMAT_BC6H_UFLOAT_BLOCK:
+		case VK_FORMAT_BC6H_SFLOAT_BLOCK:
+		case VK_FORMAT_BC7_UNORM_BLOCK:
+		case VK_FORMAT_BC7_SRGB_BLOCK:
+			outBlockBytes = 16;
+			outBlockDim = 4;
+			return;
+		case VK_FORMAT_R8_UNORM:
+		case VK_FORMAT_R8_SRGB:
+			outBlockBytes = 1;
+			return;
+		case VK_FORMAT_R8G8_UNORM:
+		case VK_FORMAT_R8G8_SRGB:
+		case VK_FORMAT_R16_UNORM:
+		case VK_FORMAT_R16_SFLOAT:
+			outBlockBytes = 2;
+			return;
+		case VK_FORMAT_R16G16B16A16_UNORM:
+		case VK_FORMAT_R16G16B16A16_SFLOAT:
+			outBlockBytes = 8;
+			return;
+		case VK_FORMAT_R32G32B32A32_SFLOAT:
+			outBlockBytes = 16;
+			return;
+		default:
+			outBlockBytes = 4;
+			return;
+		}
+	}
+
+	StreamingImageAsset::StreamingImageAsset(
+		GPUImageAsset* fallback,
+		std::weak_ptr<AssetTexture> asset,
+		VkFormat format,
+		const std::string& name,
+		uint32_t mipmapCount,
+		math::uvec3 dimension,
+		uint32_t tailFirstMip)
+		: GPUImageAsset(
+			fallback, 
+			format, 
+			name, 
+			mipmapCount - tailFirstMip,
+			math::max(math::uvec3(dimension.x >> tailFirstMip, dimension.y >> tailFirstMip, 1U), math::uvec3(1U)))
+		, m_asset(asset)
+		, m_name(name)
+		, m_format(format)
+		, m_mipmapCount(mipmapCount)
+		, m_dimension(dimension)
+		, m_tailFirstMip(tailFirstMip)
+		, m_firstResidentMip(tailFirstMip)
+	{
+		CHECK(tailFirstMip < mipmapCount && dimension.z == 1U);
+		m_tailSize = (uint32_t)m_image->getSize();
+	}
+
+	VkDeviceSize StreamingImageAsset::getResidentSize(uint32_t firstMip) const
+	{
+		uint32_t blockBytes;
+		uint32_t blockDim;
+		getFormatBlockInfo(m_format, blockBytes, blockDim);
+
+		VkDeviceSize size = 0;
+		for (uint32_t level = firstMip; level < m_mipmapCount; level++)
+		{
+			const VkDeviceSize blockCountX = (std::max(m_dimension.x >> level, 1U) + blockDim - 1) / blockDim;
+			const VkDeviceSize blockCountY = (std::max(m_dimension.y >> level, 1U) + blockDim - 1) / blockDim;
+			size += blockCountX * blockCountY * blockBytes;
+		}
+		return size;
+	}
+
+	std::unique_ptr<VulkanImage> StreamingImageAsset::createMipImage(uint32_t firstMip) const
+	{
+		CHECK(firstMip <= m_tailFirstMip);
+		return createImage(
+			m_format, 
+			m_name, 
+			m_mipmapCount - firstMip,
+			math::max(math::uvec3(m_dimension.x >> firstMip, m_dimension.y >> firstMip, 1U), math::uvec3(1U)));
+	}
+
+	std::unique_ptr<VulkanImage> StreamingImageAsset::swapResidentImage(std::unique_ptr<VulkanImage> image, uint32_t firstMip)
+	{
+		CHECK(image->getInfo().mipLevels == m_mipmapCount - firstMip);
+
+		m_firstResidentMip = firstMip;
+		std::swap(m_image, image);
+
+		return image;
+	}
+
 	RawAssetTextureLoadTask::RawAssetTextureLoadTask()
 	{
 		cacheBin = std::make_unique<AssetTextureBin>();
@@ -328,11 +447,15 @@ namespace engine
 		GPUStaticMeshAsset* fallback,
 		const std::string& name,
 		uint32_t verticesNum,
-		uint32_t indicesNum)
+		uint32_t indicesNum,
+		uint32_t meshletsNum,
+		EVertexFormat vertexFormat)
 		: UploadAssetInterface(fallback)
 		, m_asset(asset)
 		, m_verticesNum(verticesNum)
 		, m_indicesNum(indicesNum)
+		, m_meshletsNum(meshletsNum)
+		, m_vertexFormat(vertexFormat)
 	{
 		// Bindless fetch, transfer copy.
 		auto bufferFlagBasic = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
@@ -346,6 +469,8 @@ namespace engine
 			bufferFlagVMA = {};
 		}
 
+		const bool bCompactVertex = (m_vertexFormat == EVertexFormat_Compact);
+
 		makeComponent(
 			&m_indices,
 			bufferFlagBasic | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
@@ -358,28 +483,39 @@ namespace engine
 			bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 			getRuntimeUniqueGPUAssetName(name + "_positions"),
 			bufferFlagVMA,
-			sizeof(VertexPosition), m_verticesNum);
+			bCompactVertex ? sizeof(VertexPositionCompact) : sizeof(VertexPosition), m_verticesNum);
 
 		makeComponent(
 			&m_normals,
 			bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 			getRuntimeUniqueGPUAssetName(name + "_normals"),
 			bufferFlagVMA,
-			sizeof(VertexNormal), m_verticesNum);
+			bCompactVertex ? sizeof(VertexNormalCompact) : sizeof(VertexNormal), m_verticesNum);
 
 		makeComponent(
 			&m_uv0s,
 			bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 			getRuntimeUniqueGPUAssetName(name + "_uv0s"),
 			bufferFlagVMA,
-			sizeof(VertexUv0), m_verticesNum);
+			bCompactVertex ? sizeof(VertexUv0Compact) : sizeof(VertexUv0), m_verticesNum);
 
 		makeComponent(
 			&m_tangents,
 			bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 			getRuntimeUniqueGPUAssetName(name + "_tangents"),
 			bufferFlagVMA,
-			sizeof(VertexTangent), m_verticesNum);
+			bCompactVertex ? sizeof(VertexTangentCompact) : sizeof(VertexTangent), m_verticesNum);
+
+		// Meshlets only fetch by culling compute shader.
+		if (m_meshletsNum > 0)
+		{
+			makeComponent(
+				&m_meshlets,
+				VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				getRuntimeUniqueGPUAssetName(name + "_meshlets"),
+				{},
+				sizeof(StaticMeshMeshlet), m_meshletsNum);
+		}
 	}
 
 
@@ -397,6 +533,9 @@ namespace engine
 		freeComponent(&m_normals,   bReleasing ? nullptr : fallback->getNormals().buffer.get());
 		freeComponent(&m_uv0s,      bReleasing ? nullptr : fallback->getUV0s().buffer.get());
 		freeComponent(&m_tangents,  bReleasing ? nullptr : fallback->getTangents().buffer.get());
+
+		// Fallback mesh has no meshlet, any storage buffer is fine.
+		freeComponent(&m_meshlets,  bReleasing ? nullptr : fallback->getIndices().buffer.get());
 	}
 
 
@@ -407,7 +546,8 @@ namespace engine
 			+ m_positions.buffer->getSize() 
 			+ m_tangents.buffer->getSize() 
 			+ m_normals.buffer->getSize() 
-			+ uint32_t(m_uv0s.buffer->getSize());
+			+ uint32_t(m_uv0s.buffer->getSize())
+			+ uint32_t(m_meshlets.buffer ? m_meshlets.buffer->getSize() : 0);
 	}
 
 	void GPUStaticMeshAsset::makeComponent(
@@ -623,10 +763,13 @@ namespace engine
 
 				// Describe buffer as array of VertexObj.
 				VkAccelerationStructureGeometryTrianglesDataKHR triangles{ VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR };
-				triangles.vertexFormat = VK_FORMAT_R32G32B32_SFLOAT;  // vec3 vertex position data.
+				// Compact position build in submesh bounds local space, instance transform dequantize it.
+				triangles.vertexFormat = (m_vertexFormat == EVertexFormat_Compact)
+					? VK_FORMAT_R16G16B16A16_SNORM  // snorm16x4 vertex position data.
+					: VK_FORMAT_R32G32B32_SFLOAT;   // vec3 vertex position data.
 				triangles.vertexData.deviceAddress = m_positions.buffer->getDeviceAddress();
 				triangles.vertexStride = m_positions.stripeSize;
-				triangles.indexType = VK_INDEX_TYPE_UINT32;
+				triangles.indexType = submesh.bIndex16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
 				triangles.indexData.deviceAddress = m_indices.buffer->getDeviceAddress();
 				triangles.maxVertex = maxVertex;
 
@@ -637,9 +780,9 @@ namespace engine
 				asGeom.geometry.triangles = triangles;
 
 				VkAccelerationStructureBuildRangeInfoKHR offset{ };
-				offset.firstVertex = 0; // No vertex offset, current all vertex buffer start from zero.
+				offset.firstVertex = submesh.vertexStart; // Submesh indices relative to base vertex.
 				offset.primitiveCount = maxPrimitiveCount;
-				offset.primitiveOffset = submesh.indicesStart * sizeof(VertexIndexType);
+				offset.primitiveOffset = submesh.indicesWordStart * sizeof(uint32_t);
 				offset.transformOffset = 0;
 
 				allBlas[i].asGeometry.emplace_back(asGeom);
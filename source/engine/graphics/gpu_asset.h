@@ -8,6 +8,7 @@
 namespace engine
 {
 	struct StaticMeshRenderBounds;
+	class AssetTexture;
 
 	class UploadAssetInterface : public StorageInterface
 	{
@@ -102,11 +103,68 @@ namespace engine
 		const VulkanImage& getSelfImage() const { return *m_image; }
 		VulkanImage& getSelfImage() { return *m_image; }
 
+	protected:
+		static std::unique_ptr<VulkanImage> createImage(
+			VkFormat           format,
+			const std::string& name,
+			uint32_t           mipmapCount,
+			math::uvec3        dimension);
+
 	protected:
 		// Image handle.
 		std::unique_ptr<VulkanImage> m_image = nullptr;
 	};
 
+	// Texture image only hold mips from first resident mip to the smallest one, TextureStreamingManager stream detail mips.
+	// Resident mips change recreate the image, so bindless index of this asset change too.
+	class StreamingImageAsset : public GPUImageAsset
+	{
+	public:
+		StreamingImageAsset(
+			GPUImageAsset*              fallback,
+			std::weak_ptr<AssetTexture> asset,
+			VkFormat                    format,
+			const std::string&          name,
+			uint32_t                    mipmapCount,
+			math::uvec3                 dimension,
+			uint32_t                    tailFirstMip
+		);
+
+		// Keep tail mips size for LRU, streaming mips count in streaming budget.
+		virtual uint32_t getSize() const override { return m_tailSize; }
+
+		std::shared_ptr<AssetTexture> getAsset() const { return m_asset.lock(); }
+
+		uint32_t getMipmapCount() const { return m_mipmapCount; }
+		const math::uvec3& getDimension() const { return m_dimension; }
+		const std::string& getName() const { return m_name; }
+
+		// Tail mips always resident.
+		uint32_t getTailFirstMip() const { return m_tailFirstMip; }
+		uint32_t getFirstResidentMip() const { return m_firstResidentMip; }
+
+		// Mips memory size from first mip to the smallest one.
+		VkDeviceSize getResidentSize(uint32_t firstMip) const;
+
+		// Create image hold mips from first mip.
+		std::unique_ptr<VulkanImage> createMipImage(uint32_t firstMip) const;
+
+		// Swap in image after streaming upload, return old image which may still used by GPU.
+		std::unique_ptr<VulkanImage> swapResidentImage(std::unique_ptr<VulkanImage> image, uint32_t firstMip);
+
+	protected:
+		std::weak_ptr<AssetTexture> m_asset = {};
+
+		std::string m_name;
+		VkFormat    m_format;
+		uint32_t    m_mipmapCount;
+		math::uvec3 m_dimension;
+		uint32_t    m_tailFirstMip;
+		uint32_t    m_tailSize;
+
+		uint32_t m_firstResidentMip;
+	};
+
 	struct AssetTextureLoadTask : public AssetLoadTask
 	{
 	public:
@@ -197,7 +255,9 @@ namespace engine
 			GPUStaticMeshAsset* fallback,
 			const std::string& name,
 			uint32_t verticesNum,
-			uint32_t indicesNum
+			uint32_t indicesNum,
+			uint32_t meshletsNum = 0,
+			EVertexFormat vertexFormat = EVertexFormat_Float
 		);
 
 		const ComponentBuffer& getIndices() const { return m_indices; }
@@ -206,9 +266,16 @@ namespace engine
 		const ComponentBuffer& getUV0s() const { return m_uv0s; }
 		const ComponentBuffer& getTangents() const { return m_tangents; }
 
+		// Buffer is null when mesh has no meshlet.
+		const ComponentBuffer& getMeshlets() const { return m_meshlets; }
+
 		const uint32_t getVerticesCount() const { return m_verticesNum; }
+		// Index buffer words count, 16 bit indices of submesh pack two in one word.
 		const uint32_t getIndicesCount() const { return m_indicesNum; }
 
+		// Compact vertex stripe size is smaller, shader decode by mesh info vertex format.
+		EVertexFormat getVertexFormat() const { return m_vertexFormat; }
+
 		// Return BLAS cache, if it unbuild, will insert one build task to GPU, which need flush GPU.
 		BLASBuilder& getOrBuilddBLAS();
 		bool isBLASInit() const { return m_blasBuilder.isInit(); }
@@ -233,9 +300,12 @@ namespace engine
 		ComponentBuffer m_normals;
 		ComponentBuffer m_uv0s;
 		ComponentBuffer m_tangents;
+		ComponentBuffer m_meshlets;
 
 		uint32_t m_verticesNum;
 		uint32_t m_indicesNum;
+		uint32_t m_meshletsNum;
+		EVertexFormat m_vertexFormat;
 
 		// Every mesh asset hold one bottom level accelerate structure.
 		BLASBuilder m_blasBuilder;
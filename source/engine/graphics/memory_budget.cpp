@@ -0,0 +1,117 @@
+#include "memory_budget.h"
+#include "context.h"
+#include "../renderer/fsr2_context.h"
+
+#include <profile/profile.h>
+
+namespace engine
+{
+	static AutoCVarInt32 cVarMemoryBudgetEviction(
+		"r.memoryBudget.eviction",
+		"Evict cold gpu assets from lru cache when device local memory over budget target.",
+		"RHI",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarMemoryBudgetTargetPercent(
+		"r.memoryBudget.targetPercent",
+		"Device local memory usage target in percent of driver budget.",
+		"RHI",
+		90,
+		CVarFlags::ReadAndWrite
+	);
+
+	void GPUMemoryBudget::tick(const RuntimeModuleTickData& tickData)
+	{
+		ZoneScopedN("GPUMemoryBudget::tick");
+
+		updateStats();
+
+		if (cVarMemoryBudgetEviction.get() == 0 || m_stats.deviceLocalUsage <= m_stats.targetUsage)
+		{
+			return;
+		}
+
+		// Evicted asset release after in flight frames finish, wait usage report reflect it.
+		if (tickData.tickCount < m_lastEvictionTickCount + getContext()->getBackBufferCount() + 1)
+		{
+			return;
+		}
+
+		const VkDeviceSize overSize = m_stats.deviceLocalUsage - m_stats.targetUsage;
+		const size_t evictedSize = getContext()->getLRU()->evict(overSize);
+
+		m_lastEvictionTickCount = tickData.tickCount;
+		if (evictedSize > 0)
+		{
+			m_stats.evictionCount++;
+			m_stats.evictedSize += evictedSize;
+
+			LOG_TRACE("Device local memory {} MB over budget target, evict {} MB cold gpu assets.", overSize / (1024 * 1024), evictedSize / (1024 * 1024));
+		}
+	}
+
+	void GPUMemoryBudget::updateStats()
+	{
+		VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties { };
+		budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+		VkPhysicalDeviceMemoryProperties2 memoryProperties { };
+		memoryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+		memoryProperties.pNext = &budgetProperties;
+
+		vkGetPhysicalDeviceMemoryProperties2(getContext()->getGPU(), &memoryProperties);
+
+		m_stats.heapCount = memoryProperties.memoryProperties.memoryHeapCount;
+		m_stats.deviceLocalBudget = 0;
+		m_stats.deviceLocalUsage = 0;
+		for (uint32_t i = 0; i < m_stats.heapCount; i++)
+		{
+			auto& heap = m_stats.heaps[i];
+			heap.size = memoryProperties.memoryProperties.memoryHeaps[i].size;
+			heap.budget = budgetProperties.heapBudget[i];
+			heap.usage = budgetProperties.heapUsage[i];
+			heap.bDeviceLocal = (memoryProperties.memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0;
+			heap.vmaBlockSize = 0;
+			heap.vmaAllocationSize = 0;
+
+			if (heap.bDeviceLocal)
+			{
+				m_stats.deviceLocalBudget += heap.budget;
+				m_stats.deviceLocalUsage += heap.usage;
+			}
+
+			m_usageHistory[i][m_historyOffset] = float(double(heap.usage) / (1024.0 * 1024.0));
+		}
+		m_historyOffset = (m_historyOffset + 1) % kHistoryCount;
+
+		const VmaAllocator allocators[] =
+		{
+			getContext()->getVMABuffer(),
+			getContext()->getVMAImage(),
+			getContext()->getVMAFrequencyBuffer(),
+			getContext()->getVMAFrequencyImage(),
+		};
+
+		for (const auto allocator : allocators)
+		{
+			VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+			vmaGetHeapBudgets(allocator, budgets);
+
+			for (uint32_t i = 0; i < m_stats.heapCount; i++)
+			{
+				m_stats.heaps[i].vmaBlockSize += budgets[i].statistics.blockBytes;
+				m_stats.heaps[i].vmaAllocationSize += budgets[i].statistics.allocationBytes;
+			}
+		}
+
+		const int32_t targetPercent = math::clamp(cVarMemoryBudgetTargetPercent.get(), 10, 100);
+		m_stats.targetUsage = m_stats.deviceLocalBudget / 100 * targetPercent;
+
+		m_stats.renderTargetSize = getContext()->getRenderTargetPools().getPooledSize();
+		m_stats.bufferParameterSize = getContext()->getBufferParameters().getPooledSize();
+		m_stats.fsr2Size = getFSR2MemoryUsage();
+		m_stats.lruCacheSize = getContext()->getLRU()->getOwnerUsedSize();
+	}
+}
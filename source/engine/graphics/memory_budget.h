@@ -0,0 +1,77 @@
+#pragma once
+
+#include "resource.h"
+
+#include <array>
+
+namespace engine
+{
+	// Query device memory heap budget and usage of this process every frame by VK_EXT_memory_budget,
+	// when device local usage over target percent of budget, evict cold gpu assets from lru cache.
+	class GPUMemoryBudget : NonCopyable
+	{
+	public:
+		// Usage history frame count of each heap, used to plot.
+		static constexpr uint32_t kHistoryCount = 128;
+
+		struct HeapStats
+		{
+			VkDeviceSize size = 0;
+
+			// Driver reported budget and usage of this process, include memory allocate out of engine.
+			VkDeviceSize budget = 0;
+			VkDeviceSize usage = 0;
+
+			// Engine vma allocators block and allocation size.
+			VkDeviceSize vmaBlockSize = 0;
+			VkDeviceSize vmaAllocationSize = 0;
+
+			bool bDeviceLocal = false;
+		};
+
+		struct Stats
+		{
+			uint32_t heapCount = 0;
+			std::array<HeapStats, VK_MAX_MEMORY_HEAPS> heaps;
+
+			// Sum of device local heaps.
+			VkDeviceSize deviceLocalBudget = 0;
+			VkDeviceSize deviceLocalUsage = 0;
+
+			// Device local usage target, eviction start when over it.
+			VkDeviceSize targetUsage = 0;
+
+			// Known consumers.
+			VkDeviceSize renderTargetSize = 0;
+			VkDeviceSize bufferParameterSize = 0;
+			VkDeviceSize fsr2Size = 0;
+			VkDeviceSize lruCacheSize = 0;
+
+			// Eviction by budget since start.
+			uint64_t evictionCount = 0;
+			VkDeviceSize evictedSize = 0;
+		};
+
+		explicit GPUMemoryBudget() = default;
+
+		void tick(const RuntimeModuleTickData& tickData);
+
+		const Stats& getStats() const { return m_stats; }
+
+		// Usage in MB of heap, ring buffer start at history offset.
+		const float* getUsageHistory(uint32_t heapIndex) const { return m_usageHistory[heapIndex].data(); }
+		uint32_t getHistoryOffset() const { return m_historyOffset; }
+
+	private:
+		void updateStats();
+
+	private:
+		Stats m_stats { };
+
+		std::array<std::array<float, kHistoryCount>, VK_MAX_MEMORY_HEAPS> m_usageHistory { };
+		uint32_t m_historyOffset = 0;
+
+		// Freed memory return to driver after in flight frames finish, no evict again before it.
+		uint64_t m_lastEvictionTickCount = 0;
+	};
+}
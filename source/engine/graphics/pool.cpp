@@ -290,6 +290,42 @@ namespace engine
 		return getSafeReusedNum() * 2;
 	}
 
+	VkDeviceSize RenderTexturePool::getPooledSize() const
+	{
+		VkDeviceSize size = 0;
+		for (const auto* images : { &m_freeImages, &m_busyImages })
+		{
+			for (const auto& [hash, storages] : *images)
+			{
+				for (const auto& storage : storages)
+				{
+					size += storage.image->getSize();
+				}
+			}
+		}
+		return size;
+	}
+
+	VkDeviceSize BufferParameterPool::getPooledSize() const
+	{
+		// Reused buffer own by more than one frame.
+		std::unordered_set<const BufferParameter*> buffers;
+		for (const auto& frameBuffers : m_ownPtr)
+		{
+			for (const auto& buffer : frameBuffers)
+			{
+				buffers.insert(buffer.get());
+			}
+		}
+
+		VkDeviceSize size = 0;
+		for (const auto* buffer : buffers)
+		{
+			size += buffer->getBuffer()->getSize();
+		}
+		return size;
+	}
+
 	BufferParameterPool::BufferParameterPool()
 	{
 		const size_t existNum = getExistNum();
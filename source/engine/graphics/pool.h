@@ -140,6 +140,9 @@ namespace engine
 
 		// Tick update pool resource state.
 		void tick();
+
+		// Device memory size of busy and free pool images.
+		VkDeviceSize getPooledSize() const;
 	};
 
 	using PoolImageSharedRef = std::shared_ptr<RenderTexturePool::PoolImageRef>;
@@ -205,6 +208,9 @@ namespace engine
 
 		void tick();
 
+		// Device memory size of buffers still own by in flight frames.
+		VkDeviceSize getPooledSize() const;
+
 		std::shared_ptr<BufferParameter> getParameter(
 			const char* name,
 			size_t bufferSize,
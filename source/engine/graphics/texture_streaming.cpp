@@ -0,0 +1,459 @@
+#include "texture_streaming.h"
+#include "context.h"
+#include <engine/asset/asset_texture.h>
+
+namespace engine
+{
+	static AutoCVarInt32 cVarTextureStreaming(
+		"r.textureStreaming",
+		"Enable texture streaming for texture load after set, 0 load all mips.",
+		"Rendering",
+		1,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarTextureStreamingBudgetMB(
+		"r.textureStreaming.budgetMB",
+		"Streaming texture resident mips memory budget in MB.",
+		"Rendering",
+		1024,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarTextureStreamingTailSize(
+		"r.textureStreaming.tailSize",
+		"Streaming texture mips no bigger than this size always resident.",
+		"Rendering",
+		128,
+		CVarFlags::ReadAndWrite
+	);
+
+	static AutoCVarInt32 cVarTextureStreamingMaxInFlight(
+		"r.textureStreaming.maxInFlight",
+		"Max streaming texture upload tasks in flight.",
+		"Rendering",
+		8,
+		CVarFlags::ReadAndWrite
+	);
+
+	// Feedback readbacks count of one wanted mip window, texture not request in window can evict.
+	static constexpr uint32_t kFeedbackWindowSize = 64;
+
+	TextureStreamingManager::~TextureStreamingManager()
+	{
+		m_feedbackReadbacks.clear();
+		m_retiredImages.clear();
+		m_textures.clear();
+	}
+
+	bool TextureStreamingManager::isEnable()
+	{
+		return cVarTextureStreaming.get() != 0;
+	}
+
+	uint32_t TextureStreamingManager::getTailFirstMip(const math::uvec3& dimension, uint32_t mipmapCount)
+	{
+		if (dimension.z != 1U || mipmapCount <= 1)
+		{
+			return 0;
+		}
+
+		const uint32_t tailSize = (uint32_t)math::max(cVarTextureStreamingTailSize.get(), 1);
+
+		uint32_t firstMip = 0;
+		while (firstMip + 1 < mipmapCount && math::max(dimension.x >> firstMip, dimension.y >> firstMip) > tailSize)
+		{
+			firstMip++;
+		}
+		return firstMip;
+	}
+
+	void TextureStreamingManager::registerTexture(std::shared_ptr<StreamingImageAsset> texture)
+	{
+		std::lock_guard<std::mutex> lock(m_registerLock);
+		m_registerTextures.push_back(texture);
+	}
+
+	BufferParameterHandle TextureStreamingManager::beginFeedback(VkCommandBuffer cmd)
+	{
+		const uint32_t feedbackCount = getContext()->getBindlessTexture().getMaxCount();
+
+		auto feedback = getContext()->getBufferParameters().getParameter("TextureStreamingFeedback", sizeof(uint32_t) * feedbackCount,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, {});
+
+		// Shader atomic min finest mip, ~0 mean texture no sampled.
+		vkCmdFillBuffer(cmd, *feedback->getBuffer(), 0, feedback->getBuffer()->getSize(), ~0u);
+
+		auto fillBarrier = RHIBufferBarrier(feedback->getBuffer()->getVkBuffer(),
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+		RHIPipelineBarrier(cmd, 0, 1, &fillBarrier, 0, nullptr);
+
+		return feedback;
+	}
+
+	void TextureStreamingManager::endFeedback(VkCommandBuffer cmd, BufferParameterHandle feedback)
+	{
+		if (!isEnable())
+		{
+			return;
+		}
+
+		const VkDeviceSize feedbackSize = feedback->getBuffer()->getSize();
+
+		// Copy to host visible buffer, read back some frames later.
+		auto readback = getContext()->getBufferParameters().getParameter("TextureStreamingFeedbackReadback", feedbackSize,
+			VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VulkanBuffer::getReadBackFlags());
+
+		auto feedbackBarrier = RHIBufferBarrier(feedback->getBuffer()->getVkBuffer(),
+			VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+		RHIPipelineBarrier(cmd, 0, 1, &feedbackBarrier, 0, nullptr);
+
+		VkBufferCopy copyRegion = {};
+		copyRegion.size = feedbackSize;
+		vkCmdCopyBuffer(cmd, feedback->getBuffer()->getVkBuffer(), readback->getBuffer()->getVkBuffer(), 1, &copyRegion);
+
+		auto readbackBarrier = RHIBufferBarrier(readback->getBuffer()->getVkBuffer(),
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+			VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+		RHIPipelineBarrier(cmd, 0, 1, &readbackBarrier, 0, nullptr);
+
+		m_feedbackReadbacks.push_back({ readback, m_tickCount });
+	}
+
+	void TextureStreamingManager::onStreamingFinished(
+		std::shared_ptr<StreamingImageAsset> texture,
+		std::unique_ptr<VulkanImage> image,
+		uint32_t firstMip)
+	{
+		auto& entry = m_textures[texture.get()];
+		entry.texture = texture;
+
+		RetiredImage retired { };
+		retired.texture    = texture;
+		retired.bindless   = entry.bindless;
+		retired.firstMip   = texture->getFirstResidentMip();
+		retired.retireTick = m_tickCount;
+		retired.image      = texture->swapResidentImage(std::move(image), firstMip);
+		m_retiredImages.push_back(std::move(retired));
+
+		entry.bindless = texture->getBindlessIndex();
+		entry.pendingFirstMip = ~0U;
+
+		m_residencyVersion++;
+	}
+
+	void TextureStreamingManager::tick(const RuntimeModuleTickData& tickData)
+	{
+		m_tickCount++;
+
+		{
+			std::lock_guard<std::mutex> lock(m_registerLock);
+			for (auto& texture : m_registerTextures)
+			{
+				StreamingTexture entry { };
+				entry.texture = texture;
+				m_textures[texture.get()] = entry;
+			}
+			m_registerTextures.clear();
+		}
+
+		// Read back feedback of frames ago, gpu already finish them so no wait.
+		while (m_feedbackReadbacks.size() > getContext()->getBackBufferCount() + 1)
+		{
+			auto* readbackBuffer = m_feedbackReadbacks.front().buffer->getBuffer();
+			readbackBuffer->map();
+			{
+				readbackBuffer->invalidate();
+				processFeedback((const uint32_t*)readbackBuffer->getMapped(), uint32_t(readbackBuffer->getSize() / sizeof(uint32_t)));
+			}
+			readbackBuffer->unmap();
+
+			m_feedbackReadbacks.pop_front();
+		}
+
+		// Release retired image when frames in flight finish and feedback reference it already read back.
+		std::erase_if(m_retiredImages, [&](const RetiredImage& retired)
+		{
+			const bool bFeedbackPending = !m_feedbackReadbacks.empty() && m_feedbackReadbacks.front().tick <= retired.retireTick;
+			return !bFeedbackPending && retired.retireTick + getContext()->getBackBufferCount() + 1 < m_tickCount;
+		});
+
+		updateResidency();
+	}
+
+	void TextureStreamingManager::processFeedback(const uint32_t* feedback, uint32_t count)
+	{
+		auto applyRequest = [&](const StreamingImageAsset* texture, uint32_t bindless, uint32_t firstMip)
+		{
+			if (bindless >= count || feedback[bindless] == ~0U)
+			{
+				return;
+			}
+
+			auto iter = m_textures.find(texture);
+			if (iter == m_textures.end())
+			{
+				return;
+			}
+
+			// Feedback lod relative to sampled image first mip.
+			const int32_t mip = int32_t(firstMip + feedback[bindless]) - int32_t(kTextureStreamingFeedbackLodOffset);
+			const uint32_t wantedMip = (uint32_t)math::clamp(mip, 0, int32_t(texture->getMipmapCount()) - 1);
+
+			auto& entry = iter->second;
+			entry.wantedMip       = math::min(entry.wantedMip, wantedMip);
+			entry.windowWantedMip = math::min(entry.windowWantedMip, wantedMip);
+			entry.lastWantedTick  = m_tickCount;
+		};
+
+		for (auto& [key, entry] : m_textures)
+		{
+			auto texture = entry.texture.lock();
+			if (!texture || !texture->isAssetReady())
+			{
+				continue;
+			}
+
+			if (entry.bindless == ~0U)
+			{
+				entry.bindless = texture->getBindlessIndex();
+			}
+			applyRequest(texture.get(), entry.bindless, texture->getFirstResidentMip());
+		}
+
+		// Feedback may record before image swap.
+		for (const auto& retired : m_retiredImages)
+		{
+			if (auto texture = retired.texture.lock())
+			{
+				applyRequest(texture.get(), retired.bindless, retired.firstMip);
+			}
+		}
+
+		// Wanted mip only keep finest request of last window, so texture far away can drop top mips.
+		m_feedbackCount++;
+		if (m_feedbackCount % kFeedbackWindowSize == 0)
+		{
+			for (auto& [key, entry] : m_textures)
+			{
+				entry.wantedMip = entry.windowWantedMip;
+				entry.windowWantedMip = ~0U;
+			}
+		}
+	}
+
+	bool TextureStreamingManager::requestMip(std::shared_ptr<StreamingImageAsset> texture, StreamingTexture& entry, uint32_t firstMip)
+	{
+		auto asset = texture->getAsset();
+		if (!asset)
+		{
+			return false;
+		}
+
+		auto newTask = std::make_shared<AssetTextureStreamingLoadTask>();
+		newTask->texture    = texture;
+		newTask->cacheAsset = asset;
+		newTask->image      = texture->createMipImage(firstMip);
+		newTask->firstMip   = firstMip;
+
+		entry.pendingFirstMip = firstMip;
+		getContext()->getAsyncUploader().addTask(newTask);
+
+		return true;
+	}
+
+	void TextureStreamingManager::updateResidency()
+	{
+		m_stats = { };
+		m_stats.budgetSize = VkDeviceSize(math::max(cVarTextureStreamingBudgetMB.get(), 0)) * 1024 * 1024;
+
+		struct Candidate
+		{
+			std::shared_ptr<StreamingImageAsset> texture;
+			StreamingTexture* entry;
+			uint32_t targetMip;
+		};
+		std::vector<Candidate> candidates { };
+
+		// Size when all in flight tasks finish.
+		VkDeviceSize projectedSize = 0;
+		for (auto iter = m_textures.begin(); iter != m_textures.end();)
+		{
+			// Remove texture already release, it may release on other thread after feedback read back.
+			// Texture in flight still owned by task.
+			auto& entry = iter->second;
+			auto texture = entry.texture.lock();
+			if (!texture)
+			{
+				iter = m_textures.erase(iter);
+				continue;
+			}
+			++iter;
+
+			const uint32_t firstMip = texture->getFirstResidentMip();
+			const uint32_t targetMip = math::min(entry.wantedMip, texture->getTailFirstMip());
+
+			m_stats.textureCount++;
+			m_stats.fullyResidentCount += (firstMip == 0) ? 1 : 0;
+			m_stats.residentSize += texture->getResidentSize(firstMip);
+			m_stats.wantedSize += texture->getResidentSize(targetMip);
+
+			if (entry.pendingFirstMip != ~0U)
+			{
+				m_stats.pendingCount++;
+				projectedSize += texture->getResidentSize(entry.pendingFirstMip);
+			}
+			else
+			{
+				projectedSize += texture->getResidentSize(firstMip);
+				if (texture->isAssetReady())
+				{
+					candidates.push_back({ texture, &entry, targetMip });
+				}
+			}
+		}
+
+		if (!isEnable())
+		{
+			return;
+		}
+
+		const uint32_t maxInFlight = (uint32_t)math::max(cVarTextureStreamingMaxInFlight.get(), 1);
+		auto trySetResidentMip = [&](Candidate& candidate, uint32_t firstMip)
+		{
+			if (m_stats.pendingCount >= maxInFlight)
+			{
+				return false;
+			}
+
+			const uint32_t oldFirstMip = candidate.texture->getFirstResidentMip();
+			if (!requestMip(candidate.texture, *candidate.entry, firstMip))
+			{
+				return false;
+			}
+
+			projectedSize -= candidate.texture->getResidentSize(oldFirstMip);
+			projectedSize += candidate.texture->getResidentSize(firstMip);
+			m_stats.pendingCount++;
+			return true;
+		};
+
+		// Texture resident more than wanted, not wanted for longest time first.
+		std::vector<Candidate*> overResidents { };
+		std::vector<Candidate*> underResidents { };
+		for (auto& candidate : candidates)
+		{
+			const uint32_t firstMip = candidate.texture->getFirstResidentMip();
+			if (firstMip < candidate.targetMip)
+			{
+				overResidents.push_back(&candidate);
+			}
+			else if (firstMip > candidate.targetMip)
+			{
+				underResidents.push_back(&candidate);
+			}
+		}
+		std::sort(overResidents.begin(), overResidents.end(), [](const Candidate* a, const Candidate* b)
+		{
+			return a->entry->lastWantedTick < b->entry->lastWantedTick;
+		});
+
+		// Drop unwanted top mips when over budget.
+		size_t overResidentIndex = 0;
+		auto evictOverResident = [&](uint64_t lastWantedTick)
+		{
+			while (overResidentIndex < overResidents.size())
+			{
+				auto* victim = overResidents[overResidentIndex];
+				if (victim->entry->lastWantedTick > lastWantedTick)
+				{
+					return false;
+				}
+
+				overResidentIndex++;
+				if (trySetResidentMip(*victim, victim->targetMip))
+				{
+					return true;
+				}
+			}
+			return false;
+		};
+		while (projectedSize > m_stats.budgetSize && evictOverResident(~0ULL)) { }
+
+		// Still over budget, drop one top mip of wanted texture, least recently wanted first.
+		if (projectedSize > m_stats.budgetSize)
+		{
+			std::vector<Candidate*> residents { };
+			for (auto& candidate : candidates)
+			{
+				const uint32_t firstMip = candidate.texture->getFirstResidentMip();
+				if (candidate.entry->pendingFirstMip == ~0U && firstMip < candidate.texture->getTailFirstMip())
+				{
+					residents.push_back(&candidate);
+				}
+			}
+			std::sort(residents.begin(), residents.end(), [](const Candidate* a, const Candidate* b)
+			{
+				return a->entry->lastWantedTick < b->entry->lastWantedTick;
+			});
+
+			for (auto* candidate : residents)
+			{
+				if (projectedSize <= m_stats.budgetSize)
+				{
+					break;
+				}
+				trySetResidentMip(*candidate, candidate->texture->getFirstResidentMip() + 1);
+			}
+			return;
+		}
+
+		// Stream in, texture miss most mips first, then recently wanted first.
+		std::sort(underResidents.begin(), underResidents.end(), [](const Candidate* a, const Candidate* b)
+		{
+			const uint32_t missA = a->texture->getFirstResidentMip() - a->targetMip;
+			const uint32_t missB = b->texture->getFirstResidentMip() - b->targetMip;
+			if (missA != missB)
+			{
+				return missA > missB;
+			}
+			return a->entry->lastWantedTick > b->entry->lastWantedTick;
+		});
+
+		for (auto* candidate : underResidents)
+		{
+			if (m_stats.pendingCount >= maxInFlight)
+			{
+				break;
+			}
+
+			const uint32_t firstMip = candidate->texture->getFirstResidentMip();
+			const VkDeviceSize residentSize = candidate->texture->getResidentSize(firstMip);
+
+			// Make room from texture which no longer wanted.
+			while (projectedSize - residentSize + candidate->texture->getResidentSize(candidate->targetMip) > m_stats.budgetSize)
+			{
+				if (!evictOverResident(candidate->entry->lastWantedTick))
+				{
+					break;
+				}
+			}
+
+			// Stream as many mips as budget fit.
+			uint32_t newFirstMip = candidate->targetMip;
+			while (newFirstMip < firstMip && projectedSize - residentSize + candidate->texture->getResidentSize(newFirstMip) > m_stats.budgetSize)
+			{
+				newFirstMip++;
+			}
+
+			if (newFirstMip < firstMip)
+			{
+				trySetResidentMip(*candidate, newFirstMip);
+			}
+		}
+	}
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "gpu_asset.h"
+#include "pool.h"
+
+#include <deque>
+
+namespace engine
+{
+	// Texture streaming keep tail mips of streaming texture resident, detail mips stream in by GPU feedback.
+	// GBuffer pass write finest sampled mip of each bindless texture into feedback buffer, read back some frames later.
+	// When resident mips over budget, evict top mips of texture not wanted for longest time first.
+	class TextureStreamingManager : NonCopyable
+	{
+	public:
+		struct Stats
+		{
+			// Streaming texture alive count.
+			uint32_t textureCount = 0;
+
+			// Streaming texture which mip 0 resident.
+			uint32_t fullyResidentCount = 0;
+
+			// Streaming tasks in flight.
+			uint32_t pendingCount = 0;
+
+			// Resident mips memory size of all streaming textures.
+			VkDeviceSize residentSize = 0;
+
+			// Memory size when all wanted mips resident.
+			VkDeviceSize wantedSize = 0;
+
+			VkDeviceSize budgetSize = 0;
+		};
+
+		explicit TextureStreamingManager() = default;
+		~TextureStreamingManager();
+
+		// Is new texture load as streaming texture.
+		static bool isEnable();
+
+		// Streaming texture first resident mip when load, return 0 if texture too small to stream.
+		static uint32_t getTailFirstMip(const math::uvec3& dimension, uint32_t mipmapCount);
+
+		// Thread safe, texture will manage by streaming from next tick.
+		void registerTexture(std::shared_ptr<StreamingImageAsset> texture);
+
+		void tick(const RuntimeModuleTickData& tickData);
+
+		// Clear feedback buffer before gbuffer pass, buffer size is bindless texture max count.
+		BufferParameterHandle beginFeedback(VkCommandBuffer cmd);
+
+		// Copy feedback to readback buffer after gbuffer pass.
+		void endFeedback(VkCommandBuffer cmd, BufferParameterHandle feedback);
+
+		// Call from streaming load task finish callback.
+		void onStreamingFinished(std::shared_ptr<StreamingImageAsset> texture, std::unique_ptr<VulkanImage> image, uint32_t firstMip);
+
+		// Increase when any streaming texture swap image, material should refresh bindless index.
+		uint64_t getResidencyVersion() const { return m_residencyVersion; }
+
+		const Stats& getStats() const { return m_stats; }
+
+	private:
+		struct StreamingTexture
+		{
+			std::weak_ptr<StreamingImageAsset> texture;
+
+			// Bindless index of resident image, ~0 when texture not ready.
+			uint32_t bindless = ~0U;
+
+			// Finest mip request by feedback, ~0 when no request.
+			uint32_t wantedMip = ~0U;
+
+			// Finest mip request in current feedback window.
+			uint32_t windowWantedMip = ~0U;
+
+			// First mip of streaming task in flight, ~0 when idle.
+			uint32_t pendingFirstMip = ~0U;
+
+			// Last tick feedback request this texture.
+			uint64_t lastWantedTick = 0;
+		};
+
+		struct RetiredImage
+		{
+			std::weak_ptr<StreamingImageAsset> texture;
+			std::unique_ptr<VulkanImage> image;
+
+			uint32_t bindless;
+			uint32_t firstMip;
+			uint64_t retireTick;
+		};
+
+		struct FeedbackReadback
+		{
+			BufferParameterHandle buffer;
+			uint64_t tick;
+		};
+
+		void processFeedback(const uint32_t* feedback, uint32_t count);
+		void updateResidency();
+		bool requestMip(std::shared_ptr<StreamingImageAsset> texture, StreamingTexture& entry, uint32_t firstMip);
+
+	private:
+		std::mutex m_registerLock;
+		std::vector<std::shared_ptr<StreamingImageAsset>> m_registerTextures;
+
+		std::unordered_map<const StreamingImageAsset*, StreamingTexture> m_textures;
+
+		// Old image swap out, keep until GPU and feedback readback no longer use it.
+		std::vector<RetiredImage> m_retiredImages;
+
+		std::deque<FeedbackReadback> m_feedbackReadbacks;
+		uint32_t m_feedbackCount = 0;
+
+		uint64_t m_tickCount = 0;
+		uint64_t m_residencyVersion = 0;
+
+		Stats m_stats = { };
+	};
+}
@@ -12,6 +12,14 @@ namespace engine
 
 	static AutoCVarCmd cVarFSRReset("cmd.fsr.reset", "Reset fsr.");
 
+	// Device memory of all live fsr2 contexts, fsr2 allocate out of engine vma.
+	static std::atomic<VkDeviceSize> sFSR2MemoryUsage = 0;
+
+	VkDeviceSize engine::getFSR2MemoryUsage()
+	{
+		return sFSR2MemoryUsage.load();
+	}
+
 	static VkDeviceSize getMemoryUsageSnapshot(VkPhysicalDevice physicalDevice)
 	{
 		// check if VK_EXT_memory_budget is enabled
@@ -46,7 +54,7 @@ namespace engine
 
 		vkGetPhysicalDeviceMemoryProperties2(physicalDevice, &memoryProperties);
 
-		for (uint32_t i = 0; i < memoryProperties.memoryProperties.memoryTypeCount; i++)
+		for (uint32_t i = 0; i < memoryProperties.memoryProperties.memoryHeapCount; i++)
 			memoryUsage += memoryBudgetProperties.heapUsage[i];
 
 		return memoryUsage;
@@ -95,7 +103,8 @@ namespace engine
 		const uint64_t memoryUsageBefore = getMemoryUsageSnapshot(getContext()->getGPU());
 		ffxFsr2ContextCreate(&m_context, &m_initializationParameters);
 		const uint64_t memoryUsageAfter = getMemoryUsageSnapshot(getContext()->getGPU());
-		m_memoryUsageInMegabytes = (memoryUsageAfter - memoryUsageBefore) * 0.000001f;
+		m_memoryUsage = memoryUsageAfter > memoryUsageBefore ? memoryUsageAfter - memoryUsageBefore : 0;
+		sFSR2MemoryUsage += m_memoryUsage;
 	}
 
 	void FSR2Context::onDestroyWindowSizeDependentResources()
@@ -109,6 +118,9 @@ namespace engine
 			ffxFsr2ContextDestroy(&m_context);
 			free(m_initializationParameters.callbacks.scratchBuffer);
 			m_initializationParameters.callbacks.scratchBuffer = nullptr;
+
+			sFSR2MemoryUsage -= m_memoryUsage;
+			m_memoryUsage = 0;
 		}
 	}
 
@@ -74,6 +74,9 @@ namespace engine
 
 
 	// FSR2 Context for renderer.
+	// Device memory size of all live fsr2 contexts.
+	extern VkDeviceSize getFSR2MemoryUsage();
+
 	class FSR2Context : NonCopyable
 	{
 	public:
@@ -99,6 +102,6 @@ namespace engine
 	private:
 		FfxFsr2ContextDescription m_initializationParameters = {};
 		FfxFsr2Context m_context;
-		float m_memoryUsageInMegabytes = 0.0f;
+		VkDeviceSize m_memoryUsage = 0;
 	};
 }
\ No newline at end of file
@@ -8,6 +8,40 @@ namespace engine
 {
 	constexpr float kDepthBiasClampMin = 0.0f;
 
+	static AutoCVarFloat cVarShadowLodErrorPixels(
+		"r.shadow.lodErrorPixels",
+		"Static mesh select coarsest LOD whose projected simplify error in main view no bigger than this pixels when draw shadow depth.",
+		"Rendering",
+		1.0f,
+		CVarFlags::ReadAndWrite);
+
+	static AutoCVarString cVarShadowCascadeLodBias(
+		"r.shadow.cascadeLodBias",
+		"Comma separated static mesh LOD bias per cascade, cascade without value use last one.",
+		"Rendering",
+		"0,0,1,1,2,2,3,3",
+		CVarFlags::ReadAndWrite);
+
+	static int32_t getCascadeLodBias(uint32_t cascadeId)
+	{
+		const std::string lodBias = cVarShadowCascadeLodBias.get();
+
+		int32_t result = 0;
+		size_t start = 0;
+		for (uint32_t i = 0; i <= cascadeId && start < lodBias.size(); i++)
+		{
+			size_t end = lodBias.find(',', start);
+			if (end == std::string::npos)
+			{
+				end = lodBias.size();
+			}
+
+			result = std::atoi(lodBias.substr(start, end - start).c_str());
+			start = end + 1;
+		}
+		return result;
+	}
+
 	static_assert(kMaxCascadeNum % 4 == 0);
 	struct GPUSDSMPushConst
 	{
@@ -31,6 +65,11 @@ namespace engine
 		uint contactShadowSampleNum;
 		uint bContactShadow;
 		uint bCloudShadow;
+
+		float lodErrorPixels;
+		int lodBias;
+		uint pad0;
+		uint pad1;
 	};
 	static_assert(sizeof(GPUSDSMPushConst) <= kMaxPushConstSize);
 
@@ -248,7 +287,8 @@ namespace engine
 				.contactShadowLength = skyInfo.cascadeConfig.contactShadowLen,
 				.contactShadowSampleNum = (uint)skyInfo.cascadeConfig.contactShadowSampleNum,
 				.bContactShadow = (uint)skyInfo.cascadeConfig.bContactShadow,
-				.bCloudShadow = (uint)(sunCloudShadowDepth != nullptr)
+				.bCloudShadow = (uint)(sunCloudShadowDepth != nullptr),
+				.lodErrorPixels = math::max(cVarShadowLodErrorPixels.get(), 0.0f),
 			};
 
 			
@@ -316,6 +356,7 @@ namespace engine
 			{
 				// Update push const.
 				pushConst.cascadeId = i;
+				pushConst.lodBias = getCascadeLodBias(i);
 
 				// Culling.
 				{
@@ -3,11 +3,48 @@
 #include "../renderer.h"
 #include "../scene_textures.h"
 
+#include <deque>
+
 namespace engine
 {
+    static AutoCVarInt32 cVarMeshletCulling(
+        "r.staticmesh.meshletCulling",
+        "Enable static mesh meshlet culling, mesh without meshlet still cull per object.",
+        "Rendering",
+        1,
+        CVarFlags::ReadAndWrite);
+
+    static AutoCVarInt32 cVarMeshletConeCulling(
+        "r.staticmesh.meshletConeCulling",
+        "Enable meshlet backface culling by normal cone, gbuffer draw no cull face so two side mesh will lost faces.",
+        "Rendering",
+        0,
+        CVarFlags::ReadAndWrite);
+
+    static AutoCVarFloat cVarLodErrorPixels(
+        "r.staticmesh.lodErrorPixels",
+        "Static mesh select coarsest LOD whose projected simplify error no bigger than this pixels.",
+        "Rendering",
+        1.0f,
+        CVarFlags::ReadAndWrite);
+
+    static AutoCVarInt32 cVarLodBias(
+        "r.staticmesh.lodBias",
+        "Static mesh LOD bias add to screen size selected LOD, positive use coarser LOD, -3 force LOD0.",
+        "Rendering",
+        0,
+        CVarFlags::ReadAndWrite);
+
+    static AutoCVarCmd cVarMeshletCullStat(
+        "cmd.r.staticmesh.meshletCullStat", 
+        "Log static mesh meshlet culling stat of gbuffer pass.");
+
     struct GPUCullingPrepassPushConstants
     {
         uint32_t cullCount;
+        uint32_t bMeshletCull;
+        float lodErrorPixels;
+        int32_t lodBias;
     };
 
     struct GPUCullingGbufferPushConstants
@@ -15,6 +52,16 @@ namespace engine
         uint32_t cullCount;
         uint32_t hzbMipCount;
         glm::vec2 hzbSrcSize;
+        uint32_t bMeshletCull;
+        float lodErrorPixels;
+        int32_t lodBias;
+    };
+
+    struct GPUMeshletCullPushConstants
+    {
+        uint32_t bConeCull;
+        uint32_t hzbMipCount;
+        glm::vec2 hzbSrcSize;
     };
 
     class StaticMeshPass : public PassInterface
@@ -28,7 +75,12 @@ namespace engine
         std::unique_ptr<ComputePipeResources> gbuffer_cull;
         std::unique_ptr<GraphicPipeResources> gbuffer;
 
+        std::unique_ptr<ComputePipeResources> prepass_meshlet_cull;
+        std::unique_ptr<ComputePipeResources> gbuffer_meshlet_cull;
 
+        // Meshlet culling stat readback buffers in flight, and last stat already read back.
+        std::deque<BufferParameterHandle> meshletCullStatReadbacks;
+        StaticMeshMeshletCullStat meshletCullStat = { };
 
     protected:
         virtual void onInit() override
@@ -40,6 +92,8 @@ namespace engine
                     .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1) // objectDatas
                     .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2) // indirectCommands
                     .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3) // drawCount
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4) // meshletCullObjects
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5) // meshletCullDispatch
                     .buildNoInfoPush(prepassCullSetLayout);
 
                 ShaderVariant shaderVariant("shader/static_mesh.glsl");
@@ -94,6 +148,8 @@ namespace engine
                     .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 4) // inHzb
                     .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 5) // indirectCommands
                     .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 6) // drawCount
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 7) // meshletCullObjects
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 8) // meshletCullDispatch
                     .buildNoInfoPush(gbufferCullSetLayout);
 
                 ShaderVariant shaderVariant("shader/static_mesh.glsl");
@@ -111,6 +167,7 @@ namespace engine
                     .bindNoInfo(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0) // frameData
                     .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1) // objectDatas
                     .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2) // indirectCommands
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3) // textureStreamingFeedback
                     .buildNoInfoPush(gbufferSetLayout);
 
                 ShaderVariant vertexShaderVariant("shader/static_mesh.glsl");
@@ -153,6 +210,46 @@ namespace engine
                     VK_CULL_MODE_NONE,
                     VK_COMPARE_OP_GREATER_OR_EQUAL);
             }
+
+            {
+                VkDescriptorSetLayout prepassMeshletCullSetLayout = VK_NULL_HANDLE;
+                getContext()->descriptorFactoryBegin()
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0) // frameData
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1) // objectDatas
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2) // indirectCommands
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3) // drawCount
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4) // meshletCullObjects
+                    .buildNoInfoPush(prepassMeshletCullSetLayout);
+
+                ShaderVariant shaderVariant("shader/static_mesh.glsl");
+                shaderVariant.setStage(EShaderStage::eComputeShader).setMacro(L"STATIC_MESH_PREPASS_MESHLET_CULL_PASS");
+
+                prepass_meshlet_cull = std::make_unique<ComputePipeResources>(
+                    shaderVariant,
+                    (uint32_t)sizeof(GPUMeshletCullPushConstants),
+                    std::vector<VkDescriptorSetLayout>{ prepassMeshletCullSetLayout, m_context->getBindlessSSBOSetLayout() });
+            }
+
+            {
+                VkDescriptorSetLayout gbufferMeshletCullSetLayout = VK_NULL_HANDLE;
+                getContext()->descriptorFactoryBegin()
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 0) // frameData
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1) // objectDatas
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2) // indirectCommands
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3) // drawCount
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4) // meshletCullObjects
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 5) // inHzb
+                    .bindNoInfo(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 6) // meshletCullStat
+                    .buildNoInfoPush(gbufferMeshletCullSetLayout);
+
+                ShaderVariant shaderVariant("shader/static_mesh.glsl");
+                shaderVariant.setStage(EShaderStage::eComputeShader).setMacro(L"STATIC_MESH_GBUFFER_MESHLET_CULL_PASS");
+
+                gbuffer_meshlet_cull = std::make_unique<ComputePipeResources>(
+                    shaderVariant,
+                    (uint32_t)sizeof(GPUMeshletCullPushConstants),
+                    std::vector<VkDescriptorSetLayout>{ gbufferMeshletCullSetLayout, m_context->getBindlessSSBOSetLayout() });
+            }
         }
 
         virtual void release() override
@@ -162,9 +259,60 @@ namespace engine
 
             gbuffer_cull.reset();
             gbuffer.reset();
+
+            prepass_meshlet_cull.reset();
+            gbuffer_meshlet_cull.reset();
+
+            meshletCullStatReadbacks.clear();
         }
     };
 
+    // Object with meshlets draw each visible meshlet, others draw whole object.
+    static uint32_t getStaticMeshMaxDrawCount(const RenderScene* scene, bool bMeshletCull)
+    {
+        const auto& objects = scene->getObjectCollector();
+        if (!bMeshletCull)
+        {
+            return (uint32_t)objects.size();
+        }
+
+        uint32_t maxDrawCount = 0;
+        for (const auto& object : objects)
+        {
+            maxDrawCount += std::max(1U, object.meshInfoData.meshletCount);
+        }
+        return maxDrawCount;
+    }
+
+    // Barrier between object culling and meshlet culling.
+    static void meshletCullBeginBarrier(
+        VkCommandBuffer cmd,
+        BufferParameterHandle indirectDrawCommandBuffer,
+        BufferParameterHandle indirectDrawCountBuffer,
+        BufferParameterHandle meshletCullObjectsBuffer,
+        BufferParameterHandle meshletCullDispatchBuffer)
+    {
+        std::array<VkBufferMemoryBarrier2, 4> barriers
+        {
+            RHIBufferBarrier(indirectDrawCommandBuffer->getBuffer()->getVkBuffer(),
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT),
+
+            RHIBufferBarrier(indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+
+            RHIBufferBarrier(meshletCullObjectsBuffer->getBuffer()->getVkBuffer(),
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT),
+
+            RHIBufferBarrier(meshletCullDispatchBuffer->getBuffer()->getVkBuffer(),
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT),
+        };
+        RHIPipelineBarrier(cmd, 0, (uint32_t)barriers.size(), barriers.data(), 0, nullptr);
+    }
+
     void engine::renderStaticMeshPrepass(
         VkCommandBuffer cmd, 
         GBufferTextures* inGBuffers, 
@@ -181,12 +329,21 @@ namespace engine
         auto& sceneDepthZ = inGBuffers->depthTexture->getImage();
         VkRenderingAttachmentInfo depthAttachment = getDepthAttachment(sceneDepthZ);
 
+        const bool bMeshletCull = cVarMeshletCulling.get() != 0;
+        const uint32_t maxDrawCount = getStaticMeshMaxDrawCount(scene, bMeshletCull);
+
         auto indirectDrawCommandBuffer = getContext()->getBufferParameters().getIndirectStorage(
-            "StaticMeshIndirectCommand_Prepass", sizeof(StaticMeshDrawCommand) * objectCount);
+            "StaticMeshIndirectCommand_Prepass", sizeof(StaticMeshDrawCommand) * maxDrawCount);
 
         auto indirectDrawCountBuffer = getContext()->getBufferParameters().getIndirectStorage(
             "StaticMeshIndirectCount_Prepass", sizeof(uint32_t));
 
+        auto meshletCullObjectsBuffer = getContext()->getBufferParameters().getIndirectStorage(
+            "StaticMeshMeshletCullObjects_Prepass", sizeof(uint32_t) * objectCount);
+
+        auto meshletCullDispatchBuffer = getContext()->getBufferParameters().getIndirectStorage(
+            "StaticMeshMeshletCullDispatch_Prepass", sizeof(uint32_t) * 3);
+
         auto* pass = getContext()->getPasses().get<StaticMeshPass>();
 
         // Culling.
@@ -194,16 +351,27 @@ namespace engine
             ScopePerframeMarker staticMeshGBufferCullingMarker(cmd, "StaticMeshCulling_prepass", { 1.0f, 0.0f, 0.0f, 1.0f }, timer);
 
             vkCmdFillBuffer(cmd, *indirectDrawCountBuffer->getBuffer(), 0, indirectDrawCountBuffer->getBuffer()->getSize(), 0u);
+            vkCmdFillBuffer(cmd, *meshletCullDispatchBuffer->getBuffer(), 0, meshletCullDispatchBuffer->getBuffer()->getSize(), 0u);
 
-            auto fillBarriers = RHIBufferBarrier(indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
-                VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
-                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
-            RHIPipelineBarrier(cmd, 0, 1, &fillBarriers, 0, nullptr);
+            std::array<VkBufferMemoryBarrier2, 2> fillBarriers
+            {
+                RHIBufferBarrier(indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+
+                RHIBufferBarrier(meshletCullDispatchBuffer->getBuffer()->getVkBuffer(),
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+            };
+            RHIPipelineBarrier(cmd, 0, (uint32_t)fillBarriers.size(), fillBarriers.data(), 0, nullptr);
 
 
             GPUCullingPrepassPushConstants gpuPushConstant =
             {
                 .cullCount = objectCount,
+                .bMeshletCull = bMeshletCull ? 1U : 0U,
+                .lodErrorPixels = math::max(cVarLodErrorPixels.get(), 0.0f),
+                .lodBias = cVarLodBias.get(),
             };
 
             pass->prepass_cull->bindAndPushConst(cmd, &gpuPushConstant);
@@ -213,10 +381,36 @@ namespace engine
                 .addBuffer(scene->getObjectBufferGPU())
                 .addBuffer(indirectDrawCommandBuffer)
                 .addBuffer(indirectDrawCountBuffer)
+                .addBuffer(meshletCullObjectsBuffer)
+                .addBuffer(meshletCullDispatchBuffer)
                 .push(pass->prepass_cull.get());
 
             vkCmdDispatch(cmd, getGroupCount(objectCount, 64), 1, 1);
 
+            // Meshlet culling append visible meshlet draw commands after object draw commands.
+            if (bMeshletCull)
+            {
+                meshletCullBeginBarrier(cmd, indirectDrawCommandBuffer, indirectDrawCountBuffer, meshletCullObjectsBuffer, meshletCullDispatchBuffer);
+
+                GPUMeshletCullPushConstants meshletPushConstant =
+                {
+                    .bConeCull = cVarMeshletConeCulling.get() != 0 ? 1U : 0U,
+                };
+
+                pass->prepass_meshlet_cull->bindAndPushConst(cmd, &meshletPushConstant);
+                PushSetBuilder(cmd)
+                    .addBuffer(perFrameGPU)
+                    .addBuffer(scene->getObjectBufferGPU())
+                    .addBuffer(indirectDrawCommandBuffer)
+                    .addBuffer(indirectDrawCountBuffer)
+                    .addBuffer(meshletCullObjectsBuffer)
+                    .push(pass->prepass_meshlet_cull.get());
+
+                pass->prepass_meshlet_cull->bindSet(cmd, std::vector<VkDescriptorSet>{ getContext()->getBindlessSSBOSet() }, 1);
+
+                vkCmdDispatchIndirect(cmd, meshletCullDispatchBuffer->getBuffer()->getVkBuffer(), 0);
+            }
+
             // End buffer barrier.
             std::array<VkBufferMemoryBarrier2, 2> endBufferBarriers
             {
@@ -252,7 +446,7 @@ namespace engine
                 indirectDrawCommandBuffer->getBuffer()->getVkBuffer(), 0,
                 indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
                 0,
-                objectCount,
+                maxDrawCount,
                 sizeof(StaticMeshDrawCommand)
             );
         }
@@ -308,15 +502,58 @@ namespace engine
             return;
         }
 
+        const bool bMeshletCull = cVarMeshletCulling.get() != 0;
+        const uint32_t maxDrawCount = getStaticMeshMaxDrawCount(scene, bMeshletCull);
+
         auto indirectDrawCommandBuffer = getContext()->getBufferParameters().getIndirectStorage(
             "StaticMeshIndirectCommand", 
-            sizeof(StaticMeshDrawCommand) * objectCount);
+            sizeof(StaticMeshDrawCommand) * maxDrawCount);
 
         auto indirectDrawCountBuffer = getContext()->getBufferParameters().getIndirectStorage(
             "StaticMeshIndirectCount", sizeof(uint32_t));
 
+        auto meshletCullObjectsBuffer = getContext()->getBufferParameters().getIndirectStorage(
+            "StaticMeshMeshletCullObjects", sizeof(uint32_t) * objectCount);
+
+        auto meshletCullDispatchBuffer = getContext()->getBufferParameters().getIndirectStorage(
+            "StaticMeshMeshletCullDispatch", sizeof(uint32_t) * 3);
+
+        auto meshletCullStatBuffer = getContext()->getBufferParameters().getParameter("StaticMeshMeshletCullStat", sizeof(StaticMeshMeshletCullStat),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, {});
+
         auto* pass = getContext()->getPasses().get<StaticMeshPass>();
 
+        // Read back meshlet culling stat of frames ago, gpu already finish them so no wait.
+        while (pass->meshletCullStatReadbacks.size() > getContext()->getBackBufferCount() + 1)
+        {
+            auto* readbackBuffer = pass->meshletCullStatReadbacks.front()->getBuffer();
+            readbackBuffer->map();
+            {
+                readbackBuffer->invalidate();
+                memcpy(&pass->meshletCullStat, readbackBuffer->getMapped(), sizeof(StaticMeshMeshletCullStat));
+            }
+            readbackBuffer->unmap();
+
+            pass->meshletCullStatReadbacks.pop_front();
+        }
+
+        CVarCmdHandle(cVarMeshletCullStat, [&]()
+        {
+            const auto& stat = pass->meshletCullStat;
+            const auto culledPercent = [&](uint32_t count)
+            {
+                return stat.triangleTotal > 0 ? double(count) * 100.0 / double(stat.triangleTotal) : 0.0;
+            };
+
+            LOG_INFO("Meshlet culling: {}/{} meshlets visible, {}/{} triangles visible.",
+                stat.meshletVisible, stat.meshletTotal, stat.triangleVisible, stat.triangleTotal);
+            LOG_INFO("Meshlet culling: {} ({:.1f}%) triangles frustum culled, {} ({:.1f}%) cone culled, {} ({:.1f}%) occlusion culled.",
+                stat.triangleFrustumCulled, culledPercent(stat.triangleFrustumCulled),
+                stat.triangleConeCulled, culledPercent(stat.triangleConeCulled),
+                stat.triangleOcclusionCulled, culledPercent(stat.triangleOcclusionCulled));
+        });
+
         // Culling.
         {
             ScopePerframeMarker staticMeshGBufferCullingMarker(cmd, "StaticMeshGBufferCulling", { 1.0f, 0.0f, 0.0f, 1.0f }, timer);
@@ -328,8 +565,10 @@ namespace engine
             RHIPipelineBarrier(cmd, 0, 1, &beginBarriers, 0, nullptr);
 
             vkCmdFillBuffer(cmd, *indirectDrawCountBuffer->getBuffer(), 0, indirectDrawCountBuffer->getBuffer()->getSize(), 0u);
+            vkCmdFillBuffer(cmd, *meshletCullDispatchBuffer->getBuffer(), 0, meshletCullDispatchBuffer->getBuffer()->getSize(), 0u);
+            vkCmdFillBuffer(cmd, *meshletCullStatBuffer->getBuffer(), 0, meshletCullStatBuffer->getBuffer()->getSize(), 0u);
 
-            std::array<VkBufferMemoryBarrier2, 2> fillBarriers
+            std::array<VkBufferMemoryBarrier2, 4> fillBarriers
             {
                 RHIBufferBarrier(indirectDrawCommandBuffer->getBuffer()->getVkBuffer(),
                     VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
@@ -338,6 +577,14 @@ namespace engine
                 RHIBufferBarrier(indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
                     VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
                     VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+
+                RHIBufferBarrier(meshletCullDispatchBuffer->getBuffer()->getVkBuffer(),
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
+
+                RHIBufferBarrier(meshletCullStatBuffer->getBuffer()->getVkBuffer(),
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT),
             };
             RHIPipelineBarrier(cmd, 0, (uint32_t)fillBarriers.size(), fillBarriers.data(), 0, nullptr);
 
@@ -345,7 +592,10 @@ namespace engine
             {
                 .cullCount = objectCount,
                 .hzbMipCount = hzbFurthest->getImage().getInfo().mipLevels,
-                .hzbSrcSize = math::vec2(hzbFurthest->getImage().getExtent().width, hzbFurthest->getImage().getExtent().height)
+                .hzbSrcSize = math::vec2(hzbFurthest->getImage().getExtent().width, hzbFurthest->getImage().getExtent().height),
+                .bMeshletCull = bMeshletCull ? 1U : 0U,
+                .lodErrorPixels = math::max(cVarLodErrorPixels.get(), 0.0f),
+                .lodBias = cVarLodBias.get(),
             };
 
             hzbFurthest->getImage().transitionLayout(cmd, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, buildBasicImageSubresource());
@@ -365,10 +615,61 @@ namespace engine
                 .addSRV(hzbFurthest)
                 .addBuffer(debugLiner ? *debugLiner->verticesGPU->getBuffer() : getRenderer()->getSSBODump(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
                 .addBuffer(debugLiner ? *debugLiner->verticesCount->getBuffer() : getRenderer()->getSSBODump(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER)
+                .addBuffer(meshletCullObjectsBuffer)
+                .addBuffer(meshletCullDispatchBuffer)
                 .push(pass->gbuffer_cull.get());
 
             vkCmdDispatch(cmd, getGroupCount(objectCount, 64), 1, 1);
 
+            // Meshlet culling append visible meshlet draw commands after object draw commands.
+            if (bMeshletCull)
+            {
+                meshletCullBeginBarrier(cmd, indirectDrawCommandBuffer, indirectDrawCountBuffer, meshletCullObjectsBuffer, meshletCullDispatchBuffer);
+
+                GPUMeshletCullPushConstants meshletPushConstant =
+                {
+                    .bConeCull = cVarMeshletConeCulling.get() != 0 ? 1U : 0U,
+                    .hzbMipCount = gpuPushConstant.hzbMipCount,
+                    .hzbSrcSize = gpuPushConstant.hzbSrcSize,
+                };
+
+                pass->gbuffer_meshlet_cull->bindAndPushConst(cmd, &meshletPushConstant);
+                PushSetBuilder(cmd)
+                    .addBuffer(perFrameGPU)
+                    .addBuffer(scene->getObjectBufferGPU())
+                    .addBuffer(indirectDrawCommandBuffer)
+                    .addBuffer(indirectDrawCountBuffer)
+                    .addBuffer(meshletCullObjectsBuffer)
+                    .addSRV(hzbFurthest)
+                    .addBuffer(meshletCullStatBuffer)
+                    .push(pass->gbuffer_meshlet_cull.get());
+
+                pass->gbuffer_meshlet_cull->bindSet(cmd, std::vector<VkDescriptorSet>{ getContext()->getBindlessSSBOSet() }, 1);
+
+                vkCmdDispatchIndirect(cmd, meshletCullDispatchBuffer->getBuffer()->getVkBuffer(), 0);
+
+                // Copy stat to host visible buffer, read back some frames later.
+                auto statReadbackBuffer = getContext()->getBufferParameters().getParameter("StaticMeshMeshletCullStatReadback", sizeof(StaticMeshMeshletCullStat),
+                    VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VulkanBuffer::getReadBackFlags());
+
+                auto statBarrier = RHIBufferBarrier(meshletCullStatBuffer->getBuffer()->getVkBuffer(),
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT);
+                RHIPipelineBarrier(cmd, 0, 1, &statBarrier, 0, nullptr);
+
+                VkBufferCopy copyRegion = {};
+                copyRegion.size = sizeof(StaticMeshMeshletCullStat);
+                vkCmdCopyBuffer(cmd, meshletCullStatBuffer->getBuffer()->getVkBuffer(), statReadbackBuffer->getBuffer()->getVkBuffer(), 1, &copyRegion);
+
+                auto readbackBarrier = RHIBufferBarrier(statReadbackBuffer->getBuffer()->getVkBuffer(),
+                    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+                    VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+                RHIPipelineBarrier(cmd, 0, 1, &readbackBarrier, 0, nullptr);
+
+                pass->meshletCullStatReadbacks.push_back(statReadbackBuffer);
+            }
+
             // End buffer barrier.
             std::array<VkBufferMemoryBarrier2, 2> endBufferBarriers
             {
@@ -388,6 +689,9 @@ namespace engine
             }
         }
 
+        auto& textureStreaming = getContext()->getTextureStreaming();
+        auto textureStreamingFeedbackBuffer = textureStreaming.beginFeedback(cmd);
+
         rtsLayout2Attachment();
 
         {
@@ -398,6 +702,7 @@ namespace engine
                 .addBuffer(perFrameGPU)
                 .addBuffer(scene->getObjectBufferGPU())
                 .addBuffer(indirectDrawCommandBuffer)
+                .addBuffer(textureStreamingFeedbackBuffer)
                 .push(pass->gbuffer.get());
 
             pass->gbuffer->bindSet(cmd, std::vector<VkDescriptorSet>{
@@ -411,11 +716,12 @@ namespace engine
                 indirectDrawCommandBuffer->getBuffer()->getVkBuffer(), 0,
                 indirectDrawCountBuffer->getBuffer()->getVkBuffer(),
                 0,
-                objectCount,
+                maxDrawCount,
                 sizeof(StaticMeshDrawCommand)
             );
         }
 
+        textureStreaming.endFeedback(cmd, textureStreamingFeedbackBuffer);
     }
 
 }
\ No newline at end of file
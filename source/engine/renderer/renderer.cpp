@@ -2,6 +2,7 @@
 #include "../engine.h"
 #include "render_scene.h"
 #include "scene_textures.h"
+#include "../scene/scene_manager.h"
 
 namespace engine
 {
@@ -46,6 +47,50 @@ namespace engine
     }
 
     bool RendererManager::tick(const RuntimeModuleTickData& tickData)
+    {
+        bool bResult = tickUI(tickData);
+
+        getSceneManager()->flushTransform(tickData);
+        bResult &= tickRecord(tickData);
+        bResult &= tickSubmit(tickData);
+
+        return bResult;
+    }
+
+    void RendererManager::registerTickTasks(FrameTaskGraph& graph)
+    {
+        // Editor widgets edit scene and assets, and imgui need main thread.
+        graph.addTask({ "RendererManager::tickUI",
+            { },
+            { ETickResource::UI, ETickResource::Scene, ETickResource::Transform, ETickResource::Asset, ETickResource::GPUAsset },
+            true, [this](const RuntimeModuleTickData& tickData)
+        {
+            return tickUI(tickData);
+        }});
+
+        // Apply transform edit of this frame before render scene collect.
+        graph.addTask({ "SceneManager::flushTransform", { ETickResource::Scene }, { ETickResource::Transform }, false, [](const RuntimeModuleTickData& tickData)
+        {
+            getSceneManager()->flushTransform(tickData);
+            return true;
+        }});
+
+        graph.addTask({ "RendererManager::tickRecord",
+            { ETickResource::Scene, ETickResource::Transform, ETickResource::GPUAsset },
+            { ETickResource::RenderScene, ETickResource::GraphicsQueue },
+            true, [this](const RuntimeModuleTickData& tickData)
+        {
+            return tickRecord(tickData);
+        }});
+
+        // Submit and present only touch queue and ui draw data, scene tick overlap with it.
+        graph.addTask({ "RendererManager::tickSubmit", { ETickResource::UI }, { ETickResource::GraphicsQueue }, true, [this](const RuntimeModuleTickData& tickData)
+        {
+            return tickSubmit(tickData);
+        }});
+    }
+
+    bool RendererManager::tickUI(const RuntimeModuleTickData& tickData)
     {
         // Window present render tick.
         if (m_engine->isWindowApplication())
@@ -58,80 +103,102 @@ namespace engine
 
             // Prepare render data.
             m_imguiManager.render();
+        }
+
+        return true;
+    }
 
-            auto rendererTick = [&](VkCommandBuffer graphicsCmd)
-            {
-                RHICheck(vkResetCommandBuffer(graphicsCmd, 0));
-                VkCommandBufferBeginInfo cmdBeginInfo = 
-                    RHICommandbufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-
-                // Record tick command functions.
-                RHICheck(vkBeginCommandBuffer(graphicsCmd, &cmdBeginInfo));
-                {
-                    // Render scene update and collect data.
-                    m_renderScene->tick(tickData, graphicsCmd);
-
-                    // Tick delegates functions.
-                    tickCmdFunctionsBefore.broadcast(tickData, graphicsCmd, getContext());
-                    tickCmdFunctions.broadcast(tickData, graphicsCmd, getContext());
-                }
-                RHICheck(vkEndCommandBuffer(graphicsCmd));
-            };
-
-            VkPipelineStageFlags waitFlags = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT;
-
-            // Check main imgui minimized state to decide wether should we present current frame.
-            const bool bMainMinimized = m_imguiManager.isMainMinimized();
-            if (!bMainMinimized)
-            {
-                // Acquire next present image.
-                uint32_t backBufferIndex = getContext()->acquireNextPresentImage();
-                ASSERT(backBufferIndex < getContext()->getBackBufferCount(), "Swapchain backbuffer count should equal to flighting count.");
-
-                // Prepare current
-                VkCommandBuffer graphicsCmd = m_windowCmdContext.mainCmdRing.at(backBufferIndex);
-
-                // Record.
-                rendererTick(graphicsCmd);
-
-                // Record ui render.
-                m_imguiManager.renderFrame(backBufferIndex);
-
-                // Load all semaphores.
-                auto frameStartSemaphore = getContext()->getCurrentFrameWaitSemaphore();
-                auto graphicsCmdEndSemaphore = m_windowCmdContext.mainSemaphoreRing[backBufferIndex];
-                auto frameEndSemaphore = getContext()->getCurrentFrameFinishSemaphore();
-
-                // Submit with semaphore.
-                RHISubmitInfo graphicsCmdSubmitInfo{};
-                graphicsCmdSubmitInfo.setWaitStage(&waitFlags)
-                    .setWaitSemaphore(&frameStartSemaphore, 1)
-                    .setSignalSemaphore(&graphicsCmdEndSemaphore, 1)
-                    .setCommandBuffer(&graphicsCmd, 1);
-
-                RHISubmitInfo uiCmdSubmitInfo{};
-                VkCommandBuffer uiCmdBuffer = m_imguiManager.getCommandBuffer(backBufferIndex);
-                uiCmdSubmitInfo.setWaitStage(&waitFlags)
-                    .setWaitSemaphore(&graphicsCmdEndSemaphore, 1)
-                    .setSignalSemaphore(&frameEndSemaphore, 1)
-                    .setCommandBuffer(&uiCmdBuffer, 1);
-
-                std::vector<VkSubmitInfo> infosRawSubmit{ graphicsCmdSubmitInfo, uiCmdSubmitInfo };
-
-                getContext()->resetFence();
-                getContext()->submit((uint32_t)infosRawSubmit.size(), infosRawSubmit.data());
-            }
-            else
-            {
-                getContext()->waitDeviceIdle();
-            }
-
-            m_imguiManager.updateAfterSubmit();
-
-            if (!bMainMinimized)
-            {
-                getContext()->present();
-            }
+    bool RendererManager::tickRecord(const RuntimeModuleTickData& tickData)
+    {
+        if (!m_engine->isWindowApplication())
+        {
+            return true;
+        }
+
+        // Check main imgui minimized state to decide wether should we present current frame.
+        m_frameState.bMainMinimized = m_imguiManager.isMainMinimized();
+        if (m_frameState.bMainMinimized)
+        {
+            return true;
+        }
+
+        // Acquire next present image.
+        m_frameState.backBufferIndex = getContext()->acquireNextPresentImage();
+        ASSERT(m_frameState.backBufferIndex < getContext()->getBackBufferCount(), "Swapchain backbuffer count should equal to flighting count.");
+
+        // Prepare current
+        VkCommandBuffer graphicsCmd = m_windowCmdContext.mainCmdRing.at(m_frameState.backBufferIndex);
+
+        RHICheck(vkResetCommandBuffer(graphicsCmd, 0));
+        VkCommandBufferBeginInfo cmdBeginInfo = 
+            RHICommandbufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+        // Record tick command functions.
+        RHICheck(vkBeginCommandBuffer(graphicsCmd, &cmdBeginInfo));
+        {
+            // Render scene update and collect data.
+            m_renderScene->tick(tickData, graphicsCmd);
+
+            // Tick delegates functions.
+            tickCmdFunctionsBefore.broadcast(tickData, graphicsCmd, getContext());
+            tickCmdFunctions.broadcast(tickData, graphicsCmd, getContext());
+        }
+        RHICheck(vkEndCommandBuffer(graphicsCmd));
+
+        return true;
+    }
+
+    bool RendererManager::tickSubmit(const RuntimeModuleTickData& tickData)
+    {
+        if (!m_engine->isWindowApplication())
+        {
+            return true;
+        }
+
+        VkPipelineStageFlags waitFlags = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT;
+
+        if (!m_frameState.bMainMinimized)
+        {
+            const uint32_t backBufferIndex = m_frameState.backBufferIndex;
+            VkCommandBuffer graphicsCmd = m_windowCmdContext.mainCmdRing.at(backBufferIndex);
+
+            // Record ui render.
+            m_imguiManager.renderFrame(backBufferIndex);
+
+            // Load all semaphores.
+            auto frameStartSemaphore = getContext()->getCurrentFrameWaitSemaphore();
+            auto graphicsCmdEndSemaphore = m_windowCmdContext.mainSemaphoreRing[backBufferIndex];
+            auto frameEndSemaphore = getContext()->getCurrentFrameFinishSemaphore();
+
+            // Submit with semaphore.
+            RHISubmitInfo graphicsCmdSubmitInfo{};
+            graphicsCmdSubmitInfo.setWaitStage(&waitFlags)
+                .setWaitSemaphore(&frameStartSemaphore, 1)
+                .setSignalSemaphore(&graphicsCmdEndSemaphore, 1)
+                .setCommandBuffer(&graphicsCmd, 1);
+
+            RHISubmitInfo uiCmdSubmitInfo{};
+            VkCommandBuffer uiCmdBuffer = m_imguiManager.getCommandBuffer(backBufferIndex);
+            uiCmdSubmitInfo.setWaitStage(&waitFlags)
+                .setWaitSemaphore(&graphicsCmdEndSemaphore, 1)
+                .setSignalSemaphore(&frameEndSemaphore, 1)
+                .setCommandBuffer(&uiCmdBuffer, 1);
+
+            std::vector<VkSubmitInfo> infosRawSubmit{ graphicsCmdSubmitInfo, uiCmdSubmitInfo };
+
+            getContext()->resetFence();
+            getContext()->submit((uint32_t)infosRawSubmit.size(), infosRawSubmit.data());
+        }
+        else
+        {
+            getContext()->waitDeviceIdle();
+        }
+
+        m_imguiManager.updateAfterSubmit();
+
+        if (!m_frameState.bMainMinimized)
+        {
+            getContext()->present();
         }
 
         return true;
@@ -22,6 +22,7 @@ namespace engine
 		virtual void registerCheck(Engine* engine) override;
 		virtual bool init() override;
 		virtual bool tick(const RuntimeModuleTickData& tickData) override;
+		virtual void registerTickTasks(FrameTaskGraph& graph) override;
 		virtual bool beforeRelease() override;
 		virtual bool release() override;
 
@@ -43,6 +44,15 @@ namespace engine
 		const VulkanBuffer& getSSBODump() const { return *m_fallbackSSBO; }
 
 	private:
+		// Imgui new frame and editor tick functions.
+		bool tickUI(const RuntimeModuleTickData& tickData);
+
+		// Acquire present image and record render scene and passes.
+		bool tickRecord(const RuntimeModuleTickData& tickData);
+
+		// Record ui, submit and present.
+		bool tickSubmit(const RuntimeModuleTickData& tickData);
+
 		void initWindowCommandContext();
 		void destroyWindowCommandContext();
 
@@ -58,6 +68,13 @@ namespace engine
 			std::vector<VkSemaphore> mainSemaphoreRing;
 		} m_windowCmdContext;
 
+		// Present state from record to submit of current frame.
+		struct
+		{
+			bool bMainMinimized = false;
+			uint32_t backBufferIndex = 0;
+		} m_frameState;
+
 		RenderScene* m_renderScene = nullptr;
 		SharedTextures* m_sharedTextures = nullptr;
 		TemporalBlueNoise* m_temporalBlueNoise = nullptr;
@@ -55,13 +55,27 @@ namespace engine
 
             for (const auto& texId : set)
             {
-                auto asset = getAssetManager()->getAsset(texId);
-                if (ImGui::MenuItem((std::string("  ") + ICON_FA_IMAGE"   " + asset->getSaveInfo().getName()).c_str()))
+                // Project asset uuid is store path, only read name from index, no deserialize every texture in list.
+                u8str name;
+                u8str storePath;
+                if (const auto* entry = getAssetManager()->getAssetIndexEntry(texId))
+                {
+                    name = entry->name;
+                    storePath = texId;
+                }
+                else
+                {
+                    auto asset = getAssetManager()->getAsset(texId);
+                    name = asset->getSaveInfo().getName();
+                    storePath = asset->getSaveInfo().getStorePathU8();
+                }
+
+                if (ImGui::MenuItem((std::string("  ") + ICON_FA_IMAGE"   " + name).c_str()))
                 {
                     setAssetUUID(texId);
                 }
 
-                ui::hoverTip(asset->getSaveInfo().getStorePathU8().c_str());
+                ui::hoverTip(storePath.c_str());
             }
         };
 
@@ -43,6 +43,17 @@ namespace engine
 		result.meshInfoData.sphereBounds = math::vec4(submesh.bounds.origin, submesh.bounds.radius);
 		result.meshInfoData.extents = submesh.bounds.extents;
 		result.meshInfoData.submeshIndex = 0;
+		result.meshInfoData.meshletsArrayId = ~0U;
+		result.meshInfoData.meshletStart = 0;
+		result.meshInfoData.meshletCount = 0;
+		result.meshInfoData.vertexFormat = EVertexFormat_Float;
+		result.meshInfoData.vertexStart = submesh.vertexStart;
+		result.meshInfoData.indexWordStart = submesh.indicesWordStart;
+		result.meshInfoData.indexFormat = submesh.bIndex16 ? EIndexFormat_Uint16 : EIndexFormat_Uint32;
+		result.meshInfoData.lodCount = 1;
+		result.meshInfoData.lodIndexStart = math::uvec4(submesh.indicesStart);
+		result.meshInfoData.lodIndicesCount = math::uvec4(submesh.indicesCount);
+		result.meshInfoData.lodError = math::vec4(0.0f);
 
 		result.materialInfoData = buildDefaultBSDFMaterialInfo();
 		result.materialInfoData.metalAdd     = 1.0f;
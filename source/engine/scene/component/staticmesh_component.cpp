@@ -23,13 +23,27 @@ namespace engine
 			const auto& set = getAssetManager()->getAssetTypeMap(suffix);
 			for (const auto& meshId : set)
 			{
-				auto asset = getAssetManager()->getAsset(meshId);
-				if (ImGui::MenuItem((std::string("  ") + ICON_FA_CHESS_PAWN"   " + asset->getSaveInfo().getName()).c_str()))
+				// Project asset uuid is store path, only read name from index, no deserialize every mesh in list.
+				u8str name;
+				u8str storePath;
+				if (const auto* entry = getAssetManager()->getAssetIndexEntry(meshId))
+				{
+					name = entry->name;
+					storePath = meshId;
+				}
+				else
+				{
+					auto asset = getAssetManager()->getAsset(meshId);
+					name = asset->getSaveInfo().getName();
+					storePath = asset->getSaveInfo().getStorePathU8();
+				}
+
+				if (ImGui::MenuItem((std::string("  ") + ICON_FA_CHESS_PAWN"   " + name).c_str()))
 				{
 					setAssetUUID(meshId);
 				}
 
-				ui::hoverTip(asset->getSaveInfo().getStorePathU8().c_str());
+				ui::hoverTip(storePath.c_str());
 			}
 		};
 
@@ -115,10 +129,26 @@ namespace engine
 
 	void StaticMeshComponent::tick(const RuntimeModuleTickData& tickData)
 	{
+		// Mesh or its materials reimport, rebuild cache from new assets.
+		const uint64_t assetRefreshVersion = m_assetUUID.empty() ? 0 : getAssetManager()->getAssetRefreshVersion(m_assetUUID);
+		if (m_meshCache.assetRefreshVersion != assetRefreshVersion)
+		{
+			m_meshCache.assetRefreshVersion = assetRefreshVersion;
+			clearCache();
+		}
+
 		if (!m_assetUUID.empty() && m_meshCache.empty())
 		{
 			buildCacheSync();
 		}
+
+		// Streaming texture swap resident image change bindless index, so refresh material info.
+		const uint64_t textureResidencyVersion = getContext()->getTextureStreaming().getResidencyVersion();
+		if (m_meshCache.textureResidencyVersion != textureResidencyVersion)
+		{
+			m_meshCache.textureResidencyVersion = textureResidencyVersion;
+			updateMaterials();
+		}
 	}
 
 	bool StaticMeshComponent::setAssetUUID(const UUID& in)
@@ -234,7 +264,19 @@ namespace engine
 				object.bSelected = bSelected ? 1U : 0U;
 
 				auto& rtObject = rtInfos[index];
-				rtObject.transform = instanceTamplate.transform;
+				if (object.meshInfoData.vertexFormat == EVertexFormat_Compact)
+				{
+					// BLAS of compact vertex build in submesh bounds space, dequantize in instance transform.
+					const math::mat4 dequantizeMatrix = math::scale(
+						math::translate(modelMatrix, math::vec3(object.meshInfoData.sphereBounds)), object.meshInfoData.extents);
+
+					math::mat4 temp = math::transpose(dequantizeMatrix);
+					memcpy(&rtObject.transform, &temp, sizeof(VkTransformMatrixKHR));
+				}
+				else
+				{
+					rtObject.transform = instanceTamplate.transform;
+				}
 
 				// NOTE: instance custom index used to index object info.
 				rtObject.instanceCustomIndex = objectOffsetId + index;
@@ -249,7 +291,7 @@ namespace engine
 						updateObject(i);
 					}
 				};
-				Engine::get()->getThreadPool()->parallelizeLoop(0, meshInfos.size(), loop).wait();
+				Engine::get()->getThreadPool()->parallelFor(0, meshInfos.size(), loop);
 			}
 			else
 			{
@@ -322,6 +364,35 @@ namespace engine
 					cacheObject.meshInfoData.sphereBounds = math::vec4(submesh.bounds.origin, submesh.bounds.radius);
 					cacheObject.meshInfoData.extents = submesh.bounds.extents;
 					cacheObject.meshInfoData.submeshIndex = i;
+
+					// Meshlets buffer no exist when mesh cook without meshlet, fallback to per object culling.
+					const auto& meshlets = m_meshCache.cacheMeshGPU->getMeshlets();
+					cacheObject.meshInfoData.meshletsArrayId = meshlets.bindless;
+					cacheObject.meshInfoData.meshletStart = submesh.meshletStart;
+					cacheObject.meshInfoData.meshletCount = meshlets.buffer ? submesh.meshletCount : 0;
+
+					cacheObject.meshInfoData.vertexFormat = m_meshCache.cacheMeshGPU->getVertexFormat();
+
+					cacheObject.meshInfoData.vertexStart = submesh.vertexStart;
+					cacheObject.meshInfoData.indexWordStart = submesh.indicesWordStart;
+					cacheObject.meshInfoData.indexFormat = submesh.bIndex16 ? EIndexFormat_Uint16 : EIndexFormat_Uint32;
+
+					// Unused LOD slots repeat coarsest LOD, so LOD selection clamp is safe.
+					static_assert(kStaticMeshMaxLodCount == kMaxStaticMeshLodCount);
+					cacheObject.meshInfoData.lodCount = 1;
+					cacheObject.meshInfoData.lodIndexStart = math::uvec4(submesh.indicesStart);
+					cacheObject.meshInfoData.lodIndicesCount = math::uvec4(submesh.indicesCount);
+					cacheObject.meshInfoData.lodError = math::vec4(0.0f);
+					for (size_t lod = 0; lod < submesh.lods.size() && lod + 1 < kMaxStaticMeshLodCount; lod++)
+					{
+						const uint32_t lodIndex = cacheObject.meshInfoData.lodCount++;
+						for (uint32_t slot = lodIndex; slot < kMaxStaticMeshLodCount; slot++)
+						{
+							cacheObject.meshInfoData.lodIndexStart[slot] = submesh.lods[lod].indicesStart;
+							cacheObject.meshInfoData.lodIndicesCount[slot] = submesh.lods[lod].indicesCount;
+							cacheObject.meshInfoData.lodError[slot] = submesh.lods[lod].error;
+						}
+					}
 				}
 
 				m_meshCache.cacheMaterialId[i] = submesh.material;
@@ -393,7 +464,7 @@ namespace engine
 					object.materialInfoData = material->getGPUOnly();
 				}
 			};
-			Engine::get()->getThreadPool()->parallelizeLoop(0, m_meshCache.cachePerObjectData.size(), loop).wait();
+			Engine::get()->getThreadPool()->parallelFor(0, m_meshCache.cachePerObjectData.size(), loop);
 		}
 		else
 		{
@@ -63,6 +63,12 @@ namespace engine
 			std::vector<VkAccelerationStructureInstanceKHR> cachePerObjectAs;
 			std::vector<MaterialUUID> cacheMaterialId;
 
+			// Texture streaming residency version when material info update.
+			uint64_t textureResidencyVersion = 0;
+
+			// Asset refresh version of mesh when cache build.
+			uint64_t assetRefreshVersion = 0;
+
 			void clear()
 			{
 				cachePerObjectData.clear();
@@ -35,6 +35,24 @@ namespace engine
 		return true;
 	}
 
+	void SceneManager::registerTickTasks(FrameTaskGraph& graph)
+	{
+		// Component tick may create bindless view of gpu asset, write bindless descriptor set which frame record and submit use.
+		// Keep on main thread until bindless update is lock protected.
+		graph.addTask({ "SceneManager::tick", { ETickResource::Asset, ETickResource::GPUAsset }, { ETickResource::Scene, ETickResource::Transform }, true, [this](const RuntimeModuleTickData& tickData)
+		{
+			return tick(tickData);
+		}});
+	}
+
+	void SceneManager::flushTransform(const RuntimeModuleTickData& tickData)
+	{
+		if (getAssetManager()->isProjectSetup())
+		{
+			getActiveScene()->flushSceneNodeTransform();
+		}
+	}
+
 	bool SceneManager::beforeRelease()
 	{
 		return true;
@@ -15,6 +15,7 @@ namespace engine
 		virtual void registerCheck(Engine* engine) override;
 		virtual bool init() override;
 		virtual bool tick(const RuntimeModuleTickData& tickData) override;
+		virtual void registerTickTasks(FrameTaskGraph& graph) override;
 		virtual bool beforeRelease() override;
 		virtual bool release() override;
 
@@ -23,6 +24,9 @@ namespace engine
 		void onGameContinue();
 		void onGameStop();
 
+		// Update dirty world transforms of active scene, such as edit by ui in this frame.
+		void flushTransform(const RuntimeModuleTickData& tickData);
+
 		// Get current active scene.
 		std::shared_ptr<Scene> getActiveScene();
 
@@ -21,6 +21,11 @@ registerClassMember(AssetInterface)
 {
 	archive(m_saveInfo);
     archive(m_rawAssetPath);
+
+    if (version > 10)
+    {
+        archive(m_importSource);
+    }
 }
 
 registerPODClassMember(StaticMeshRenderBounds)
@@ -198,9 +203,34 @@ registerPODClassMember(PostprocessVolumeSetting)
     }
 }
 
+registerPODClassMember(StaticMeshLod)
+{
+    archive(indicesStart, indicesCount, error);
+}
+
 registerPODClassMember(StaticMeshSubMesh)
 {
     archive(indicesStart, indicesCount, material, bounds);
+
+    if (version > 6)
+    {
+        archive(meshletStart, meshletCount);
+    }
+
+    if (version > 8)
+    {
+        archive(vertexStart, indicesWordStart, bIndex16);
+    }
+    else
+    {
+        // Legacy indices are absolute 32 bit.
+        indicesWordStart = indicesStart;
+    }
+
+    if (version > 9)
+    {
+        archive(lods);
+    }
 }
 
 registerPODClassMember(StaticMeshBin)
@@ -251,6 +281,20 @@ registerClassMemberInherit(AssetStaticMesh, AssetInterface)
         archive(m_minPosition);
         archive(m_maxPosition);
     }
+
+    if (version > 7)
+    {
+        archive(m_vertexFormat);
+    }
+
+    if (version > 8)
+    {
+        archive(m_indicesWordsCount);
+    }
+    else
+    {
+        m_indicesWordsCount = m_indicesCount;
+    }
 }}
 
 registerClassMember(Component)
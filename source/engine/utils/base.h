@@ -24,6 +24,7 @@ namespace engine
 	};
 
 	class Engine;
+	class FrameTaskGraph;
 
 	// Per module tick data, time in seconds unit, used in engine module.
 	struct RuntimeModuleTickData
@@ -78,6 +79,10 @@ namespace engine
 		virtual bool init() = 0;
 		virtual bool tick(const RuntimeModuleTickData& tickData) = 0;
 
+		// Declare tick as frame tasks with read write resources, so independent work run concurrently.
+		// Default add one main thread task call tick and write all resources.
+		virtual void registerTickTasks(FrameTaskGraph& graph);
+
 		virtual bool beforeRelease() { return true; }
 		virtual bool release() = 0;
 
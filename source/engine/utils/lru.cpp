@@ -0,0 +1,334 @@
+#include "lru.h"
+
+namespace engine
+{
+	// Weak nodes check per insert, keep sweep cost O(1).
+	static constexpr uint32_t kSweepWeakNodesPerInsert = 2;
+
+	void LRUAssetCache::NodeList::pushFront(Node* node)
+	{
+		node->prev = nullptr;
+		node->next = head;
+
+		if (head)
+		{
+			head->prev = node;
+		}
+		else
+		{
+			tail = node;
+		}
+
+		head = node;
+		count++;
+	}
+
+	void LRUAssetCache::NodeList::remove(Node* node)
+	{
+		if (node->prev)
+		{
+			node->prev->next = node->next;
+		}
+		else
+		{
+			head = node->next;
+		}
+
+		if (node->next)
+		{
+			node->next->prev = node->prev;
+		}
+		else
+		{
+			tail = node->prev;
+		}
+
+		node->prev = nullptr;
+		node->next = nullptr;
+		count--;
+	}
+
+	bool LRUAssetCache::contain(const KeyType& key) const
+	{
+		const auto& shard = getShard(key);
+		std::shared_lock<std::shared_mutex> lock(shard.lock);
+
+		const auto iter = shard.nodes.find(key);
+		if (iter == shard.nodes.end())
+		{
+			return false;
+		}
+
+		return iter->second.owner != nullptr || !iter->second.weak.expired();
+	}
+
+	void LRUAssetCache::clear()
+	{
+		for (auto& shard : m_shards)
+		{
+			// Value release out of lock, release may touch cache again.
+			std::unordered_map<KeyType, Node> nodes;
+			{
+				std::unique_lock<std::shared_mutex> lock(shard.lock);
+
+				for (const auto& [key, node] : shard.nodes)
+				{
+					if (node.owner)
+					{
+						m_usedSize -= node.size;
+					}
+				}
+
+				nodes.swap(shard.nodes);
+				shard.ownerList = { };
+				shard.weakList = { };
+			}
+		}
+	}
+
+	void LRUAssetCache::erase(const KeyType& key)
+	{
+		std::shared_ptr<ValueType> value = nullptr;
+
+		auto& shard = getShard(key);
+		std::unique_lock<std::shared_mutex> lock(shard.lock);
+
+		const auto iter = shard.nodes.find(key);
+		if (iter == shard.nodes.end())
+		{
+			return;
+		}
+
+		auto& node = iter->second;
+		if (node.owner)
+		{
+			m_usedSize -= node.size;
+			value = std::move(node.owner);
+
+			shard.ownerList.remove(&node);
+		}
+		else
+		{
+			shard.weakList.remove(&node);
+		}
+		shard.nodes.erase(iter);
+	}
+
+	void LRUAssetCache::insert(const KeyType& key, std::shared_ptr<ValueType> value)
+	{
+		// Only call virtual size once, size keep same until erase or evict.
+		const uint32_t size = value->getSize();
+		std::shared_ptr<ValueType> replacedValue = nullptr;
+		{
+			auto& shard = getShard(key);
+			std::unique_lock<std::shared_mutex> lock(shard.lock);
+
+			auto [iter, bInserted] = shard.nodes.try_emplace(key);
+			auto& node = iter->second;
+			if (bInserted)
+			{
+				node.key = &iter->first;
+			}
+			else if (node.owner)
+			{
+				m_usedSize -= node.size;
+				replacedValue = std::move(node.owner);
+
+				shard.ownerList.remove(&node);
+			}
+			else
+			{
+				shard.weakList.remove(&node);
+			}
+
+			node.weak = value;
+			node.owner = std::move(value);
+			node.size = size;
+			node.bReferenced.store(false, std::memory_order_relaxed);
+
+			shard.ownerList.pushFront(&node);
+			m_usedSize += size;
+
+			sweepWeakNodes(shard);
+		}
+
+		// May oversize, need reduce.
+		prune();
+	}
+
+	std::shared_ptr<LRUAssetCache::ValueType> LRUAssetCache::tryGet(const KeyType& key)
+	{
+		auto& shard = getShard(key);
+		std::shared_lock<std::shared_mutex> lock(shard.lock);
+
+		const auto iter = shard.nodes.find(key);
+		if (iter != shard.nodes.end())
+		{
+			auto& node = iter->second;
+			if (node.owner)
+			{
+				// Check before store, hot node no write its cache line every hit.
+				if (!node.bReferenced.load(std::memory_order_relaxed))
+				{
+					node.bReferenced.store(true, std::memory_order_relaxed);
+				}
+
+				shard.hitCount.fetch_add(1, std::memory_order_relaxed);
+				return node.owner;
+			}
+
+			// Evicted but still used by other actor.
+			if (auto value = node.weak.lock())
+			{
+				shard.weakHitCount.fetch_add(1, std::memory_order_relaxed);
+				return value;
+			}
+		}
+
+		// No valid instance, return nullptr and need reload.
+		shard.missCount.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	bool LRUAssetCache::evictOne(Shard& shard, std::shared_ptr<ValueType>& outValue, uint32_t& outSize)
+	{
+		// Referenced node get second chance, each node move at most once so loop bound by owner count.
+		uint32_t checkCount = shard.ownerList.count;
+		while (Node* node = shard.ownerList.tail)
+		{
+			if (checkCount > 0 && node->bReferenced.load(std::memory_order_relaxed))
+			{
+				node->bReferenced.store(false, std::memory_order_relaxed);
+
+				shard.ownerList.remove(node);
+				shard.ownerList.pushFront(node);
+
+				checkCount--;
+				continue;
+			}
+
+			m_usedSize -= node->size;
+			m_evictionCount++;
+			m_evictedSize += node->size;
+
+			outValue = std::move(node->owner);
+			outSize = node->size;
+
+			shard.ownerList.remove(node);
+			shard.weakList.pushFront(node);
+
+			return true;
+		}
+
+		return false;
+	}
+
+	void LRUAssetCache::sweepWeakNodes(Shard& shard)
+	{
+		for (uint32_t i = 0; i < kSweepWeakNodesPerInsert; i++)
+		{
+			Node* node = shard.weakList.tail;
+			if (node == nullptr)
+			{
+				return;
+			}
+
+			shard.weakList.remove(node);
+			if (node->weak.expired())
+			{
+				shard.nodes.erase(*node->key);
+			}
+			else
+			{
+				// Still alive, check again after other weak nodes.
+				shard.weakList.pushFront(node);
+			}
+		}
+	}
+
+	size_t LRUAssetCache::prune(std::function<void(std::shared_ptr<ValueType>)>&& reduceFunction)
+	{
+		const size_t maxAllowed = m_capacity + m_elasticity;
+		if (m_capacity == 0 || m_usedSize < maxAllowed)
+		{
+			return 0;
+		}
+
+		return evictUntil(m_capacity, std::move(reduceFunction));
+	}
+
+	size_t LRUAssetCache::evict(size_t size)
+	{
+		const size_t usedSize = m_usedSize.load();
+		return evictUntil(usedSize > size ? usedSize - size : 0, nullptr);
+	}
+
+	size_t LRUAssetCache::evictUntil(size_t targetUsedSize, std::function<void(std::shared_ptr<ValueType>)>&& reduceFunction)
+	{
+		std::lock_guard<std::mutex> pruneLock(m_pruneLock);
+
+		// Loop until release enough resource, evict one node per shard round robin.
+		size_t reduceSize = 0;
+		uint32_t emptyShardCount = 0;
+		while (m_usedSize > targetUsedSize && emptyShardCount < kShardCount)
+		{
+			auto& shard = m_shards[m_pruneCursor];
+			m_pruneCursor = (m_pruneCursor + 1) % kShardCount;
+
+			std::shared_ptr<ValueType> value = nullptr;
+			uint32_t size = 0;
+			{
+				std::unique_lock<std::shared_mutex> lock(shard.lock);
+				if (!evictOne(shard, value, size))
+				{
+					emptyShardCount++;
+					continue;
+				}
+			}
+			emptyShardCount = 0;
+
+			// Value release out of shard lock.
+			reduceSize += size;
+			if (reduceFunction)
+			{
+				reduceFunction(std::move(value));
+			}
+		}
+
+		return reduceSize;
+	}
+
+	LRUAssetCache::Stats LRUAssetCache::getStats() const
+	{
+		Stats stats { };
+		for (const auto& shard : m_shards)
+		{
+			stats.hitCount += shard.hitCount.load(std::memory_order_relaxed);
+			stats.weakHitCount += shard.weakHitCount.load(std::memory_order_relaxed);
+			stats.missCount += shard.missCount.load(std::memory_order_relaxed);
+
+			std::shared_lock<std::shared_mutex> lock(shard.lock);
+			stats.ownerCount += shard.ownerList.count;
+			stats.weakCount += shard.weakList.count;
+		}
+
+		stats.evictionCount = m_evictionCount.load();
+		stats.evictedSize = m_evictedSize.load();
+		stats.usedSize = m_usedSize.load();
+
+		return stats;
+	}
+
+	void LRUAssetCache::resetStats()
+	{
+		for (auto& shard : m_shards)
+		{
+			shard.hitCount = 0;
+			shard.weakHitCount = 0;
+			shard.missCount = 0;
+		}
+
+		m_evictionCount = 0;
+		m_evictedSize = 0;
+	}
+}
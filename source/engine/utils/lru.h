@@ -3,12 +3,14 @@
 #include <atomic>
 #include <cstdint>
 #include <type_traits>
-#include <list>
 #include <unordered_map>
+#include <shared_mutex>
 #include <mutex>
 #include <memory>
+#include <functional>
 
 #include "noncopyable.h"
+#include "cacheline.h"
 #include "uuid.h"
 
 namespace engine
@@ -24,12 +26,37 @@ namespace engine
 	// All asset used in this application will not release immediate when it don't need.
 	// It will cache in LRU map when memory is enough, but if memory is not enough for new asset,
 	// it will prune the cache ones.
+	// Keys shard by hash, each shard own a map of intrusive list nodes and a shared lock.
+	// Hit only take shared lock and mark node referenced, prune move referenced tail node to front instead of evict,
+	// so hits from many threads no serialize on list splice.
 	class LRUAssetCache : NonCopyable
 	{
 	public:
 		using ValueType = StorageInterface;
 		using KeyType = UUID;
 
+		static constexpr uint32_t kShardCount = 16;
+
+		struct Stats
+		{
+			// Found in cache owner list.
+			uint64_t hitCount = 0;
+
+			// Evicted but still alive in other owner.
+			uint64_t weakHitCount = 0;
+
+			uint64_t missCount = 0;
+			uint64_t evictionCount = 0;
+			uint64_t evictedSize = 0;
+
+			// Size and count of cache owned values.
+			size_t usedSize = 0;
+			uint32_t ownerCount = 0;
+
+			// Evicted values still track by weak reference.
+			uint32_t weakCount = 0;
+		};
+
 		// Init lru asset cache with capacity and elasticity in MB unit.
 		explicit LRUAssetCache(size_t capacity, size_t elasticity)
 			: m_capacity(capacity * 1024 * 1024)
@@ -50,157 +77,91 @@ namespace engine
 		// Current LRU owner shared_ptr map cache used size, no included asset owner by other actor.
 		size_t getOwnerUsedSize() const { return m_usedSize.load(); }
 
-		// Is contain current asset key.
-		bool contain(const KeyType& key)
-		{
-			// Need lock when search from weak ptr map.
-			std::lock_guard<std::mutex> lockGuard(m_lock);
-
-			// First search from lru owner map.
-			if (m_lruMap.contains(key))
-			{
-				return true;
-			}
-
-			// Then if lru owner map no exist, search from lru weak map.
-			if (m_cacheWeakPtrMap.contains(key))
-			{
-				if (auto lockPtr = m_cacheWeakPtrMap[key].lock())
-				{
-					return true;
-				}
-				else
-				{
-					// Erase unvalid waek ptr.
-					m_cacheWeakPtrMap.erase(key);
-
-					// Non valid pointer.
-					return false;
-				}
-			}
-
-			return false;
-		}
+		// Is contain current asset key, owned by cache or still alive in other owner.
+		bool contain(const KeyType& key) const;
 
 		// Clear all lru cache.
-		void clear()
-		{
-			std::lock_guard<std::mutex> lockGuard(m_lock);
-			
-			// Make used size as zero.
-			m_usedSize = 0;
-
-			// LRU cache clear.
-			m_lruMap.clear();
-			m_lruList.clear();
-			m_cacheWeakPtrMap.clear();
-		}
+		void clear();
+
+		// Remove key, value owner by other actor still alive until they release it.
+		void erase(const KeyType& key);
+
+		// Insert or replace value, value size cache at insert.
+		void insert(const KeyType& key, std::shared_ptr<ValueType> value);
+
+		// Try to get value, will return nullptr if no exist, miss no insert anything.
+		std::shared_ptr<ValueType> tryGet(const KeyType& key);
 
-		// Insert one 
-		void insert(const KeyType& key, std::shared_ptr<ValueType> value)
+		// Prune lru map when used size over max allowed size until under capacity, return pruned size.
+		size_t prune(std::function<void(std::shared_ptr<ValueType>)>&& reduceFunction = nullptr);
+
+		// Evict cold values at least size bytes no matter capacity, such as device memory over budget, return evicted size.
+		size_t evict(size_t size);
+
+		Stats getStats() const;
+		void resetStats();
+
+	protected:
+		static_assert(std::is_base_of_v<StorageInterface, ValueType>,
+			"Value type must derived from StorageInterface");
+
+		struct Node
 		{
-			std::lock_guard<std::mutex> lockGuard(m_lock);
-
-			// Cache weak ptr value.
-			m_cacheWeakPtrMap[key] = value;
-			m_usedSize += value->getSize();
-
-			// LRU asset can insert repeatly, it loop whole map to find exist or not.
-			const auto iter = m_lruMap.find(key);
-			if (iter != m_lruMap.end())
-			{
-				// Key exist, update map value, and update list.
-				m_usedSize -= iter->second->second->getSize();
-				iter->second->second = value;
-
-				m_lruList.splice(m_lruList.begin(), m_lruList, iter->second);
-				return;
-			}
-
-			// Key no exist, emplace to list front, and update map key-value.
-			m_lruList.emplace_front(key, std::move(value));
-			m_lruMap[key] = m_lruList.begin();
-
-			// May oversize, need reduce.
-			prune();
-		}
+			// Point to key of map, map node never move.
+			const KeyType* key = nullptr;
+
+			// Null when evicted, value still reachable by weak reference until other owner release it.
+			std::shared_ptr<ValueType> owner = nullptr;
+			std::weak_ptr<ValueType> weak;
+
+			uint32_t size = 0;
 
-		// Try to get value, will return nullptr if no exist.
-		std::shared_ptr<ValueType> tryGet(const KeyType& inKey)
+			// Hit since last move to list front.
+			std::atomic<bool> bReferenced = false;
+
+			Node* prev = nullptr;
+			Node* next = nullptr;
+		};
+
+		struct NodeList
 		{
-			std::lock_guard<std::mutex> lockGuard(m_lock);
-
-			// Else found in lru map.
-			const auto iter = m_lruMap.find(inKey);
-			if (iter == m_lruMap.end())
-			{
-				// May still valid in weak ptr cache, try get.
-				std::weak_ptr<ValueType> weakPtr = m_cacheWeakPtrMap[inKey];
-				if (auto sharePtr = weakPtr.lock())
-				{
-					return sharePtr;
-				}
-				else
-				{
-					// Unvalid weak ptr, remove.
-					m_cacheWeakPtrMap.erase(inKey);
-				}
-
-				// No valid instance, return nullptr and need reload.
-				return nullptr;
-			}
-
-			// Still exist in lru map, set as first guy.
-			m_lruList.splice(m_lruList.begin(), m_lruList, iter->second);
-			return iter->second->second;
-		}
+			Node* head = nullptr;
+			Node* tail = nullptr;
+			uint32_t count = 0;
+
+			void pushFront(Node* node);
+			void remove(Node* node);
+		};
 
-		// Prune lru map.
-		size_t prune(std::function<void(std::shared_ptr<ValueType>)>&& reduceFunction = nullptr)
+		struct alignas(CPU_CACHELINE_SIZE) Shard
 		{
-			size_t maxAllowed = m_capacity + m_elasticity;
-			if (m_capacity == 0 || m_usedSize < maxAllowed)
-			{
-				return 0;
-			}
-
-			// Loop until release enough resource.
-			size_t reduceSize = 0;
-			while (m_usedSize > m_capacity)
-			{
-				size_t eleSize = m_lruList.back().second->getSize();
-
-				// Do a callback if valid.
-				if (reduceFunction)
-				{
-					reduceFunction(m_lruList.back().second);
-				}
-
-				// Erase last one.
-				m_lruMap.erase(m_lruList.back().first);
-				m_lruList.pop_back();
-
-				// Update size.
-				m_usedSize -= eleSize;
-				reduceSize += eleSize;
-			}
-
-			return reduceSize;
-		}
+			mutable std::shared_mutex lock;
+			std::unordered_map<KeyType, Node> nodes;
 
-	protected:
-		static_assert(std::is_base_of_v<StorageInterface, ValueType>, 
-			"Value type must derived from StorageInterface");
+			// Most recent use at head.
+			NodeList ownerList;
+
+			// Evicted nodes, sweep when owner outside release.
+			NodeList weakList;
 
-		using LRUList = std::list<std::pair<KeyType, std::shared_ptr<ValueType>>>;
-		using LRUListNode = LRUList::iterator;
+			std::atomic<uint64_t> hitCount = 0;
+			std::atomic<uint64_t> weakHitCount = 0;
+			std::atomic<uint64_t> missCount = 0;
+		};
 
-		// LRU data struct.
-		LRUList m_lruList;
-		std::unordered_map<KeyType, LRUListNode> m_lruMap;
+		Shard& getShard(const KeyType& key) { return m_shards[std::hash<KeyType>{}(key) % kShardCount]; }
+		const Shard& getShard(const KeyType& key) const { return m_shards[std::hash<KeyType>{}(key) % kShardCount]; }
 
-		// Some asset may prune when space is not enough, but may cache in other system, in this case, it still can used.
-		std::unordered_map<KeyType, std::weak_ptr<ValueType>> m_cacheWeakPtrMap;
+		// Evict least recent unreferenced node of shard, require shard lock, return false if shard no owner node.
+		bool evictOne(Shard& shard, std::shared_ptr<ValueType>& outValue, uint32_t& outSize);
+
+		// Evict round robin between shards until used size not over target.
+		size_t evictUntil(size_t targetUsedSize, std::function<void(std::shared_ptr<ValueType>)>&& reduceFunction);
+
+		// Check a few weak nodes, erase released ones, require shard lock.
+		void sweepWeakNodes(Shard& shard);
+
+		Shard m_shards[kShardCount];
 
 		// LRU cache desire capacity.
 		size_t m_capacity;
@@ -208,10 +169,14 @@ namespace engine
 		// Some elasticity space to enable LRU cache no always prune.
 		size_t m_elasticity;
 
-		// Shared_ptr(m_lruMap) used size.
+		// Shared_ptr(owner list) used size.
 		std::atomic<size_t> m_usedSize = 0;
 
-		// Lock mutex for map edit.
-		std::mutex m_lock;
+		// Only one prune loop shards at the same time, next shard to evict from.
+		std::mutex m_pruneLock;
+		uint32_t m_pruneCursor = 0;
+
+		std::atomic<uint64_t> m_evictionCount = 0;
+		std::atomic<uint64_t> m_evictedSize = 0;
 	};
-}
\ No newline at end of file
+}
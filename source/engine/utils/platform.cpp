@@ -0,0 +1,197 @@
+#include "platform.h"
+
+#if _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <Windows.h>
+    #include <Psapi.h>
+    #pragma comment(lib, "Psapi.lib")
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/resource.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #include <fstream>
+#endif
+
+namespace engine
+{
+#if _WIN32
+    bool MappedFile::open(const std::filesystem::path& path)
+    {
+        close();
+
+        HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        m_fileHandle = file;
+        m_mappingHandle = mapping;
+        m_data = (const uint8_t*)view;
+        m_size = (size_t)fileSize.QuadPart;
+
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data)
+        {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mappingHandle)
+        {
+            CloseHandle((HANDLE)m_mappingHandle);
+        }
+        if (m_fileHandle)
+        {
+            CloseHandle((HANDLE)m_fileHandle);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+        m_fileHandle = nullptr;
+        m_mappingHandle = nullptr;
+    }
+
+    ProcessMemoryStat getProcessMemoryStat()
+    {
+        ProcessMemoryStat result { };
+
+        PROCESS_MEMORY_COUNTERS counters { };
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            result.residentSize = counters.WorkingSetSize;
+            result.peakResidentSize = counters.PeakWorkingSetSize;
+        }
+
+        return result;
+    }
+
+    bool evictFileCache(const std::filesystem::path& path)
+    {
+        // Open without buffering purge cached pages of the file when no other handle map it.
+        HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+            OPEN_EXISTING, FILE_FLAG_NO_BUFFERING, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        CloseHandle(file);
+        return true;
+    }
+#else
+    bool MappedFile::open(const std::filesystem::path& path)
+    {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        void* view = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        // Mapping keep a reference of the file, so descriptor can close now.
+        ::close(fd);
+        if (view == MAP_FAILED)
+        {
+            return false;
+        }
+        madvise(view, (size_t)fileStat.st_size, MADV_SEQUENTIAL);
+
+        m_data = (const uint8_t*)view;
+        m_size = (size_t)fileStat.st_size;
+
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data)
+        {
+            munmap((void*)m_data, m_size);
+        }
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    ProcessMemoryStat getProcessMemoryStat()
+    {
+        ProcessMemoryStat result { };
+
+        // Current resident size from statm, in pages.
+        {
+            std::ifstream statm("/proc/self/statm");
+            size_t totalPages = 0;
+            size_t residentPages = 0;
+            if (statm >> totalPages >> residentPages)
+            {
+                result.residentSize = residentPages * (size_t)sysconf(_SC_PAGESIZE);
+            }
+        }
+
+        // Peak resident size, linux report in kilobytes.
+        rusage usage { };
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+            result.peakResidentSize = (size_t)usage.ru_maxrss * 1024;
+        }
+
+        return result;
+    }
+
+    bool evictFileCache(const std::filesystem::path& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        // Dirty page can't drop, write back first.
+        fdatasync(fd);
+        const bool bSucceed = posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0;
+
+        ::close(fd);
+        return bSucceed;
+    }
+#endif
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <filesystem>
+#include <streambuf>
+
+#include "noncopyable.h"
+
+namespace engine
+{
+    // Read only memory mapped file, page in by os when access, no heap copy.
+    class MappedFile : NonCopyable
+    {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const std::filesystem::path& path) { open(path); }
+        ~MappedFile() { close(); }
+
+        // Map whole file into address space, return false if file miss or map fail.
+        bool open(const std::filesystem::path& path);
+        void close();
+
+        bool isValid() const { return m_data != nullptr; }
+
+        const uint8_t* getData() const { return m_data; }
+        size_t getSize() const { return m_size; }
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+
+        // Platform handles.
+        void* m_fileHandle = nullptr;
+        void* m_mappingHandle = nullptr;
+    };
+
+    // Stream buffer view of exist memory, use to feed cereal without std::string/std::stringstream copy.
+    class MemoryViewStreamBuffer : public std::streambuf
+    {
+    public:
+        explicit MemoryViewStreamBuffer(const void* data, size_t size)
+        {
+            char* start = (char*)data;
+            setg(start, start, start + size);
+        }
+
+    protected:
+        virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override
+        {
+            char* target = gptr();
+            if (dir == std::ios_base::beg) target = eback() + off;
+            else if (dir == std::ios_base::cur) target = gptr() + off;
+            else if (dir == std::ios_base::end) target = egptr() + off;
+
+            if (target < eback() || target > egptr())
+            {
+                return pos_type(off_type(-1));
+            }
+
+            setg(eback(), target, egptr());
+            return pos_type(target - eback());
+        }
+
+        virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which) override
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, which);
+        }
+    };
+
+    struct ProcessMemoryStat
+    {
+        // Current resident memory size in bytes.
+        size_t residentSize = 0;
+
+        // Peak resident memory size in bytes since process start.
+        size_t peakResidentSize = 0;
+    };
+
+    extern ProcessMemoryStat getProcessMemoryStat();
+
+    // Drop cached pages of file from os page cache, so next read hit disk, used by cold io benchmark.
+    // Return false if file miss or os refuse, file still mapped by other handle may keep its pages.
+    extern bool evictFileCache(const std::filesystem::path& path);
+}
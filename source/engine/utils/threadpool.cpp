@@ -0,0 +1,635 @@
+#include "threadpool.h"
+#include "log.h"
+
+#include <queue>
+#include <functional>
+
+namespace engine
+{
+	// Worker identity of current thread, task push from worker go into its own queue.
+	static thread_local const ThreadPool* sWorkerPool = nullptr;
+	static thread_local uint32_t sWorkerIndex = 0;
+
+	// Idle worker retry before sleep, cheaper than sleep and wake for short task burst.
+	static const uint32_t kWorkerSpinCount = 32;
+
+	static uint32_t computeThreadCount(bool bLeftOneFreeCore, uint32_t threadCount)
+	{
+		if (threadCount > 0)
+		{
+			return threadCount;
+		}
+
+		const static uint32_t kMaxCoreThreadNum = std::thread::hardware_concurrency();
+		uint32_t result = 0;
+
+		if (kMaxCoreThreadNum > 0)
+		{
+			result = bLeftOneFreeCore ? (kMaxCoreThreadNum - 1) : kMaxCoreThreadNum;
+		}
+
+		result = std::max(1u, result);
+		return result;
+	}
+
+	ThreadPool::ThreadPool(bool bLeftOneFreeCore, uint32_t threadCount)
+	{
+		m_threadCount = computeThreadCount(bLeftOneFreeCore, threadCount);
+		createThreads();
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		waitForTasks();
+		destroyThreads();
+	}
+
+	void ThreadPool::setPause(bool bState)
+	{
+		m_bPaused = bState;
+
+		if (!bState)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_sleepMutex);
+			}
+			m_cvTaskAvailable.notify_all();
+			m_cvTaskDone.notify_all();
+		}
+	}
+
+	void ThreadPool::pushTaskImpl(ThreadPoolTask&& task, TaskCounter* counter)
+	{
+		if (counter)
+		{
+			counter->m_count++;
+		}
+		m_tasksTotalNum++;
+
+		// Nested task stay in worker own queue, hot in its cache.
+		const uint32_t queueIndex = (sWorkerPool == this)
+			? sWorkerIndex
+			: m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_threadCount;
+
+		// Queued count increase before task visible, so pop never decrease it first.
+		m_tasksQueuedNum++;
+
+		auto& queue = m_queues[queueIndex];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back({ std::move(task), counter });
+			queue.count++;
+		}
+
+		// Sleeping flag check after queued count increase, lock before notify so no lost wake up.
+		if (m_sleepingNum > 0)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_sleepMutex);
+			}
+			m_cvTaskAvailable.notify_one();
+		}
+
+		if (m_waitingNum > 0)
+		{
+			notifyWaiters();
+		}
+	}
+
+	bool ThreadPool::popTask(QueuedTask& out)
+	{
+		if (m_tasksQueuedNum == 0)
+		{
+			return false;
+		}
+
+		const bool bWorker = (sWorkerPool == this);
+		if (bWorker)
+		{
+			auto& queue = m_queues[sWorkerIndex];
+			if (queue.count > 0)
+			{
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if (!queue.tasks.empty())
+				{
+					out = std::move(queue.tasks.back());
+					queue.tasks.pop_back();
+					queue.count--;
+					m_tasksQueuedNum--;
+					return true;
+				}
+			}
+		}
+
+		// Steal oldest task from other queues, start from neighbor so thieves spread.
+		const uint32_t startIndex = bWorker ? sWorkerIndex + 1 : m_nextQueue.load(std::memory_order_relaxed);
+		for (uint32_t i = 0; i < m_threadCount; i++)
+		{
+			const uint32_t queueIndex = (startIndex + i) % m_threadCount;
+			if (bWorker && queueIndex == sWorkerIndex)
+			{
+				continue;
+			}
+
+			auto& queue = m_queues[queueIndex];
+			if (queue.count == 0)
+			{
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.tasks.empty())
+			{
+				out = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+				queue.count--;
+				m_tasksQueuedNum--;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool ThreadPool::popCountedTask(const TaskCounter& counter, QueuedTask& out)
+	{
+		for (uint32_t queueIndex = 0; queueIndex < m_threadCount; queueIndex++)
+		{
+			auto& queue = m_queues[queueIndex];
+			if (queue.count == 0)
+			{
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			for (auto iter = queue.tasks.begin(); iter != queue.tasks.end(); ++iter)
+			{
+				if (iter->counter == &counter)
+				{
+					out = std::move(*iter);
+					queue.tasks.erase(iter);
+					queue.count--;
+					m_tasksQueuedNum--;
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool ThreadPool::tryRunTask()
+	{
+		QueuedTask queuedTask;
+		if (!popTask(queuedTask))
+		{
+			return false;
+		}
+
+		runQueuedTask(queuedTask);
+		return true;
+	}
+
+	void ThreadPool::runQueuedTask(QueuedTask& queuedTask)
+	{
+		queuedTask.task();
+
+		// Release task captures before finish, waiter may destroy captured objects after finish.
+		queuedTask.task = ThreadPoolTask();
+
+		if (queuedTask.counter)
+		{
+			queuedTask.counter->m_count--;
+		}
+		m_tasksTotalNum--;
+
+		if (m_waitingNum > 0)
+		{
+			notifyWaiters();
+		}
+	}
+
+	void ThreadPool::notifyWaiters()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+		}
+		m_cvTaskDone.notify_all();
+	}
+
+	void ThreadPool::waitForTasks()
+	{
+		while (true)
+		{
+			if (m_tasksTotalNum == (m_bPaused ? m_tasksQueuedNum.load() : 0))
+			{
+				return;
+			}
+
+			if (!m_bPaused && tryRunTask())
+			{
+				continue;
+			}
+
+			m_waitingNum++;
+			{
+				std::unique_lock<std::mutex> lock(m_sleepMutex);
+				m_cvTaskDone.wait(lock, [this]
+				{
+					return
+						(m_tasksTotalNum == (m_bPaused ? m_tasksQueuedNum.load() : 0)) ||
+						(!m_bPaused && m_tasksQueuedNum > 0);
+				});
+			}
+			m_waitingNum--;
+		}
+	}
+
+	void ThreadPool::waitForCounter(TaskCounter& counter)
+	{
+		while (!counter.isDone())
+		{
+			if (!m_bPaused && tryRunTask())
+			{
+				continue;
+			}
+
+			m_waitingNum++;
+			{
+				std::unique_lock<std::mutex> lock(m_sleepMutex);
+				m_cvTaskDone.wait(lock, [&]
+				{
+					return counter.isDone() || (!m_bPaused && m_tasksQueuedNum > 0);
+				});
+			}
+			m_waitingNum--;
+		}
+	}
+
+	void ThreadPool::waitForOwnTasks(TaskCounter& counter)
+	{
+		while (!counter.isDone())
+		{
+			// Own queued task run even when pause, no one else will.
+			QueuedTask queuedTask;
+			if (popCountedTask(counter, queuedTask))
+			{
+				runQueuedTask(queuedTask);
+				continue;
+			}
+
+			// Rest tasks running on other threads, sleep until one finish.
+			m_waitingNum++;
+			{
+				std::unique_lock<std::mutex> lock(m_sleepMutex);
+				m_cvTaskDone.wait(lock, [&]
+				{
+					return counter.isDone();
+				});
+			}
+			m_waitingNum--;
+		}
+	}
+
+	void ThreadPool::worker(uint32_t index)
+	{
+		sWorkerPool = this;
+		sWorkerIndex = index;
+
+		uint32_t spinCount = 0;
+		while (m_bRuning)
+		{
+			if (!m_bPaused && tryRunTask())
+			{
+				spinCount = 0;
+				continue;
+			}
+
+			if (spinCount < kWorkerSpinCount)
+			{
+				spinCount++;
+				std::this_thread::yield();
+				continue;
+			}
+
+			m_sleepingNum++;
+			{
+				std::unique_lock<std::mutex> lock(m_sleepMutex);
+				m_cvTaskAvailable.wait(lock, [this]
+				{
+					return !m_bRuning || (!m_bPaused && m_tasksQueuedNum > 0);
+				});
+			}
+			m_sleepingNum--;
+			spinCount = 0;
+		}
+
+		sWorkerPool = nullptr;
+	}
+
+	void ThreadPool::createThreads()
+	{
+		m_queues = std::make_unique<WorkerQueue[]>(m_threadCount);
+		m_threads = std::make_unique<std::thread[]>(m_threadCount);
+
+		m_bRuning = true;
+		for (uint32_t i = 0; i < m_threadCount; i++)
+		{
+			m_threads[i] = std::thread(&ThreadPool::worker, this, i);
+		}
+	}
+
+	void ThreadPool::destroyThreads()
+	{
+		m_bRuning = false;
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+		}
+		m_cvTaskAvailable.notify_all();
+
+		for (uint32_t i = 0; i < m_threadCount; i++)
+		{
+			m_threads[i].join();
+		}
+	}
+
+	void ThreadPool::reset(bool bLeftOneFreeCore, uint32_t threadCount)
+	{
+		const bool wasPaused = m_bPaused;
+
+		// Queued tasks keep in queues when pause, move them to new queues after threads recreate.
+		m_bPaused = true;
+		waitForTasks();
+		destroyThreads();
+
+		std::vector<QueuedTask> queuedTasks { };
+		for (uint32_t i = 0; i < m_threadCount; i++)
+		{
+			for (auto& queuedTask : m_queues[i].tasks)
+			{
+				queuedTasks.push_back(std::move(queuedTask));
+			}
+		}
+
+		m_threadCount = computeThreadCount(bLeftOneFreeCore, threadCount);
+		createThreads();
+
+		for (size_t i = 0; i < queuedTasks.size(); i++)
+		{
+			auto& queue = m_queues[i % m_threadCount];
+			queue.tasks.push_back(std::move(queuedTasks[i]));
+			queue.count++;
+		}
+
+		setPause(wasPaused);
+	}
+
+	// Old single queue pool, one std::function queue behind one lock, only keep for benchmark compare.
+	class SingleQueueThreadPool : NonCopyable
+	{
+	public:
+		explicit SingleQueueThreadPool(uint32_t threadCount)
+			: m_threads(threadCount)
+		{
+			for (auto& thread : m_threads)
+			{
+				thread = std::thread(&SingleQueueThreadPool::worker, this);
+			}
+		}
+
+		~SingleQueueThreadPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_bRuning = false;
+			}
+			m_cvTaskAvailable.notify_all();
+
+			for (auto& thread : m_threads)
+			{
+				thread.join();
+			}
+		}
+
+		void pushTask(std::function<void()>&& task)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_tasks.push(std::move(task));
+				m_tasksTotalNum++;
+			}
+			m_cvTaskAvailable.notify_one();
+		}
+
+		void waitForTasks()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_cvTaskDone.wait(lock, [this] { return m_tasksTotalNum == 0; });
+		}
+
+	private:
+		void worker()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while (true)
+			{
+				m_cvTaskAvailable.wait(lock, [this] { return !m_tasks.empty() || !m_bRuning; });
+				if (!m_bRuning)
+				{
+					return;
+				}
+
+				auto task = std::move(m_tasks.front());
+				m_tasks.pop();
+
+				lock.unlock();
+				task();
+				lock.lock();
+
+				if (--m_tasksTotalNum == 0)
+				{
+					m_cvTaskDone.notify_all();
+				}
+			}
+		}
+
+		std::mutex m_mutex;
+		std::condition_variable m_cvTaskAvailable;
+		std::condition_variable m_cvTaskDone;
+		std::queue<std::function<void()>> m_tasks;
+		size_t m_tasksTotalNum = 0;
+		bool m_bRuning = true;
+		std::vector<std::thread> m_threads;
+	};
+
+	void engine::benchmarkThreadPool()
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		auto getMilliseconds = [](Clock::time_point start)
+		{
+			return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		};
+
+		// Tiny tasks so scheduler overhead and lock contention dominate.
+		constexpr uint32_t kTaskCount = 200000;
+		constexpr uint32_t kFanOutParentCount = 64;
+		constexpr uint32_t kFanOutChildCount = kTaskCount / kFanOutParentCount;
+
+		std::atomic<uint64_t> sink = 0;
+		auto work = [&sink](uint32_t i)
+		{
+			uint64_t value = i;
+			for (uint32_t j = 0; j < 16; j++)
+			{
+				value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+			}
+			sink.fetch_add(value & 1, std::memory_order_relaxed);
+		};
+
+		LOG_INFO("Thread pool benchmark: {0} tiny tasks, flat push from caller and fan out from {1} parent tasks.", kTaskCount, kFanOutParentCount);
+		for (uint32_t threadCount : { 1u, 8u, 32u })
+		{
+			double singleQueueFlat;
+			double singleQueueFanOut;
+			{
+				SingleQueueThreadPool pool(threadCount);
+
+				auto startTime = Clock::now();
+				for (uint32_t i = 0; i < kTaskCount; i++)
+				{
+					pool.pushTask([&work, i]() { work(i); });
+				}
+				pool.waitForTasks();
+				singleQueueFlat = getMilliseconds(startTime);
+
+				startTime = Clock::now();
+				for (uint32_t i = 0; i < kFanOutParentCount; i++)
+				{
+					pool.pushTask([&pool, &work]()
+					{
+						for (uint32_t j = 0; j < kFanOutChildCount; j++)
+						{
+							pool.pushTask([&work, j]() { work(j); });
+						}
+					});
+				}
+				pool.waitForTasks();
+				singleQueueFanOut = getMilliseconds(startTime);
+			}
+
+			double workStealingFlat;
+			double workStealingFanOut;
+			{
+				ThreadPool pool(false, threadCount);
+
+				auto startTime = Clock::now();
+				{
+					TaskCounter counter;
+					for (uint32_t i = 0; i < kTaskCount; i++)
+					{
+						pool.pushCountedTask(counter, [&work, i]() { work(i); });
+					}
+					pool.waitForCounter(counter);
+				}
+				workStealingFlat = getMilliseconds(startTime);
+
+				startTime = Clock::now();
+				{
+					// Parent wait its children, helping wait so no deadlock even at one thread.
+					TaskCounter counter;
+					for (uint32_t i = 0; i < kFanOutParentCount; i++)
+					{
+						pool.pushCountedTask(counter, [&pool, &work]()
+						{
+							TaskCounter childCounter;
+							for (uint32_t j = 0; j < kFanOutChildCount; j++)
+							{
+								pool.pushCountedTask(childCounter, [&work, j]() { work(j); });
+							}
+							pool.waitForCounter(childCounter);
+						});
+					}
+					pool.waitForCounter(counter);
+				}
+				workStealingFanOut = getMilliseconds(startTime);
+			}
+
+			LOG_INFO("  {0} threads: single queue flat {1:.2f} ms, fan out {2:.2f} ms; work stealing flat {3:.2f} ms, fan out {4:.2f} ms.",
+				threadCount, singleQueueFlat, singleQueueFanOut, workStealingFlat, workStealingFanOut);
+		}
+
+		LOG_TRACE("Thread pool benchmark sink {}.", sink.load());
+	}
+
+	void engine::benchmarkParallelFor()
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		auto getMicroseconds = [](Clock::time_point start)
+		{
+			return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+		};
+
+		std::atomic<uint64_t> sink = 0;
+		auto work = [](size_t i, uint32_t cost)
+		{
+			uint64_t value = i;
+			for (uint32_t j = 0; j < cost; j++)
+			{
+				value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+			}
+			return value & 1;
+		};
+
+		struct LoopCase
+		{
+			const char* name;
+			size_t size;
+			uint32_t repeat;
+
+			// Iteration cost grow with index when true, such as mip levels or rows with vary content.
+			bool bVaryCost;
+		};
+
+		const LoopCase cases[] =
+		{
+			{ "small",  64,      2000, false },
+			{ "large",  1 << 20, 10,   false },
+			{ "vary",   4096,    50,   true  },
+		};
+
+		ThreadPool pool(false);
+		LOG_INFO("Parallel for benchmark on {} threads.", pool.getThreadCount());
+
+		for (const auto& loopCase : cases)
+		{
+			auto loop = [&](const size_t loopStart, const size_t loopEnd)
+			{
+				uint64_t local = 0;
+				for (size_t i = loopStart; i < loopEnd; i++)
+				{
+					local += work(i, loopCase.bVaryCost ? uint32_t(i / 4) : 16);
+				}
+				sink.fetch_add(local, std::memory_order_relaxed);
+			};
+
+			auto startTime = Clock::now();
+			for (uint32_t i = 0; i < loopCase.repeat; i++)
+			{
+				pool.parallelizeLoop(0, loopCase.size, loop).wait();
+			}
+			const double parallelizeLoopTime = getMicroseconds(startTime) / loopCase.repeat;
+
+			startTime = Clock::now();
+			for (uint32_t i = 0; i < loopCase.repeat; i++)
+			{
+				pool.parallelFor(0, loopCase.size, loop);
+			}
+			const double parallelForTime = getMicroseconds(startTime) / loopCase.repeat;
+
+			LOG_INFO("  {0} loop of {1} iterations: parallelizeLoop {2:.2f} us, parallelFor {3:.2f} us.",
+				loopCase.name, loopCase.size, parallelizeLoopTime, parallelForTime);
+		}
+
+		LOG_TRACE("Parallel for benchmark sink {}.", sink.load());
+	}
+}
@@ -1,13 +1,19 @@
 #pragma once
 
+#include <cstddef>
+
 #include "noncopyable.h"
+#include "cacheline.h"
 
 #include <vector>
+#include <deque>
 #include <future>
 #include <thread>
 #include <condition_variable>
 #include <mutex>
-#include <queue>
+#include <atomic>
+#include <memory>
+#include <new>
 #include <type_traits>
 #include <algorithm>
 #include <chrono>
@@ -20,11 +26,24 @@ namespace engine
 		return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
 	}
 
+	// Blocks of parallel loop claim by index, so waiting caller run unclaimed blocks itself.
+	class ParallelLoopBlocks : NonCopyable
+	{
+	public:
+		virtual ~ParallelLoopBlocks() = default;
+
+		// Claim and run one block, return false when all blocks claimed.
+		virtual bool runNextBlock() = 0;
+	};
+
 	template<typename T>
 	struct FutureCollection
 	{
 		std::vector<std::future<T>> futures;
 
+		// Valid when collection come from parallel loop.
+		std::shared_ptr<ParallelLoopBlocks> blocks = nullptr;
+
 		FutureCollection(const size_t num = 0)
 			: futures(num)
 		{
@@ -33,6 +52,8 @@ namespace engine
 
 		[[nodiscard]] inline std::vector<T> get()
 		{
+			wait();
+
 			std::vector<T> results(futures.size());
 			for (size_t i = 0; i < futures.size(); i++)
 			{
@@ -41,8 +62,14 @@ namespace engine
 			return results;
 		}
 
+		// Run unclaimed blocks on caller, then wait blocks running on workers, safe to call inside pool task.
 		inline void wait() const
 		{
+			if (blocks)
+			{
+				while (blocks->runNextBlock()) { }
+			}
+
 			for (size_t i = 0; i < futures.size(); i++)
 			{
 				futures[i].wait();
@@ -64,102 +91,134 @@ namespace engine
 		}
 	};
 
-	class ThreadPool : NonCopyable
+	// Type erased move only callable, small callable store inline so push task no heap allocation.
+	class ThreadPoolTask
 	{
-	private:
-		// Set this value to true to pause all task in this threadpool.
-		// Set this value to false to enable all task in this threadpool.
-		std::atomic<bool> m_bPaused = false;
-
-		// Flag of runing or waiting.
-		std::atomic<bool> m_bRuning = false;
-		std::atomic<bool> m_bWaiting = false;
+	public:
+		static constexpr size_t kInlineSize = 48;
 
-		std::condition_variable m_cvTaskAvailable;
-		std::condition_variable m_cvTaskDone;
+		ThreadPoolTask() = default;
 
-		std::atomic<size_t> m_tasksQueueTotalNum = 0;
-		mutable std::mutex m_taskQueueMutex;
-		std::queue<std::function<void()>> m_tasksQueue;
+		template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, ThreadPoolTask>>>
+		ThreadPoolTask(F&& func)
+		{
+			using Func = std::decay_t<F>;
+			if constexpr (sizeof(Func) <= kInlineSize && alignof(Func) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Func>)
+			{
+				new (m_storage) Func(std::forward<F>(func));
+				m_ops = &kInlineOps<Func>;
+			}
+			else
+			{
+				// Big callable fallback to heap.
+				*reinterpret_cast<Func**>(m_storage) = new Func(std::forward<F>(func));
+				m_ops = &kHeapOps<Func>;
+			}
+		}
 
-		uint32_t m_threadCount = 0;
-		std::unique_ptr<std::thread[]> m_threads = nullptr;
+		ThreadPoolTask(ThreadPoolTask&& other) noexcept
+		{
+			moveFrom(other);
+		}
 
-	private:
-		void worker()
+		ThreadPoolTask& operator=(ThreadPoolTask&& other) noexcept
 		{
-			while (m_bRuning)
+			if (this != &other)
 			{
-				std::function<void()> task;
-
-				std::unique_lock<std::mutex> lockTasksQueue(m_taskQueueMutex);
-				m_cvTaskAvailable.wait(lockTasksQueue, [&]
-				{
-					// When task queue no empty, keep moving.
-					return !m_tasksQueue.empty() || !m_bRuning;
-				});
+				reset();
+				moveFrom(other);
+			}
+			return *this;
+		}
 
-				if (m_bRuning && !m_bPaused)
-				{
-					task = std::move(m_tasksQueue.front());
-					m_tasksQueue.pop();
+		ThreadPoolTask(const ThreadPoolTask&) = delete;
+		ThreadPoolTask& operator=(const ThreadPoolTask&) = delete;
 
-					// Unlock so other thread can find task from queue.
-					lockTasksQueue.unlock();
+		~ThreadPoolTask()
+		{
+			reset();
+		}
 
-                    // Execute task.
-					task();
+		explicit operator bool() const { return m_ops != nullptr; }
 
-					// When task finish, we need lock again to minus queue num.
-					// Alway invoke new guy when waiting.
-                    lockTasksQueue.lock();
-					--m_tasksQueueTotalNum;
-					if (m_bWaiting)
-					{
-						m_cvTaskDone.notify_one();
-					}
-				}
-			}
+		void operator()()
+		{
+			m_ops->invoke(m_storage);
 		}
 
-		void createThread()
+	private:
+		struct Ops
+		{
+			void (*invoke)(void* storage);
+
+			// Move construct into dest storage and destroy src.
+			void (*move)(void* dest, void* src);
+			void (*destroy)(void* storage);
+		};
+
+		template<typename Func>
+		static constexpr Ops kInlineOps =
+		{
+			[](void* storage) { (*static_cast<Func*>(storage))(); },
+			[](void* dest, void* src) { new (dest) Func(std::move(*static_cast<Func*>(src))); static_cast<Func*>(src)->~Func(); },
+			[](void* storage) { static_cast<Func*>(storage)->~Func(); },
+		};
+
+		template<typename Func>
+		static constexpr Ops kHeapOps =
 		{
-			m_bRuning = true;
-			for (uint32_t i = 0; i < m_threadCount; i++)
+			[](void* storage) { (**static_cast<Func**>(storage))(); },
+			[](void* dest, void* src) { *static_cast<Func**>(dest) = *static_cast<Func**>(src); },
+			[](void* storage) { delete *static_cast<Func**>(storage); },
+		};
+
+		void moveFrom(ThreadPoolTask& other)
+		{
+			if (other.m_ops)
 			{
-				m_threads[i] = std::thread(&ThreadPool::worker, this);
+				other.m_ops->move(m_storage, other.m_storage);
+				m_ops = other.m_ops;
+				other.m_ops = nullptr;
 			}
 		}
 
-		void destroyThreads()
+		void reset()
 		{
-			m_bRuning = false;
-			m_cvTaskAvailable.notify_all();
-			for (uint32_t i = 0; i < m_threadCount; i++)
+			if (m_ops)
 			{
-				m_threads[i].join();
+				m_ops->destroy(m_storage);
+				m_ops = nullptr;
 			}
 		}
 
-		inline uint32_t getThreadCount(bool bLeftOneFreeCore)
-		{
-			const static uint32_t kMaxCoreThreadNum = std::thread::hardware_concurrency();
-			uint32_t result = 0;
+		alignas(std::max_align_t) unsigned char m_storage[kInlineSize];
+		const Ops* m_ops = nullptr;
+	};
 
-			if (kMaxCoreThreadNum > 0)
-			{
-				result = bLeftOneFreeCore ? (kMaxCoreThreadNum - 1) : kMaxCoreThreadNum;
-			}
+	// Count unfinished tasks push with it, use as dependency handle of a task group.
+	class TaskCounter : NonCopyable
+	{
+	public:
+		bool isDone() const { return m_count.load() == 0; }
+		uint32_t getCount() const { return m_count.load(); }
 
-			result = std::max(1u, result);
-			return result;
-		}
+	private:
+		friend class ThreadPool;
+		std::atomic<uint32_t> m_count = 0;
+	};
 
+	// Work stealing thread pool.
+	// Each worker own a deque, worker push and pop its own deque back, idle worker steal other deque front.
+	// Task push from other threads spread over worker deques round robin, so no single queue lock to serialize on.
+	// Waiting thread help run tasks, so task wait its subtasks never deadlock.
+	class ThreadPool : NonCopyable
+	{
 	public:
-		void setPause(bool bState)
-		{
-			m_bPaused = bState;
-		}
+		// Thread count zero use hardware concurrency.
+		explicit ThreadPool(bool bLeftOneFreeCore = true, uint32_t threadCount = 0);
+		~ThreadPool();
+
+		void setPause(bool bState);
 
 		bool getPauseState() const
 		{
@@ -168,19 +227,17 @@ namespace engine
 
 		[[nodiscard]] size_t getTasksQueuedNum() const
 		{
-			const std::scoped_lock tasksLock(m_taskQueueMutex);
-			return m_tasksQueue.size();
+			return m_tasksQueuedNum;
 		}
 
 		[[nodiscard]] size_t getTasksRunningNum() const
 		{
-			const std::scoped_lock tasks_lock(m_taskQueueMutex);
-			return m_tasksQueueTotalNum - m_tasksQueue.size();
+			return m_tasksTotalNum - m_tasksQueuedNum;
 		}
 
 		[[nodiscard]] size_t getTasksTotal() const
 		{
-			return m_tasksQueueTotalNum;
+			return m_tasksTotalNum;
 		}
 
 		[[nodiscard]] uint32_t getThreadCount() const
@@ -189,71 +246,62 @@ namespace engine
 		}
 
 		// Wait for all task finish, if when pause, wait for all processing task finish.
-		void waitForTasks()
-		{
-			m_bWaiting = true;
+		// Caller help run tasks when not pause, never call inside pool task.
+		void waitForTasks();
 
-			std::unique_lock<std::mutex> tasksLock(m_taskQueueMutex);
-			m_cvTaskDone.wait(tasksLock, [this]
-			{
-				return (m_tasksQueueTotalNum == (m_bPaused ? m_tasksQueue.size() : 0));
-			});
-			m_bWaiting = false;
-		}
+		// Wait all tasks push with counter finish, caller help run queued tasks meanwhile.
+		// Helping caller may run any queued task, include long one from other system.
+		void waitForCounter(TaskCounter& counter);
+
+		// Wait all tasks push with counter finish, caller only help run queued tasks of this counter.
+		// Use when caller must not pick long task from other system, such as main thread in frame.
+		void waitForOwnTasks(TaskCounter& counter);
 
 		template <typename F, typename... A>
 		void pushTask(const F& task, const A&... args)
 		{
+			if constexpr (sizeof...(args) == 0)
 			{
-				const std::scoped_lock tasksLock(m_taskQueueMutex);
-				if constexpr (sizeof...(args) == 0)
-				{
-					m_tasksQueue.push(std::function<void()>(task));
-				}
-				else
-				{
-					m_tasksQueue.push(std::function<void()>([task, args...]{ task(args...); }));
-				}
+				pushTaskImpl(ThreadPoolTask(task), nullptr);
+			}
+			else
+			{
+				pushTaskImpl(ThreadPoolTask([task, args...]() { task(args...); }), nullptr);
 			}
-			++m_tasksQueueTotalNum;
-			m_cvTaskAvailable.notify_one();
+		}
+
+		// Task finish decrease counter, wait it with waitForCounter.
+		template <typename F>
+		void pushCountedTask(TaskCounter& counter, F&& task)
+		{
+			pushTaskImpl(ThreadPoolTask(std::forward<F>(task)), &counter);
 		}
 
 		template <typename F, typename... A, typename R = std::invoke_result_t<std::decay_t<F>, std::decay_t<A>...>>
 		[[nodiscard]] std::future<R> submit(const F& task, const A&... args)
 		{
-			std::shared_ptr<std::promise<R>> taskPromise = std::make_shared<std::promise<R>>();
+			// Promise move into task storage, no shared pointer.
+			std::promise<R> taskPromise;
+			std::future<R> future = taskPromise.get_future();
 
-			pushTask([task, args..., taskPromise]
+			pushTaskImpl(ThreadPoolTask([task, args..., taskPromise = std::move(taskPromise)]() mutable
 			{
 				if constexpr (std::is_void_v<R>)
 				{
 					task(args...);
-					taskPromise->set_value();
+					taskPromise.set_value();
 				}
 				else
 				{
-					taskPromise->set_value(task(args...));
+					taskPromise.set_value(task(args...));
 				}
-			});
-			return taskPromise->get_future();
-		}
-
-		void reset(bool bLeftOneFreeCore = true)
-		{
-			const bool wasPaused = m_bPaused;
-
-			m_bPaused = true;
-			waitForTasks();
-			destroyThreads();
-
-			m_threadCount = getThreadCount(bLeftOneFreeCore);
-			m_threads = std::make_unique<std::thread[]>(m_threadCount);
+			}), nullptr);
 
-			m_bPaused = wasPaused;
-			createThread();
+			return future;
 		}
 
+		void reset(bool bLeftOneFreeCore = true, uint32_t threadCount = 0);
+
 		// Parallel loop with indexing.
 		// Usage example:
 		/*
@@ -266,6 +314,7 @@ namespace engine
 			};
 			threadpool->parallelizeLoop(0, vector.size(), loop).wait();
 		**/
+		// Wait of result run unclaimed blocks on caller, so nested loop inside pool task is safe.
 		template <typename F, typename T1, typename T2, typename T = std::common_type_t<T1, T2>, typename R = std::invoke_result_t<std::decay_t<F>, T, T>>
 		[[nodiscard]] FutureCollection<R> parallelizeLoop(const T1& firstIndex, const T2& indexAfterLast, const F& loop, size_t numBlocks = 0)
 		{
@@ -295,28 +344,248 @@ namespace engine
 				numBlocks = totalSize > 1 ? totalSize : 1;
 			}
 
+			auto blocks = std::make_shared<LoopBlocks<F, T, R>>(loop, firstIndexT, indexAfterLastT, blockSize, numBlocks);
+
 			FutureCollection<R> fc(numBlocks);
 			for (size_t i = 0; i < numBlocks; ++i)
 			{
-				const T start = (static_cast<T>(i * blockSize) + firstIndexT);
-				const T end = (i == numBlocks - 1) ? indexAfterLastT : (static_cast<T>((i + 1) * blockSize) + firstIndexT);
-				fc.futures[i] = submit(loop, start, end);
+				fc.futures[i] = blocks->promises[i].get_future();
+			}
+			fc.blocks = blocks;
+
+			// Each task claim next block, block may already claim by waiting caller.
+			for (size_t i = 0; i < numBlocks; ++i)
+			{
+				pushTaskImpl(ThreadPoolTask([blocks]() { blocks->runNextBlock(); }), nullptr);
 			}
 			return fc;
 		}
 
-	public:
-		explicit ThreadPool(bool bLeftOneFreeCore = true)
+		// Parallel for with dynamic chunk claim, block until whole range finish, no heap allocation.
+		// Loop called as loop(chunkStart, chunkEnd) like parallelizeLoop, caller also run chunks.
+		// Grain size is fixed chunk size, zero auto tune chunk: claim big chunk first and small chunk at tail,
+		// so loop with vary iteration cost still balance.
+		// Usage example:
+		/*
+			threadpool->parallelFor(0, rowCount, [&](const size_t loopStart, const size_t loopEnd)
+			{
+				for (size_t i = loopStart; i < loopEnd; ++i)
+				{
+					buildRow(i);
+				}
+			});
+		**/
+		template <typename F, typename T1, typename T2, typename T = std::common_type_t<T1, T2>>
+		void parallelFor(const T1& firstIndex, const T2& indexAfterLast, const F& loop, size_t grainSize = 0)
 		{
-			m_threadCount = getThreadCount(bLeftOneFreeCore);
-			m_threads = std::make_unique<std::thread[]>(m_threadCount);
-			createThread();
+			T firstIndexT = static_cast<T>(firstIndex);
+			T indexAfterLastT = static_cast<T>(indexAfterLast);
+
+			if (indexAfterLastT < firstIndexT)
+			{
+				std::swap(indexAfterLastT, firstIndexT);
+			}
+
+			const size_t totalSize = static_cast<size_t>(indexAfterLastT - firstIndexT);
+			if (totalSize == 0)
+			{
+				return;
+			}
+
+			const size_t chunkCount = grainSize > 0 ? (totalSize + grainSize - 1) / grainSize : totalSize;
+
+			// Paused pool never run helper task, so run whole range on caller.
+			if (chunkCount <= 1 || m_bPaused)
+			{
+				loop(firstIndexT, indexAfterLastT);
+				return;
+			}
+
+			ParallelForRange<F, T> range(loop, firstIndexT, totalSize, grainSize, m_threadCount);
+
+			// Helper task only hold range pointer, store inline in task. Late helper find no chunk and return.
+			const size_t helperCount = std::min(chunkCount - 1, size_t(m_threadCount));
+			for (size_t i = 0; i < helperCount; i++)
+			{
+				pushCountedTask(range.counter, [rangePtr = &range]() { rangePtr->run(); });
+			}
+
+			range.run();
+
+			// Range on stack, must wait all helpers leave it.
+			// Only run own queued helpers, which return at once, never stall caller with foreign task.
+			waitForOwnTasks(range.counter);
 		}
 
-		~ThreadPool()
+	private:
+		template<typename F, typename T, typename R>
+		class LoopBlocks : public ParallelLoopBlocks
+		{
+		public:
+			LoopBlocks(const F& inLoop, T inFirst, T inLast, size_t inBlockSize, size_t inNumBlocks)
+				: loop(inLoop), first(inFirst), last(inLast), blockSize(inBlockSize), numBlocks(inNumBlocks), promises(inNumBlocks)
+			{
+
+			}
+
+			virtual bool runNextBlock() override
+			{
+				const size_t block = nextBlock.fetch_add(1);
+				if (block >= numBlocks)
+				{
+					return false;
+				}
+
+				const T start = (static_cast<T>(block * blockSize) + first);
+				const T end = (block == numBlocks - 1) ? last : (static_cast<T>((block + 1) * blockSize) + first);
+
+				if constexpr (std::is_void_v<R>)
+				{
+					loop(start, end);
+					promises[block].set_value();
+				}
+				else
+				{
+					promises[block].set_value(loop(start, end));
+				}
+				return true;
+			}
+
+			F loop;
+			T first;
+			T last;
+			size_t blockSize;
+			size_t numBlocks;
+
+			std::atomic<size_t> nextBlock = 0;
+			std::vector<std::promise<R>> promises;
+		};
+
+		template<typename F, typename T>
+		class ParallelForRange : NonCopyable
 		{
-			waitForTasks();
-			destroyThreads();
-		}
+		public:
+			ParallelForRange(const F& inLoop, T inFirst, size_t inSize, size_t inGrainSize, uint32_t threadCount)
+				: loop(inLoop), first(inFirst), size(inSize), grainSize(inGrainSize), guidedDivisor(size_t(threadCount + 1) * 2)
+			{
+
+			}
+
+			// Claim chunks until range empty.
+			void run()
+			{
+				size_t start;
+				size_t end;
+				while (claimChunk(start, end))
+				{
+					loop(static_cast<T>(start) + first, static_cast<T>(end) + first);
+				}
+			}
+
+			bool claimChunk(size_t& outStart, size_t& outEnd)
+			{
+				if (grainSize > 0)
+				{
+					outStart = next.fetch_add(grainSize);
+					if (outStart >= size)
+					{
+						return false;
+					}
+
+					outEnd = std::min(outStart + grainSize, size);
+					return true;
+				}
+
+				// Guided chunk, part of remaining iterations evenly for all threads.
+				outStart = next.load();
+				do
+				{
+					if (outStart >= size)
+					{
+						return false;
+					}
+
+					outEnd = outStart + std::max(size_t(1), (size - outStart) / guidedDivisor);
+				} while (!next.compare_exchange_weak(outStart, outEnd));
+
+				return true;
+			}
+
+			const F& loop;
+			T first;
+			size_t size;
+			size_t grainSize;
+			size_t guidedDivisor;
+
+			std::atomic<size_t> next = 0;
+			TaskCounter counter;
+		};
+
+		struct QueuedTask
+		{
+			ThreadPoolTask task;
+			TaskCounter* counter = nullptr;
+		};
+
+		// Owner use back, thief use front, lock only hold for one push or pop.
+		struct alignas(CPU_CACHELINE_SIZE) WorkerQueue
+		{
+			std::mutex mutex;
+			std::deque<QueuedTask> tasks;
+
+			// Fast empty check without lock.
+			std::atomic<uint32_t> count = 0;
+		};
+
+		void pushTaskImpl(ThreadPoolTask&& task, TaskCounter* counter);
+
+		// Pop own queue first, then steal from others.
+		bool popTask(QueuedTask& out);
+
+		// Pop queued task push with counter from any queue.
+		bool popCountedTask(const TaskCounter& counter, QueuedTask& out);
+
+		// Run one queued task, return false if no task.
+		bool tryRunTask();
+
+		void runQueuedTask(QueuedTask& queuedTask);
+
+		void notifyWaiters();
+
+		void worker(uint32_t index);
+		void createThreads();
+		void destroyThreads();
+
+	private:
+		// Set this value to true to pause all task in this threadpool.
+		// Set this value to false to enable all task in this threadpool.
+		std::atomic<bool> m_bPaused = false;
+
+		// Flag of runing.
+		std::atomic<bool> m_bRuning = false;
+
+		// Queued and queued + running tasks.
+		std::atomic<size_t> m_tasksQueuedNum = 0;
+		std::atomic<size_t> m_tasksTotalNum = 0;
+
+		// Idle workers sleep on task available, waiting threads sleep on task done.
+		std::mutex m_sleepMutex;
+		std::condition_variable m_cvTaskAvailable;
+		std::condition_variable m_cvTaskDone;
+		std::atomic<uint32_t> m_sleepingNum = 0;
+		std::atomic<uint32_t> m_waitingNum = 0;
+
+		// Round robin queue of task push from non worker thread.
+		std::atomic<uint32_t> m_nextQueue = 0;
+
+		uint32_t m_threadCount = 0;
+		std::unique_ptr<WorkerQueue[]> m_queues = nullptr;
+		std::unique_ptr<std::thread[]> m_threads = nullptr;
 	};
-}
\ No newline at end of file
+
+	// Compare old single queue pool and work stealing pool with tiny tasks at 1, 8 and 32 threads, log result.
+	extern void benchmarkThreadPool();
+
+	// Compare parallelizeLoop and parallelFor on small, large and vary cost loops, log result.
+	extern void benchmarkParallelFor();
+}
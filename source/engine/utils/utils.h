@@ -22,6 +22,7 @@
 #include "base.h"
 #include "timer.h"
 #include "crc.h"
+#include "platform.h"
 
 #pragma warning(disable : 4996)
 